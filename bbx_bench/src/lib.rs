@@ -0,0 +1,96 @@
+//! # BBX Bench
+//!
+//! Shared support for the workspace's Criterion benches. This crate is not
+//! published and is only used as a dev-dependency.
+
+use std::{
+    env, fs,
+    path::{Path, PathBuf},
+};
+
+use serde_json::{Map, Value};
+
+/// Location of Criterion's output, following Criterion's own lookup order.
+pub fn criterion_dir() -> PathBuf {
+    if let Some(home) = env::var_os("CRITERION_HOME") {
+        return PathBuf::from(home);
+    }
+    if let Some(target) = env::var_os("CARGO_TARGET_DIR") {
+        return PathBuf::from(target).join("criterion");
+    }
+    Path::new(env!("CARGO_MANIFEST_DIR")).join("../target/criterion")
+}
+
+/// Collect Criterion's latest estimates for every benchmark whose group
+/// starts with one of `group_prefixes` and write them to `<criterion_dir>/<name>.json`.
+///
+/// Each entry has the mean time per iteration and, when the benchmark set a
+/// `Throughput::Elements`, the elements processed per second. `simd` records
+/// whether the calling crate was built with its `simd` feature.
+pub fn export_json(name: &str, group_prefixes: &[&str], simd: bool) {
+    export_json_with(name, group_prefixes, simd, Map::new());
+}
+
+/// Like [`export_json`], with extra top-level fields for measurements
+/// Criterion doesn't record (e.g. memory use).
+pub fn export_json_with(name: &str, group_prefixes: &[&str], simd: bool, extra: Map<String, Value>) {
+    let dir = criterion_dir();
+    let mut results = Vec::new();
+    collect_estimates(&dir, group_prefixes, &mut results);
+    results.sort_by(|a, b| a["id"].as_str().cmp(&b["id"].as_str()));
+
+    let mut report = serde_json::json!({
+        "bench": name,
+        "simd": simd,
+        "results": results,
+    });
+    report.as_object_mut().unwrap().extend(extra);
+
+    let path = dir.join(format!("{name}.json"));
+    match fs::create_dir_all(&dir).and_then(|_| fs::write(&path, serde_json::to_string_pretty(&report).unwrap())) {
+        Ok(()) => println!("wrote {} results to {}", results.len(), path.display()),
+        Err(e) => eprintln!("failed to write {}: {e}", path.display()),
+    }
+}
+
+fn collect_estimates(dir: &Path, group_prefixes: &[&str], results: &mut Vec<Value>) {
+    let Ok(entries) = fs::read_dir(dir) else {
+        return;
+    };
+    for entry in entries.flatten() {
+        let path = entry.path();
+        if !path.is_dir() || path.file_name().is_some_and(|name| name == "report") {
+            continue;
+        }
+        if path.file_name().is_some_and(|name| name == "new") {
+            if let Some(result) = read_estimate(&path, group_prefixes) {
+                results.push(result);
+            }
+        } else {
+            collect_estimates(&path, group_prefixes, results);
+        }
+    }
+}
+
+fn read_estimate(dir: &Path, group_prefixes: &[&str]) -> Option<Value> {
+    let read = |file: &str| -> Option<Value> { serde_json::from_str(&fs::read_to_string(dir.join(file)).ok()?).ok() };
+    let benchmark = read("benchmark.json")?;
+    let group = benchmark["group_id"].as_str()?;
+    if !group_prefixes.iter().any(|prefix| group.starts_with(prefix)) {
+        return None;
+    }
+    let estimates = read("estimates.json")?;
+
+    let mean_ns = estimates["mean"]["point_estimate"].as_f64()?;
+    let elements = benchmark["throughput"]["Elements"].as_u64();
+    Some(serde_json::json!({
+        "id": benchmark["full_id"],
+        "group": benchmark["group_id"],
+        "function": benchmark["function_id"],
+        "parameter": benchmark["value_str"],
+        "mean_ns": mean_ns,
+        "std_err_ns": estimates["mean"]["standard_error"],
+        "elements": elements,
+        "elements_per_sec": elements.map(|n| n as f64 * 1e9 / mean_ns),
+    }))
+}
@@ -0,0 +1,46 @@
+#![allow(dead_code)]
+
+use std::env;
+
+/// Cores used for two-thread benchmarks: `(main, helper)`.
+///
+/// Defaults to cores 0 and 1. Set `BBX_BENCH_CORES=<main>,<helper>` to
+/// choose others, e.g. two cores on different sockets or SMT siblings.
+pub fn bench_cores() -> (usize, usize) {
+    env::var("BBX_BENCH_CORES")
+        .ok()
+        .and_then(|cores| {
+            let (main, helper) = cores.split_once(',')?;
+            Some((main.trim().parse().ok()?, helper.trim().parse().ok()?))
+        })
+        .unwrap_or((0, 1))
+}
+
+/// Returns `true` if two threads can spin concurrently.
+///
+/// Cross-thread benchmarks busy-wait, which on a single core only measures
+/// the scheduler's time slice.
+pub fn has_two_cores() -> bool {
+    std::thread::available_parallelism().is_ok_and(|n| n.get() >= 2)
+}
+
+/// Pin the calling thread to `core`.
+///
+/// Returns `false` if pinning isn't supported on this platform or failed,
+/// in which case the thread is left wherever the scheduler puts it.
+#[cfg(target_os = "linux")]
+pub fn pin_to_core(core: usize) -> bool {
+    // SAFETY: `set` is a plain bitmask owned by this frame, and pid 0 refers
+    // to the calling thread.
+    unsafe {
+        let mut set: libc::cpu_set_t = std::mem::zeroed();
+        libc::CPU_SET(core, &mut set);
+        libc::sched_setaffinity(0, std::mem::size_of::<libc::cpu_set_t>(), &set) == 0
+    }
+}
+
+/// Pin the calling thread to `core` (unsupported on this platform).
+#[cfg(not(target_os = "linux"))]
+pub fn pin_to_core(_core: usize) -> bool {
+    false
+}
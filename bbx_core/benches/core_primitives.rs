@@ -0,0 +1,419 @@
+#![cfg_attr(feature = "simd", feature(portable_simd))]
+
+//! Benchmarks for the realtime primitives in `bbx_core`.
+//!
+//! - `spsc_latency`: round-trip time of one message between two threads pinned to different cores (see
+//!   [`common::bench_cores`]).
+//! - `spsc_transfer`: bulk producer-to-consumer throughput across threads at several ring capacities and element sizes.
+//! - `spsc_push_pop`: single-threaded fill and drain cost.
+//! - `stack_vec`, `denormal_*`, `kernels_*`: `StackVec` operations, denormal flushing and the `simd` kernels, each next
+//!   to a scalar baseline.
+//!
+//! After the run, the results are written to
+//! `target/criterion/core_primitives.json`.
+
+mod common;
+
+use std::{
+    hint::spin_loop,
+    sync::Barrier,
+    thread,
+    time::{Duration, Instant},
+};
+
+use bbx_bench::export_json;
+use bbx_core::{
+    denormal::{flush_denormal_f32, flush_denormal_f64},
+    flush_denormals_f32_batch, flush_denormals_f64_batch,
+    spsc::{Consumer, Producer, SpscRingBuffer},
+    stack_vec::StackVec,
+};
+use common::*;
+use criterion::{BatchSize, BenchmarkGroup, BenchmarkId, Criterion, Throughput, black_box, measurement::WallTime};
+
+const BUFFER_SIZES: &[usize] = &[256, 512, 1024];
+const CAPACITIES: &[usize] = &[64, 1024, 16384];
+
+/// Messages moved per iteration of the transfer benchmarks.
+const TRANSFER_BATCH: usize = 4096;
+
+/// Message used to stop the echo thread.
+const STOP: u64 = u64::MAX;
+
+fn push_spin<T>(producer: &mut Producer<T>, mut value: T) {
+    while let Err(rejected) = producer.try_push(value) {
+        value = rejected;
+        spin_loop();
+    }
+}
+
+fn pop_spin<T>(consumer: &mut Consumer<T>) -> T {
+    loop {
+        if let Some(value) = consumer.try_pop() {
+            return value;
+        }
+        spin_loop();
+    }
+}
+
+// =============================================================================
+// SPSC
+// =============================================================================
+
+fn bench_spsc_latency(c: &mut Criterion) {
+    if !has_two_cores() {
+        eprintln!("skipping spsc_latency: needs at least two cores");
+        return;
+    }
+    let (main_core, echo_core) = bench_cores();
+    let (mut ping, mut ping_rx) = SpscRingBuffer::new::<u64>(1);
+    let (mut pong_tx, mut pong) = SpscRingBuffer::new::<u64>(1);
+
+    let echo = thread::spawn(move || {
+        pin_to_core(echo_core);
+        loop {
+            let value = pop_spin(&mut ping_rx);
+            if value == STOP {
+                break;
+            }
+            push_spin(&mut pong_tx, value);
+        }
+    });
+    let pinned = pin_to_core(main_core);
+
+    let mut group = c.benchmark_group("spsc_latency");
+    let name = if pinned {
+        format!("round_trip/core{main_core}-core{echo_core}")
+    } else {
+        "round_trip/unpinned".to_string()
+    };
+    group.bench_function(name, |b| {
+        b.iter_custom(|iters| {
+            let start = Instant::now();
+            for i in 0..iters {
+                push_spin(&mut ping, i);
+                black_box(pop_spin(&mut pong));
+            }
+            start.elapsed()
+        });
+    });
+    group.finish();
+
+    push_spin(&mut ping, STOP);
+    echo.join().unwrap();
+}
+
+/// Move `iters * TRANSFER_BATCH` elements from this thread to a pinned
+/// consumer thread and time until the consumer has received the last one.
+fn transfer<T: Copy + Send>(value: T, capacity: usize, iters: u64) -> Duration {
+    let (main_core, helper_core) = bench_cores();
+    let (mut producer, mut consumer) = SpscRingBuffer::new::<T>(capacity);
+    let count = iters as usize * TRANSFER_BATCH;
+    let ready = Barrier::new(2);
+
+    thread::scope(|scope| {
+        let receiver = scope.spawn(|| {
+            pin_to_core(helper_core);
+            ready.wait();
+            for _ in 0..count {
+                black_box(pop_spin(&mut consumer));
+            }
+            Instant::now()
+        });
+
+        pin_to_core(main_core);
+        ready.wait();
+        let start = Instant::now();
+        for _ in 0..count {
+            push_spin(&mut producer, value);
+        }
+        receiver.join().unwrap() - start
+    })
+}
+
+fn bench_transfer_element<T: Copy + Send>(group: &mut BenchmarkGroup<'_, WallTime>, value: T) {
+    let element = format!("{}B", size_of::<T>());
+    for &capacity in CAPACITIES {
+        group.bench_with_input(BenchmarkId::new(&element, capacity), &capacity, |b, &capacity| {
+            b.iter_custom(|iters| transfer(value, capacity, iters));
+        });
+    }
+}
+
+fn bench_spsc_transfer(c: &mut Criterion) {
+    if !has_two_cores() {
+        eprintln!("skipping spsc_transfer: needs at least two cores");
+        return;
+    }
+    let mut group = c.benchmark_group("spsc_transfer");
+    group.throughput(Throughput::Elements(TRANSFER_BATCH as u64));
+
+    bench_transfer_element(&mut group, 0.5f32);
+    bench_transfer_element(&mut group, [0.5f32; 16]);
+    bench_transfer_element(&mut group, [0.5f32; 64]);
+
+    group.finish();
+}
+
+fn bench_spsc_push_pop(c: &mut Criterion) {
+    let mut group = c.benchmark_group("spsc_push_pop");
+
+    for &capacity in CAPACITIES {
+        group.throughput(Throughput::Elements(capacity as u64));
+        group.bench_with_input(BenchmarkId::new("fill_drain", capacity), &capacity, |b, &capacity| {
+            let (mut producer, mut consumer) = SpscRingBuffer::new::<f32>(capacity);
+            b.iter(|| {
+                for i in 0..capacity {
+                    let _ = producer.try_push(black_box(i as f32));
+                }
+                while let Some(value) = consumer.try_pop() {
+                    black_box(value);
+                }
+            });
+        });
+    }
+
+    group.finish();
+}
+
+// =============================================================================
+// StackVec
+// =============================================================================
+
+fn filled_stack_vec<const N: usize>() -> StackVec<f32, N> {
+    let mut vec = StackVec::new();
+    for i in 0..N {
+        vec.push_unchecked(i as f32);
+    }
+    vec
+}
+
+fn bench_stack_vec_capacity<const N: usize>(group: &mut BenchmarkGroup<'_, WallTime>) {
+    group.throughput(Throughput::Elements(N as u64));
+
+    group.bench_function(BenchmarkId::new("push", N), |b| {
+        b.iter_batched_ref(
+            StackVec::<f32, N>::new,
+            |vec| {
+                for i in 0..N {
+                    let _ = vec.push(black_box(i as f32));
+                }
+            },
+            BatchSize::SmallInput,
+        );
+    });
+
+    group.bench_function(BenchmarkId::new("pop", N), |b| {
+        b.iter_batched_ref(
+            filled_stack_vec::<N>,
+            |vec| {
+                while let Some(value) = vec.pop() {
+                    black_box(value);
+                }
+            },
+            BatchSize::SmallInput,
+        );
+    });
+
+    group.bench_function(BenchmarkId::new("iter_sum", N), |b| {
+        let vec = filled_stack_vec::<N>();
+        b.iter(|| black_box(&vec).as_slice().iter().sum::<f32>());
+    });
+
+    group.bench_function(BenchmarkId::new("vec_push_baseline", N), |b| {
+        b.iter_batched_ref(
+            || Vec::<f32>::with_capacity(N),
+            |vec| {
+                for i in 0..N {
+                    vec.push(black_box(i as f32));
+                }
+            },
+            BatchSize::SmallInput,
+        );
+    });
+}
+
+fn bench_stack_vec(c: &mut Criterion) {
+    let mut group = c.benchmark_group("stack_vec");
+
+    bench_stack_vec_capacity::<16>(&mut group);
+    bench_stack_vec_capacity::<64>(&mut group);
+    bench_stack_vec_capacity::<256>(&mut group);
+
+    group.finish();
+}
+
+// =============================================================================
+// Denormals
+// =============================================================================
+
+/// Buffer alternating ordinary samples with values below the flush threshold.
+fn denormal_buffer(size: usize) -> Vec<f64> {
+    (0..size)
+        .map(|i| if i % 2 == 0 { 1e-20 } else { (i as f64 * 0.01).sin() })
+        .collect()
+}
+
+fn bench_denormal(c: &mut Criterion) {
+    let mut group = c.benchmark_group("denormal_f32");
+    for &size in BUFFER_SIZES {
+        group.throughput(Throughput::Elements(size as u64));
+        let input: Vec<f32> = denormal_buffer(size).iter().map(|&x| x as f32).collect();
+
+        group.bench_with_input(BenchmarkId::new("batch", size), &input, |b, input| {
+            let mut buffer = input.clone();
+            b.iter(|| {
+                buffer.copy_from_slice(input);
+                flush_denormals_f32_batch(black_box(&mut buffer));
+            });
+        });
+        group.bench_with_input(BenchmarkId::new("scalar", size), &input, |b, input| {
+            let mut buffer = input.clone();
+            b.iter(|| {
+                buffer.copy_from_slice(input);
+                for sample in black_box(&mut buffer).iter_mut() {
+                    *sample = flush_denormal_f32(*sample);
+                }
+            });
+        });
+    }
+    group.finish();
+
+    let mut group = c.benchmark_group("denormal_f64");
+    for &size in BUFFER_SIZES {
+        group.throughput(Throughput::Elements(size as u64));
+        let input = denormal_buffer(size);
+
+        group.bench_with_input(BenchmarkId::new("batch", size), &input, |b, input| {
+            let mut buffer = input.clone();
+            b.iter(|| {
+                buffer.copy_from_slice(input);
+                flush_denormals_f64_batch(black_box(&mut buffer));
+            });
+        });
+        group.bench_with_input(BenchmarkId::new("scalar", size), &input, |b, input| {
+            let mut buffer = input.clone();
+            b.iter(|| {
+                buffer.copy_from_slice(input);
+                for sample in black_box(&mut buffer).iter_mut() {
+                    *sample = flush_denormal_f64(*sample);
+                }
+            });
+        });
+    }
+    group.finish();
+}
+
+// =============================================================================
+// Kernels
+// =============================================================================
+
+/// Scalar reference implementations of the `simd` kernels.
+mod scalar {
+    pub fn fill(slice: &mut [f32], value: f32) {
+        for sample in slice {
+            *sample = value;
+        }
+    }
+
+    pub fn apply_gain(input: &[f32], output: &mut [f32], gain: f32) {
+        for (out, &x) in output.iter_mut().zip(input) {
+            *out = x * gain;
+        }
+    }
+
+    pub fn multiply_add(a: &[f32], b: &[f32], output: &mut [f32]) {
+        for ((out, &x), &y) in output.iter_mut().zip(a).zip(b) {
+            *out = x * y;
+        }
+    }
+
+    pub fn sin(input: &[f32], output: &mut [f32]) {
+        for (out, &x) in output.iter_mut().zip(input) {
+            *out = x.sin();
+        }
+    }
+
+    pub fn power_to_db(power: &[f32], output: &mut [f32], floor_db: f32) {
+        for (out, &p) in output.iter_mut().zip(power) {
+            *out = (10.0 * p.log10()).max(floor_db);
+        }
+    }
+}
+
+type Unary = fn(&[f32], &mut [f32]);
+type Binary = fn(&[f32], &[f32], &mut [f32]);
+
+fn kernels() -> Vec<(&'static str, &'static str, Unary)> {
+    #[allow(unused_mut)]
+    let mut kernels: Vec<(&str, &str, Unary)> = vec![
+        ("fill", "scalar", |_, out| scalar::fill(out, 0.5)),
+        ("apply_gain", "scalar", |x, out| scalar::apply_gain(x, out, 0.5)),
+        ("sin", "scalar", scalar::sin),
+        ("power_to_db", "scalar", |x, out| scalar::power_to_db(x, out, -120.0)),
+    ];
+    #[cfg(feature = "simd")]
+    kernels.extend([
+        ("fill", "simd", (|_, out| bbx_core::simd::fill_f32(out, 0.5)) as Unary),
+        ("apply_gain", "simd", |x, out| {
+            bbx_core::simd::apply_gain_f32(x, out, 0.5)
+        }),
+        ("sin", "simd", bbx_core::simd::sin_f32),
+        ("power_to_db", "simd", |x, out| {
+            bbx_core::simd::power_to_db_f32(x, out, -120.0)
+        }),
+    ]);
+    kernels
+}
+
+fn binary_kernels() -> Vec<(&'static str, &'static str, Binary)> {
+    #[allow(unused_mut)]
+    let mut kernels: Vec<(&str, &str, Binary)> = vec![("multiply_add", "scalar", scalar::multiply_add)];
+    #[cfg(feature = "simd")]
+    kernels.push(("multiply_add", "simd", bbx_core::simd::multiply_add_f32));
+    kernels
+}
+
+fn bench_kernels(c: &mut Criterion) {
+    let mut group = c.benchmark_group("kernels_f32");
+
+    for &size in BUFFER_SIZES {
+        group.throughput(Throughput::Elements(size as u64));
+        let input: Vec<f32> = (0..size).map(|i| (i as f32 + 1.0) / size as f32).collect();
+
+        for (kernel, variant, f) in kernels() {
+            let id = BenchmarkId::new(format!("{kernel}/{variant}"), size);
+            group.bench_with_input(id, &input, |b, input| {
+                let mut output = vec![0.0; input.len()];
+                b.iter(|| f(black_box(input), black_box(&mut output)));
+            });
+        }
+        for (kernel, variant, f) in binary_kernels() {
+            let id = BenchmarkId::new(format!("{kernel}/{variant}"), size);
+            group.bench_with_input(id, &input, |b, input| {
+                let mut output = vec![0.0; input.len()];
+                b.iter(|| f(black_box(input), black_box(input), black_box(&mut output)));
+            });
+        }
+    }
+
+    group.finish();
+}
+
+fn main() {
+    let mut criterion = Criterion::default().configure_from_args();
+
+    bench_spsc_latency(&mut criterion);
+    bench_spsc_transfer(&mut criterion);
+    bench_spsc_push_pop(&mut criterion);
+    bench_stack_vec(&mut criterion);
+    bench_denormal(&mut criterion);
+    bench_kernels(&mut criterion);
+
+    criterion.final_summary();
+    export_json(
+        "core_primitives",
+        &["spsc_", "stack_vec", "denormal_", "kernels_"],
+        cfg!(feature = "simd"),
+    );
+}
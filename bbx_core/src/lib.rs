@@ -13,9 +13,11 @@ pub mod sample;
 pub mod simd;
 pub mod spsc;
 pub mod stack_vec;
+pub mod triple_buffer;
 
 pub use denormal::{flush_denormal_f32, flush_denormal_f64, flush_denormals_f32_batch, flush_denormals_f64_batch};
 pub use error::{BbxError, Result};
 pub use sample::Sample;
 pub use spsc::{Consumer, Producer, SpscRingBuffer};
 pub use stack_vec::StackVec;
+pub use triple_buffer::TripleBuffer;
@@ -8,7 +8,12 @@
 #![allow(clippy::excessive_precision)]
 
 #[cfg(feature = "simd")]
-use std::simd::{StdFloat, cmp::SimdPartialOrd, f32x4, f64x4, num::SimdFloat};
+use std::simd::{
+    StdFloat,
+    cmp::SimdPartialOrd,
+    f32x4, f64x4, i32x4,
+    num::{SimdFloat, SimdInt},
+};
 use std::{
     fmt::Debug,
     ops::{Add, AddAssign, Div, DivAssign, Mul, MulAssign, Neg, Sub, SubAssign},
@@ -136,6 +141,19 @@ pub trait Sample:
     /// Returns a SIMD vector with lane offsets [0.0, 1.0, 2.0, 3.0].
     #[cfg(feature = "simd")]
     fn simd_lane_offsets() -> Self::Simd;
+
+    /// Convert integer lanes to a SIMD vector of this sample type.
+    #[cfg(feature = "simd")]
+    fn simd_from_i32(values: i32x4) -> Self::Simd;
+
+    /// Widen a SIMD vector of this sample type to `f64` lanes.
+    #[cfg(feature = "simd")]
+    fn simd_to_f64(simd: Self::Simd) -> f64x4;
+
+    /// Convert `f64` lanes to a SIMD vector of this sample type, rounding to
+    /// nearest.
+    #[cfg(feature = "simd")]
+    fn simd_from_f64(values: f64x4) -> Self::Simd;
 }
 
 impl Sample for f32 {
@@ -207,6 +225,24 @@ impl Sample for f32 {
     fn simd_lane_offsets() -> Self::Simd {
         f32x4::from_array([0.0, 1.0, 2.0, 3.0])
     }
+
+    #[cfg(feature = "simd")]
+    #[inline]
+    fn simd_from_i32(values: i32x4) -> Self::Simd {
+        values.cast()
+    }
+
+    #[cfg(feature = "simd")]
+    #[inline]
+    fn simd_to_f64(simd: Self::Simd) -> f64x4 {
+        simd.cast()
+    }
+
+    #[cfg(feature = "simd")]
+    #[inline]
+    fn simd_from_f64(values: f64x4) -> Self::Simd {
+        values.cast()
+    }
 }
 
 impl Sample for f64 {
@@ -278,6 +314,24 @@ impl Sample for f64 {
     fn simd_lane_offsets() -> Self::Simd {
         f64x4::from_array([0.0, 1.0, 2.0, 3.0])
     }
+
+    #[cfg(feature = "simd")]
+    #[inline]
+    fn simd_from_i32(values: i32x4) -> Self::Simd {
+        values.cast()
+    }
+
+    #[cfg(feature = "simd")]
+    #[inline]
+    fn simd_to_f64(simd: Self::Simd) -> f64x4 {
+        simd
+    }
+
+    #[cfg(feature = "simd")]
+    #[inline]
+    fn simd_from_f64(values: f64x4) -> Self::Simd {
+        values
+    }
 }
 
 #[cfg(test)]
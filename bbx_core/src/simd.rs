@@ -3,7 +3,11 @@
 //! This module provides SIMD-accelerated operations for common DSP tasks.
 //! Requires the `simd` feature and nightly Rust.
 
-use std::simd::{StdFloat, f32x4, f64x4};
+use std::simd::{
+    StdFloat, f32x4, f64x4, i32x4,
+    num::{SimdFloat, SimdInt, SimdUint},
+    u32x4,
+};
 
 use crate::sample::{SIMD_LANES, Sample};
 
@@ -156,6 +160,52 @@ pub fn sin_f64(input: &[f64], output: &mut [f64]) {
     }
 }
 
+/// Polynomial coefficients for `log2(1 + t)` on `t` in `[0, 1)`.
+const LOG2_COEFFS: [f32; 4] = [1.438_546_8, -0.678_081_5, 0.323_630_37, -0.084_285_09];
+
+/// `10 * log10(2)`: decibels per unit of `log2(power)`.
+const DB_PER_LOG2: f32 = 10.0 * std::f32::consts::LOG10_2;
+
+#[inline]
+fn log2_approx(x: f32) -> f32 {
+    let bits = x.max(f32::MIN_POSITIVE).to_bits();
+    let exponent = ((bits >> 23) as i32 - 127) as f32;
+    let t = f32::from_bits((bits & 0x007F_FFFF) | 0x3F80_0000) - 1.0;
+    let [c1, c2, c3, c4] = LOG2_COEFFS;
+    exponent + t * (c1 + t * (c2 + t * (c3 + t * c4)))
+}
+
+/// Convert power values to decibels (`10 * log10(power)`), clamped at `floor_db`.
+///
+/// Uses a polynomial `log2` approximation accurate to within 0.001 dB.
+/// Zero, negative, and denormal inputs map to `floor_db`.
+pub fn power_to_db_f32(power: &[f32], output: &mut [f32], floor_db: f32) {
+    debug_assert!(power.len() <= output.len());
+
+    let len = power.len();
+    let chunks = len / F32_LANES;
+    let remainder_start = chunks * F32_LANES;
+
+    let [c1, c2, c3, c4] = LOG2_COEFFS.map(f32x4::splat);
+    let floor = f32x4::splat(floor_db);
+
+    for i in 0..chunks {
+        let offset = i * F32_LANES;
+        let p = f32x4::from_slice(&power[offset..]).simd_max(f32x4::splat(f32::MIN_POSITIVE));
+        let bits = p.to_bits();
+        let exponent = ((bits >> u32x4::splat(23)).cast::<i32>() - i32x4::splat(127)).cast::<f32>();
+        let mantissa = f32x4::from_bits((bits & u32x4::splat(0x007F_FFFF)) | u32x4::splat(0x3F80_0000));
+        let t = mantissa - f32x4::splat(1.0);
+        let log2 = exponent + t * (c1 + t * (c2 + t * (c3 + t * c4)));
+        let db = (log2 * f32x4::splat(DB_PER_LOG2)).simd_max(floor);
+        output[offset..offset + F32_LANES].copy_from_slice(&db.to_array());
+    }
+
+    for i in remainder_start..len {
+        output[i] = (log2_approx(power[i]) * DB_PER_LOG2).max(floor_db);
+    }
+}
+
 // =============================================================================
 // Generic SIMD operations using Sample trait
 // =============================================================================
@@ -245,6 +295,130 @@ pub fn sin<S: Sample>(input: &[S], output: &mut [S]) {
     }
 }
 
+/// Scale from 16-bit PCM to `[-1, 1)`.
+const PCM16_SCALE: f64 = 1.0 / 32768.0;
+
+/// Scale from 24-bit PCM, held in the top bits of an `i32`, to `[-1, 1)`.
+const PCM24_SCALE: f64 = 1.0 / 2147483648.0;
+
+/// Decode 16-bit PCM to samples in `[-1, 1)` using SIMD.
+#[inline]
+pub fn decode_pcm16<S: Sample>(input: &[i16], output: &mut [S]) {
+    debug_assert!(input.len() <= output.len());
+
+    let scale = S::simd_splat(S::from_f64(PCM16_SCALE));
+    let (chunks, remainder) = input.as_chunks::<SIMD_LANES>();
+
+    for (i, chunk) in chunks.iter().enumerate() {
+        let values = i32x4::from_array(chunk.map(i32::from));
+        let offset = i * SIMD_LANES;
+        output[offset..offset + SIMD_LANES].copy_from_slice(&S::simd_to_array(S::simd_from_i32(values) * scale));
+    }
+
+    let remainder_start = chunks.len() * SIMD_LANES;
+    for (out, &value) in output[remainder_start..].iter_mut().zip(remainder) {
+        *out = S::from_f64(value as f64 * PCM16_SCALE);
+    }
+}
+
+/// Decode packed little-endian 24-bit PCM (3 bytes per sample) to samples in
+/// `[-1, 1)` using SIMD.
+#[inline]
+pub fn decode_pcm24<S: Sample>(input: &[u8], output: &mut [S]) {
+    debug_assert!(input.len() / 3 <= output.len());
+
+    // Each sample is loaded into the top three bytes of an i32, which keeps
+    // its sign without a shift
+    let widen = |bytes: &[u8; 3]| i32::from_le_bytes([0, bytes[0], bytes[1], bytes[2]]);
+
+    let scale = S::simd_splat(S::from_f64(PCM24_SCALE));
+    let (samples, _) = input.as_chunks::<3>();
+    let (chunks, remainder) = samples.as_chunks::<SIMD_LANES>();
+
+    for (i, chunk) in chunks.iter().enumerate() {
+        let values = i32x4::from_array(chunk.each_ref().map(widen));
+        let offset = i * SIMD_LANES;
+        output[offset..offset + SIMD_LANES].copy_from_slice(&S::simd_to_array(S::simd_from_i32(values) * scale));
+    }
+
+    let remainder_start = chunks.len() * SIMD_LANES;
+    for (out, bytes) in output[remainder_start..].iter_mut().zip(remainder) {
+        *out = S::from_f64(widen(bytes) as f64 * PCM24_SCALE);
+    }
+}
+
+/// Widen samples to `f64` using SIMD.
+#[inline]
+pub fn convert_to_f64<S: Sample>(input: &[S], output: &mut [f64]) {
+    debug_assert!(input.len() <= output.len());
+
+    let (chunks, remainder) = input.as_chunks::<SIMD_LANES>();
+    for (chunk, out) in chunks.iter().zip(output.as_chunks_mut::<SIMD_LANES>().0) {
+        *out = S::simd_to_f64(S::simd_from_slice(chunk)).to_array();
+    }
+
+    let remainder_start = chunks.len() * SIMD_LANES;
+    for (out, &value) in output[remainder_start..].iter_mut().zip(remainder) {
+        *out = value.to_f64();
+    }
+}
+
+/// Convert `f64` samples to another sample type using SIMD, rounding to
+/// nearest.
+#[inline]
+pub fn convert_from_f64<S: Sample>(input: &[f64], output: &mut [S]) {
+    debug_assert!(input.len() <= output.len());
+
+    let (chunks, remainder) = input.as_chunks::<SIMD_LANES>();
+    for (chunk, out) in chunks.iter().zip(output.as_chunks_mut::<SIMD_LANES>().0) {
+        *out = S::simd_to_array(S::simd_from_f64(f64x4::from_array(*chunk)));
+    }
+
+    let remainder_start = chunks.len() * SIMD_LANES;
+    for (out, &value) in output[remainder_start..].iter_mut().zip(remainder) {
+        *out = S::from_f64(value);
+    }
+}
+
+/// Peak magnitude, sum of squares and the number of samples whose magnitude
+/// exceeds `clip_level`, in one pass.
+#[inline]
+pub fn level_stats<S: Sample>(input: &[S], clip_level: S) -> (S, S, usize) {
+    let zero = S::simd_splat(S::ZERO);
+    let one = S::simd_splat(S::ONE);
+    let clip = S::simd_splat(clip_level);
+    let mut peak = zero;
+    let mut sum_squares = zero;
+    let mut clips = zero;
+
+    let chunks = input.len() / SIMD_LANES;
+    let remainder_start = chunks * SIMD_LANES;
+
+    for i in 0..chunks {
+        let chunk = S::simd_from_slice(&input[i * SIMD_LANES..]);
+        let magnitude = chunk.abs();
+        peak = peak.simd_max(magnitude);
+        sum_squares = sum_squares + chunk * chunk;
+        clips = clips + S::simd_select_gt(magnitude, clip, one, zero);
+    }
+
+    let mut peak = peak.reduce_max();
+    let mut sum_squares = sum_squares.reduce_sum();
+    let mut clips = clips.reduce_sum().to_f64() as usize;
+    for &sample in &input[remainder_start..] {
+        let magnitude = sample.abs();
+        if magnitude > peak {
+            peak = magnitude;
+        }
+        sum_squares += sample * sample;
+        if magnitude > clip_level {
+            clips += 1;
+        }
+    }
+
+    (peak, sum_squares, clips)
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -260,6 +434,30 @@ mod tests {
         assert!(buffer.iter().all(|&x| x == 1.5));
     }
 
+    #[test]
+    fn test_power_to_db_f32() {
+        let power: Vec<f32> = (0..37).map(|i| 10f32.powf(i as f32 * 0.37 - 9.0)).collect();
+        let mut output = vec![0.0f32; power.len()];
+        power_to_db_f32(&power, &mut output, -200.0);
+
+        for (&p, &db) in power.iter().zip(&output) {
+            assert!((db - 10.0 * p.log10()).abs() < 0.001, "{p}: {db}");
+        }
+    }
+
+    #[test]
+    fn test_power_to_db_f32_floor() {
+        let power = [0.0f32, -1.0, 1e-20, 1.0, 0.0];
+        let mut output = [0.0f32; 5];
+        power_to_db_f32(&power, &mut output, -120.0);
+
+        assert_eq!(output[0], -120.0);
+        assert_eq!(output[1], -120.0);
+        assert_eq!(output[2], -120.0);
+        assert!(output[3].abs() < 0.001);
+        assert_eq!(output[4], -120.0);
+    }
+
     #[test]
     fn test_fill_f64() {
         let mut buffer = [0.0f64; 10];
@@ -576,4 +774,80 @@ mod tests {
             }
         }
     }
+
+    #[test]
+    fn test_level_stats_f32() {
+        let input: Vec<f32> = (0..37).map(|i| (i as f32 * 0.7).sin() * 1.3).collect();
+        let (peak, sum_squares, clips) = level_stats(&input, 1.0);
+
+        let expected_peak = input.iter().fold(0.0f32, |acc, x| acc.max(x.abs()));
+        let expected_sum: f32 = input.iter().map(|x| x * x).sum();
+        let expected_clips = input.iter().filter(|x| x.abs() > 1.0).count();
+        assert_eq!(peak, expected_peak);
+        assert!((sum_squares - expected_sum).abs() < 1e-4);
+        assert_eq!(clips, expected_clips);
+    }
+
+    #[test]
+    fn test_level_stats_edge_sizes() {
+        for len in 0usize..9 {
+            let input: Vec<f64> = (0..len).map(|i| -(i as f64)).collect();
+            let (peak, sum_squares, clips) = level_stats(&input, 1.0);
+            assert_eq!(peak, len.saturating_sub(1) as f64);
+            assert_eq!(sum_squares, input.iter().map(|x| x * x).sum::<f64>());
+            assert_eq!(clips, len.saturating_sub(2));
+        }
+    }
+
+    #[test]
+    fn test_decode_pcm16_edge_sizes() {
+        for len in 0usize..11 {
+            let input: Vec<i16> = (0..len)
+                .map(|i| (i as i16 - 5) * 6553)
+                .chain([i16::MIN, i16::MAX])
+                .collect();
+            let mut output = vec![0.0f32; input.len()];
+            decode_pcm16(&input, &mut output);
+            for (&x, &y) in input.iter().zip(&output) {
+                assert_eq!(y, x as f32 / 32768.0);
+            }
+        }
+    }
+
+    #[test]
+    fn test_decode_pcm24_sign_and_range() {
+        let values = [0i32, 1, -1, 8_388_607, -8_388_608, 4_194_304, -123_456];
+        let input: Vec<u8> = values.iter().flat_map(|v| v.to_le_bytes()[..3].to_vec()).collect();
+        let mut output = vec![0.0f64; values.len()];
+        decode_pcm24(&input, &mut output);
+        for (&x, &y) in values.iter().zip(&output) {
+            assert_eq!(y, x as f64 / 8_388_608.0);
+        }
+    }
+
+    #[test]
+    fn test_convert_f64_round_trip_edge_sizes() {
+        for len in 0usize..11 {
+            let input: Vec<f32> = (0..len).map(|i| (i as f32 * 0.7).sin() / 3.0).collect();
+            let mut wide = vec![0.0f64; len];
+            convert_to_f64(&input, &mut wide);
+            for (&x, &y) in input.iter().zip(&wide) {
+                assert_eq!(y, x as f64);
+            }
+
+            let mut narrow = vec![0.0f32; len];
+            convert_from_f64(&wide, &mut narrow);
+            assert_eq!(narrow, input);
+        }
+    }
+
+    #[test]
+    fn test_convert_from_f64_rounds_to_nearest() {
+        let input: Vec<f64> = (0..9).map(|i| 0.1 + i as f64 * 1e-9).collect();
+        let mut output = vec![0.0f32; input.len()];
+        convert_from_f64(&input, &mut output);
+        for (&x, &y) in input.iter().zip(&output) {
+            assert_eq!(y, x as f32);
+        }
+    }
 }
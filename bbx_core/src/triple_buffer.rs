@@ -0,0 +1,245 @@
+//! Lock-free triple buffer for publishing the latest value between threads.
+//!
+//! Unlike a queue, a triple buffer only keeps the most recent value: the
+//! writer never waits for the reader, and the reader always sees the newest
+//! complete value without copying. This suits data such as analysis results
+//! or meter levels that are produced at one rate and consumed at another.
+
+use core::cell::UnsafeCell;
+#[cfg(not(loom))]
+use std::sync::{
+    Arc,
+    atomic::{AtomicU8, Ordering},
+};
+
+#[cfg(loom)]
+use loom::sync::{
+    Arc,
+    atomic::{AtomicU8, Ordering},
+};
+
+/// Bit set in the shared index when it holds a value the reader hasn't seen.
+const NEW_DATA: u8 = 0b100;
+
+/// Mask for the buffer index.
+const INDEX_MASK: u8 = 0b011;
+
+/// Internal shared state for the triple buffer.
+struct TripleBufferInner<T> {
+    buffers: [UnsafeCell<T>; 3],
+    /// Index of the buffer not owned by either side, plus the `NEW_DATA` flag.
+    shared: AtomicU8,
+}
+
+// SAFETY: Each buffer is owned by exactly one side at a time; ownership is
+// exchanged through atomic swaps of `shared`.
+unsafe impl<T: Send> Send for TripleBufferInner<T> {}
+unsafe impl<T: Send> Sync for TripleBufferInner<T> {}
+
+/// Factory for creating input/output pairs.
+pub struct TripleBuffer;
+
+impl TripleBuffer {
+    /// Creates a new triple buffer with every slot set to `initial`.
+    ///
+    /// Returns an `(Input, Output)` pair. Values are allocated up front, so
+    /// writers that reuse the slot's storage (e.g. `Vec::clear` + `extend`)
+    /// never allocate.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use bbx_core::triple_buffer::TripleBuffer;
+    ///
+    /// let (mut input, mut output) = TripleBuffer::new(0);
+    ///
+    /// *input.input_buffer() = 1;
+    /// input.publish();
+    /// *input.input_buffer() = 2;
+    /// input.publish();
+    ///
+    /// assert_eq!(*output.read(), 2);
+    /// ```
+    #[allow(clippy::new_ret_no_self)]
+    pub fn new<T: Clone>(initial: T) -> (Input<T>, Output<T>) {
+        let inner = Arc::new(TripleBufferInner {
+            buffers: [
+                UnsafeCell::new(initial.clone()),
+                UnsafeCell::new(initial.clone()),
+                UnsafeCell::new(initial),
+            ],
+            shared: AtomicU8::new(1),
+        });
+
+        (
+            Input {
+                inner: Arc::clone(&inner),
+                back: 0,
+            },
+            Output { inner, front: 2 },
+        )
+    }
+}
+
+/// Writer handle for a triple buffer.
+///
+/// This type is `Send` but not `Clone` - only one writer should exist.
+pub struct Input<T> {
+    inner: Arc<TripleBufferInner<T>>,
+    back: u8,
+}
+
+// SAFETY: Input can be sent to another thread if T: Send
+unsafe impl<T: Send> Send for Input<T> {}
+
+impl<T> Input<T> {
+    /// Get the buffer to write the next value into.
+    ///
+    /// The buffer holds an older value; overwrite it completely before
+    /// calling [`publish`](Self::publish).
+    #[inline]
+    pub fn input_buffer(&mut self) -> &mut T {
+        // SAFETY: The back buffer is owned exclusively by the writer.
+        unsafe { &mut *self.inner.buffers[self.back as usize].get() }
+    }
+
+    /// Make the input buffer the latest value.
+    #[inline]
+    pub fn publish(&mut self) {
+        let previous = self.inner.shared.swap(self.back | NEW_DATA, Ordering::AcqRel);
+        self.back = previous & INDEX_MASK;
+    }
+
+    /// Write a value and publish it.
+    #[inline]
+    pub fn write(&mut self, value: T) {
+        *self.input_buffer() = value;
+        self.publish();
+    }
+}
+
+/// Reader handle for a triple buffer.
+///
+/// This type is `Send` but not `Clone` - only one reader should exist.
+pub struct Output<T> {
+    inner: Arc<TripleBufferInner<T>>,
+    front: u8,
+}
+
+// SAFETY: Output can be sent to another thread if T: Send
+unsafe impl<T: Send> Send for Output<T> {}
+
+impl<T> Output<T> {
+    /// Returns `true` if a value was published since the last read.
+    #[inline]
+    pub fn has_update(&self) -> bool {
+        self.inner.shared.load(Ordering::Relaxed) & NEW_DATA != 0
+    }
+
+    /// Get the latest published value.
+    ///
+    /// Returns the previous value again if nothing new was published.
+    #[inline]
+    pub fn read(&mut self) -> &T {
+        if self.has_update() {
+            let previous = self.inner.shared.swap(self.front, Ordering::AcqRel);
+            self.front = previous & INDEX_MASK;
+        }
+        // SAFETY: The front buffer is owned exclusively by the reader.
+        unsafe { &*self.inner.buffers[self.front as usize].get() }
+    }
+}
+
+#[cfg(all(test, not(loom)))]
+mod tests {
+    use std::thread;
+
+    use super::*;
+
+    #[test]
+    fn test_initial_value() {
+        let (_input, mut output) = TripleBuffer::new(7);
+        assert!(!output.has_update());
+        assert_eq!(*output.read(), 7);
+    }
+
+    #[test]
+    fn test_latest_value_wins() {
+        let (mut input, mut output) = TripleBuffer::new(0);
+
+        input.write(1);
+        input.write(2);
+        input.write(3);
+
+        assert!(output.has_update());
+        assert_eq!(*output.read(), 3);
+        assert!(!output.has_update());
+        assert_eq!(*output.read(), 3);
+    }
+
+    #[test]
+    fn test_input_buffer_reuses_storage() {
+        let (mut input, mut output) = TripleBuffer::new(Vec::<f32>::with_capacity(8));
+
+        for round in 0..5 {
+            let buf = input.input_buffer();
+            buf.clear();
+            buf.extend((0..8).map(|i| (round * 8 + i) as f32));
+            input.publish();
+        }
+
+        let latest = output.read();
+        assert_eq!(latest.len(), 8);
+        assert_eq!(latest[0], 32.0);
+    }
+
+    #[test]
+    fn test_concurrent_values_are_complete_and_monotonic() {
+        let (mut input, mut output) = TripleBuffer::new([0u64; 16]);
+
+        let writer = thread::spawn(move || {
+            for i in 1..=10_000u64 {
+                input.write([i; 16]);
+            }
+        });
+
+        let mut last = 0;
+        while last < 10_000 {
+            let value = *output.read();
+            assert!(value.iter().all(|&v| v == value[0]), "torn read");
+            assert!(value[0] >= last);
+            last = value[0];
+            if writer.is_finished() && !output.has_update() {
+                break;
+            }
+        }
+
+        writer.join().unwrap();
+        assert_eq!(*output.read(), [10_000; 16]);
+    }
+}
+
+#[cfg(loom)]
+mod loom_tests {
+    use loom::thread;
+
+    use super::*;
+
+    #[test]
+    fn loom_publish_read() {
+        loom::model(|| {
+            let (mut input, mut output) = TripleBuffer::new(0);
+
+            let writer = thread::spawn(move || {
+                input.write(1);
+                input.write(2);
+            });
+
+            let value = *output.read();
+            assert!(value <= 2);
+
+            writer.join().unwrap();
+            assert_eq!(*output.read(), 2);
+        });
+    }
+}
@@ -11,7 +11,7 @@ use std::{
     time::Duration,
 };
 
-use bbx_draw::{AudioFrame, Visualizer, WaveformVisualizer, audio_bridge};
+use bbx_draw::{Visualizer, WaveformVisualizer, audio_bridge};
 use nannou::prelude::*;
 
 struct Model {
@@ -51,8 +51,7 @@ fn model(app: &App) -> Model {
                 }
             }
 
-            let frame = AudioFrame::new(&samples, sample_rate, 1);
-            let _ = producer.try_send(frame);
+            let _ = producer.try_write(&samples, sample_rate, 1);
 
             thread::sleep(Duration::from_micros(
                 (1_000_000 * BUFFER_SIZE as u64) / sample_rate as u64,
@@ -0,0 +1,474 @@
+//! Spectrum analysis on a dedicated thread.
+//!
+//! [`SpectrumProcessor`] turns a stream of samples into magnitude spectra
+//! using a cached real-to-complex FFT plan, computing a new spectrum every
+//! `hop_size` samples. [`SpectrumAnalysisThread`] runs a processor on its own
+//! thread, draining an [`AudioBridgeConsumer`] and publishing each spectrum
+//! through a [`TripleBuffer`], so the draw thread only ever reads the latest
+//! finished result.
+
+use std::{
+    sync::{
+        Arc,
+        atomic::{AtomicBool, Ordering},
+    },
+    thread::{self, JoinHandle},
+    time::Duration,
+};
+
+use bbx_core::triple_buffer::{Output, TripleBuffer};
+use realfft::{RealFftPlanner, RealToComplex, num_complex::Complex};
+
+use crate::bridge::AudioBridgeConsumer;
+
+/// Lowest level reported, in dB.
+pub const SPECTRUM_FLOOR_DB: f32 = -120.0;
+
+/// How long the analysis thread sleeps when the bridge is empty.
+const IDLE_SLEEP: Duration = Duration::from_millis(1);
+
+/// Windowed real FFT with hop-based overlap.
+///
+/// All buffers and the FFT plan are allocated at construction.
+pub struct SpectrumProcessor {
+    fft: Arc<dyn RealToComplex<f32>>,
+    window: Vec<f32>,
+    history: Vec<f32>,
+    write_position: usize,
+    hop_size: usize,
+    samples_since_hop: usize,
+    fft_input: Vec<f32>,
+    fft_output: Vec<Complex<f32>>,
+    scratch: Vec<Complex<f32>>,
+    power: Vec<f32>,
+    magnitudes_db: Vec<f32>,
+}
+
+impl SpectrumProcessor {
+    /// Create a processor for `fft_size`-point spectra every `hop_size` samples.
+    ///
+    /// `hop_size` is clamped to `1..=fft_size`; a hop of a quarter of the FFT
+    /// size gives 75% overlap.
+    pub fn new(fft_size: usize, hop_size: usize) -> Self {
+        let fft_size = fft_size.max(2);
+        let fft = RealFftPlanner::<f32>::new().plan_fft_forward(fft_size);
+        let num_bins = fft_size / 2;
+
+        Self {
+            fft_input: fft.make_input_vec(),
+            fft_output: fft.make_output_vec(),
+            scratch: fft.make_scratch_vec(),
+            fft,
+            window: hann_window(fft_size),
+            history: vec![0.0; fft_size],
+            write_position: 0,
+            hop_size: hop_size.clamp(1, fft_size),
+            samples_since_hop: 0,
+            power: vec![0.0; num_bins],
+            magnitudes_db: vec![SPECTRUM_FLOOR_DB; num_bins],
+        }
+    }
+
+    /// FFT size in samples.
+    pub fn fft_size(&self) -> usize {
+        self.history.len()
+    }
+
+    /// Samples between spectra.
+    pub fn hop_size(&self) -> usize {
+        self.hop_size
+    }
+
+    /// Number of frequency bins per spectrum (`fft_size / 2`).
+    pub fn num_bins(&self) -> usize {
+        self.magnitudes_db.len()
+    }
+
+    /// The most recently computed spectrum in dB.
+    pub fn magnitudes_db(&self) -> &[f32] {
+        &self.magnitudes_db
+    }
+
+    /// Feed samples, calling `on_spectrum` with each new spectrum in dB.
+    ///
+    /// Returns the number of spectra computed.
+    pub fn process(&mut self, samples: impl IntoIterator<Item = f32>, mut on_spectrum: impl FnMut(&[f32])) -> usize {
+        let fft_size = self.fft_size();
+        let mut count = 0;
+
+        for sample in samples {
+            self.history[self.write_position] = sample;
+            self.write_position += 1;
+            if self.write_position == fft_size {
+                self.write_position = 0;
+            }
+
+            self.samples_since_hop += 1;
+            if self.samples_since_hop == self.hop_size {
+                self.samples_since_hop = 0;
+                self.compute();
+                on_spectrum(&self.magnitudes_db);
+                count += 1;
+            }
+        }
+
+        count
+    }
+
+    fn compute(&mut self) {
+        let fft_size = self.fft_size();
+        let split = fft_size - self.write_position;
+
+        // The oldest sample sits at the write position, so the history is
+        // windowed in two contiguous runs instead of indexing modulo the size.
+        apply_window(
+            &self.history[self.write_position..],
+            &self.window[..split],
+            &mut self.fft_input[..split],
+        );
+        apply_window(
+            &self.history[..self.write_position],
+            &self.window[split..],
+            &mut self.fft_input[split..],
+        );
+
+        if self
+            .fft
+            .process_with_scratch(&mut self.fft_input, &mut self.fft_output, &mut self.scratch)
+            .is_err()
+        {
+            return;
+        }
+
+        // Magnitudes are scaled by 2/N so a full-scale sine reads 0 dB; the
+        // scale is squared because we work in power to skip the square root.
+        let scale = 2.0 / fft_size as f32;
+        let power_scale = scale * scale;
+        for (power, bin) in self.power.iter_mut().zip(&self.fft_output) {
+            *power = (bin.re * bin.re + bin.im * bin.im) * power_scale;
+        }
+
+        power_to_db(&self.power, &mut self.magnitudes_db);
+    }
+}
+
+/// Runs a [`SpectrumProcessor`] on a background thread.
+///
+/// The thread drains channel 0 of the audio bridge and publishes each
+/// spectrum (in dB) to the [`Output`] returned by [`spawn`](Self::spawn), or
+/// hands it to a callback with [`spawn_with`](Self::spawn_with).
+/// Stopping the thread hands the bridge consumer back so analysis can be
+/// restarted with new settings.
+pub struct SpectrumAnalysisThread {
+    stop: Arc<AtomicBool>,
+    handle: Option<JoinHandle<AudioBridgeConsumer>>,
+}
+
+impl SpectrumAnalysisThread {
+    /// Start analyzing audio from `consumer`.
+    pub fn spawn(consumer: AudioBridgeConsumer, fft_size: usize, hop_size: usize) -> (Self, Output<Vec<f32>>) {
+        let num_bins = SpectrumProcessor::new(fft_size, hop_size).num_bins();
+        let (mut input, output) = TripleBuffer::new(vec![SPECTRUM_FLOOR_DB; num_bins]);
+
+        let thread = Self::spawn_with(consumer, fft_size, hop_size, move |spectrum, _sample_rate| {
+            let buffer = input.input_buffer();
+            buffer.clear();
+            buffer.extend_from_slice(spectrum);
+            input.publish();
+        });
+
+        (thread, output)
+    }
+
+    /// Start analyzing audio from `consumer`, passing every spectrum (in dB)
+    /// and the stream's sample rate to `on_spectrum` on the analysis thread.
+    ///
+    /// Use this when every hop matters, such as for a spectrogram, rather than
+    /// only the latest spectrum.
+    pub fn spawn_with(
+        consumer: AudioBridgeConsumer,
+        fft_size: usize,
+        hop_size: usize,
+        mut on_spectrum: impl FnMut(&[f32], u32) + Send + 'static,
+    ) -> Self {
+        let mut processor = SpectrumProcessor::new(fft_size, hop_size);
+        let stop = Arc::new(AtomicBool::new(false));
+
+        let handle = {
+            let stop = Arc::clone(&stop);
+            let mut consumer = consumer;
+            thread::Builder::new()
+                .name("bbx-spectrum".to_string())
+                .spawn(move || {
+                    while !stop.load(Ordering::Relaxed) {
+                        let received = consumer.read(|view| {
+                            if let Some(samples) = view.channel(0) {
+                                let sample_rate = view.sample_rate();
+                                processor.process(samples, |spectrum| on_spectrum(spectrum, sample_rate));
+                            }
+                            !view.is_empty()
+                        });
+
+                        if !received {
+                            thread::sleep(IDLE_SLEEP);
+                        }
+                    }
+                    consumer
+                })
+                .expect("failed to spawn spectrum analysis thread")
+        };
+
+        Self {
+            stop,
+            handle: Some(handle),
+        }
+    }
+
+    /// Stop the thread and return the audio bridge consumer.
+    pub fn stop(mut self) -> AudioBridgeConsumer {
+        self.stop.store(true, Ordering::Relaxed);
+        self.handle
+            .take()
+            .expect("analysis thread already stopped")
+            .join()
+            .expect("spectrum analysis thread panicked")
+    }
+}
+
+impl Drop for SpectrumAnalysisThread {
+    fn drop(&mut self) {
+        self.stop.store(true, Ordering::Relaxed);
+        if let Some(handle) = self.handle.take() {
+            let _ = handle.join();
+        }
+    }
+}
+
+/// Maps linear FFT bins onto log-spaced frequency rows.
+///
+/// The mapping is precomputed as a sparse matrix (one short run of bin
+/// weights per row), so applying it costs one multiply-add per nonzero
+/// weight. Rows wider than a bin average the bins they overlap; rows
+/// narrower than a bin interpolate between the two nearest bins.
+pub struct LogFrequencyMap {
+    row_starts: Vec<usize>,
+    bins: Vec<usize>,
+    weights: Vec<f32>,
+}
+
+impl LogFrequencyMap {
+    /// Build a map from `num_bins` bins of an FFT of size `2 * num_bins` at
+    /// `sample_rate` onto `num_rows` rows spanning `min_freq..max_freq` Hz.
+    ///
+    /// Row 0 is the lowest frequency.
+    pub fn new(num_bins: usize, num_rows: usize, sample_rate: f32, min_freq: f32, max_freq: f32) -> Self {
+        let bin_width = sample_rate / (2 * num_bins) as f32;
+        let max_freq = max_freq.min(sample_rate / 2.0);
+        let min_freq = min_freq.clamp(bin_width * 0.5, max_freq);
+        let ratio = (max_freq / min_freq).powf(1.0 / num_rows.max(1) as f32);
+        let last_bin = num_bins.saturating_sub(1) as f32;
+
+        let mut row_starts = Vec::with_capacity(num_rows + 1);
+        let mut bins = Vec::new();
+        let mut weights = Vec::new();
+
+        for row in 0..num_rows {
+            row_starts.push(bins.len());
+            let low = (min_freq * ratio.powi(row as i32) / bin_width).min(last_bin);
+            let high = (min_freq * ratio.powi(row as i32 + 1) / bin_width).min(last_bin + 1.0);
+
+            if high - low <= 1.0 {
+                let center = ((low + high) * 0.5).min(last_bin);
+                let below = center.floor();
+                let frac = center - below;
+                bins.push(below as usize);
+                weights.push(1.0 - frac);
+                if frac > 0.0 && below as usize + 1 < num_bins {
+                    bins.push(below as usize + 1);
+                    weights.push(frac);
+                }
+            } else {
+                let total = high - low;
+                for bin in low.floor() as usize..(high.ceil() as usize).min(num_bins) {
+                    let overlap = (high.min(bin as f32 + 1.0) - low.max(bin as f32)).max(0.0);
+                    if overlap > 0.0 {
+                        bins.push(bin);
+                        weights.push(overlap / total);
+                    }
+                }
+            }
+        }
+        row_starts.push(bins.len());
+
+        Self {
+            row_starts,
+            bins,
+            weights,
+        }
+    }
+
+    /// Number of output rows.
+    pub fn num_rows(&self) -> usize {
+        self.row_starts.len() - 1
+    }
+
+    /// Map `spectrum` onto `output`, one value per row.
+    pub fn apply(&self, spectrum: &[f32], output: &mut [f32]) {
+        for (row, out) in output.iter_mut().enumerate().take(self.num_rows()) {
+            let range = self.row_starts[row]..self.row_starts[row + 1];
+            *out = self.bins[range.clone()]
+                .iter()
+                .zip(&self.weights[range])
+                .map(|(&bin, &weight)| spectrum[bin] * weight)
+                .sum();
+        }
+    }
+}
+
+pub(crate) fn hann_window(size: usize) -> Vec<f32> {
+    (0..size)
+        .map(|i| 0.5 * (1.0 - (std::f32::consts::TAU * i as f32 / size as f32).cos()))
+        .collect()
+}
+
+#[inline]
+fn apply_window(samples: &[f32], window: &[f32], output: &mut [f32]) {
+    #[cfg(feature = "simd")]
+    bbx_core::simd::multiply_add_f32(samples, window, output);
+
+    #[cfg(not(feature = "simd"))]
+    for ((out, &sample), &w) in output.iter_mut().zip(samples).zip(window) {
+        *out = sample * w;
+    }
+}
+
+#[inline]
+fn power_to_db(power: &[f32], output: &mut [f32]) {
+    #[cfg(feature = "simd")]
+    bbx_core::simd::power_to_db_f32(power, output, SPECTRUM_FLOOR_DB);
+
+    #[cfg(not(feature = "simd"))]
+    for (out, &p) in output.iter_mut().zip(power) {
+        *out = if p > 0.0 {
+            (10.0 * p.log10()).max(SPECTRUM_FLOOR_DB)
+        } else {
+            SPECTRUM_FLOOR_DB
+        };
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::bridge::audio_bridge;
+
+    fn sine(freq: f32, sample_rate: f32, len: usize) -> Vec<f32> {
+        (0..len)
+            .map(|i| (std::f32::consts::TAU * freq * i as f32 / sample_rate).sin())
+            .collect()
+    }
+
+    #[test]
+    fn test_hann_window() {
+        let window = hann_window(4);
+        assert!((window[0] - 0.0).abs() < 0.001);
+        assert!((window[1] - 0.5).abs() < 0.001);
+        assert!((window[2] - 1.0).abs() < 0.001);
+        assert!((window[3] - 0.5).abs() < 0.001);
+    }
+
+    #[test]
+    fn test_power_to_db() {
+        let mut out = [0.0; 3];
+        power_to_db(&[1.0, 0.01, 0.0], &mut out);
+        assert!(out[0].abs() < 0.001);
+        assert!((out[1] + 20.0).abs() < 0.001);
+        assert_eq!(out[2], SPECTRUM_FLOOR_DB);
+    }
+
+    #[test]
+    fn test_hop_controls_spectrum_rate() {
+        let mut processor = SpectrumProcessor::new(1024, 256);
+        let count = processor.process(sine(1000.0, 48000.0, 4096), |_| {});
+        assert_eq!(count, 16);
+    }
+
+    #[test]
+    fn test_sine_peak_in_expected_bin() {
+        // Bin-centered frequency: bin 32 of a 1024-point FFT at 48 kHz.
+        let freq = 32.0 * 48000.0 / 1024.0;
+        let mut processor = SpectrumProcessor::new(1024, 1024);
+        processor.process(sine(freq, 48000.0, 1024), |_| {});
+
+        let spectrum = processor.magnitudes_db();
+        let peak = (0..spectrum.len())
+            .max_by(|&a, &b| spectrum[a].total_cmp(&spectrum[b]))
+            .unwrap();
+        assert_eq!(peak, 32);
+        // Hann window coherent gain is 0.5 (-6 dB).
+        assert!((spectrum[32] + 6.02).abs() < 0.1, "{}", spectrum[32]);
+        assert!(spectrum[200] < -60.0);
+    }
+
+    #[test]
+    fn test_overlapping_history_matches_contiguous_input() {
+        let signal = sine(440.0, 48000.0, 1024 + 300);
+        let mut streamed = SpectrumProcessor::new(1024, 1);
+        streamed.process(signal.iter().copied(), |_| {});
+
+        let mut direct = SpectrumProcessor::new(1024, 1024);
+        direct.process(signal[300..].iter().copied(), |_| {});
+
+        for (a, b) in streamed.magnitudes_db().iter().zip(direct.magnitudes_db()) {
+            assert!((a - b).abs() < 0.01);
+        }
+    }
+
+    #[test]
+    fn test_log_frequency_map_preserves_flat_spectrum() {
+        let map = LogFrequencyMap::new(1024, 128, 48000.0, 20.0, 20000.0);
+        let mut rows = vec![0.0; 128];
+        map.apply(&vec![-30.0; 1024], &mut rows);
+
+        assert_eq!(map.num_rows(), 128);
+        assert!(rows.iter().all(|&r| (r + 30.0).abs() < 1e-3));
+    }
+
+    #[test]
+    fn test_log_frequency_map_places_tone() {
+        let map = LogFrequencyMap::new(1024, 100, 48000.0, 100.0, 10000.0);
+        // 1 kHz is bin ~42.7; rows are log-spaced between 100 Hz and 10 kHz, so
+        // 1 kHz sits in the middle row.
+        let mut spectrum = vec![-120.0; 1024];
+        spectrum[42] = 0.0;
+        spectrum[43] = 0.0;
+        let mut rows = vec![0.0; 100];
+        map.apply(&spectrum, &mut rows);
+
+        let peak = (0..rows.len()).max_by(|&a, &b| rows[a].total_cmp(&rows[b])).unwrap();
+        assert!((48..=51).contains(&peak), "{peak}");
+        assert!(rows[10] < -100.0 && rows[90] < -100.0);
+    }
+
+    #[test]
+    fn test_analysis_thread_publishes_latest_spectrum() {
+        let (mut producer, consumer) = audio_bridge(16);
+        let (thread, mut output) = SpectrumAnalysisThread::spawn(consumer, 512, 512);
+
+        let samples = sine(3000.0, 48000.0, 512);
+        for chunk in samples.chunks(256) {
+            producer.try_write(chunk, 48000, 1);
+        }
+
+        let deadline = std::time::Instant::now() + Duration::from_secs(2);
+        while !output.has_update() && std::time::Instant::now() < deadline {
+            thread::sleep(Duration::from_millis(1));
+        }
+
+        let spectrum = output.read();
+        assert_eq!(spectrum.len(), 256);
+        assert!(spectrum[32] > -10.0);
+
+        let _consumer = thread.stop();
+    }
+}
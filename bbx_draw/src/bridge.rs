@@ -1,68 +1,357 @@
 //! Audio and MIDI data bridges for thread-safe communication.
 //!
-//! Uses `bbx_core::SpscRingBuffer` for lock-free, real-time-safe communication
-//! between audio/MIDI threads and the visualization thread.
+//! The audio bridge is a lock-free ring of interleaved samples with a single
+//! writer and any number of readers (up to [`MAX_AUDIO_READERS`]). Writing a
+//! block is one copy into the ring; readers borrow the samples in place
+//! through a [`SampleView`] and reduce them however they need. The MIDI bridge
+//! uses `bbx_core::SpscRingBuffer`.
+
+use std::{
+    cell::UnsafeCell,
+    ptr,
+    sync::{
+        Arc,
+        atomic::{AtomicU32, AtomicU64, AtomicUsize, Ordering},
+    },
+};
 
 use bbx_core::spsc::{Consumer, Producer, SpscRingBuffer};
-use bbx_dsp::Frame;
+use bbx_dsp::{Frame, MAX_FRAME_SAMPLES};
 use bbx_midi::message::MidiMessage;
 
+/// Maximum number of consumers that can read from one audio bridge.
+pub const MAX_AUDIO_READERS: usize = 8;
+
+/// Cursor value for a reader slot that isn't in use.
+const INACTIVE: u64 = u64::MAX;
+
+/// Ring storage shared by the audio bridge producer and its consumers.
+///
+/// Positions are monotonic sample counts; the ring index is the position
+/// modulo the capacity. The writer only writes ahead of the slowest reader,
+/// so the region between a reader's cursor and the write position is never
+/// modified while it's being read.
+struct SampleRing {
+    buffer: Box<[UnsafeCell<f32>]>,
+    write: AtomicU64,
+    cursors: [AtomicU64; MAX_AUDIO_READERS],
+    sample_rate: AtomicU32,
+    num_channels: AtomicUsize,
+}
+
+// SAFETY: Samples are only written in the region no reader can observe;
+// ownership of that region moves through the `write` and `cursors` atomics.
+unsafe impl Send for SampleRing {}
+unsafe impl Sync for SampleRing {}
+
+impl SampleRing {
+    #[inline]
+    fn capacity(&self) -> usize {
+        self.buffer.len()
+    }
+
+    #[inline]
+    fn base(&self) -> *mut f32 {
+        UnsafeCell::raw_get(self.buffer.as_ptr())
+    }
+
+    /// Position of the slowest active reader.
+    #[inline]
+    fn oldest_cursor(&self) -> Option<u64> {
+        self.cursors
+            .iter()
+            .map(|cursor| cursor.load(Ordering::Acquire))
+            .filter(|&cursor| cursor != INACTIVE)
+            .min()
+    }
+}
+
 /// Producer side of the audio bridge (used in audio thread).
 pub struct AudioBridgeProducer {
-    producer: Producer<Frame>,
+    ring: Arc<SampleRing>,
+    write: u64,
 }
 
 impl AudioBridgeProducer {
+    /// Try to write a block of interleaved samples.
+    ///
+    /// The block is copied into the ring in one piece (two at the wrap point).
+    /// Returns `false` without writing anything if the slowest reader hasn't
+    /// made room for the whole block. Dropping blocks is acceptable for
+    /// visualization purposes.
+    pub fn try_write(&mut self, samples: &[f32], sample_rate: u32, num_channels: usize) -> bool {
+        let ring = &*self.ring;
+        let capacity = ring.capacity();
+        let used = ring.oldest_cursor().map_or(0, |cursor| (self.write - cursor) as usize);
+        if samples.len() > capacity - used {
+            return false;
+        }
+
+        ring.sample_rate.store(sample_rate, Ordering::Relaxed);
+        ring.num_channels.store(num_channels, Ordering::Relaxed);
+
+        let start = (self.write % capacity as u64) as usize;
+        let first = samples.len().min(capacity - start);
+        // SAFETY: The destination lies between the write position and the
+        // slowest reader's cursor plus the capacity, which no reader can see.
+        unsafe {
+            ptr::copy_nonoverlapping(samples.as_ptr(), ring.base().add(start), first);
+            ptr::copy_nonoverlapping(samples.as_ptr().add(first), ring.base(), samples.len() - first);
+        }
+
+        self.write += samples.len() as u64;
+        ring.write.store(self.write, Ordering::Release);
+        true
+    }
+
     /// Try to send a frame to the visualization thread.
     ///
-    /// Returns `true` if the frame was sent, `false` if the buffer was full.
-    /// Dropping frames is acceptable for visualization purposes.
+    /// Equivalent to [`try_write`](Self::try_write) with the frame's samples.
     pub fn try_send(&mut self, frame: Frame) -> bool {
-        self.producer.try_push(frame).is_ok()
+        self.try_write(frame.samples.as_slice(), frame.sample_rate, frame.num_channels)
     }
 
     /// Check if the buffer is full.
     pub fn is_full(&self) -> bool {
-        self.producer.is_full()
+        self.ring
+            .oldest_cursor()
+            .is_some_and(|cursor| (self.write - cursor) as usize == self.ring.capacity())
     }
 }
 
 /// Consumer side of the audio bridge (used in visualization or audio thread).
 ///
+/// Each consumer has its own read position, so several visualizers can read
+/// the same audio; use [`try_clone`](Self::try_clone) to add one. The
+/// producer waits for the slowest consumer, so every consumer must keep
+/// reading (or be dropped) for the stream to flow.
+///
 /// All methods are realtime-safe and do not allocate.
 pub struct AudioBridgeConsumer {
-    consumer: Consumer<Frame>,
+    ring: Arc<SampleRing>,
+    slot: usize,
+    position: u64,
 }
 
 impl AudioBridgeConsumer {
-    /// Pop a single frame from the buffer (realtime-safe).
+    /// Create another consumer starting at this consumer's read position.
     ///
-    /// Returns `Some(Frame)` if available, `None` if empty.
+    /// Returns `None` if [`MAX_AUDIO_READERS`] consumers already exist.
+    pub fn try_clone(&self) -> Option<Self> {
+        self.ring.cursors.iter().enumerate().find_map(|(slot, cursor)| {
+            cursor
+                .compare_exchange(INACTIVE, self.position, Ordering::AcqRel, Ordering::Relaxed)
+                .ok()
+                .map(|_| Self {
+                    ring: Arc::clone(&self.ring),
+                    slot,
+                    position: self.position,
+                })
+        })
+    }
+
+    /// Borrow all unread samples without copying them.
     #[inline]
-    pub fn try_pop(&mut self) -> Option<Frame> {
-        self.consumer.try_pop()
+    pub fn view(&self) -> SampleView<'_> {
+        let ring = &*self.ring;
+        let capacity = ring.capacity();
+        let available = (ring.write.load(Ordering::Acquire) - self.position) as usize;
+        let start = (self.position % capacity as u64) as usize;
+        let first = available.min(capacity - start);
+
+        // SAFETY: Samples between this reader's cursor and the write position
+        // were published by the producer and won't be overwritten until the
+        // cursor moves past them, which requires `&mut self`.
+        let (first, second) = unsafe {
+            (
+                std::slice::from_raw_parts(ring.base().add(start), first),
+                std::slice::from_raw_parts(ring.base(), available - first),
+            )
+        };
+
+        SampleView {
+            first,
+            second,
+            sample_rate: ring.sample_rate.load(Ordering::Relaxed),
+            num_channels: ring.num_channels.load(Ordering::Relaxed),
+        }
+    }
+
+    /// Mark `samples` samples as read, making room for the producer.
+    #[inline]
+    pub fn advance(&mut self, samples: usize) {
+        let available = self.ring.write.load(Ordering::Acquire) - self.position;
+        self.position += (samples as u64).min(available);
+        self.ring.cursors[self.slot].store(self.position, Ordering::Release);
+    }
+
+    /// Pass all unread samples to `f`, then mark them as read.
+    #[inline]
+    pub fn read<R>(&mut self, f: impl FnOnce(&SampleView<'_>) -> R) -> R {
+        let view = self.view();
+        let len = view.len();
+        let result = f(&view);
+        self.advance(len);
+        result
     }
 
-    /// Check if there are frames available.
+    /// Check if there are samples available.
     #[inline]
     pub fn is_empty(&self) -> bool {
-        self.consumer.is_empty()
+        self.len() == 0
     }
 
-    /// Returns the number of frames currently available.
+    /// Returns the number of unread samples.
     #[inline]
     pub fn len(&self) -> usize {
-        self.consumer.len()
+        (self.ring.write.load(Ordering::Acquire) - self.position) as usize
+    }
+}
+
+impl Drop for AudioBridgeConsumer {
+    fn drop(&mut self) {
+        self.ring.cursors[self.slot].store(INACTIVE, Ordering::Release);
+    }
+}
+
+/// Borrowed, interleaved samples from an [`AudioBridgeConsumer`].
+///
+/// The samples may wrap around the end of the ring, so they're exposed as
+/// two slices.
+pub struct SampleView<'a> {
+    first: &'a [f32],
+    second: &'a [f32],
+    sample_rate: u32,
+    num_channels: usize,
+}
+
+impl<'a> SampleView<'a> {
+    /// The samples as two contiguous runs, oldest first.
+    #[inline]
+    pub fn as_slices(&self) -> (&'a [f32], &'a [f32]) {
+        (self.first, self.second)
+    }
+
+    /// Total number of interleaved samples.
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.first.len() + self.second.len()
+    }
+
+    /// Returns `true` if there are no samples.
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Sample rate of the most recent write, in Hz.
+    #[inline]
+    pub fn sample_rate(&self) -> u32 {
+        self.sample_rate
+    }
+
+    /// Channel count of the most recent write.
+    #[inline]
+    pub fn num_channels(&self) -> usize {
+        self.num_channels
+    }
+
+    /// Number of complete multichannel frames.
+    #[inline]
+    pub fn num_frames(&self) -> usize {
+        if self.num_channels == 0 {
+            0
+        } else {
+            self.len() / self.num_channels
+        }
+    }
+
+    /// Returns an iterator over samples for a specific channel (de-interleaved).
+    ///
+    /// Returns `None` if the channel index is out of bounds.
+    pub fn channel(&self, channel: usize) -> Option<impl Iterator<Item = f32> + 'a> {
+        if channel >= self.num_channels {
+            return None;
+        }
+        Some(
+            self.first
+                .iter()
+                .chain(self.second)
+                .skip(channel)
+                .step_by(self.num_channels)
+                .copied()
+                .take(self.num_frames()),
+        )
+    }
+
+    /// Write every `factor`th sample of `channel` into `output`.
+    ///
+    /// Returns the number of samples written.
+    pub fn decimate(&self, channel: usize, factor: usize, output: &mut [f32]) -> usize {
+        let Some(samples) = self.channel(channel) else {
+            return 0;
+        };
+        let mut written = 0;
+        for (out, sample) in output.iter_mut().zip(samples.step_by(factor.max(1))) {
+            *out = sample;
+            written += 1;
+        }
+        written
+    }
+
+    /// Reduce `channel` to `(min, max)` pairs over `frames_per_column` frames.
+    ///
+    /// This is the usual reduction for drawing one waveform column per pixel.
+    /// A trailing partial column is included. Returns the number of columns
+    /// written.
+    pub fn min_max(&self, channel: usize, frames_per_column: usize, output: &mut [(f32, f32)]) -> usize {
+        let Some(mut samples) = self.channel(channel) else {
+            return 0;
+        };
+        let frames_per_column = frames_per_column.max(1);
+        let mut written = 0;
+        for out in output.iter_mut() {
+            let Some(first) = samples.next() else {
+                break;
+            };
+            *out = samples
+                .by_ref()
+                .take(frames_per_column - 1)
+                .fold((first, first), |(lo, hi), s| (lo.min(s), hi.max(s)));
+            written += 1;
+        }
+        written
     }
 }
 
 /// Create an audio bridge pair for thread-safe audio data transfer.
 ///
-/// The `capacity` determines how many audio frames can be buffered.
-/// A typical value is 4-16 frames.
+/// The `capacity` is measured in frames of [`MAX_FRAME_SAMPLES`] samples;
+/// a typical value is 4-16. Additional consumers can be created with
+/// [`AudioBridgeConsumer::try_clone`].
 pub fn audio_bridge(capacity: usize) -> (AudioBridgeProducer, AudioBridgeConsumer) {
-    let (producer, consumer) = SpscRingBuffer::new(capacity);
-    (AudioBridgeProducer { producer }, AudioBridgeConsumer { consumer })
+    let buffer = (0..capacity.max(1) * MAX_FRAME_SAMPLES)
+        .map(|_| UnsafeCell::new(0.0))
+        .collect();
+    let ring = Arc::new(SampleRing {
+        buffer,
+        write: AtomicU64::new(0),
+        cursors: std::array::from_fn(|slot| AtomicU64::new(if slot == 0 { 0 } else { INACTIVE })),
+        sample_rate: AtomicU32::new(0),
+        num_channels: AtomicUsize::new(0),
+    });
+
+    (
+        AudioBridgeProducer {
+            ring: Arc::clone(&ring),
+            write: 0,
+        },
+        AudioBridgeConsumer {
+            ring,
+            slot: 0,
+            position: 0,
+        },
+    )
 }
 
 /// Producer side of the MIDI bridge (used in MIDI input thread).
@@ -118,6 +407,13 @@ pub fn midi_bridge(capacity: usize) -> (MidiBridgeProducer, MidiBridgeConsumer)
 mod tests {
     use super::*;
 
+    fn drain(consumer: &mut AudioBridgeConsumer) -> Vec<f32> {
+        consumer.read(|view| {
+            let (first, second) = view.as_slices();
+            [first, second].concat()
+        })
+    }
+
     #[test]
     fn test_audio_bridge_send_receive() {
         let (mut producer, mut consumer) = audio_bridge(4);
@@ -126,48 +422,153 @@ mod tests {
         let frame = Frame::new(&samples, 44100, 2);
         assert!(producer.try_send(frame));
 
-        let frame = consumer.try_pop().expect("should have frame");
-        assert_eq!(frame.samples.len(), 4);
-        assert_eq!(frame.sample_rate, 44100);
-        assert!(consumer.try_pop().is_none());
+        let view = consumer.view();
+        assert_eq!(view.len(), 4);
+        assert_eq!(view.num_frames(), 2);
+        assert_eq!(view.sample_rate(), 44100);
+        assert_eq!(drain(&mut consumer), samples);
+        assert!(consumer.is_empty());
     }
 
     #[test]
     fn test_audio_bridge_overflow() {
-        let (mut producer, _consumer) = audio_bridge(2);
+        let (mut producer, mut consumer) = audio_bridge(2);
+
+        let block = [0.0f32; MAX_FRAME_SAMPLES];
+        assert!(producer.try_write(&block, 44100, 1));
+        assert!(producer.try_write(&block, 44100, 1));
+        assert!(producer.is_full());
+        assert!(!producer.try_write(&[0.0], 44100, 1));
 
-        let samples = [0.0f32];
-        let frame = Frame::new(&samples, 44100, 1);
-        assert!(producer.try_send(frame.clone()));
-        assert!(producer.try_send(frame.clone()));
-        assert!(!producer.try_send(frame));
+        consumer.advance(1);
+        assert!(producer.try_write(&[0.0], 44100, 1));
     }
 
     #[test]
-    fn test_try_pop_empty() {
-        let (_producer, mut consumer) = audio_bridge(4);
-        assert!(consumer.try_pop().is_none());
+    fn test_view_empty() {
+        let (_producer, consumer) = audio_bridge(4);
+        assert!(consumer.view().is_empty());
         assert!(consumer.is_empty());
         assert_eq!(consumer.len(), 0);
     }
 
     #[test]
-    fn test_try_pop_multiple() {
+    fn test_writes_are_contiguous() {
         let (mut producer, mut consumer) = audio_bridge(4);
 
-        let samples1 = [1.0f32, 2.0];
-        let samples2 = [3.0f32, 4.0];
-        producer.try_send(Frame::new(&samples1, 44100, 1));
-        producer.try_send(Frame::new(&samples2, 44100, 1));
+        producer.try_write(&[1.0, 2.0], 44100, 1);
+        producer.try_write(&[3.0, 4.0], 44100, 1);
+
+        assert_eq!(consumer.len(), 4);
+        assert_eq!(drain(&mut consumer), [1.0, 2.0, 3.0, 4.0]);
+    }
+
+    #[test]
+    fn test_view_wraps_around_ring() {
+        let (mut producer, mut consumer) = audio_bridge(1);
+        let block: Vec<f32> = (0..MAX_FRAME_SAMPLES - 2).map(|i| i as f32).collect();
+        producer.try_write(&block, 44100, 1);
+        consumer.advance(block.len());
+
+        producer.try_write(&[1.0, 2.0, 3.0, 4.0], 44100, 1);
+        let view = consumer.view();
+        let (first, second) = view.as_slices();
+        assert_eq!(first, [1.0, 2.0]);
+        assert_eq!(second, [3.0, 4.0]);
+        assert_eq!(view.channel(0).unwrap().collect::<Vec<_>>(), [1.0, 2.0, 3.0, 4.0]);
+    }
+
+    #[test]
+    fn test_channel_deinterleaves() {
+        let (mut producer, consumer) = audio_bridge(1);
+        producer.try_write(&[1.0, -1.0, 2.0, -2.0, 3.0], 48000, 2);
+
+        let view = consumer.view();
+        assert_eq!(view.channel(0).unwrap().collect::<Vec<_>>(), [1.0, 2.0]);
+        assert_eq!(view.channel(1).unwrap().collect::<Vec<_>>(), [-1.0, -2.0]);
+        assert!(view.channel(2).is_none());
+    }
 
-        assert_eq!(consumer.len(), 2);
+    #[test]
+    fn test_decimate_and_min_max() {
+        let (mut producer, consumer) = audio_bridge(1);
+        let samples: Vec<f32> = (0..10)
+            .map(|i| if i % 2 == 0 { i as f32 } else { -(i as f32) })
+            .collect();
+        producer.try_write(&samples, 48000, 1);
+        let view = consumer.view();
 
-        let f1 = consumer.try_pop().unwrap();
-        let f2 = consumer.try_pop().unwrap();
-        assert!(consumer.try_pop().is_none());
+        let mut decimated = [0.0; 8];
+        assert_eq!(view.decimate(0, 4, &mut decimated), 3);
+        assert_eq!(&decimated[..3], [0.0, 4.0, 8.0]);
+
+        let mut columns = [(0.0, 0.0); 8];
+        assert_eq!(view.min_max(0, 4, &mut columns), 3);
+        assert_eq!(&columns[..3], [(-3.0, 2.0), (-7.0, 6.0), (-9.0, 8.0)]);
+    }
+
+    #[test]
+    fn test_multiple_readers_see_same_audio() {
+        let (mut producer, mut a) = audio_bridge(1);
+        let mut b = a.try_clone().unwrap();
+
+        producer.try_write(&[1.0, 2.0], 44100, 1);
+        assert_eq!(drain(&mut a), [1.0, 2.0]);
+        producer.try_write(&[3.0], 44100, 1);
+
+        assert_eq!(drain(&mut a), [3.0]);
+        assert_eq!(drain(&mut b), [1.0, 2.0, 3.0]);
+    }
+
+    #[test]
+    fn test_slowest_reader_limits_producer() {
+        let (mut producer, mut fast) = audio_bridge(1);
+        let slow = fast.try_clone().unwrap();
+        let block = [0.0f32; MAX_FRAME_SAMPLES];
+
+        assert!(producer.try_write(&block, 44100, 1));
+        fast.advance(MAX_FRAME_SAMPLES);
+        assert!(!producer.try_write(&[0.0], 44100, 1));
+
+        drop(slow);
+        assert!(producer.try_write(&[0.0], 44100, 1));
+    }
+
+    #[test]
+    fn test_reader_limit() {
+        let (_producer, consumer) = audio_bridge(1);
+        let clones: Vec<_> = (1..MAX_AUDIO_READERS).map(|_| consumer.try_clone().unwrap()).collect();
+        assert!(consumer.try_clone().is_none());
+
+        drop(clones);
+        assert!(consumer.try_clone().is_some());
+    }
+
+    #[test]
+    fn test_concurrent_stream_is_continuous() {
+        let (mut producer, mut consumer) = audio_bridge(2);
+
+        let writer = std::thread::spawn(move || {
+            let mut next = 0u32;
+            while next < 100_000 {
+                let block: Vec<f32> = (next..next + 100).map(|i| i as f32).collect();
+                if producer.try_write(&block, 48000, 1) {
+                    next += 100;
+                }
+            }
+        });
+
+        let mut expected = 0u32;
+        while expected < 100_000 {
+            consumer.read(|view| {
+                for sample in view.channel(0).into_iter().flatten() {
+                    assert_eq!(sample, expected as f32);
+                    expected += 1;
+                }
+            });
+        }
 
-        assert_eq!(f1.samples.as_slice(), &[1.0, 2.0]);
-        assert_eq!(f2.samples.as_slice(), &[3.0, 4.0]);
+        writer.join().unwrap();
     }
 
     #[test]
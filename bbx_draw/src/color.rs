@@ -72,6 +72,11 @@ impl Palette {
     pub fn midi_note_off() -> Srgb<u8> {
         Srgb::new(66, 66, 66)
     }
+
+    /// Clip indicator color (red).
+    pub fn clip() -> Srgb<u8> {
+        Srgb::new(244, 67, 54)
+    }
 }
 
 /// Convert an Srgb<u8> color to normalized Rgb<f32> for nannou.
@@ -2,7 +2,10 @@
 
 use nannou::color::Rgb;
 
-use crate::color::{Palette, to_rgb};
+use crate::{
+    color::{Palette, to_rgb},
+    waterfall::Colormap,
+};
 
 /// Configuration for the graph topology visualizer.
 #[derive(Clone)]
@@ -41,6 +44,16 @@ pub struct GraphTopologyConfig {
     pub dash_length: f32,
     /// Gap length between dashes for modulation connections.
     pub dash_gap: f32,
+    /// Colormap for blocks when a load monitor is attached.
+    pub load_colormap: Colormap,
+    /// Share of the callback budget mapped to the top of the load colormap.
+    pub load_full_scale: f32,
+    /// Whether to print each block's load under its name.
+    pub show_load_values: bool,
+    /// Color for metering tap labels on connections.
+    pub tap_text_color: Rgb,
+    /// Color for metering tap labels once the tapped signal has clipped.
+    pub tap_clip_color: Rgb,
 }
 
 impl Default for GraphTopologyConfig {
@@ -63,6 +76,11 @@ impl Default for GraphTopologyConfig {
             arrow_size: 8.0,
             dash_length: 8.0,
             dash_gap: 4.0,
+            load_colormap: Colormap::heat(),
+            load_full_scale: 0.25,
+            show_load_values: true,
+            tap_text_color: to_rgb(Palette::text()),
+            tap_clip_color: to_rgb(Palette::clip()),
         }
     }
 }
@@ -111,6 +129,11 @@ pub enum SpectrumDisplayMode {
 pub struct SpectrumConfig {
     /// FFT size (must be power of 2: 512, 1024, 2048, 4096).
     pub fft_size: usize,
+    /// Samples between successive FFTs.
+    ///
+    /// Sets the analysis rate independently of `fft_size`; a quarter of the
+    /// FFT size gives 75% overlap.
+    pub hop_size: usize,
     /// Color for spectrum bars/line.
     pub bar_color: Rgb,
     /// Color for peak hold indicators.
@@ -133,6 +156,7 @@ impl Default for SpectrumConfig {
     fn default() -> Self {
         Self {
             fft_size: 2048,
+            hop_size: 512,
             bar_color: to_rgb(Palette::spectrum()),
             peak_color: to_rgb(Palette::spectrum_peak()),
             min_db: -80.0,
@@ -145,6 +169,45 @@ impl Default for SpectrumConfig {
     }
 }
 
+/// Configuration for the spectrogram visualizer.
+#[derive(Clone)]
+pub struct SpectrogramConfig {
+    /// FFT size (must be power of 2: 512, 1024, 2048, 4096).
+    pub fft_size: usize,
+    /// Samples between successive columns.
+    pub hop_size: usize,
+    /// Number of columns of history kept and displayed.
+    pub history_columns: usize,
+    /// Number of log-spaced frequency rows.
+    pub num_rows: usize,
+    /// Lowest displayed frequency in Hz.
+    pub min_freq: f32,
+    /// Highest displayed frequency in Hz (clamped to Nyquist).
+    pub max_freq: f32,
+    /// Level mapped to the bottom of the colormap.
+    pub min_db: f32,
+    /// Level mapped to the top of the colormap.
+    pub max_db: f32,
+    /// Colormap lookup table.
+    pub colormap: Colormap,
+}
+
+impl Default for SpectrogramConfig {
+    fn default() -> Self {
+        Self {
+            fft_size: 2048,
+            hop_size: 512,
+            history_columns: 512,
+            num_rows: 256,
+            min_freq: 20.0,
+            max_freq: 20000.0,
+            min_db: -100.0,
+            max_db: 0.0,
+            colormap: Colormap::default(),
+        }
+    }
+}
+
 /// Configuration for the MIDI activity visualizer.
 #[derive(Clone)]
 pub struct MidiActivityConfig {
@@ -2,13 +2,14 @@
 //!
 //! `bbx_draw` provides visualizers that can be embedded in any nannou application,
 //! with lock-free communication between audio and visualization threads via
-//! `bbx_core::SpscRingBuffer`.
+//! the [`bridge`] module.
 //!
 //! # Visualizers
 //!
 //! - [`GraphTopologyVisualizer`](visualizers::GraphTopologyVisualizer) - DSP graph topology display
 //! - [`WaveformVisualizer`](visualizers::WaveformVisualizer) - Oscilloscope-style waveform
 //! - [`SpectrumAnalyzer`](visualizers::SpectrumAnalyzer) - FFT-based spectrum display
+//! - [`SpectrogramVisualizer`](visualizers::SpectrogramVisualizer) - Scrolling spectrogram (waterfall)
 //! - [`MidiActivityVisualizer`](visualizers::MidiActivityVisualizer) - MIDI note activity
 //!
 //! # Example
@@ -26,21 +27,27 @@
 //! let visualizer = GraphTopologyVisualizer::new(topology);
 //! ```
 
+pub mod analysis;
 pub mod bridge;
 pub mod color;
 pub mod config;
+pub mod pyramid;
 pub mod sketch;
 pub mod visualizers;
+pub mod waterfall;
 
 pub use bbx_dsp::{Frame, MAX_FRAME_SAMPLES};
 
 /// Type alias for `Frame` to avoid confusion with visual frames in nannou.
 pub type AudioFrame = Frame;
 pub use bridge::{
-    AudioBridgeConsumer, AudioBridgeProducer, MidiBridgeConsumer, MidiBridgeProducer, audio_bridge, midi_bridge,
+    AudioBridgeConsumer, AudioBridgeProducer, MidiBridgeConsumer, MidiBridgeProducer, SampleView, audio_bridge,
+    midi_bridge,
 };
 use nannou::geom::Rect;
-pub use visualizers::{GraphTopologyVisualizer, MidiActivityVisualizer, SpectrumAnalyzer, WaveformVisualizer};
+pub use visualizers::{
+    GraphTopologyVisualizer, MidiActivityVisualizer, SpectrogramVisualizer, SpectrumAnalyzer, WaveformVisualizer,
+};
 
 /// Core trait for all visualizers.
 ///
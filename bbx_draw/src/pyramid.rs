@@ -0,0 +1,382 @@
+//! Multi-resolution min/max/RMS waveform summaries.
+//!
+//! A [`WaveformPyramid`] keeps one summary per block of samples at several
+//! resolutions, each level [`LEVEL_FACTOR`] times coarser than the one below.
+//! Incoming samples update the finest level and ripple upward only when a
+//! block completes, so a block of audio costs O(samples + levels). Queries
+//! cover a range with the coarsest summaries that fit inside it, so drawing
+//! N pixel columns costs O(N) regardless of how much audio they span.
+
+use bbx_core::Sample;
+use bbx_dsp::reader::Reader;
+
+/// Default number of samples summarized by each finest-level bin.
+pub const DEFAULT_BASE_BLOCK: usize = 64;
+
+/// Number of bins merged into one bin of the next level.
+pub const LEVEL_FACTOR: usize = 4;
+
+/// Minimum, maximum and RMS of a run of samples.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct WaveformSummary {
+    /// Lowest sample value.
+    pub min: f32,
+    /// Highest sample value.
+    pub max: f32,
+    /// Mean of the squared samples.
+    pub mean_square: f32,
+    /// Number of samples summarized.
+    pub count: u32,
+}
+
+impl WaveformSummary {
+    /// A summary of no samples.
+    pub const EMPTY: Self = Self {
+        min: f32::INFINITY,
+        max: f32::NEG_INFINITY,
+        mean_square: 0.0,
+        count: 0,
+    };
+
+    /// Returns `true` if no samples were summarized.
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.count == 0
+    }
+
+    /// Root mean square of the summarized samples.
+    #[inline]
+    pub fn rms(&self) -> f32 {
+        self.mean_square.sqrt()
+    }
+
+    #[inline]
+    fn push(&mut self, sample: f32) {
+        self.min = self.min.min(sample);
+        self.max = self.max.max(sample);
+        self.count += 1;
+        self.mean_square += (sample * sample - self.mean_square) / self.count as f32;
+    }
+
+    #[inline]
+    fn merge(&mut self, other: &Self) {
+        if other.is_empty() {
+            return;
+        }
+        self.min = self.min.min(other.min);
+        self.max = self.max.max(other.max);
+        let count = self.count + other.count;
+        self.mean_square += (other.mean_square - self.mean_square) * (other.count as f32 / count as f32);
+        self.count = count;
+    }
+}
+
+impl Default for WaveformSummary {
+    fn default() -> Self {
+        Self::EMPTY
+    }
+}
+
+/// One resolution of the pyramid: a ring of completed bins plus the bin
+/// currently being filled.
+struct Level {
+    bins: Vec<WaveformSummary>,
+    bin_size: u64,
+    completed: u64,
+    pending: WaveformSummary,
+    pending_children: usize,
+}
+
+impl Level {
+    fn new(bin_size: u64, capacity: usize) -> Self {
+        Self {
+            bins: vec![WaveformSummary::EMPTY; capacity],
+            bin_size,
+            completed: 0,
+            pending: WaveformSummary::EMPTY,
+            pending_children: 0,
+        }
+    }
+
+    /// Completed bin `index`, if it's still in the ring.
+    #[inline]
+    fn bin(&self, index: u64) -> Option<&WaveformSummary> {
+        let capacity = self.bins.len() as u64;
+        (index < self.completed && index + capacity >= self.completed).then(|| &self.bins[(index % capacity) as usize])
+    }
+
+    #[inline]
+    fn complete(&mut self) -> WaveformSummary {
+        let capacity = self.bins.len() as u64;
+        let bin = self.pending;
+        self.bins[(self.completed % capacity) as usize] = bin;
+        self.completed += 1;
+        self.pending = WaveformSummary::EMPTY;
+        self.pending_children = 0;
+        bin
+    }
+}
+
+/// Incrementally maintained min/max/RMS mipmap of one audio channel.
+///
+/// Keeps the most recent `history` samples. Use
+/// [`from_reader`](Self::from_reader) to summarize a whole file up front.
+pub struct WaveformPyramid {
+    levels: Vec<Level>,
+    base_block: usize,
+    history: u64,
+    total: u64,
+}
+
+impl WaveformPyramid {
+    /// Create a pyramid covering the last `history` samples, with
+    /// `base_block` samples per finest-level bin.
+    pub fn new(history: usize, base_block: usize) -> Self {
+        let history = history.max(1) as u64;
+        let base_block = base_block.max(1);
+
+        let mut levels = Vec::new();
+        let mut bin_size = base_block as u64;
+        loop {
+            levels.push(Level::new(bin_size, history.div_ceil(bin_size) as usize + 1));
+            if bin_size >= history {
+                break;
+            }
+            bin_size *= LEVEL_FACTOR as u64;
+        }
+
+        Self {
+            levels,
+            base_block,
+            history,
+            total: 0,
+        }
+    }
+
+    /// Summarize one channel of a reader's audio.
+    ///
+    /// Reads through [`Reader::read_into`] a block at a time, so compressed
+    /// readers are summarized without decoding the whole channel.
+    pub fn from_reader<S: Sample, R: Reader<S> + ?Sized>(reader: &R, channel: usize, base_block: usize) -> Self {
+        let num_samples = reader.num_samples();
+        let mut pyramid = Self::new(num_samples, base_block);
+        if channel < reader.num_channels() {
+            let mut block = vec![S::ZERO; base_block.max(1) * LEVEL_FACTOR];
+            for start in (0..num_samples).step_by(block.len()) {
+                let len = block.len().min(num_samples - start);
+                reader.read_into(channel, start, &mut block[..len]);
+                pyramid.push(block[..len].iter().map(|&s| s.to_f64() as f32));
+            }
+        }
+        pyramid
+    }
+
+    /// Number of levels.
+    pub fn num_levels(&self) -> usize {
+        self.levels.len()
+    }
+
+    /// Samples per bin at `level`.
+    pub fn bin_size(&self, level: usize) -> usize {
+        self.levels[level].bin_size as usize
+    }
+
+    /// Total number of samples pushed.
+    pub fn total_samples(&self) -> u64 {
+        self.total
+    }
+
+    /// Append samples.
+    pub fn push(&mut self, samples: impl IntoIterator<Item = f32>) {
+        for sample in samples {
+            let base = &mut self.levels[0];
+            base.pending.push(sample);
+            self.total += 1;
+
+            if base.pending.count as usize == self.base_block {
+                self.complete_base();
+            }
+        }
+    }
+
+    fn complete_base(&mut self) {
+        let mut bin = self.levels[0].complete();
+        for level in self.levels.iter_mut().skip(1) {
+            level.pending.merge(&bin);
+            level.pending_children += 1;
+            if level.pending_children < LEVEL_FACTOR {
+                break;
+            }
+            bin = level.complete();
+        }
+    }
+
+    /// Summarize the samples in `start..end`.
+    ///
+    /// The range is widened to whole finest-level bins and clamped to the
+    /// retained history. Each step takes the coarsest bin that starts at the
+    /// current position and fits inside the range, so the cost is bounded by
+    /// the number of levels rather than the length of the range.
+    pub fn summarize(&self, start: u64, end: u64) -> WaveformSummary {
+        let base = self.base_block as u64;
+        let start = start.max(self.total.saturating_sub(self.history));
+        let end = end.min(self.total).div_ceil(base) * base;
+
+        let mut summary = WaveformSummary::EMPTY;
+        let mut position = start - start % base;
+        while position < end {
+            let bin = self.levels.iter().rev().find_map(|level| {
+                let size = level.bin_size;
+                if position % size != 0 || position + size > end {
+                    return None;
+                }
+                level.bin(position / size).map(|bin| (bin, size))
+            });
+
+            match bin {
+                Some((bin, size)) => {
+                    summary.merge(bin);
+                    position += size;
+                }
+                None => {
+                    // Only the partially filled finest bin is left.
+                    summary.merge(&self.levels[0].pending);
+                    break;
+                }
+            }
+        }
+
+        summary
+    }
+
+    /// Split `start..end` evenly into `output.len()` columns and summarize
+    /// each one.
+    ///
+    /// Returns the number of columns written, which is smaller than
+    /// `output.len()` when the range holds fewer samples than columns.
+    pub fn columns(&self, start: u64, end: u64, output: &mut [WaveformSummary]) -> usize {
+        let len = end.saturating_sub(start);
+        let columns = (output.len() as u64).min(len) as usize;
+        for (i, out) in output[..columns].iter_mut().enumerate() {
+            let column_start = start + len * i as u64 / columns as u64;
+            let column_end = start + len * (i as u64 + 1) / columns as u64;
+            *out = self.summarize(column_start, column_end);
+        }
+        columns
+    }
+
+    /// Summarize the most recent `span` samples into `output.len()` columns.
+    pub fn latest(&self, span: u64, output: &mut [WaveformSummary]) -> usize {
+        self.columns(self.total.saturating_sub(span), self.total, output)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn brute_force(samples: &[f32]) -> WaveformSummary {
+        let mut summary = WaveformSummary::EMPTY;
+        for &s in samples {
+            summary.push(s);
+        }
+        summary
+    }
+
+    fn signal(len: usize) -> Vec<f32> {
+        (0..len).map(|i| ((i * 7919) % 1000) as f32 / 500.0 - 1.0).collect()
+    }
+
+    struct TestReader(Vec<f32>);
+
+    impl Reader<f32> for TestReader {
+        fn sample_rate(&self) -> f64 {
+            48000.0
+        }
+
+        fn num_channels(&self) -> usize {
+            1
+        }
+
+        fn num_samples(&self) -> usize {
+            self.0.len()
+        }
+
+        fn read_channel(&self, _channel_index: usize) -> &[f32] {
+            &self.0
+        }
+    }
+
+    #[test]
+    fn test_levels_cover_history() {
+        let pyramid = WaveformPyramid::new(48000 * 60, 64);
+        let top = pyramid.num_levels() - 1;
+        assert!(pyramid.bin_size(top) >= 48000 * 60);
+        assert_eq!(pyramid.bin_size(1), 64 * LEVEL_FACTOR);
+    }
+
+    #[test]
+    fn test_summarize_matches_brute_force() {
+        let samples = signal(10_000);
+        let mut pyramid = WaveformPyramid::new(samples.len(), 16);
+        pyramid.push(samples.iter().copied());
+
+        for &(start, end) in &[(0, 10_000), (0, 16), (32, 4096), (1024, 9984), (9984, 10_000)] {
+            let expected = brute_force(&samples[start..end]);
+            let actual = pyramid.summarize(start as u64, end as u64);
+            assert_eq!(actual.min, expected.min);
+            assert_eq!(actual.max, expected.max);
+            assert_eq!(actual.count, expected.count);
+            assert!((actual.mean_square - expected.mean_square).abs() < 1e-4);
+        }
+    }
+
+    #[test]
+    fn test_includes_partial_block() {
+        let mut pyramid = WaveformPyramid::new(1000, 64);
+        pyramid.push([0.1, 0.9, -0.3]);
+
+        let summary = pyramid.summarize(0, 3);
+        assert_eq!(summary.count, 3);
+        assert_eq!(summary.max, 0.9);
+        assert_eq!(summary.min, -0.3);
+    }
+
+    #[test]
+    fn test_history_is_bounded() {
+        let mut pyramid = WaveformPyramid::new(1024, 16);
+        pyramid.push(std::iter::repeat_n(1.0, 4096));
+        pyramid.push(std::iter::repeat_n(0.5, 1024));
+
+        let summary = pyramid.summarize(0, pyramid.total_samples());
+        assert_eq!(summary.max, 0.5);
+        assert_eq!(summary.count, 1024);
+    }
+
+    #[test]
+    fn test_columns() {
+        let mut samples = vec![0.0; 4096];
+        samples[1000] = 1.0;
+        samples[3000] = -1.0;
+        let mut pyramid = WaveformPyramid::new(samples.len(), 16);
+        pyramid.push(samples);
+
+        let mut columns = [WaveformSummary::EMPTY; 4];
+        assert_eq!(pyramid.latest(4096, &mut columns), 4);
+        assert_eq!(columns[0].max, 1.0);
+        assert_eq!(columns[1].max, 0.0);
+        assert_eq!(columns[2].min, -1.0);
+        assert!(columns.iter().all(|c| c.count == 1024));
+    }
+
+    #[test]
+    fn test_from_reader() {
+        let reader = TestReader(signal(5000));
+        let pyramid = WaveformPyramid::from_reader(&reader, 0, 64);
+
+        assert_eq!(pyramid.total_samples(), 5000);
+        let expected = brute_force(&reader.0);
+        let actual = pyramid.summarize(0, 5000);
+        assert_eq!((actual.min, actual.max), (expected.min, expected.max));
+    }
+}
@@ -2,10 +2,14 @@
 
 use bbx_dsp::{
     BlockCategory,
+    block::BlockId,
     graph::{BlockSnapshot, ConnectionSnapshot, GraphTopologySnapshot, ModulationConnectionSnapshot},
+    profile::BlockLoad,
+    tap::MeterTaps,
 };
 use nannou::{
     Draw,
+    color::Rgb,
     geom::{Point2, Rect, Vec2},
 };
 
@@ -14,12 +18,17 @@ use crate::{Visualizer, config::GraphTopologyConfig};
 /// Visualizes a DSP graph's topology as connected blocks.
 ///
 /// Blocks are arranged left-to-right based on their topological depth
-/// (distance from source blocks).
+/// (distance from source blocks). With a [`BlockLoad`] attached, blocks are
+/// colored by their share of the callback budget instead of their category.
 pub struct GraphTopologyVisualizer {
     topology: GraphTopologySnapshot,
     config: GraphTopologyConfig,
     block_positions: Vec<Point2>,
     depths: Vec<usize>,
+    load: Option<BlockLoad>,
+    block_loads: Vec<f32>,
+    callback_load: f32,
+    taps: Option<MeterTaps>,
 }
 
 impl GraphTopologyVisualizer {
@@ -30,6 +39,10 @@ impl GraphTopologyVisualizer {
             config: GraphTopologyConfig::default(),
             block_positions: Vec::new(),
             depths: Vec::new(),
+            load: None,
+            block_loads: Vec::new(),
+            callback_load: 0.0,
+            taps: None,
         };
         visualizer.compute_layout();
         visualizer
@@ -42,6 +55,10 @@ impl GraphTopologyVisualizer {
             config,
             block_positions: Vec::new(),
             depths: Vec::new(),
+            load: None,
+            block_loads: Vec::new(),
+            callback_load: 0.0,
+            taps: None,
         };
         visualizer.compute_layout();
         visualizer
@@ -58,6 +75,46 @@ impl GraphTopologyVisualizer {
         self.compute_layout();
     }
 
+    /// Color blocks by the live loads from
+    /// [`Graph::enable_profiling`](bbx_dsp::graph::Graph::enable_profiling).
+    ///
+    /// Loads are matched to blocks by ID, so the topology should come from
+    /// the same graph's builder.
+    pub fn set_block_load(&mut self, load: BlockLoad) {
+        self.block_loads = vec![0.0; load.num_blocks()];
+        self.callback_load = 0.0;
+        self.load = Some(load);
+    }
+
+    /// Return to coloring blocks by category.
+    pub fn clear_block_load(&mut self) {
+        self.load = None;
+        self.block_loads.clear();
+        self.callback_load = 0.0;
+    }
+
+    /// Last loaded share of the callback budget for a block, if a load
+    /// monitor is attached.
+    pub fn block_load(&self, block_id: usize) -> Option<f32> {
+        self.load
+            .as_ref()
+            .map(|_| self.block_loads.get(block_id).copied().unwrap_or(0.0))
+    }
+
+    /// Label connections with readings from
+    /// [`Graph::enable_taps`](bbx_dsp::graph::Graph::enable_taps).
+    ///
+    /// Only connections whose source output is tapped are labelled; switch
+    /// taps on and off through the same handle at any time.
+    pub fn set_meter_taps(&mut self, taps: MeterTaps) {
+        self.taps = Some(taps);
+    }
+
+    /// Stop labelling connections with tap readings.
+    pub fn clear_meter_taps(&mut self) {
+        self.taps = None;
+    }
+
     fn compute_layout(&mut self) {
         let num_blocks = self.topology.blocks.len();
         if num_blocks == 0 {
@@ -116,6 +173,14 @@ impl GraphTopologyVisualizer {
         }
     }
 
+    fn color_for_load(&self, load: f32) -> Rgb {
+        let [r, g, b, _] = self
+            .config
+            .load_colormap
+            .lookup(load / self.config.load_full_scale.max(f32::EPSILON));
+        Rgb::new(r as f32 / 255.0, g as f32 / 255.0, b as f32 / 255.0)
+    }
+
     fn draw_block(&self, draw: &Draw, block: &BlockSnapshot, position: Point2, bounds: Rect) {
         let offset_x = bounds.left() + bounds.w() / 2.0;
         let offset_y = bounds.bottom() + bounds.h() / 2.0;
@@ -127,15 +192,43 @@ impl GraphTopologyVisualizer {
             return;
         }
 
-        let color = self.color_for_category(block.category);
+        let load = self.block_load(block.id);
+        let color = match load {
+            Some(load) => self.color_for_load(load),
+            None => self.color_for_category(block.category),
+        };
 
         draw.rect()
             .xy(adjusted_pos)
             .w_h(self.config.block_width, self.config.block_height)
             .color(color);
 
-        draw.text(&block.name)
-            .xy(adjusted_pos)
+        match load {
+            Some(load) if self.config.show_load_values => {
+                let line_offset = Vec2::new(0.0, self.config.block_height * 0.18);
+                draw.text(&block.name)
+                    .xy(adjusted_pos + line_offset)
+                    .color(self.config.text_color)
+                    .font_size(12);
+                draw.text(&format!("{:.1}%", load * 100.0))
+                    .xy(adjusted_pos - line_offset)
+                    .color(self.config.text_color)
+                    .font_size(11);
+            }
+            _ => {
+                draw.text(&block.name)
+                    .xy(adjusted_pos)
+                    .color(self.config.text_color)
+                    .font_size(12);
+            }
+        }
+    }
+
+    fn draw_callback_load(&self, draw: &Draw, bounds: Rect) {
+        draw.text(&format!("callback {:.1}%", self.callback_load * 100.0))
+            .x_y(bounds.left() + 70.0, bounds.top() - 16.0)
+            .w(140.0)
+            .left_justify()
             .color(self.config.text_color)
             .font_size(12);
     }
@@ -174,6 +267,22 @@ impl GraphTopologyVisualizer {
                     self.config.audio_connection_color,
                 );
             }
+
+            let reading = self
+                .taps
+                .as_ref()
+                .and_then(|taps| taps.read(BlockId(conn.from_block), conn.from_output));
+            if let Some(reading) = reading {
+                let color = if reading.clips > 0 {
+                    self.config.tap_clip_color
+                } else {
+                    self.config.tap_text_color
+                };
+                draw.text(&format!("{:.1} / {:.1} dB", reading.peak_db(), reading.rms_db()))
+                    .xy(points[points.len() / 2] + Vec2::new(0.0, 10.0))
+                    .color(color)
+                    .font_size(10);
+            }
         }
     }
 
@@ -248,7 +357,12 @@ impl GraphTopologyVisualizer {
 }
 
 impl Visualizer for GraphTopologyVisualizer {
-    fn update(&mut self) {}
+    fn update(&mut self) {
+        if let Some(load) = &self.load {
+            load.read_into(&mut self.block_loads);
+            self.callback_load = load.callback_load();
+        }
+    }
 
     fn draw(&self, draw: &Draw, bounds: Rect) {
         for conn in &self.topology.connections {
@@ -264,6 +378,10 @@ impl Visualizer for GraphTopologyVisualizer {
                 self.draw_block(draw, block, pos, bounds);
             }
         }
+
+        if self.load.is_some() {
+            self.draw_callback_load(draw, bounds);
+        }
     }
 }
 
@@ -341,6 +459,8 @@ fn dashed_bezier_points(points: &[Point2], dash_length: f32, gap_length: f32) ->
 
 #[cfg(test)]
 mod tests {
+    use bbx_dsp::{blocks::OscillatorBlock, graph::GraphBuilder, waveform::Waveform};
+
     use super::*;
 
     #[test]
@@ -372,6 +492,28 @@ mod tests {
         assert_eq!(visualizer.depths[0], 0);
     }
 
+    #[test]
+    fn test_block_load_follows_profile() {
+        let mut builder = GraphBuilder::<f32>::new(44100.0, 64, 1);
+        builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+        let topology = builder.capture_topology();
+        let mut graph = builder.build();
+
+        let mut visualizer = GraphTopologyVisualizer::new(topology);
+        assert_eq!(visualizer.block_load(0), None);
+
+        visualizer.set_block_load(graph.enable_profiling(1));
+        let mut output = vec![0.0; 64];
+        graph.process_buffers(&mut [&mut output]);
+        visualizer.update();
+
+        assert!(visualizer.block_load(0).unwrap() > 0.0);
+        assert!(visualizer.callback_load >= visualizer.block_load(0).unwrap());
+
+        visualizer.clear_block_load();
+        assert_eq!(visualizer.block_load(0), None);
+    }
+
     #[test]
     fn test_depth_calculation() {
         let topology = GraphTopologySnapshot {
@@ -2,10 +2,12 @@
 
 mod graph_topology;
 mod midi_activity;
+mod spectrogram;
 mod spectrum;
 mod waveform;
 
 pub use graph_topology::GraphTopologyVisualizer;
 pub use midi_activity::MidiActivityVisualizer;
+pub use spectrogram::SpectrogramVisualizer;
 pub use spectrum::SpectrumAnalyzer;
 pub use waveform::WaveformVisualizer;
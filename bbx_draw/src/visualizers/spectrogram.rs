@@ -0,0 +1,257 @@
+//! Scrolling spectrogram (waterfall) visualizer.
+
+use bbx_core::spsc::{Consumer, SpscRingBuffer};
+use nannou::{
+    Draw,
+    geom::{Rect, pt2},
+    wgpu,
+    window::Window,
+};
+
+use crate::{
+    Visualizer,
+    analysis::{LogFrequencyMap, SpectrumAnalysisThread},
+    bridge::AudioBridgeConsumer,
+    config::SpectrogramConfig,
+    waterfall::WaterfallImage,
+};
+
+/// Columns that can be queued between the analysis thread and `update()`.
+const COLUMN_QUEUE_DEPTH: usize = 64;
+
+/// Scrolling time/frequency display.
+///
+/// The analysis thread computes a spectrum every `hop_size` samples, maps it
+/// onto log-spaced rows with a precomputed [`LogFrequencyMap`], and queues
+/// the rows. [`update`](Visualizer::update) colors each new column into a
+/// fixed-size [`WaterfallImage`], and [`upload`](Self::upload) copies only
+/// those columns into a GPU texture, so per-frame cost doesn't grow with the
+/// history length.
+///
+/// Call [`upload`](Self::upload) from the nannou `update` function after
+/// [`update`](Visualizer::update); nothing is drawn until the first upload.
+pub struct SpectrogramVisualizer {
+    analysis: Option<SpectrumAnalysisThread>,
+    columns: Consumer<f32>,
+    config: SpectrogramConfig,
+    image: WaterfallImage,
+    column: Vec<f32>,
+    texture: Option<wgpu::Texture>,
+}
+
+impl SpectrogramVisualizer {
+    /// Create a new spectrogram with default configuration.
+    pub fn new(consumer: AudioBridgeConsumer) -> Self {
+        Self::with_config(consumer, SpectrogramConfig::default())
+    }
+
+    /// Create a new spectrogram with custom configuration.
+    pub fn with_config(consumer: AudioBridgeConsumer, config: SpectrogramConfig) -> Self {
+        let (analysis, columns) = spawn_analysis(consumer, &config);
+
+        Self {
+            analysis: Some(analysis),
+            columns,
+            image: new_image(&config),
+            column: vec![0.0; config.num_rows],
+            texture: None,
+            config,
+        }
+    }
+
+    /// Get the current configuration.
+    pub fn config(&self) -> &SpectrogramConfig {
+        &self.config
+    }
+
+    /// Update the configuration.
+    ///
+    /// Restarts the analysis thread and clears the history.
+    pub fn set_config(&mut self, config: SpectrogramConfig) {
+        if let Some(analysis) = self.analysis.take() {
+            let (analysis, columns) = spawn_analysis(analysis.stop(), &config);
+            self.analysis = Some(analysis);
+            self.columns = columns;
+        }
+        self.image = new_image(&config);
+        self.column = vec![0.0; config.num_rows];
+        self.texture = None;
+        self.config = config;
+    }
+
+    /// Copy columns added since the last upload into the window's GPU texture.
+    ///
+    /// Creates the texture on first use.
+    pub fn upload(&mut self, window: &Window) {
+        let image = &mut self.image;
+        let num_rows = image.num_rows() as u32;
+        let texture = self.texture.get_or_insert_with(|| {
+            wgpu::TextureBuilder::new()
+                .size([image.num_columns() as u32, num_rows])
+                .format(wgpu::TextureFormat::Rgba8UnormSrgb)
+                .usage(wgpu::TextureUsages::COPY_DST | wgpu::TextureUsages::TEXTURE_BINDING)
+                .build(window.device())
+        });
+        for column in image.take_dirty() {
+            window.queue().write_texture(
+                wgpu::ImageCopyTexture {
+                    texture: &**texture,
+                    mip_level: 0,
+                    origin: wgpu::Origin3d {
+                        x: column as u32,
+                        y: 0,
+                        z: 0,
+                    },
+                    aspect: wgpu::TextureAspect::All,
+                },
+                image.column(column),
+                wgpu::ImageDataLayout {
+                    offset: 0,
+                    bytes_per_row: Some(4),
+                    rows_per_image: Some(num_rows),
+                },
+                wgpu::Extent3d {
+                    width: 1,
+                    height: num_rows,
+                    depth_or_array_layers: 1,
+                },
+            );
+        }
+    }
+}
+
+impl Visualizer for SpectrogramVisualizer {
+    fn update(&mut self) {
+        let num_rows = self.column.len();
+        while num_rows > 0 && self.columns.len() >= num_rows {
+            for value in self.column.iter_mut() {
+                *value = self.columns.try_pop().unwrap_or(self.config.min_db);
+            }
+            self.image.push_column(&self.column);
+        }
+    }
+
+    fn draw(&self, draw: &Draw, bounds: Rect) {
+        let Some(texture) = &self.texture else {
+            return;
+        };
+
+        // The newest column sits at the right edge; the ring is drawn as up
+        // to two texture slices.
+        let num_columns = self.image.num_columns() as f32;
+        let column_width = bounds.w() / num_columns;
+        let mut left = bounds.right() - self.image.filled() as f32 * column_width;
+
+        for segment in self.image.segments() {
+            if segment.is_empty() {
+                continue;
+            }
+            let width = segment.len() as f32 * column_width;
+            let area = Rect::from_corners(
+                pt2(segment.start as f32 / num_columns, 0.0),
+                pt2(segment.end as f32 / num_columns, 1.0),
+            );
+            draw.texture(texture)
+                .x_y(left + width / 2.0, bounds.y())
+                .w_h(width, bounds.h())
+                .area(area);
+            left += width;
+        }
+    }
+}
+
+fn new_image(config: &SpectrogramConfig) -> WaterfallImage {
+    WaterfallImage::new(
+        config.history_columns,
+        config.num_rows,
+        config.colormap.clone(),
+        config.min_db,
+        config.max_db,
+    )
+}
+
+/// Start an analysis thread that queues one column of log-frequency rows
+/// per hop.
+fn spawn_analysis(
+    consumer: AudioBridgeConsumer,
+    config: &SpectrogramConfig,
+) -> (SpectrumAnalysisThread, Consumer<f32>) {
+    let num_rows = config.num_rows;
+    let (mut producer, columns) = SpscRingBuffer::new(num_rows * COLUMN_QUEUE_DEPTH);
+    let (min_freq, max_freq) = (config.min_freq, config.max_freq);
+
+    let mut map: Option<(u32, LogFrequencyMap)> = None;
+    let mut rows = vec![0.0; num_rows];
+
+    let analysis = SpectrumAnalysisThread::spawn_with(
+        consumer,
+        config.fft_size,
+        config.hop_size,
+        move |spectrum, sample_rate| {
+            if sample_rate == 0 {
+                return;
+            }
+            // The map depends on the sample rate, which is only known once
+            // audio arrives; rebuild it off the draw thread if it changes.
+            if map.as_ref().is_none_or(|(rate, _)| *rate != sample_rate) {
+                let log_map = LogFrequencyMap::new(spectrum.len(), num_rows, sample_rate as f32, min_freq, max_freq);
+                map = Some((sample_rate, log_map));
+            }
+            let Some((_, log_map)) = &map else {
+                return;
+            };
+
+            // Drop the column rather than a partial one if the queue is full.
+            if producer.capacity() - producer.len() < num_rows {
+                return;
+            }
+            log_map.apply(spectrum, &mut rows);
+            for &row in &rows {
+                let _ = producer.try_push(row);
+            }
+        },
+    );
+
+    (analysis, columns)
+}
+
+#[cfg(test)]
+mod tests {
+    use std::{
+        thread,
+        time::{Duration, Instant},
+    };
+
+    use super::*;
+    use crate::bridge::audio_bridge;
+
+    #[test]
+    fn test_spectrogram_creation() {
+        let (_producer, consumer) = audio_bridge(4);
+        let visualizer = SpectrogramVisualizer::new(consumer);
+        assert_eq!(visualizer.image.num_columns(), 512);
+        assert_eq!(visualizer.image.num_rows(), 256);
+        assert!(visualizer.texture.is_none());
+    }
+
+    #[test]
+    fn test_update_appends_columns() {
+        let (mut producer, consumer) = audio_bridge(4);
+        let config = SpectrogramConfig {
+            fft_size: 256,
+            hop_size: 256,
+            num_rows: 32,
+            ..Default::default()
+        };
+        let mut visualizer = SpectrogramVisualizer::with_config(consumer, config);
+
+        producer.try_write(&[0.25; 1024], 48000, 1);
+        let deadline = Instant::now() + Duration::from_secs(2);
+        while visualizer.image.filled() < 4 && Instant::now() < deadline {
+            visualizer.update();
+            thread::sleep(Duration::from_millis(1));
+        }
+
+        assert_eq!(visualizer.image.filled(), 4);
+    }
+}
@@ -1,13 +1,14 @@
 //! FFT-based spectrum analyzer.
 
+use bbx_core::triple_buffer::Output;
 use nannou::{
     Draw,
     geom::{Point2, Rect},
 };
-use rustfft::{FftPlanner, num_complex::Complex};
 
 use crate::{
     Visualizer,
+    analysis::SpectrumAnalysisThread,
     bridge::AudioBridgeConsumer,
     config::{SpectrumConfig, SpectrumDisplayMode},
 };
@@ -16,17 +17,16 @@ use crate::{
 ///
 /// Displays frequency content of audio using bars, line, or filled display modes.
 /// Features temporal smoothing and optional peak hold.
+///
+/// The FFT runs on a dedicated analysis thread that computes a new spectrum
+/// every `hop_size` samples; [`update`](Visualizer::update) only picks up the
+/// latest finished spectrum, so the frame rate doesn't depend on the FFT size.
 pub struct SpectrumAnalyzer {
-    consumer: AudioBridgeConsumer,
+    analysis: Option<SpectrumAnalysisThread>,
+    spectrum: Output<Vec<f32>>,
     config: SpectrumConfig,
-    fft_planner: FftPlanner<f32>,
-    window: Vec<f32>,
-    sample_buffer: Vec<f32>,
-    fft_buffer: Vec<Complex<f32>>,
-    magnitudes: Vec<f32>,
     smoothed_magnitudes: Vec<f32>,
     peaks: Vec<f32>,
-    write_position: usize,
 }
 
 impl SpectrumAnalyzer {
@@ -38,20 +38,14 @@ impl SpectrumAnalyzer {
 
     /// Create a new spectrum analyzer with custom configuration.
     pub fn with_config(consumer: AudioBridgeConsumer, config: SpectrumConfig) -> Self {
-        let fft_size = config.fft_size;
-        let window = hann_window(fft_size);
-        let num_bins = fft_size / 2;
+        let (analysis, spectrum) = SpectrumAnalysisThread::spawn(consumer, config.fft_size, config.hop_size);
+        let num_bins = config.fft_size / 2;
 
         Self {
-            consumer,
-            fft_planner: FftPlanner::new(),
-            window,
-            sample_buffer: vec![0.0; fft_size],
-            fft_buffer: vec![Complex::new(0.0, 0.0); fft_size],
-            magnitudes: vec![0.0; num_bins],
+            analysis: Some(analysis),
+            spectrum,
             smoothed_magnitudes: vec![config.min_db; num_bins],
             peaks: vec![config.min_db; num_bins],
-            write_position: 0,
             config,
         }
     }
@@ -62,52 +56,27 @@ impl SpectrumAnalyzer {
     }
 
     /// Update the configuration (may reset internal state).
+    ///
+    /// Changing `fft_size` or `hop_size` restarts the analysis thread.
     pub fn set_config(&mut self, config: SpectrumConfig) {
-        if config.fft_size != self.config.fft_size {
-            let fft_size = config.fft_size;
-            let num_bins = fft_size / 2;
-            self.window = hann_window(fft_size);
-            self.sample_buffer = vec![0.0; fft_size];
-            self.fft_buffer = vec![Complex::new(0.0, 0.0); fft_size];
-            self.magnitudes = vec![0.0; num_bins];
+        if config.fft_size != self.config.fft_size || config.hop_size != self.config.hop_size {
+            if let Some(analysis) = self.analysis.take() {
+                let consumer = analysis.stop();
+                let (analysis, spectrum) = SpectrumAnalysisThread::spawn(consumer, config.fft_size, config.hop_size);
+                self.analysis = Some(analysis);
+                self.spectrum = spectrum;
+            }
+
+            let num_bins = config.fft_size / 2;
             self.smoothed_magnitudes = vec![config.min_db; num_bins];
             self.peaks = vec![config.min_db; num_bins];
-            self.write_position = 0;
         }
         self.config = config;
     }
 
-    fn compute_fft(&mut self) {
-        let fft_size = self.config.fft_size;
-        let fft = self.fft_planner.plan_fft_forward(fft_size);
-
-        for i in 0..fft_size {
-            let idx = (self.write_position + i) % fft_size;
-            self.fft_buffer[i] = Complex::new(self.sample_buffer[idx] * self.window[i], 0.0);
-        }
-
-        fft.process(&mut self.fft_buffer);
-
-        let num_bins = fft_size / 2;
-        let scale = 2.0 / fft_size as f32;
-
-        for i in 0..num_bins {
-            let magnitude = self.fft_buffer[i].norm() * scale;
-            self.magnitudes[i] = amplitude_to_db(magnitude);
-        }
-    }
-
-    fn apply_smoothing(&mut self) {
-        let smoothing = self.config.smoothing;
-        for i in 0..self.magnitudes.len() {
-            self.smoothed_magnitudes[i] =
-                smoothing * self.smoothed_magnitudes[i] + (1.0 - smoothing) * self.magnitudes[i];
-        }
-    }
-
     fn update_peaks(&mut self) {
         let decay = self.config.peak_decay;
-        for i in 0..self.magnitudes.len() {
+        for i in 0..self.smoothed_magnitudes.len() {
             if self.smoothed_magnitudes[i] > self.peaks[i] {
                 self.peaks[i] = self.smoothed_magnitudes[i];
             } else {
@@ -125,24 +94,18 @@ impl SpectrumAnalyzer {
 
 impl Visualizer for SpectrumAnalyzer {
     fn update(&mut self) {
-        let mut has_data = false;
+        if !self.spectrum.has_update() {
+            return;
+        }
 
-        while let Some(frame) = self.consumer.try_pop() {
-            if let Some(channel_iter) = frame.channel_samples(0) {
-                for sample in channel_iter {
-                    self.sample_buffer[self.write_position] = sample;
-                    self.write_position = (self.write_position + 1) % self.config.fft_size;
-                    has_data = true;
-                }
-            }
+        let magnitudes = self.spectrum.read();
+        let smoothing = self.config.smoothing;
+        for (smoothed, &db) in self.smoothed_magnitudes.iter_mut().zip(magnitudes.iter()) {
+            *smoothed = smoothing * *smoothed + (1.0 - smoothing) * db;
         }
 
-        if has_data {
-            self.compute_fft();
-            self.apply_smoothing();
-            if self.config.show_peaks {
-                self.update_peaks();
-            }
+        if self.config.show_peaks {
+            self.update_peaks();
         }
     }
 
@@ -214,20 +177,6 @@ impl Visualizer for SpectrumAnalyzer {
     }
 }
 
-fn hann_window(size: usize) -> Vec<f32> {
-    (0..size)
-        .map(|i| 0.5 * (1.0 - (std::f32::consts::TAU * i as f32 / size as f32).cos()))
-        .collect()
-}
-
-fn amplitude_to_db(amplitude: f32) -> f32 {
-    if amplitude <= 0.0 {
-        -120.0
-    } else {
-        20.0 * amplitude.log10()
-    }
-}
-
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -237,22 +186,23 @@ mod tests {
     fn test_spectrum_creation() {
         let (_producer, consumer) = audio_bridge(4);
         let analyzer = SpectrumAnalyzer::new(consumer);
-        assert_eq!(analyzer.sample_buffer.len(), 2048);
-        assert_eq!(analyzer.magnitudes.len(), 1024);
+        assert_eq!(analyzer.config().fft_size, 2048);
+        assert_eq!(analyzer.smoothed_magnitudes.len(), 1024);
     }
 
     #[test]
-    fn test_hann_window() {
-        let window = hann_window(4);
-        assert!((window[0] - 0.0).abs() < 0.001);
-        assert!((window[1] - 0.5).abs() < 0.001);
-        assert!((window[2] - 1.0).abs() < 0.001);
-        assert!((window[3] - 0.5).abs() < 0.001);
-    }
+    fn test_set_config_restarts_analysis() {
+        let (_producer, consumer) = audio_bridge(4);
+        let mut analyzer = SpectrumAnalyzer::new(consumer);
 
-    #[test]
-    fn test_amplitude_to_db() {
-        assert!((amplitude_to_db(1.0) - 0.0).abs() < 0.001);
-        assert!((amplitude_to_db(0.1) - (-20.0)).abs() < 0.001);
+        analyzer.set_config(SpectrumConfig {
+            fft_size: 512,
+            hop_size: 128,
+            ..Default::default()
+        });
+
+        assert!(analyzer.analysis.is_some());
+        assert_eq!(analyzer.smoothed_magnitudes.len(), 256);
+        assert_eq!(analyzer.spectrum.read().len(), 256);
     }
 }
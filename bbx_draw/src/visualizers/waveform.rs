@@ -5,40 +5,50 @@ use nannou::{
     geom::{Point2, Rect},
 };
 
-use crate::{Visualizer, bridge::AudioBridgeConsumer, config::WaveformConfig};
+use crate::{
+    Visualizer,
+    bridge::AudioBridgeConsumer,
+    config::WaveformConfig,
+    pyramid::{DEFAULT_BASE_BLOCK, WaveformPyramid, WaveformSummary},
+};
+
+/// Longest window drawn sample-by-sample with trigger detection.
+///
+/// Longer windows are drawn as a min/max envelope from a [`WaveformPyramid`],
+/// one column per pixel.
+pub const MAX_TRIGGERED_WINDOW: usize = 4096;
 
 /// Displays audio waveform in oscilloscope style.
 ///
 /// Features zero-crossing trigger detection for stable display of periodic waveforms.
+/// Windows longer than [`MAX_TRIGGERED_WINDOW`] samples (e.g. minutes of a live
+/// set) are summarized incrementally and drawn as a min/max envelope, so draw
+/// cost depends on the width in pixels rather than the time span.
 pub struct WaveformVisualizer {
     consumer: AudioBridgeConsumer,
     config: WaveformConfig,
     sample_buffer: Vec<f32>,
     write_position: usize,
+    pyramid: Option<WaveformPyramid>,
 }
 
 impl WaveformVisualizer {
     /// Create a new waveform visualizer with default configuration.
     pub fn new(consumer: AudioBridgeConsumer) -> Self {
-        let config = WaveformConfig::default();
-        let buffer_size = config.time_window_samples * 2;
-        Self {
-            consumer,
-            config: config.clone(),
-            sample_buffer: vec![0.0; buffer_size],
-            write_position: 0,
-        }
+        Self::with_config(consumer, WaveformConfig::default())
     }
 
     /// Create a new waveform visualizer with custom configuration.
     pub fn with_config(consumer: AudioBridgeConsumer, config: WaveformConfig) -> Self {
-        let buffer_size = config.time_window_samples * 2;
-        Self {
+        let mut visualizer = Self {
             consumer,
-            sample_buffer: vec![0.0; buffer_size],
-            write_position: 0,
             config,
-        }
+            sample_buffer: Vec::new(),
+            write_position: 0,
+            pyramid: None,
+        };
+        visualizer.allocate_history();
+        visualizer
     }
 
     /// Get the current configuration.
@@ -48,12 +58,46 @@ impl WaveformVisualizer {
 
     /// Update the configuration.
     pub fn set_config(&mut self, config: WaveformConfig) {
-        let buffer_size = config.time_window_samples * 2;
-        if buffer_size != self.sample_buffer.len() {
-            self.sample_buffer.resize(buffer_size, 0.0);
-            self.write_position = 0;
-        }
+        let window_changed = config.time_window_samples != self.config.time_window_samples;
         self.config = config;
+        if window_changed {
+            self.allocate_history();
+        }
+    }
+
+    fn allocate_history(&mut self) {
+        let window = self.config.time_window_samples;
+        self.write_position = 0;
+        if window > MAX_TRIGGERED_WINDOW {
+            self.sample_buffer = Vec::new();
+            self.pyramid = Some(WaveformPyramid::new(window, DEFAULT_BASE_BLOCK));
+        } else {
+            self.sample_buffer = vec![0.0; window * 2];
+            self.pyramid = None;
+        }
+    }
+
+    fn draw_envelope(&self, draw: &Draw, bounds: Rect, pyramid: &WaveformPyramid) {
+        let mut columns = vec![WaveformSummary::EMPTY; bounds.w().max(1.0) as usize];
+        let num_columns = pyramid.latest(self.config.time_window_samples as u64, &mut columns);
+        if num_columns < 2 {
+            return;
+        }
+
+        // Right-align so the newest audio is always at the right edge.
+        let column_width = bounds.w() / columns.len() as f32;
+        let left = bounds.right() - num_columns as f32 * column_width;
+        let half_height = bounds.h() / 2.0;
+        let column =
+            |i: usize, value: f32| Point2::new(left + i as f32 * column_width, bounds.y() + value * half_height);
+
+        let top = columns[..num_columns].iter().enumerate().map(|(i, c)| column(i, c.max));
+        let bottom = columns[..num_columns]
+            .iter()
+            .enumerate()
+            .rev()
+            .map(|(i, c)| column(i, c.min));
+        draw.polygon().color(self.config.line_color).points(top.chain(bottom));
     }
 
     fn find_trigger_point(&self) -> usize {
@@ -79,14 +123,20 @@ impl WaveformVisualizer {
 
 impl Visualizer for WaveformVisualizer {
     fn update(&mut self) {
-        while let Some(frame) = self.consumer.try_pop() {
-            if let Some(channel_iter) = frame.channel_samples(0) {
-                for sample in channel_iter {
-                    self.sample_buffer[self.write_position] = sample;
-                    self.write_position = (self.write_position + 1) % self.sample_buffer.len();
+        self.consumer.read(|view| {
+            let Some(samples) = view.channel(0) else {
+                return;
+            };
+            match self.pyramid.as_mut() {
+                Some(pyramid) => pyramid.push(samples),
+                None => {
+                    for sample in samples {
+                        self.sample_buffer[self.write_position] = sample;
+                        self.write_position = (self.write_position + 1) % self.sample_buffer.len();
+                    }
                 }
             }
-        }
+        });
     }
 
     fn draw(&self, draw: &Draw, bounds: Rect) {
@@ -94,6 +144,11 @@ impl Visualizer for WaveformVisualizer {
             draw.rect().xy(bounds.xy()).wh(bounds.wh()).color(bg);
         }
 
+        if let Some(pyramid) = &self.pyramid {
+            self.draw_envelope(draw, bounds, pyramid);
+            return;
+        }
+
         let trigger_point = self.find_trigger_point();
         let buffer_len = self.sample_buffer.len();
         let window_samples = self.config.time_window_samples;
@@ -141,4 +196,23 @@ mod tests {
         let visualizer = WaveformVisualizer::with_config(consumer, config);
         assert_eq!(visualizer.sample_buffer.len(), 1024);
     }
+
+    #[test]
+    fn test_long_window_uses_pyramid() {
+        let (mut producer, consumer) = audio_bridge(4);
+        let config = WaveformConfig {
+            time_window_samples: 48000 * 60,
+            ..Default::default()
+        };
+        let mut visualizer = WaveformVisualizer::with_config(consumer, config);
+        assert!(visualizer.sample_buffer.is_empty());
+
+        producer.try_write(&[0.5; 256], 48000, 1);
+        visualizer.update();
+        assert_eq!(visualizer.pyramid.as_ref().unwrap().total_samples(), 256);
+
+        visualizer.set_config(WaveformConfig::default());
+        assert!(visualizer.pyramid.is_none());
+        assert_eq!(visualizer.sample_buffer.len(), 2048);
+    }
 }
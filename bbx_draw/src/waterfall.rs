@@ -0,0 +1,237 @@
+//! Circular spectrogram image and colormaps.
+//!
+//! [`WaterfallImage`] holds a fixed number of spectrogram columns as RGBA
+//! pixels. New columns overwrite the oldest one, so memory is bounded by the
+//! history length, and only the columns written since the last upload need
+//! to be sent to the GPU.
+
+use std::ops::Range;
+
+/// Number of entries in a colormap lookup table.
+pub const COLORMAP_SIZE: usize = 256;
+
+/// Lookup table from normalized level (0.0 to 1.0) to RGBA color.
+#[derive(Clone)]
+pub struct Colormap {
+    lut: [[u8; 4]; COLORMAP_SIZE],
+}
+
+impl Colormap {
+    /// Build a colormap by linearly interpolating between `(position, rgb)`
+    /// stops sorted by position in `0.0..=1.0`.
+    pub fn from_stops(stops: &[(f32, [u8; 3])]) -> Self {
+        let mut lut = [[0, 0, 0, 255]; COLORMAP_SIZE];
+        for (i, entry) in lut.iter_mut().enumerate() {
+            let t = i as f32 / (COLORMAP_SIZE - 1) as f32;
+            let upper = stops.iter().position(|&(pos, _)| pos >= t).unwrap_or(stops.len() - 1);
+            let lower = upper.saturating_sub(1);
+            let (p0, c0) = stops[lower];
+            let (p1, c1) = stops[upper];
+            let frac = if p1 > p0 {
+                ((t - p0) / (p1 - p0)).clamp(0.0, 1.0)
+            } else {
+                0.0
+            };
+            for channel in 0..3 {
+                entry[channel] = (c0[channel] as f32 + (c1[channel] as f32 - c0[channel] as f32) * frac).round() as u8;
+            }
+        }
+        Self { lut }
+    }
+
+    /// Perceptually ordered black-purple-orange-yellow map.
+    pub fn inferno() -> Self {
+        Self::from_stops(&[
+            (0.0, [0, 0, 4]),
+            (0.25, [87, 16, 110]),
+            (0.5, [188, 55, 84]),
+            (0.75, [249, 142, 9]),
+            (1.0, [252, 255, 164]),
+        ])
+    }
+
+    /// Slate-amber-red map for load heatmaps, dark enough at the low end
+    /// for light text to stay readable.
+    pub fn heat() -> Self {
+        Self::from_stops(&[
+            (0.0, [38, 52, 74]),
+            (0.4, [64, 120, 96]),
+            (0.7, [214, 150, 36]),
+            (1.0, [214, 40, 40]),
+        ])
+    }
+
+    /// Black to white.
+    pub fn grayscale() -> Self {
+        Self::from_stops(&[(0.0, [0, 0, 0]), (1.0, [255, 255, 255])])
+    }
+
+    /// Color for a normalized level, clamped to `0.0..=1.0`.
+    #[inline]
+    pub fn lookup(&self, level: f32) -> [u8; 4] {
+        let index = (level.clamp(0.0, 1.0) * (COLORMAP_SIZE - 1) as f32) as usize;
+        self.lut[index]
+    }
+}
+
+impl Default for Colormap {
+    fn default() -> Self {
+        Self::inferno()
+    }
+}
+
+/// Fixed-size circular spectrogram image.
+///
+/// Pixels are stored column by column (RGBA, top row first), so each column
+/// is one contiguous slice that can be uploaded on its own.
+pub struct WaterfallImage {
+    pixels: Vec<u8>,
+    num_columns: usize,
+    num_rows: usize,
+    write_column: usize,
+    filled: usize,
+    dirty: usize,
+    colormap: Colormap,
+    min_db: f32,
+    db_range: f32,
+}
+
+impl WaterfallImage {
+    /// Create an image of `num_columns` columns of `num_rows` rows, mapping
+    /// `min_db..max_db` onto the colormap.
+    pub fn new(num_columns: usize, num_rows: usize, colormap: Colormap, min_db: f32, max_db: f32) -> Self {
+        let num_columns = num_columns.max(1);
+        let mut pixels = vec![0u8; num_columns * num_rows * 4];
+        let background = colormap.lookup(0.0);
+        for pixel in pixels.chunks_exact_mut(4) {
+            pixel.copy_from_slice(&background);
+        }
+
+        Self {
+            pixels,
+            num_columns,
+            num_rows,
+            write_column: 0,
+            filled: 0,
+            dirty: 0,
+            colormap,
+            min_db,
+            db_range: (max_db - min_db).max(f32::EPSILON),
+        }
+    }
+
+    /// Number of columns of history.
+    pub fn num_columns(&self) -> usize {
+        self.num_columns
+    }
+
+    /// Number of rows per column.
+    pub fn num_rows(&self) -> usize {
+        self.num_rows
+    }
+
+    /// Number of columns written so far, up to [`num_columns`](Self::num_columns).
+    pub fn filled(&self) -> usize {
+        self.filled
+    }
+
+    /// All pixels, column-major RGBA.
+    pub fn pixels(&self) -> &[u8] {
+        &self.pixels
+    }
+
+    /// RGBA pixels of one column, top row first.
+    pub fn column(&self, column: usize) -> &[u8] {
+        let stride = self.num_rows * 4;
+        &self.pixels[column * stride..(column + 1) * stride]
+    }
+
+    /// Append a column of levels in dB, lowest frequency first.
+    ///
+    /// Overwrites the oldest column once the image is full.
+    pub fn push_column(&mut self, levels_db: &[f32]) {
+        let stride = self.num_rows * 4;
+        let start = self.write_column * stride;
+        let column = &mut self.pixels[start..start + stride];
+
+        // The top row is the highest frequency.
+        for (pixel, &db) in column.chunks_exact_mut(4).zip(levels_db.iter().rev()) {
+            pixel.copy_from_slice(&self.colormap.lookup((db - self.min_db) / self.db_range));
+        }
+
+        self.write_column = (self.write_column + 1) % self.num_columns;
+        self.filled = (self.filled + 1).min(self.num_columns);
+        self.dirty = (self.dirty + 1).min(self.num_columns);
+    }
+
+    /// Take the columns written since the last call, oldest first.
+    pub fn take_dirty(&mut self) -> impl Iterator<Item = usize> + use<> {
+        let count = std::mem::take(&mut self.dirty);
+        let num_columns = self.num_columns;
+        let first = self.write_column + num_columns - count;
+        (0..count).map(move |i| (first + i) % num_columns)
+    }
+
+    /// Written columns in display order (oldest first), as at most two
+    /// contiguous ranges of column indices.
+    pub fn segments(&self) -> [Range<usize>; 2] {
+        if self.filled < self.num_columns {
+            [0..self.filled, 0..0]
+        } else {
+            [self.write_column..self.num_columns, 0..self.write_column]
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_colormap_endpoints() {
+        let map = Colormap::grayscale();
+        assert_eq!(map.lookup(0.0), [0, 0, 0, 255]);
+        assert_eq!(map.lookup(1.0), [255, 255, 255, 255]);
+        assert_eq!(map.lookup(2.0), [255, 255, 255, 255]);
+        assert_eq!(map.lookup(0.5)[0], 127);
+    }
+
+    #[test]
+    fn test_push_column_maps_and_flips() {
+        let mut image = WaterfallImage::new(4, 2, Colormap::grayscale(), -100.0, 0.0);
+        image.push_column(&[-100.0, 0.0]);
+
+        assert_eq!(image.column(0), [255, 255, 255, 255, 0, 0, 0, 255]);
+        assert_eq!(image.filled(), 1);
+    }
+
+    #[test]
+    fn test_history_wraps_and_segments() {
+        let mut image = WaterfallImage::new(3, 1, Colormap::grayscale(), -100.0, 0.0);
+        for _ in 0..2 {
+            image.push_column(&[0.0]);
+        }
+        assert_eq!(image.segments(), [0..2, 0..0]);
+
+        for _ in 0..2 {
+            image.push_column(&[0.0]);
+        }
+        assert_eq!(image.pixels().len(), 3 * 4);
+        assert_eq!(image.segments(), [1..3, 0..1]);
+    }
+
+    #[test]
+    fn test_take_dirty_returns_new_columns_only() {
+        let mut image = WaterfallImage::new(4, 1, Colormap::grayscale(), -100.0, 0.0);
+        for _ in 0..3 {
+            image.push_column(&[0.0]);
+        }
+        assert_eq!(image.take_dirty().collect::<Vec<_>>(), [0, 1, 2]);
+        assert_eq!(image.take_dirty().count(), 0);
+
+        for _ in 0..6 {
+            image.push_column(&[0.0]);
+        }
+        assert_eq!(image.take_dirty().collect::<Vec<_>>(), [1, 2, 3, 0]);
+    }
+}
@@ -12,6 +12,9 @@ pub fn create_context(buffer_size: usize) -> DspContext {
         buffer_size,
         num_channels: NUM_CHANNELS,
         current_sample: 0,
+        is_playing: true,
+        tempo: None,
+        ppq_position: None,
         channel_layout: ChannelLayout::default(),
     }
 }
@@ -0,0 +1,274 @@
+#![cfg_attr(feature = "simd", feature(portable_simd))]
+
+//! Graph scaling benchmarks from 10 to 10,000 blocks.
+//!
+//! Synthetic topologies:
+//! - `chain`: one oscillator feeding a series of gain blocks
+//! - `fan`: one oscillator fanned out to parallel gains, summed by a mixer tree
+//! - `random_dag`: seeded random DAG of gains and mixers over a few oscillators
+//! - `modulated`: a gain chain where every gain level is driven by its own LFO
+//!
+//! Measures `GraphBuilder::build` (which includes `Graph::prepare`), a
+//! repeated `Graph::prepare`, and `Graph::process_buffers`. Processing
+//! throughput is reported in block-samples, so its inverse is the average
+//! cost per block per sample. Heap bytes held by each built graph are
+//! measured with a counting allocator and written to
+//! `target/criterion/graph_scaling.json` along with the timings.
+
+mod common;
+
+use std::{
+    alloc::{GlobalAlloc, Layout, System},
+    sync::atomic::{AtomicUsize, Ordering},
+};
+
+use bbx_bench::export_json_with;
+use bbx_core::random::XorShiftRng;
+use bbx_dsp::{
+    block::BlockId,
+    blocks::{GainBlock, LfoBlock, MixerBlock, OscillatorBlock},
+    graph::{Graph, GraphBuilder, MAX_BLOCK_INPUTS},
+    waveform::Waveform,
+};
+use common::*;
+use criterion::{BatchSize, BenchmarkId, Criterion, Throughput, black_box};
+
+/// Heap allocator that tracks the number of live bytes.
+struct CountingAllocator;
+
+static LIVE_BYTES: AtomicUsize = AtomicUsize::new(0);
+
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        LIVE_BYTES.fetch_add(layout.size(), Ordering::Relaxed);
+        unsafe { System.alloc(layout) }
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        LIVE_BYTES.fetch_sub(layout.size(), Ordering::Relaxed);
+        unsafe { System.dealloc(ptr, layout) }
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        LIVE_BYTES.fetch_add(new_size, Ordering::Relaxed);
+        LIVE_BYTES.fetch_sub(layout.size(), Ordering::Relaxed);
+        unsafe { System.realloc(ptr, layout, new_size) }
+    }
+}
+
+#[global_allocator]
+static ALLOCATOR: CountingAllocator = CountingAllocator;
+
+const BLOCK_COUNTS: &[usize] = &[10, 100, 1000, 10_000];
+const BUFFER_SIZE: usize = 256;
+
+/// Graphs are mono so per-block cost isn't scaled by the channel count.
+const CHANNELS: usize = 1;
+
+/// Inputs per mixer when summing many terminal blocks.
+const MIXER_FAN_IN: usize = MAX_BLOCK_INPUTS;
+
+type Topology = fn(usize) -> GraphBuilder<f32>;
+
+const TOPOLOGIES: &[(&str, Topology)] = &[
+    ("chain", chain),
+    ("fan", fan),
+    ("random_dag", random_dag),
+    ("modulated", modulated),
+];
+
+fn new_builder() -> GraphBuilder<f32> {
+    GraphBuilder::new(SAMPLE_RATE, BUFFER_SIZE, CHANNELS)
+}
+
+/// Sum `sources` through a tree of mixers with at most `MIXER_FAN_IN`
+/// inputs each, so `build()` sees a single terminal block.
+fn mix_down(builder: &mut GraphBuilder<f32>, mut sources: Vec<BlockId>) {
+    while sources.len() > 1 {
+        sources = sources
+            .chunks(MIXER_FAN_IN)
+            .map(|group| {
+                let mixer = builder.add(MixerBlock::new(group.len(), CHANNELS));
+                for (input, &source) in group.iter().enumerate() {
+                    builder.connect(source, 0, mixer, input);
+                }
+                mixer
+            })
+            .collect();
+    }
+}
+
+fn chain(num_blocks: usize) -> GraphBuilder<f32> {
+    let mut builder = new_builder();
+    let mut previous = builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+    for _ in 1..num_blocks {
+        let gain = builder.add(GainBlock::new(-0.1, None));
+        builder.connect(previous, 0, gain, 0);
+        previous = gain;
+    }
+    builder
+}
+
+fn fan(num_blocks: usize) -> GraphBuilder<f32> {
+    let mut builder = new_builder();
+    let osc = builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+    let branches = (0..num_blocks.saturating_sub(1).max(1))
+        .map(|_| {
+            let gain = builder.add(GainBlock::new(-0.1, None));
+            builder.connect(osc, 0, gain, 0);
+            gain
+        })
+        .collect();
+    mix_down(&mut builder, branches);
+    builder
+}
+
+fn random_dag(num_blocks: usize) -> GraphBuilder<f32> {
+    let mut builder = new_builder();
+    let mut rng = XorShiftRng::new(0x5eed);
+    let mut pick = |n: usize| (((rng.next_noise_sample() + 1.0) * 0.5 * n as f64) as usize).min(n - 1);
+
+    let num_sources = num_blocks / 16 + 1;
+    let mut nodes: Vec<BlockId> = (0..num_sources)
+        .map(|i| builder.add(OscillatorBlock::new(110.0 * (i + 1) as f64, Waveform::Sine, None)))
+        .collect();
+    let mut has_outgoing = vec![false; num_blocks.max(num_sources)];
+
+    for _ in num_sources..num_blocks {
+        let fan_in = pick(4) + 1;
+        let node = if fan_in == 1 {
+            builder.add(GainBlock::new(-0.1, None))
+        } else {
+            builder.add(MixerBlock::new(fan_in, CHANNELS))
+        };
+        for input in 0..fan_in {
+            let source = pick(nodes.len());
+            builder.connect(nodes[source], 0, node, input);
+            has_outgoing[source] = true;
+        }
+        nodes.push(node);
+    }
+
+    let terminals = nodes
+        .iter()
+        .zip(&has_outgoing)
+        .filter(|&(_, &used)| !used)
+        .map(|(&node, _)| node)
+        .collect();
+    mix_down(&mut builder, terminals);
+    builder
+}
+
+fn modulated(num_blocks: usize) -> GraphBuilder<f32> {
+    let mut builder = new_builder();
+    let mut previous = builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+    for i in 0..num_blocks.saturating_sub(1) / 2 {
+        let lfo = builder.add(LfoBlock::new(0.5 + i as f64 * 0.01, 1.0, Waveform::Sine, None));
+        let gain = builder.add(GainBlock::new(-0.1, None));
+        builder.connect(previous, 0, gain, 0);
+        builder.modulate(lfo, gain, "level");
+        previous = gain;
+    }
+    builder
+}
+
+fn bench_build(c: &mut Criterion) {
+    let mut group = c.benchmark_group("graph_scaling_build");
+    group.sample_size(10);
+
+    for &(name, topology) in TOPOLOGIES {
+        for &num_blocks in BLOCK_COUNTS {
+            group.bench_with_input(BenchmarkId::new(name, num_blocks), &num_blocks, |b, &n| {
+                b.iter_batched(|| topology(n), |builder| builder.build(), BatchSize::LargeInput);
+            });
+        }
+    }
+
+    group.finish();
+}
+
+fn bench_prepare(c: &mut Criterion) {
+    let mut group = c.benchmark_group("graph_scaling_prepare");
+    group.sample_size(10);
+
+    for &(name, topology) in TOPOLOGIES {
+        for &num_blocks in BLOCK_COUNTS {
+            group.bench_with_input(BenchmarkId::new(name, num_blocks), &num_blocks, |b, &n| {
+                let mut graph = topology(n).build();
+                b.iter(|| graph.prepare(black_box(SAMPLE_RATE), BUFFER_SIZE, CHANNELS));
+            });
+        }
+    }
+
+    group.finish();
+}
+
+fn bench_process(c: &mut Criterion) {
+    let mut group = c.benchmark_group("graph_scaling_process");
+    group.sample_size(10);
+
+    for &(name, topology) in TOPOLOGIES {
+        for &num_blocks in BLOCK_COUNTS {
+            let mut graph = topology(num_blocks).build();
+            let actual_blocks = count_blocks(&graph);
+            group.throughput(Throughput::Elements((actual_blocks * BUFFER_SIZE) as u64));
+
+            group.bench_with_input(BenchmarkId::new(name, num_blocks), &num_blocks, |b, _| {
+                let mut output = vec![0.0f32; BUFFER_SIZE];
+                b.iter(|| {
+                    let mut output_buffers: [&mut [f32]; CHANNELS] = [&mut output];
+                    graph.process_buffers(black_box(&mut output_buffers));
+                });
+            });
+        }
+    }
+
+    group.finish();
+}
+
+fn count_blocks(graph: &Graph<f32>) -> usize {
+    (0..).take_while(|&i| graph.get_block(BlockId(i)).is_some()).count()
+}
+
+/// Heap bytes held by each built graph.
+fn measure_memory() -> Vec<serde_json::Value> {
+    let mut entries = Vec::new();
+
+    for &(name, topology) in TOPOLOGIES {
+        for &num_blocks in BLOCK_COUNTS {
+            let before = LIVE_BYTES.load(Ordering::Relaxed);
+            let graph = topology(num_blocks).build();
+            let bytes = LIVE_BYTES.load(Ordering::Relaxed).saturating_sub(before);
+            let blocks = count_blocks(&graph);
+            drop(graph);
+
+            println!(
+                "graph_scaling_memory/{name}/{num_blocks}: {blocks} blocks, {bytes} bytes ({} bytes/block)",
+                bytes / blocks
+            );
+            entries.push(serde_json::json!({
+                "topology": name,
+                "requested_blocks": num_blocks,
+                "blocks": blocks,
+                "bytes": bytes,
+                "bytes_per_block": bytes / blocks,
+            }));
+        }
+    }
+
+    entries
+}
+
+fn main() {
+    let mut criterion = Criterion::default().configure_from_args();
+
+    bench_build(&mut criterion);
+    bench_prepare(&mut criterion);
+    bench_process(&mut criterion);
+    criterion.final_summary();
+
+    let mut extra = serde_json::Map::new();
+    extra.insert("buffer_size".into(), BUFFER_SIZE.into());
+    extra.insert("memory".into(), measure_memory().into());
+    export_json_with("graph_scaling", &["graph_scaling_"], cfg!(feature = "simd"), extra);
+}
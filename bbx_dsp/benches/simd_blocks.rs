@@ -18,9 +18,12 @@ use bbx_dsp::{
             vca::VcaBlock,
         },
         generators::oscillator::OscillatorBlock,
+        io::file_input::FileInputBlock,
         modulators::{envelope::EnvelopeBlock, lfo::LfoBlock},
     },
     buffer::{AudioBuffer, Buffer},
+    pcm::{PcmEncoding, PcmStore},
+    reader::Reader,
     sample::Sample,
     waveform::Waveform,
 };
@@ -617,6 +620,87 @@ fn bench_envelope_f64(c: &mut Criterion) {
     bench_envelope::<f64>(c, "f64");
 }
 
+/// Channels in the file input benchmarks, a third-order ambisonic bed with room
+/// to spare.
+const FILE_INPUT_CHANNELS: usize = 64;
+
+/// Full-width samples, the baseline for the compressed stores.
+struct FullWidthReader<S: Sample>(Vec<Vec<S>>);
+
+impl<S: Sample> Reader<S> for FullWidthReader<S> {
+    fn sample_rate(&self) -> f64 {
+        SAMPLE_RATE
+    }
+
+    fn num_channels(&self) -> usize {
+        self.0.len()
+    }
+
+    fn num_samples(&self) -> usize {
+        self.0.first().map_or(0, |c| c.len())
+    }
+
+    fn read_channel(&self, channel_index: usize) -> &[S] {
+        &self.0[channel_index]
+    }
+}
+
+fn bench_file_input<S: Sample>(c: &mut Criterion, type_name: &str) {
+    let mut group = c.benchmark_group(format!("file_input_{}ch_{}", FILE_INPUT_CHANNELS, type_name));
+
+    // One second per channel, looped
+    let channels = create_input_buffers::<S>(SAMPLE_RATE as usize, FILE_INPUT_CHANNELS);
+    let channel_slices = as_input_slices(&channels);
+
+    let readers: [(&str, fn(&[&[S]]) -> Box<dyn Reader<S>>); 3] = [
+        ("full_width", |c| {
+            Box::new(FullWidthReader(c.iter().map(|c| c.to_vec()).collect()))
+        }),
+        ("pcm16", |c| {
+            Box::new(PcmStore::from_channels(SAMPLE_RATE, c, PcmEncoding::Pcm16))
+        }),
+        ("pcm24", |c| {
+            Box::new(PcmStore::from_channels(SAMPLE_RATE, c, PcmEncoding::Pcm24))
+        }),
+    ];
+
+    for buffer_size in BUFFER_SIZES {
+        group.throughput(Throughput::Elements((*buffer_size * FILE_INPUT_CHANNELS) as u64));
+
+        for (name, make_reader) in &readers {
+            let bench_id = BenchmarkId::new(*name, buffer_size);
+
+            group.bench_with_input(bench_id, buffer_size, |b, &size| {
+                let context = create_context(size);
+                let mut block = FileInputBlock::new(make_reader(&channel_slices));
+                block.set_loop_enabled(true);
+                let mut outputs = create_output_buffers::<S>(size, FILE_INPUT_CHANNELS);
+                let modulation_values: Vec<S> = vec![];
+
+                b.iter(|| {
+                    let mut output_slices = as_output_slices(&mut outputs);
+                    block.process(
+                        black_box(&[]),
+                        black_box(&mut output_slices),
+                        black_box(&modulation_values),
+                        black_box(&context),
+                    );
+                });
+            });
+        }
+    }
+
+    group.finish();
+}
+
+fn bench_file_input_f32(c: &mut Criterion) {
+    bench_file_input::<f32>(c, "f32");
+}
+
+fn bench_file_input_f64(c: &mut Criterion) {
+    bench_file_input::<f64>(c, "f64");
+}
+
 criterion_group!(oscillator_benches, bench_oscillator_f32, bench_oscillator_f64,);
 
 criterion_group!(panner_benches, bench_panner_f32, bench_panner_f64);
@@ -659,6 +743,8 @@ criterion_group!(overdrive_benches, bench_overdrive_f32, bench_overdrive_f64);
 
 criterion_group!(envelope_benches, bench_envelope_f32, bench_envelope_f64);
 
+criterion_group!(file_input_benches, bench_file_input_f32, bench_file_input_f64);
+
 criterion_main!(
     oscillator_benches,
     panner_benches,
@@ -672,5 +758,6 @@ criterion_main!(
     vca_benches,
     dc_blocker_benches,
     overdrive_benches,
-    envelope_benches
+    envelope_benches,
+    file_input_benches
 );
@@ -3,8 +3,9 @@
 mod common;
 
 use bbx_dsp::{
-    blocks::{LfoBlock, OscillatorBlock, OverdriveBlock},
+    blocks::{GainBlock, LfoBlock, LowPassFilterBlock, OscillatorBlock, OverdriveBlock},
     graph::GraphBuilder,
+    modulation::{ModulationCurve, ModulationRoute},
     sample::Sample,
     waveform::Waveform,
 };
@@ -33,6 +34,32 @@ fn create_modulated_synth<S: Sample>(buffer_size: usize) -> bbx_dsp::graph::Grap
     builder.build()
 }
 
+/// Four oscillators, each with its frequency routed from four LFOs through
+/// the modulation matrix.
+fn create_routed_synth<S: Sample>(buffer_size: usize) -> bbx_dsp::graph::Graph<S> {
+    let mut builder = GraphBuilder::new(SAMPLE_RATE, buffer_size, NUM_CHANNELS);
+    let lfos: Vec<_> = [0.5, 2.0, 5.0, 7.0]
+        .into_iter()
+        .map(|rate| builder.add(LfoBlock::new(rate, 1.0, Waveform::Sine, None)))
+        .collect();
+    let curves = [
+        ModulationCurve::Linear,
+        ModulationCurve::Unipolar,
+        ModulationCurve::Quadratic,
+    ];
+    for (i, frequency) in [220.0, 330.0, 440.0, 550.0].into_iter().enumerate() {
+        let osc = builder.add(OscillatorBlock::new(frequency, Waveform::Sine, None));
+        for (j, &lfo) in lfos.iter().enumerate() {
+            let route = ModulationRoute::new(lfo, osc, "frequency")
+                .depth(5.0)
+                .offset(if j == 0 { frequency } else { 0.0 })
+                .curve(curves[(i + j) % curves.len()]);
+            builder.route(route).unwrap();
+        }
+    }
+    builder.build()
+}
+
 fn create_multi_oscillator<S: Sample>(buffer_size: usize) -> bbx_dsp::graph::Graph<S> {
     let mut builder = GraphBuilder::new(SAMPLE_RATE, buffer_size, NUM_CHANNELS);
     builder.add(OscillatorBlock::new(220.0, Waveform::Sine, Some(1)));
@@ -42,6 +69,33 @@ fn create_multi_oscillator<S: Sample>(buffer_size: usize) -> bbx_dsp::graph::Gra
     builder.build()
 }
 
+fn create_filtered_synth<S: Sample>(buffer_size: usize) -> bbx_dsp::graph::Graph<S> {
+    let mut builder = GraphBuilder::new(SAMPLE_RATE, buffer_size, NUM_CHANNELS);
+    let osc = builder.add(OscillatorBlock::new(110.0, Waveform::Sawtooth, None));
+    let filter = builder.add(LowPassFilterBlock::new(80.0, 4.0));
+    let overdrive = builder.add(OverdriveBlock::new(2.0, 0.7, 0.5, SAMPLE_RATE));
+    let gain = builder.add(GainBlock::new(-6.0, None));
+    builder
+        .connect(osc, 0, filter, 0)
+        .connect(filter, 0, overdrive, 0)
+        .connect(overdrive, 0, gain, 0);
+    builder.build()
+}
+
+/// The filtered synth in f32, with only the filter run in f64.
+fn create_filtered_synth_mixed(buffer_size: usize) -> bbx_dsp::graph::Graph<f32> {
+    let mut builder = GraphBuilder::new(SAMPLE_RATE, buffer_size, NUM_CHANNELS);
+    let osc = builder.add(OscillatorBlock::new(110.0, Waveform::Sawtooth, None));
+    let filter = builder.add_f64(LowPassFilterBlock::new(80.0, 4.0));
+    let overdrive = builder.add(OverdriveBlock::new(2.0, 0.7, 0.5, SAMPLE_RATE));
+    let gain = builder.add(GainBlock::new(-6.0, None));
+    builder
+        .connect(osc, 0, filter, 0)
+        .connect(filter, 0, overdrive, 0)
+        .connect(overdrive, 0, gain, 0);
+    builder.build()
+}
+
 fn bench_graph<S: Sample, F>(c: &mut Criterion, type_name: &str, graph_name: &str, graph_fn: F)
 where
     F: Fn(usize) -> bbx_dsp::graph::Graph<S>,
@@ -92,6 +146,14 @@ fn bench_modulated_synth_f64(c: &mut Criterion) {
     bench_graph::<f64, _>(c, "f64", "modulated_synth", create_modulated_synth);
 }
 
+fn bench_routed_synth_f32(c: &mut Criterion) {
+    bench_graph::<f32, _>(c, "f32", "routed_synth", create_routed_synth);
+}
+
+fn bench_routed_synth_f64(c: &mut Criterion) {
+    bench_graph::<f64, _>(c, "f64", "routed_synth", create_routed_synth);
+}
+
 fn bench_multi_osc_f32(c: &mut Criterion) {
     bench_graph::<f32, _>(c, "f32", "multi_osc", create_multi_oscillator);
 }
@@ -100,6 +162,18 @@ fn bench_multi_osc_f64(c: &mut Criterion) {
     bench_graph::<f64, _>(c, "f64", "multi_osc", create_multi_oscillator);
 }
 
+fn bench_filtered_synth_f32(c: &mut Criterion) {
+    bench_graph::<f32, _>(c, "f32", "filtered_synth", create_filtered_synth);
+}
+
+fn bench_filtered_synth_f64(c: &mut Criterion) {
+    bench_graph::<f64, _>(c, "f64", "filtered_synth", create_filtered_synth);
+}
+
+fn bench_filtered_synth_mixed(c: &mut Criterion) {
+    bench_graph::<f32, _>(c, "mixed", "filtered_synth", create_filtered_synth_mixed);
+}
+
 criterion_group!(simple_chain_benches, bench_simple_chain_f32, bench_simple_chain_f64,);
 
 criterion_group!(effect_chain_benches, bench_effect_chain_f32, bench_effect_chain_f64,);
@@ -110,11 +184,22 @@ criterion_group!(
     bench_modulated_synth_f64,
 );
 
+criterion_group!(routed_synth_benches, bench_routed_synth_f32, bench_routed_synth_f64);
+
 criterion_group!(multi_osc_benches, bench_multi_osc_f32, bench_multi_osc_f64);
 
+criterion_group!(
+    filtered_synth_benches,
+    bench_filtered_synth_f32,
+    bench_filtered_synth_f64,
+    bench_filtered_synth_mixed,
+);
+
 criterion_main!(
     simple_chain_benches,
     effect_chain_benches,
     modulated_synth_benches,
-    multi_osc_benches
+    routed_synth_benches,
+    multi_osc_benches,
+    filtered_synth_benches
 );
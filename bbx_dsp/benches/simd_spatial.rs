@@ -0,0 +1,160 @@
+#![cfg_attr(feature = "simd", feature(portable_simd))]
+
+//! Benchmarks for the spatial audio blocks.
+//!
+//! Sweeps ambisonic order (FOA/SOA/TOA), speaker layout, buffer size and
+//! sample type. Throughput is reported in channel-samples: buffer size times
+//! the channel count on the wider side of the block (input channels for
+//! decoders, output channels for encoders and panners). After the run, the
+//! results are written to `target/criterion/simd_spatial.json`.
+
+mod common;
+
+use bbx_bench::export_json;
+use bbx_dsp::{
+    block::Block,
+    blocks::effectors::{
+        ambisonic_decoder::AmbisonicDecoderBlock,
+        binaural_decoder::{BinauralDecoderBlock, BinauralStrategy},
+        panner::PannerBlock,
+    },
+    channel::ChannelLayout,
+    context::DspContext,
+    sample::Sample,
+};
+use common::*;
+use criterion::{BenchmarkGroup, BenchmarkId, Criterion, Throughput, black_box, measurement::WallTime};
+
+const ORDERS: &[(usize, &str)] = &[(1, "foa"), (2, "soa"), (3, "toa")];
+
+const SPEAKER_LAYOUTS: &[(ChannelLayout, &str)] = &[
+    (ChannelLayout::Stereo, "stereo"),
+    (ChannelLayout::Surround51, "5.1"),
+    (ChannelLayout::Surround71, "7.1"),
+];
+
+const STRATEGIES: &[(BinauralStrategy, &str)] =
+    &[(BinauralStrategy::Hrtf, "hrtf"), (BinauralStrategy::Matrix, "matrix")];
+
+fn spatial_context(buffer_size: usize, layout: ChannelLayout) -> DspContext {
+    DspContext {
+        sample_rate: SAMPLE_RATE,
+        buffer_size,
+        num_channels: layout.channel_count(),
+        current_sample: 0,
+        is_playing: true,
+        tempo: None,
+        ppq_position: None,
+        channel_layout: layout,
+    }
+}
+
+/// Benchmark one block configuration at every buffer size.
+fn bench_block<S: Sample, B: Block<S>>(
+    group: &mut BenchmarkGroup<'_, WallTime>,
+    config_name: &str,
+    layout: ChannelLayout,
+    make_block: impl Fn() -> B,
+) {
+    for buffer_size in BUFFER_SIZES {
+        let mut block = make_block();
+        let num_inputs = block.input_count();
+        let num_outputs = block.output_count();
+        group.throughput(Throughput::Elements(
+            (*buffer_size * num_inputs.max(num_outputs)) as u64,
+        ));
+
+        let bench_id = BenchmarkId::new(config_name, buffer_size);
+
+        group.bench_with_input(bench_id, buffer_size, |b, &size| {
+            let context = spatial_context(size, layout);
+            let inputs = create_input_buffers::<S>(size, num_inputs);
+            let mut outputs = create_output_buffers::<S>(size, num_outputs);
+            let modulation_values: Vec<S> = vec![];
+
+            b.iter(|| {
+                let input_slices = as_input_slices(&inputs);
+                let mut output_slices = as_output_slices(&mut outputs);
+                block.process(
+                    black_box(&input_slices),
+                    black_box(&mut output_slices),
+                    black_box(&modulation_values),
+                    black_box(&context),
+                );
+            });
+        });
+    }
+}
+
+fn bench_binaural_decoder<S: Sample>(c: &mut Criterion, type_name: &str) {
+    let mut group = c.benchmark_group(format!("spatial_binaural_decoder_{type_name}"));
+
+    for &(strategy, strategy_name) in STRATEGIES {
+        for &(order, order_name) in ORDERS {
+            bench_block(
+                &mut group,
+                &format!("{strategy_name}_{order_name}"),
+                ChannelLayout::Stereo,
+                || BinauralDecoderBlock::<S>::with_strategy(order, strategy),
+            );
+        }
+        for &(channels, layout_name) in &[(6, "5.1"), (8, "7.1")] {
+            bench_block(
+                &mut group,
+                &format!("{strategy_name}_{layout_name}"),
+                ChannelLayout::Stereo,
+                || BinauralDecoderBlock::<S>::new_surround(channels, strategy),
+            );
+        }
+    }
+
+    group.finish();
+}
+
+fn bench_ambisonic_decoder<S: Sample>(c: &mut Criterion, type_name: &str) {
+    let mut group = c.benchmark_group(format!("spatial_ambisonic_decoder_{type_name}"));
+
+    for &(order, order_name) in ORDERS {
+        for &(layout, layout_name) in SPEAKER_LAYOUTS {
+            bench_block(&mut group, &format!("{order_name}_{layout_name}"), layout, || {
+                AmbisonicDecoderBlock::<S>::new(order, layout)
+            });
+        }
+    }
+
+    group.finish();
+}
+
+fn bench_panner<S: Sample>(c: &mut Criterion, type_name: &str) {
+    let mut group = c.benchmark_group(format!("spatial_panner_{type_name}"));
+
+    for &(order, order_name) in ORDERS {
+        let layout = ChannelLayout::from_ambisonic_order(order).unwrap();
+        bench_block(&mut group, &format!("ambisonic_{order_name}"), layout, || {
+            PannerBlock::<S>::new_ambisonic(order)
+        });
+    }
+    for &(layout, layout_name) in &SPEAKER_LAYOUTS[1..] {
+        bench_block(&mut group, &format!("surround_{layout_name}"), layout, || {
+            PannerBlock::<S>::new_surround(layout)
+        });
+    }
+
+    group.finish();
+}
+
+fn bench_spatial<S: Sample>(c: &mut Criterion, type_name: &str) {
+    bench_binaural_decoder::<S>(c, type_name);
+    bench_ambisonic_decoder::<S>(c, type_name);
+    bench_panner::<S>(c, type_name);
+}
+
+fn main() {
+    let mut criterion = Criterion::default().configure_from_args();
+
+    bench_spatial::<f32>(&mut criterion, "f32");
+    bench_spatial::<f64>(&mut criterion, "f64");
+
+    criterion.final_summary();
+    export_json("simd_spatial", &["spatial_"], cfg!(feature = "simd"));
+}
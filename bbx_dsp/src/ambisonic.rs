@@ -0,0 +1,139 @@
+//! Spherical harmonics for ambisonic encoding and decoding.
+//!
+//! Coefficients use ACN channel ordering and SN3D normalization, the AmbiX
+//! convention used throughout the crate. Channel `l² + l + m` holds the real
+//! spherical harmonic of degree `l` and order `m` (`-l ≤ m ≤ l`):
+//!
+//! ```text
+//! Y(l, m) = N(l, |m|) · P(l, |m|)(sin el) · { cos(m · az)    m ≥ 0
+//!                                           { sin(|m| · az)  m < 0
+//!
+//! N(l, m) = sqrt((2 - δ(m, 0)) · (l - m)! / (l + m)!)
+//! ```
+//!
+//! where `P` is the associated Legendre function without the Condon-Shortley
+//! phase. Both `P` and the azimuth terms are computed by recurrence, so a full
+//! set of coefficients costs one `sin`/`cos` pair per angle at any order.
+
+/// Highest ambisonic order supported by the encoder and decoder blocks.
+pub const MAX_AMBISONIC_ORDER: usize = 5;
+
+/// Write the SN3D spherical harmonic coefficients of a direction into
+/// `coeffs`, in ACN order.
+///
+/// Fills the first `(order + 1)²` entries, or as many as `coeffs` holds.
+/// Azimuth is in degrees counter-clockwise from the front (90 = left) and
+/// elevation in degrees above the horizon.
+pub fn sn3d_coefficients(order: usize, azimuth_deg: f64, elevation_deg: f64, coeffs: &mut [f64]) {
+    let az = azimuth_deg.to_radians();
+    let el = elevation_deg.to_radians();
+    let (sin_el, cos_el) = el.sin_cos();
+    let (sin_az, cos_az) = az.sin_cos();
+
+    // cos(m·az) and sin(m·az) by angle addition, starting from m = 0
+    let (mut cos_m, mut sin_m) = (1.0, 0.0);
+    // P(m, m) = (2m - 1)!! · cos(el)^m
+    let mut p_mm = 1.0;
+
+    for m in 0..=order {
+        if m > 0 {
+            (cos_m, sin_m) = (cos_m * cos_az - sin_m * sin_az, sin_m * cos_az + cos_m * sin_az);
+            p_mm *= (2 * m - 1) as f64 * cos_el;
+        }
+
+        // Walk up the degrees for this order: P(l, m) from P(l-1, m) and P(l-2, m)
+        let (mut p_prev, mut p) = (0.0, p_mm);
+        // (l - m)! / (l + m)!, starting at l = m
+        let mut factorial_ratio = (1..=2 * m).fold(1.0, |ratio, k| ratio / k as f64);
+
+        for l in m..=order {
+            if l > m {
+                (p_prev, p) = (
+                    p,
+                    ((2 * l - 1) as f64 * sin_el * p - (l + m - 1) as f64 * p_prev) / (l - m) as f64,
+                );
+                factorial_ratio *= (l - m) as f64 / (l + m) as f64;
+            }
+
+            let weight = if m == 0 { 1.0 } else { 2.0 };
+            let value = (weight * factorial_ratio).sqrt() * p;
+
+            let center = l * l + l;
+            if let Some(coeff) = coeffs.get_mut(center + m) {
+                *coeff = value * cos_m;
+            }
+            if m > 0
+                && let Some(coeff) = coeffs.get_mut(center - m)
+            {
+                *coeff = value * sin_m;
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::channel::ChannelLayout;
+
+    /// Closed forms for orders 0-3, as previously written out per channel.
+    fn third_order(az: f64, el: f64) -> [f64; 16] {
+        let (az, el) = (az.to_radians(), el.to_radians());
+        let (sin_el, cos_el) = el.sin_cos();
+        let (sin_az, cos_az) = az.sin_cos();
+        let (sin_2el, cos_el_sq, sin_el_sq) = ((2.0 * el).sin(), cos_el * cos_el, sin_el * sin_el);
+        [
+            1.0,
+            cos_el * sin_az,
+            sin_el,
+            cos_el * cos_az,
+            0.8660254037844386 * cos_el_sq * (2.0 * az).sin(),
+            0.8660254037844386 * sin_2el * sin_az,
+            0.5 * (3.0 * sin_el_sq - 1.0),
+            0.8660254037844386 * sin_2el * cos_az,
+            0.8660254037844386 * cos_el_sq * (2.0 * az).cos(),
+            0.7905694150420949 * cos_el_sq * cos_el * (3.0 * az).sin(),
+            1.9364916731037085 * cos_el_sq * sin_el * (2.0 * az).sin(),
+            0.6123724356957945 * cos_el * (5.0 * sin_el_sq - 1.0) * sin_az,
+            0.5 * sin_el * (5.0 * sin_el_sq - 3.0),
+            0.6123724356957945 * cos_el * (5.0 * sin_el_sq - 1.0) * cos_az,
+            1.9364916731037085 * cos_el_sq * sin_el * (2.0 * az).cos(),
+            0.7905694150420949 * cos_el_sq * cos_el * (3.0 * az).cos(),
+        ]
+    }
+
+    #[test]
+    fn test_matches_closed_forms_through_third_order() {
+        for &(az, el) in &[(0.0, 0.0), (37.0, 12.0), (-120.0, -45.0), (90.0, 80.0)] {
+            let mut coeffs = [0.0; 16];
+            sn3d_coefficients(3, az, el, &mut coeffs);
+            for (acn, (&got, expected)) in coeffs.iter().zip(third_order(az, el)).enumerate() {
+                assert!(
+                    (got - expected).abs() < 1e-12,
+                    "ACN {acn} at ({az}, {el}): {got} != {expected}"
+                );
+            }
+        }
+    }
+
+    #[test]
+    fn test_fifth_order_degree_energy_and_zonal() {
+        let channels = ChannelLayout::ambisonic_channel_count(MAX_AMBISONIC_ORDER);
+        let mut coeffs = vec![0.0; channels];
+
+        // SN3D: the squares of each degree's components sum to 1 in any direction
+        sn3d_coefficients(MAX_AMBISONIC_ORDER, 73.0, -31.0, &mut coeffs);
+        for l in 0..=MAX_AMBISONIC_ORDER {
+            let energy: f64 = coeffs[l * l..(l + 1) * (l + 1)].iter().map(|c| c * c).sum();
+            assert!((energy - 1.0).abs() < 1e-9, "degree {l}: {energy}");
+        }
+
+        // Straight up, only the zonal (m = 0) components are non-zero
+        sn3d_coefficients(MAX_AMBISONIC_ORDER, 0.0, 90.0, &mut coeffs);
+        for (acn, &coeff) in coeffs.iter().enumerate() {
+            let l = acn.isqrt();
+            let expected = if acn == l * l + l { 1.0 } else { 0.0 };
+            assert!((coeff - expected).abs() < 1e-9, "ACN {acn}: {coeff}");
+        }
+    }
+}
@@ -18,7 +18,9 @@ use crate::{
     },
     channel::ChannelConfig,
     context::DspContext,
+    memory::MemoryFootprint,
     parameter::{ModulationOutput, Parameter},
+    precision::F64Block,
     sample::Sample,
 };
 
@@ -120,6 +122,29 @@ pub trait Block<S: Sample> {
     ///
     /// Default implementation is a no-op for stateless blocks.
     fn reset(&mut self) {}
+
+    /// Jump to `position` samples on the transport timeline.
+    ///
+    /// Returns `true` if the block's state now matches what continuous
+    /// playback up to `position` would have produced, as for stateless blocks
+    /// and those whose state is a function of time (oscillator phase, file
+    /// position). Returns `false` if state was only reset and needs audio to
+    /// settle, as for filter history.
+    ///
+    /// Default implementation calls [`reset`](Self::reset) and returns `false`.
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        self.reset();
+        false
+    }
+
+    /// Returns the memory this block holds, excluding the graph's audio buffers.
+    ///
+    /// Default implementation reports the block's inline size. Override to
+    /// add heap storage the block owns (`state`) or references alongside
+    /// other owners (`shared`).
+    fn memory_footprint(&self) -> MemoryFootprint {
+        MemoryFootprint::of(self)
+    }
 }
 
 /// Type-erased container for all block implementations.
@@ -172,6 +197,10 @@ pub enum BlockType<S: Sample> {
     Envelope(EnvelopeBlock<S>),
     /// Low-frequency oscillator for modulation.
     Lfo(LfoBlock<S>),
+
+    // MIXED PRECISION
+    /// Another block run in `f64`.
+    F64(F64Block<S>),
 }
 
 impl<S: Sample> BlockType<S> {
@@ -211,6 +240,9 @@ impl<S: Sample> BlockType<S> {
             // MODULATORS
             BlockType::Envelope(block) => block.process(inputs, outputs, modulation_values, context),
             BlockType::Lfo(block) => block.process(inputs, outputs, modulation_values, context),
+
+            // MIXED PRECISION
+            BlockType::F64(block) => block.process(inputs, outputs, modulation_values, context),
         }
     }
 
@@ -244,6 +276,9 @@ impl<S: Sample> BlockType<S> {
             // MODULATORS
             BlockType::Envelope(block) => block.input_count(),
             BlockType::Lfo(block) => block.input_count(),
+
+            // MIXED PRECISION
+            BlockType::F64(block) => block.input_count(),
         }
     }
 
@@ -277,6 +312,9 @@ impl<S: Sample> BlockType<S> {
             // MODULATORS
             BlockType::Envelope(block) => block.output_count(),
             BlockType::Lfo(block) => block.output_count(),
+
+            // MIXED PRECISION
+            BlockType::F64(block) => block.output_count(),
         }
     }
 
@@ -310,6 +348,9 @@ impl<S: Sample> BlockType<S> {
             // MODULATORS
             BlockType::Envelope(block) => block.modulation_outputs(),
             BlockType::Lfo(block) => block.modulation_outputs(),
+
+            // MIXED PRECISION
+            BlockType::F64(block) => block.modulation_outputs(),
         }
     }
 
@@ -343,6 +384,9 @@ impl<S: Sample> BlockType<S> {
             // MODULATORS
             BlockType::Envelope(block) => block.channel_config(),
             BlockType::Lfo(block) => block.channel_config(),
+
+            // MIXED PRECISION
+            BlockType::F64(block) => block.channel_config(),
         }
     }
 
@@ -355,6 +399,7 @@ impl<S: Sample> BlockType<S> {
             BlockType::Panner(block) => block.set_smoothing(sample_rate, ramp_time_ms),
             BlockType::Gain(block) => block.set_smoothing(sample_rate, ramp_time_ms),
             BlockType::Overdrive(block) => block.set_smoothing(sample_rate, ramp_time_ms),
+            BlockType::F64(block) => block.set_smoothing(sample_rate, ramp_time_ms),
             _ => {} // Blocks without smoothing use default no-op
         }
     }
@@ -391,6 +436,9 @@ impl<S: Sample> BlockType<S> {
             // MODULATORS
             BlockType::Envelope(block) => block.prepare(context),
             BlockType::Lfo(block) => block.prepare(context),
+
+            // MIXED PRECISION
+            BlockType::F64(block) => block.prepare(context),
         }
     }
 
@@ -426,6 +474,82 @@ impl<S: Sample> BlockType<S> {
             // MODULATORS
             BlockType::Envelope(block) => block.reset(),
             BlockType::Lfo(block) => block.reset(),
+
+            // MIXED PRECISION
+            BlockType::F64(block) => block.reset(),
+        }
+    }
+
+    /// Move the underlying `Block` to a transport position.
+    ///
+    /// Returns whether the block's state is exact at `position`; see
+    /// [`Block::seek`].
+    pub fn seek(&mut self, position: u64, context: &DspContext) -> bool {
+        match self {
+            // I/O
+            BlockType::FileInput(block) => block.seek(position, context),
+            BlockType::FileOutput(block) => block.seek(position, context),
+            BlockType::Output(block) => block.seek(position, context),
+
+            // GENERATORS
+            BlockType::Oscillator(block) => block.seek(position, context),
+
+            // EFFECTORS
+            BlockType::AmbisonicDecoder(block) => block.seek(position, context),
+            BlockType::BinauralDecoder(block) => block.seek(position, context),
+            BlockType::ChannelMerger(block) => block.seek(position, context),
+            BlockType::ChannelRouter(block) => block.seek(position, context),
+            BlockType::ChannelSplitter(block) => block.seek(position, context),
+            BlockType::DcBlocker(block) => block.seek(position, context),
+            BlockType::Gain(block) => block.seek(position, context),
+            BlockType::LowPassFilter(block) => block.seek(position, context),
+            BlockType::MatrixMixer(block) => block.seek(position, context),
+            BlockType::Mixer(block) => block.seek(position, context),
+            BlockType::Overdrive(block) => block.seek(position, context),
+            BlockType::Panner(block) => block.seek(position, context),
+            BlockType::Vca(block) => block.seek(position, context),
+
+            // MODULATORS
+            BlockType::Envelope(block) => block.seek(position, context),
+            BlockType::Lfo(block) => block.seek(position, context),
+
+            // MIXED PRECISION
+            BlockType::F64(block) => block.seek(position, context),
+        }
+    }
+
+    /// Get the memory footprint of the underlying `Block`.
+    pub fn memory_footprint(&self) -> MemoryFootprint {
+        match self {
+            // I/O
+            BlockType::FileInput(block) => block.memory_footprint(),
+            BlockType::FileOutput(block) => block.memory_footprint(),
+            BlockType::Output(block) => block.memory_footprint(),
+
+            // GENERATORS
+            BlockType::Oscillator(block) => block.memory_footprint(),
+
+            // EFFECTORS
+            BlockType::AmbisonicDecoder(block) => block.memory_footprint(),
+            BlockType::BinauralDecoder(block) => block.memory_footprint(),
+            BlockType::ChannelMerger(block) => block.memory_footprint(),
+            BlockType::ChannelRouter(block) => block.memory_footprint(),
+            BlockType::ChannelSplitter(block) => block.memory_footprint(),
+            BlockType::DcBlocker(block) => block.memory_footprint(),
+            BlockType::Gain(block) => block.memory_footprint(),
+            BlockType::LowPassFilter(block) => block.memory_footprint(),
+            BlockType::MatrixMixer(block) => block.memory_footprint(),
+            BlockType::Mixer(block) => block.memory_footprint(),
+            BlockType::Overdrive(block) => block.memory_footprint(),
+            BlockType::Panner(block) => block.memory_footprint(),
+            BlockType::Vca(block) => block.memory_footprint(),
+
+            // MODULATORS
+            BlockType::Envelope(block) => block.memory_footprint(),
+            BlockType::Lfo(block) => block.memory_footprint(),
+
+            // MIXED PRECISION
+            BlockType::F64(block) => block.memory_footprint(),
         }
     }
 
@@ -536,19 +660,28 @@ impl<S: Sample> BlockType<S> {
                 }
                 _ => Err(format!("Unknown LFO parameter: {parameter_name}")),
             },
+
+            // MIXED PRECISION
+            BlockType::F64(block) => block.set_parameter(parameter_name, parameter),
         }
     }
 
     /// Returns `true` if this block is a modulator (LFO or Envelope).
     #[inline]
     pub fn is_modulator(&self) -> bool {
-        matches!(self, BlockType::Envelope(_) | BlockType::Lfo(_))
+        match self {
+            BlockType::F64(block) => block.inner().is_modulator(),
+            _ => matches!(self, BlockType::Envelope(_) | BlockType::Lfo(_)),
+        }
     }
 
     /// Returns `true` if this block is an output-type block (Output or FileOutput).
     #[inline]
     pub fn is_output(&self) -> bool {
-        matches!(self, BlockType::Output(_) | BlockType::FileOutput(_))
+        match self {
+            BlockType::F64(block) => block.inner().is_output(),
+            _ => matches!(self, BlockType::Output(_) | BlockType::FileOutput(_)),
+        }
     }
 
     /// Returns the category of this block.
@@ -571,6 +704,7 @@ impl<S: Sample> BlockType<S> {
             | BlockType::Panner(_)
             | BlockType::Vca(_) => BlockCategory::Effector,
             BlockType::Envelope(_) | BlockType::Lfo(_) => BlockCategory::Modulator,
+            BlockType::F64(block) => block.inner().category(),
         }
     }
 
@@ -597,6 +731,7 @@ impl<S: Sample> BlockType<S> {
             BlockType::Vca(_) => "VCA",
             BlockType::Envelope(_) => "Envelope",
             BlockType::Lfo(_) => "LFO",
+            BlockType::F64(block) => block.inner().name(),
         }
     }
 
@@ -693,6 +828,8 @@ impl<S: Sample> BlockType<S> {
                     result.push(("depth", *id));
                 }
             }
+
+            BlockType::F64(block) => result = block.inner().get_modulated_parameters(),
         }
 
         result
@@ -818,3 +955,10 @@ impl<S: Sample> From<LfoBlock<S>> for BlockType<S> {
         BlockType::Lfo(block)
     }
 }
+
+// Mixed precision
+impl<S: Sample> From<F64Block<S>> for BlockType<S> {
+    fn from(block: F64Block<S>) -> Self {
+        BlockType::F64(block)
+    }
+}
@@ -3,10 +3,11 @@
 use std::marker::PhantomData;
 
 use crate::{
+    ambisonic::{MAX_AMBISONIC_ORDER, sn3d_coefficients},
     block::Block,
     channel::{ChannelConfig, ChannelLayout},
     context::DspContext,
-    graph::{MAX_BLOCK_INPUTS, MAX_BLOCK_OUTPUTS},
+    memory::MemoryFootprint,
     parameter::ModulationOutput,
     sample::Sample,
 };
@@ -17,7 +18,7 @@ use crate::{
 /// discrete speaker feeds using a mode-matching decoder.
 ///
 /// # Supported Configurations
-/// - Input: 1st order (4 ch), 2nd order (9 ch), or 3rd order (16 ch)
+/// - Input: 1st through 5th order (4, 9, 16, 25, or 36 ch)
 /// - Output: Stereo, 5.1, 7.1, or custom layouts
 ///
 /// # Example
@@ -26,7 +27,8 @@ use crate::{
 pub struct AmbisonicDecoderBlock<S: Sample> {
     input_order: usize,
     output_layout: ChannelLayout,
-    decoder_matrix: Box<[[f64; MAX_BLOCK_INPUTS]; MAX_BLOCK_OUTPUTS]>,
+    /// Speaker-major: the gains for speaker `s` start at `s * input_channel_count()`.
+    decoder_matrix: Box<[f64]>,
     _phantom: PhantomData<S>,
 }
 
@@ -34,18 +36,22 @@ impl<S: Sample> AmbisonicDecoderBlock<S> {
     /// Create a new ambisonic decoder.
     ///
     /// # Arguments
-    /// * `order` - Ambisonic order (1, 2, or 3)
+    /// * `order` - Ambisonic order (1 to 5)
     /// * `output_layout` - Target speaker layout
     ///
     /// # Panics
-    /// Panics if order is not 1, 2, or 3.
+    /// Panics if order is not between 1 and 5.
     pub fn new(order: usize, output_layout: ChannelLayout) -> Self {
-        assert!((1..=3).contains(&order), "Ambisonic order must be 1, 2, or 3");
+        assert!(
+            (1..=MAX_AMBISONIC_ORDER).contains(&order),
+            "Ambisonic order must be 1 to {MAX_AMBISONIC_ORDER}"
+        );
 
+        let num_gains = ChannelLayout::ambisonic_channel_count(order) * output_layout.channel_count();
         let mut decoder = Self {
             input_order: order,
             output_layout,
-            decoder_matrix: Box::new([[0.0; MAX_BLOCK_INPUTS]; MAX_BLOCK_OUTPUTS]),
+            decoder_matrix: vec![0.0; num_gains].into_boxed_slice(),
             _phantom: PhantomData,
         };
         decoder.compute_decoder_matrix();
@@ -64,19 +70,21 @@ impl<S: Sample> AmbisonicDecoderBlock<S> {
 
     fn compute_decoder_matrix(&mut self) {
         let speaker_positions = self.get_speaker_positions();
-        let num_speakers = self.output_layout.channel_count();
         let num_channels = self.input_channel_count();
 
-        for (spk, &(azimuth, elevation)) in speaker_positions.iter().enumerate().take(num_speakers) {
-            let coeffs = self.compute_sh_coefficients(azimuth, elevation);
-            self.decoder_matrix[spk][..num_channels].copy_from_slice(&coeffs[..num_channels]);
+        for (gains, &(azimuth, elevation)) in self
+            .decoder_matrix
+            .chunks_exact_mut(num_channels)
+            .zip(&speaker_positions)
+        {
+            sn3d_coefficients(self.input_order, azimuth, elevation, gains);
         }
 
         self.normalize_decoder_matrix();
     }
 
-    fn get_speaker_positions(&self) -> [(f64, f64); MAX_BLOCK_OUTPUTS] {
-        let mut positions = [(0.0, 0.0); MAX_BLOCK_OUTPUTS];
+    fn get_speaker_positions(&self) -> Vec<(f64, f64)> {
+        let mut positions = vec![(0.0, 0.0); self.output_layout.channel_count()];
 
         match self.output_layout {
             ChannelLayout::Mono => {
@@ -106,7 +114,7 @@ impl<S: Sample> AmbisonicDecoderBlock<S> {
             }
             ChannelLayout::Custom(n) => {
                 let angle_step = 360.0 / n as f64;
-                for (i, pos) in positions.iter_mut().enumerate().take(n) {
+                for (i, pos) in positions.iter_mut().enumerate() {
                     *pos = (i as f64 * angle_step - 90.0, 0.0);
                 }
             }
@@ -116,64 +124,8 @@ impl<S: Sample> AmbisonicDecoderBlock<S> {
         positions
     }
 
-    fn compute_sh_coefficients(&self, azimuth_deg: f64, elevation_deg: f64) -> [f64; MAX_BLOCK_INPUTS] {
-        let mut coeffs = [0.0; MAX_BLOCK_INPUTS];
-
-        let az = azimuth_deg.to_radians();
-        let el = elevation_deg.to_radians();
-
-        let cos_el = el.cos();
-        let sin_el = el.sin();
-        let cos_az = az.cos();
-        let sin_az = az.sin();
-
-        // Order 0 (W channel)
-        coeffs[0] = 1.0;
-
-        if self.input_order >= 1 {
-            // Order 1: Y, Z, X (ACN 1, 2, 3)
-            coeffs[1] = cos_el * sin_az; // Y
-            coeffs[2] = sin_el; // Z
-            coeffs[3] = cos_el * cos_az; // X
-        }
-
-        if self.input_order >= 2 {
-            // Order 2: ACN 4-8
-            let cos_2az = (2.0 * az).cos();
-            let sin_2az = (2.0 * az).sin();
-            let sin_2el = (2.0 * el).sin();
-            let cos_el_sq = cos_el * cos_el;
-
-            coeffs[4] = 0.8660254037844386 * cos_el_sq * sin_2az; // V
-            coeffs[5] = 0.8660254037844386 * sin_2el * sin_az; // T
-            coeffs[6] = 0.5 * (3.0 * sin_el * sin_el - 1.0); // R
-            coeffs[7] = 0.8660254037844386 * sin_2el * cos_az; // S
-            coeffs[8] = 0.8660254037844386 * cos_el_sq * cos_2az; // U
-        }
-
-        if self.input_order >= 3 {
-            // Order 3: ACN 9-15
-            let cos_3az = (3.0 * az).cos();
-            let sin_3az = (3.0 * az).sin();
-            let cos_el_sq = cos_el * cos_el;
-            let cos_el_cu = cos_el_sq * cos_el;
-            let sin_el_sq = sin_el * sin_el;
-
-            coeffs[9] = 0.7905694150420949 * cos_el_cu * sin_3az; // Q
-            coeffs[10] = 1.9364916731037085 * cos_el_sq * sin_el * (2.0 * az).sin(); // O
-            coeffs[11] = 0.6123724356957945 * cos_el * (5.0 * sin_el_sq - 1.0) * sin_az; // M
-            coeffs[12] = 0.5 * sin_el * (5.0 * sin_el_sq - 3.0); // K
-            coeffs[13] = 0.6123724356957945 * cos_el * (5.0 * sin_el_sq - 1.0) * cos_az; // L
-            coeffs[14] = 1.9364916731037085 * cos_el_sq * sin_el * (2.0 * az).cos(); // N
-            coeffs[15] = 0.7905694150420949 * cos_el_cu * cos_3az; // P
-        }
-
-        coeffs
-    }
-
     fn normalize_decoder_matrix(&mut self) {
         let num_speakers = self.output_layout.channel_count();
-        let num_channels = self.input_channel_count();
 
         if num_speakers == 0 {
             return;
@@ -181,10 +133,8 @@ impl<S: Sample> AmbisonicDecoderBlock<S> {
 
         let energy_scale = 1.0 / (num_speakers as f64).sqrt();
 
-        for spk in 0..num_speakers {
-            for ch in 0..num_channels {
-                self.decoder_matrix[spk][ch] *= energy_scale;
-            }
+        for gain in self.decoder_matrix.iter_mut() {
+            *gain *= energy_scale;
         }
     }
 
@@ -203,12 +153,14 @@ impl<S: Sample> Block<S> for AmbisonicDecoderBlock<S> {
         }
 
         let num_samples = inputs[0].len().min(outputs[0].len());
+        let num_channels = self.input_channel_count();
 
         for (out_ch, output) in outputs.iter_mut().enumerate().take(num_outputs) {
+            let gains = &self.decoder_matrix[out_ch * num_channels..][..num_inputs];
             for i in 0..num_samples {
                 let mut sum = 0.0f64;
-                for (in_ch, input) in inputs.iter().enumerate().take(num_inputs) {
-                    sum += input[i].to_f64() * self.decoder_matrix[out_ch][in_ch];
+                for (input, &gain) in inputs.iter().zip(gains) {
+                    sum += input[i].to_f64() * gain;
                 }
                 output[i] = S::from_f64(sum);
             }
@@ -234,6 +186,15 @@ impl<S: Sample> Block<S> for AmbisonicDecoderBlock<S> {
     fn channel_config(&self) -> ChannelConfig {
         ChannelConfig::Explicit
     }
+
+    fn memory_footprint(&self) -> MemoryFootprint {
+        MemoryFootprint::of(self).with_state(size_of_val(&*self.decoder_matrix))
+    }
+
+    #[inline]
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        true
+    }
 }
 
 #[cfg(test)]
@@ -246,6 +207,9 @@ mod tests {
             num_channels: 2,
             buffer_size: 4,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Stereo,
         }
     }
@@ -331,6 +295,31 @@ mod tests {
     #[test]
     #[should_panic]
     fn test_decoder_order_too_high_panics() {
-        let _ = AmbisonicDecoderBlock::<f32>::new(4, ChannelLayout::Stereo);
+        let _ = AmbisonicDecoderBlock::<f32>::new(6, ChannelLayout::Stereo);
+    }
+
+    #[test]
+    fn test_decoder_fifth_order_left_signal() {
+        let mut decoder = AmbisonicDecoderBlock::<f32>::new(5, ChannelLayout::Stereo);
+        assert_eq!(decoder.input_count(), 36);
+        let context = test_context();
+
+        // Encode a source hard left
+        let mut coeffs = [0.0; 36];
+        sn3d_coefficients(5, 90.0, 0.0, &mut coeffs);
+        let channels: Vec<[f32; 4]> = coeffs.iter().map(|&c| [c as f32; 4]).collect();
+        let inputs: Vec<&[f32]> = channels.iter().map(|c| c.as_slice()).collect();
+        let mut left_out = [0.0f32; 4];
+        let mut right_out = [0.0f32; 4];
+        let mut outputs: [&mut [f32]; 2] = [&mut left_out, &mut right_out];
+
+        decoder.process(&inputs, &mut outputs, &[], &context);
+
+        assert!(
+            left_out[0] > right_out[0],
+            "Left signal should be louder in left channel: L={}, R={}",
+            left_out[0],
+            right_out[0]
+        );
     }
 }
@@ -4,10 +4,11 @@
 //! to produce binaural stereo output.
 
 use super::{
+    MAX_INPUT_CHANNELS,
     hrir_data::{HRIR_LENGTH, get_hrir_for_azimuth},
     virtual_speaker::{MAX_HRIR_LENGTH, MAX_VIRTUAL_SPEAKERS, VirtualSpeaker, layouts},
 };
-use crate::{graph::MAX_BLOCK_INPUTS, sample::Sample};
+use crate::sample::Sample;
 
 /// HRTF convolution engine with pre-allocated buffers.
 ///
@@ -34,7 +35,7 @@ pub struct HrtfConvolver {
 #[derive(Clone)]
 struct VirtualSpeakerConfig {
     /// Spherical harmonic weights for decoding.
-    sh_weights: [f64; MAX_BLOCK_INPUTS],
+    sh_weights: [f64; MAX_INPUT_CHANNELS],
 
     /// Left ear HRIR (borrowed from static data).
     left_hrir: &'static [f32],
@@ -91,7 +92,7 @@ impl HrtfConvolver {
             let hrir = get_hrir_for_azimuth(azimuth);
 
             // For surround, each channel maps directly to a speaker (no SH decoding)
-            let mut sh_weights = [0.0; MAX_BLOCK_INPUTS];
+            let mut sh_weights = [0.0; MAX_INPUT_CHANNELS];
             sh_weights[i] = 1.0;
 
             speakers[i] = Some(VirtualSpeakerConfig {
@@ -140,7 +141,7 @@ impl HrtfConvolver {
 
         for sample_idx in 0..num_samples {
             // Decode input channels to f64 for processing
-            let mut input_samples = [0.0f64; MAX_BLOCK_INPUTS];
+            let mut input_samples = [0.0f64; MAX_INPUT_CHANNELS];
             for (ch, input) in inputs.iter().enumerate().take(num_input_channels) {
                 input_samples[ch] = input[sample_idx].to_f64();
             }
@@ -156,7 +157,7 @@ impl HrtfConvolver {
     ///
     /// Returns (left, right) output samples.
     #[inline]
-    fn process_sample(&mut self, inputs: &[f64; MAX_BLOCK_INPUTS], num_channels: usize) -> (f64, f64) {
+    fn process_sample(&mut self, inputs: &[f64; MAX_INPUT_CHANNELS], num_channels: usize) -> (f64, f64) {
         let mut left_sum = 0.0f64;
         let mut right_sum = 0.0f64;
 
@@ -188,9 +189,9 @@ impl HrtfConvolver {
     #[inline]
     fn decode_to_speaker(
         &self,
-        inputs: &[f64; MAX_BLOCK_INPUTS],
+        inputs: &[f64; MAX_INPUT_CHANNELS],
         num_channels: usize,
-        sh_weights: &[f64; MAX_BLOCK_INPUTS],
+        sh_weights: &[f64; MAX_INPUT_CHANNELS],
     ) -> f64 {
         let mut sum = 0.0;
         for ch in 0..num_channels {
@@ -1,13 +1,13 @@
 //! Matrix-based binaural decoder using ILD (Interaural Level Difference) approximation.
 
-use crate::graph::MAX_BLOCK_INPUTS;
+use super::MAX_INPUT_CHANNELS;
 
 /// Compute matrix decoder coefficients for the given ambisonic order.
 ///
 /// Returns a 2×N matrix where N is the number of ambisonic channels.
 /// Row 0 is left ear, row 1 is right ear.
-pub fn compute_matrix(order: usize) -> [[f64; MAX_BLOCK_INPUTS]; 2] {
-    let mut matrix = [[0.0; MAX_BLOCK_INPUTS]; 2];
+pub fn compute_matrix(order: usize) -> [[f64; MAX_INPUT_CHANNELS]; 2] {
+    let mut matrix = [[0.0; MAX_INPUT_CHANNELS]; 2];
 
     match order {
         1 => compute_foa_matrix(&mut matrix),
@@ -20,7 +20,7 @@ pub fn compute_matrix(order: usize) -> [[f64; MAX_BLOCK_INPUTS]; 2] {
     matrix
 }
 
-fn compute_foa_matrix(matrix: &mut [[f64; MAX_BLOCK_INPUTS]; 2]) {
+fn compute_foa_matrix(matrix: &mut [[f64; MAX_INPUT_CHANNELS]; 2]) {
     // ACN ordering: W(0), Y(1), Z(2), X(3)
     // Y is the lateral channel (positive = left, negative = right)
     // X is front-back (positive = front)
@@ -39,7 +39,7 @@ fn compute_foa_matrix(matrix: &mut [[f64; MAX_BLOCK_INPUTS]; 2]) {
     matrix[1][3] = 0.35; // X
 }
 
-fn compute_soa_matrix(matrix: &mut [[f64; MAX_BLOCK_INPUTS]; 2]) {
+fn compute_soa_matrix(matrix: &mut [[f64; MAX_INPUT_CHANNELS]; 2]) {
     // Start with scaled FOA components
     matrix[0][0] = 0.45; // W
     matrix[0][1] = 0.45; // Y
@@ -65,7 +65,7 @@ fn compute_soa_matrix(matrix: &mut [[f64; MAX_BLOCK_INPUTS]; 2]) {
     matrix[1][8] = 0.15;
 }
 
-fn compute_toa_matrix(matrix: &mut [[f64; MAX_BLOCK_INPUTS]; 2]) {
+fn compute_toa_matrix(matrix: &mut [[f64; MAX_INPUT_CHANNELS]; 2]) {
     // Left ear coefficients for all 16 channels
     let left: [f64; 16] = [
         // Order 0-1
@@ -86,7 +86,7 @@ fn compute_toa_matrix(matrix: &mut [[f64; MAX_BLOCK_INPUTS]; 2]) {
     matrix[1].copy_from_slice(&right);
 }
 
-fn normalize_matrix(matrix: &mut [[f64; MAX_BLOCK_INPUTS]; 2], order: usize) {
+fn normalize_matrix(matrix: &mut [[f64; MAX_INPUT_CHANNELS]; 2], order: usize) {
     let energy_scale = 1.0 / 2.0_f64.sqrt();
     let num_channels = (order + 1) * (order + 1);
 
@@ -118,7 +118,7 @@ mod tests {
             );
         }
 
-        for ch in num_channels..MAX_BLOCK_INPUTS {
+        for ch in num_channels..MAX_INPUT_CHANNELS {
             assert!(
                 matrix[0][ch].abs() < EPSILON && matrix[1][ch].abs() < EPSILON,
                 "Channel {ch} should be zero for FOA"
@@ -178,7 +178,7 @@ mod tests {
             );
         }
 
-        for ch in num_channels..MAX_BLOCK_INPUTS {
+        for ch in num_channels..MAX_INPUT_CHANNELS {
             assert!(
                 matrix[0][ch].abs() < EPSILON && matrix[1][ch].abs() < EPSILON,
                 "Channel {ch} should be zero for SOA"
@@ -269,15 +269,15 @@ mod tests {
     #[test]
     fn matrix_has_max_block_inputs_columns() {
         let matrix = compute_matrix(1);
-        assert_eq!(matrix[0].len(), MAX_BLOCK_INPUTS);
-        assert_eq!(matrix[1].len(), MAX_BLOCK_INPUTS);
+        assert_eq!(matrix[0].len(), MAX_INPUT_CHANNELS);
+        assert_eq!(matrix[1].len(), MAX_INPUT_CHANNELS);
     }
 
     // ==================== normalization tests ====================
 
     #[test]
     fn normalization_applies_energy_scale() {
-        let mut matrix = [[0.0; MAX_BLOCK_INPUTS]; 2];
+        let mut matrix = [[0.0; MAX_INPUT_CHANNELS]; 2];
         matrix[0][0] = 1.0;
         matrix[1][0] = 1.0;
 
@@ -289,8 +289,8 @@ mod tests {
 
     #[test]
     fn normalization_only_affects_relevant_channels() {
-        let mut matrix = [[0.0; MAX_BLOCK_INPUTS]; 2];
-        for i in 0..MAX_BLOCK_INPUTS {
+        let mut matrix = [[0.0; MAX_INPUT_CHANNELS]; 2];
+        for i in 0..MAX_INPUT_CHANNELS {
             matrix[0][i] = 1.0;
             matrix[1][i] = 1.0;
         }
@@ -303,7 +303,7 @@ mod tests {
                 "Channel {i} should be normalized"
             );
         }
-        for i in 4..MAX_BLOCK_INPUTS {
+        for i in 4..MAX_INPUT_CHANNELS {
             assert!(
                 (matrix[0][i] - 1.0).abs() < EPSILON,
                 "Channel {i} should not be normalized"
@@ -16,10 +16,16 @@ use std::marker::PhantomData;
 use hrtf::HrtfConvolver;
 
 use crate::{
-    block::Block, channel::ChannelConfig, context::DspContext, graph::MAX_BLOCK_INPUTS, parameter::ModulationOutput,
+    block::Block, channel::ChannelConfig, context::DspContext, memory::MemoryFootprint, parameter::ModulationOutput,
     sample::Sample,
 };
 
+/// Maximum number of input channels: third-order ambisonics (16 channels).
+///
+/// Kept separate from the graph's block I/O limits, since the HRTF path
+/// decodes through eight virtual speakers, which can't resolve higher orders.
+const MAX_INPUT_CHANNELS: usize = 16;
+
 /// Binaural decoding strategy.
 ///
 /// Determines how multi-channel audio is converted to binaural stereo.
@@ -70,7 +76,7 @@ impl Default for BinauralStrategy {
 pub struct BinauralDecoderBlock<S: Sample> {
     input_count: usize,
     strategy: BinauralStrategy,
-    decoder_matrix: [[f64; MAX_BLOCK_INPUTS]; 2],
+    decoder_matrix: [[f64; MAX_INPUT_CHANNELS]; 2],
     hrtf_convolver: Option<Box<HrtfConvolver>>,
     _phantom: PhantomData<S>,
 }
@@ -129,7 +135,7 @@ impl<S: Sample> BinauralDecoderBlock<S> {
             "Surround channel count must be 6 (5.1) or 8 (7.1)"
         );
 
-        let decoder_matrix = [[0.0; MAX_BLOCK_INPUTS]; 2];
+        let decoder_matrix = [[0.0; MAX_INPUT_CHANNELS]; 2];
 
         let hrtf_convolver = match strategy {
             BinauralStrategy::Matrix => None,
@@ -242,6 +248,18 @@ impl<S: Sample> Block<S> for BinauralDecoderBlock<S> {
             convolver.reset();
         }
     }
+
+    /// HRIR tables are static data and aren't counted.
+    fn memory_footprint(&self) -> MemoryFootprint {
+        let convolver = self.hrtf_convolver.as_deref().map_or(0, size_of_val);
+        MemoryFootprint::of(self).with_state(convolver)
+    }
+
+    /// The matrix strategy is stateless; HRTF convolution history is reset.
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        self.reset();
+        self.hrtf_convolver.is_none()
+    }
 }
 
 #[cfg(test)]
@@ -255,6 +273,9 @@ mod tests {
             num_channels: 2,
             buffer_size: 4,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Stereo,
         }
     }
@@ -3,7 +3,7 @@
 //! A virtual speaker represents a point source at a specific position,
 //! with associated HRIR filters for left and right ears.
 
-use crate::graph::MAX_BLOCK_INPUTS;
+use super::MAX_INPUT_CHANNELS;
 
 /// Maximum HRIR length in samples (512 samples at 48kHz ≈ 10.7ms).
 pub const MAX_HRIR_LENGTH: usize = 512;
@@ -20,7 +20,7 @@ pub const MAX_VIRTUAL_SPEAKERS: usize = 8;
 pub struct VirtualSpeaker {
     /// Spherical harmonic weights for decoding B-format to this speaker.
     /// Indexed by ACN channel order.
-    pub sh_weights: [f64; MAX_BLOCK_INPUTS],
+    pub sh_weights: [f64; MAX_INPUT_CHANNELS],
 
     /// Left ear HRIR coefficients.
     pub left_hrir: &'static [f32],
@@ -57,8 +57,8 @@ impl VirtualSpeaker {
 /// Compute spherical harmonic coefficients for a given direction.
 ///
 /// Uses ACN channel ordering and SN3D normalization.
-fn compute_sh_coefficients(azimuth_deg: f64, elevation_deg: f64, order: usize) -> [f64; MAX_BLOCK_INPUTS] {
-    let mut coeffs = [0.0; MAX_BLOCK_INPUTS];
+fn compute_sh_coefficients(azimuth_deg: f64, elevation_deg: f64, order: usize) -> [f64; MAX_INPUT_CHANNELS] {
+    let mut coeffs = [0.0; MAX_INPUT_CHANNELS];
 
     let az = azimuth_deg.to_radians();
     let el = elevation_deg.to_radians();
@@ -135,7 +135,7 @@ fn compute_max_re_weights(order: usize) -> [f64; 4] {
 ///
 /// This variant applies max-rE weights to improve perceived localization
 /// when decoding ambisonics to a finite speaker array.
-fn compute_sh_coefficients_max_re(azimuth_deg: f64, elevation_deg: f64, order: usize) -> [f64; MAX_BLOCK_INPUTS] {
+fn compute_sh_coefficients_max_re(azimuth_deg: f64, elevation_deg: f64, order: usize) -> [f64; MAX_INPUT_CHANNELS] {
     let mut coeffs = compute_sh_coefficients(azimuth_deg, elevation_deg, order);
     let weights = compute_max_re_weights(order);
 
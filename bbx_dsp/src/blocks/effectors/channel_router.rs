@@ -146,6 +146,11 @@ impl<S: Sample> Block<S> for ChannelRouterBlock<S> {
     fn channel_config(&self) -> ChannelConfig {
         ChannelConfig::Explicit
     }
+
+    #[inline]
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        true
+    }
 }
 
 #[cfg(test)]
@@ -159,6 +164,9 @@ mod tests {
             num_channels: 2,
             buffer_size,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Stereo,
         }
     }
@@ -24,7 +24,7 @@ impl<S: Sample> ChannelSplitterBlock<S> {
     /// Create a new channel splitter for the given number of channels.
     ///
     /// # Panics
-    /// Panics if `channels` is 0 or greater than `MAX_BLOCK_OUTPUTS` (16).
+    /// Panics if `channels` is 0 or greater than `MAX_BLOCK_OUTPUTS` (64).
     pub fn new(channels: usize) -> Self {
         assert!(channels > 0 && channels <= MAX_BLOCK_OUTPUTS);
         Self {
@@ -71,6 +71,11 @@ impl<S: Sample> Block<S> for ChannelSplitterBlock<S> {
     fn channel_config(&self) -> ChannelConfig {
         ChannelConfig::Explicit
     }
+
+    #[inline]
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        true
+    }
 }
 
 #[cfg(test)]
@@ -84,6 +89,9 @@ mod tests {
             num_channels: 2,
             buffer_size: 4,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Stereo,
         }
     }
@@ -124,6 +132,6 @@ mod tests {
     #[test]
     #[should_panic]
     fn test_channel_splitter_too_many_channels_panics() {
-        let _ = ChannelSplitterBlock::<f32>::new(17);
+        let _ = ChannelSplitterBlock::<f32>::new(MAX_BLOCK_OUTPUTS + 1);
     }
 }
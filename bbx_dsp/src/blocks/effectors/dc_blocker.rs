@@ -8,6 +8,7 @@ use crate::{
     block::{Block, DEFAULT_EFFECTOR_INPUT_COUNT, DEFAULT_EFFECTOR_OUTPUT_COUNT},
     context::DspContext,
     graph::MAX_BLOCK_OUTPUTS,
+    memory::MemoryFootprint,
     parameter::ModulationOutput,
     sample::Sample,
 };
@@ -19,8 +20,8 @@ pub struct DcBlockerBlock<S: Sample> {
     /// Whether the DC blocker is enabled.
     pub enabled: bool,
 
-    x_prev: [f64; MAX_BLOCK_OUTPUTS],
-    y_prev: [f64; MAX_BLOCK_OUTPUTS],
+    x_prev: Box<[f64; MAX_BLOCK_OUTPUTS]>,
+    y_prev: Box<[f64; MAX_BLOCK_OUTPUTS]>,
 
     // Filter coefficient (~0.995 for 5Hz at 44.1kHz)
     coeff: f64,
@@ -33,8 +34,8 @@ impl<S: Sample> DcBlockerBlock<S> {
     pub fn new(enabled: bool) -> Self {
         Self {
             enabled,
-            x_prev: [0.0; MAX_BLOCK_OUTPUTS],
-            y_prev: [0.0; MAX_BLOCK_OUTPUTS],
+            x_prev: Box::new([0.0; MAX_BLOCK_OUTPUTS]),
+            y_prev: Box::new([0.0; MAX_BLOCK_OUTPUTS]),
             coeff: 0.995, // Will be recalculated on prepare
             _phantom: PhantomData,
         }
@@ -52,8 +53,8 @@ impl<S: Sample> DcBlockerBlock<S> {
 
     /// Reset the filter state.
     pub fn reset(&mut self) {
-        self.x_prev = [0.0; MAX_BLOCK_OUTPUTS];
-        self.y_prev = [0.0; MAX_BLOCK_OUTPUTS];
+        self.x_prev.fill(0.0);
+        self.y_prev.fill(0.0);
     }
 }
 
@@ -105,14 +106,18 @@ impl<S: Sample> Block<S> for DcBlockerBlock<S> {
         &[]
     }
 
+    fn memory_footprint(&self) -> MemoryFootprint {
+        MemoryFootprint::of(self).with_state(size_of_val(&*self.x_prev) + size_of_val(&*self.y_prev))
+    }
+
     fn prepare(&mut self, context: &DspContext) {
         self.set_sample_rate(context.sample_rate);
         self.reset();
     }
 
     fn reset(&mut self) {
-        self.x_prev = [0.0; MAX_BLOCK_OUTPUTS];
-        self.y_prev = [0.0; MAX_BLOCK_OUTPUTS];
+        self.x_prev.fill(0.0);
+        self.y_prev.fill(0.0);
     }
 }
 
@@ -127,6 +132,9 @@ mod tests {
             num_channels: 6,
             buffer_size,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Surround51,
         }
     }
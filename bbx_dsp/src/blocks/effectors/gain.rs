@@ -133,6 +133,17 @@ impl<S: Sample> Block<S> for GainBlock<S> {
     fn prepare(&mut self, context: &DspContext) {
         self.gain_smoother.reset(context.sample_rate, 10.0);
     }
+
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        match self.level_db {
+            Parameter::Constant(level_db) => {
+                let gain = S::from_f64(Self::db_to_linear(level_db.to_f64()));
+                self.gain_smoother.set_immediate(gain);
+                true
+            }
+            Parameter::Modulated(_) => false,
+        }
+    }
 }
 
 #[cfg(test)]
@@ -146,6 +157,9 @@ mod tests {
             num_channels: 2,
             buffer_size,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Stereo,
         }
     }
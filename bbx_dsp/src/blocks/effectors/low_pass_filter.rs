@@ -6,6 +6,7 @@ use crate::{
     block::{Block, DEFAULT_EFFECTOR_INPUT_COUNT, DEFAULT_EFFECTOR_OUTPUT_COUNT},
     context::DspContext,
     graph::MAX_BLOCK_OUTPUTS,
+    memory::MemoryFootprint,
     parameter::{ModulationOutput, Parameter},
     sample::Sample,
 };
@@ -25,8 +26,8 @@ pub struct LowPassFilterBlock<S: Sample> {
     /// Resonance (Q factor, 0.5-10.0, default 0.707 = Butterworth).
     pub resonance: Parameter<S>,
 
-    ic1eq: [f64; MAX_BLOCK_OUTPUTS],
-    ic2eq: [f64; MAX_BLOCK_OUTPUTS],
+    ic1eq: Box<[f64; MAX_BLOCK_OUTPUTS]>,
+    ic2eq: Box<[f64; MAX_BLOCK_OUTPUTS]>,
 }
 
 impl<S: Sample> LowPassFilterBlock<S> {
@@ -40,8 +41,8 @@ impl<S: Sample> LowPassFilterBlock<S> {
         Self {
             cutoff: Parameter::Constant(S::from_f64(cutoff)),
             resonance: Parameter::Constant(S::from_f64(resonance)),
-            ic1eq: [0.0; MAX_BLOCK_OUTPUTS],
-            ic2eq: [0.0; MAX_BLOCK_OUTPUTS],
+            ic1eq: Box::new([0.0; MAX_BLOCK_OUTPUTS]),
+            ic2eq: Box::new([0.0; MAX_BLOCK_OUTPUTS]),
         }
     }
 }
@@ -126,13 +127,17 @@ impl<S: Sample> Block<S> for LowPassFilterBlock<S> {
         &[]
     }
 
+    fn memory_footprint(&self) -> MemoryFootprint {
+        MemoryFootprint::of(self).with_state(size_of_val(&*self.ic1eq) + size_of_val(&*self.ic2eq))
+    }
+
     fn prepare(&mut self, _context: &DspContext) {
         self.reset();
     }
 
     fn reset(&mut self) {
-        self.ic1eq = [0.0; MAX_BLOCK_OUTPUTS];
-        self.ic2eq = [0.0; MAX_BLOCK_OUTPUTS];
+        self.ic1eq.fill(0.0);
+        self.ic2eq.fill(0.0);
     }
 }
 
@@ -147,6 +152,9 @@ mod tests {
             num_channels: 6,
             buffer_size,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Surround51,
         }
     }
@@ -267,6 +275,9 @@ mod tests {
             num_channels: 6,
             buffer_size: 64,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Surround51,
         };
         filter.prepare(&new_context);
@@ -5,6 +5,7 @@ use crate::{
     channel::ChannelConfig,
     context::DspContext,
     graph::{MAX_BLOCK_INPUTS, MAX_BLOCK_OUTPUTS},
+    memory::MemoryFootprint,
     parameter::ModulationOutput,
     sample::Sample,
 };
@@ -21,7 +22,8 @@ use crate::{
 pub struct MatrixMixerBlock<S: Sample> {
     num_inputs: usize,
     num_outputs: usize,
-    gains: [[S; MAX_BLOCK_INPUTS]; MAX_BLOCK_OUTPUTS],
+    /// Output-major: the gains for output `o` start at `o * num_inputs`.
+    gains: Box<[S]>,
 }
 
 impl<S: Sample> MatrixMixerBlock<S> {
@@ -30,14 +32,15 @@ impl<S: Sample> MatrixMixerBlock<S> {
     /// All gains are initialized to zero.
     ///
     /// # Panics
-    /// Panics if `inputs` or `outputs` is 0 or greater than 16.
+    /// Panics if `inputs` is 0 or greater than `MAX_BLOCK_INPUTS` (64), or
+    /// `outputs` is 0 or greater than `MAX_BLOCK_OUTPUTS` (64).
     pub fn new(inputs: usize, outputs: usize) -> Self {
         assert!(inputs > 0 && inputs <= MAX_BLOCK_INPUTS);
         assert!(outputs > 0 && outputs <= MAX_BLOCK_OUTPUTS);
         Self {
             num_inputs: inputs,
             num_outputs: outputs,
-            gains: [[S::ZERO; MAX_BLOCK_INPUTS]; MAX_BLOCK_OUTPUTS],
+            gains: vec![S::ZERO; inputs * outputs].into_boxed_slice(),
         }
     }
 
@@ -47,11 +50,11 @@ impl<S: Sample> MatrixMixerBlock<S> {
     /// with unity gain. Requires `inputs == outputs`.
     ///
     /// # Panics
-    /// Panics if `channels` is 0 or greater than 16.
+    /// Panics if `channels` is 0 or greater than 64.
     pub fn identity(channels: usize) -> Self {
         let mut mixer = Self::new(channels, channels);
         for ch in 0..channels {
-            mixer.gains[ch][ch] = S::ONE;
+            mixer.gains[ch * channels + ch] = S::ONE;
         }
         mixer
     }
@@ -68,7 +71,7 @@ impl<S: Sample> MatrixMixerBlock<S> {
     pub fn set_gain(&mut self, input: usize, output: usize, gain: S) {
         assert!(input < self.num_inputs);
         assert!(output < self.num_outputs);
-        self.gains[output][input] = gain;
+        self.gains[output * self.num_inputs + input] = gain;
     }
 
     /// Get the gain for a specific input-to-output routing.
@@ -78,7 +81,7 @@ impl<S: Sample> MatrixMixerBlock<S> {
     pub fn get_gain(&self, input: usize, output: usize) -> S {
         assert!(input < self.num_inputs);
         assert!(output < self.num_outputs);
-        self.gains[output][input]
+        self.gains[output * self.num_inputs + input]
     }
 
     /// Returns the number of input channels.
@@ -103,11 +106,15 @@ impl<S: Sample> Block<S> for MatrixMixerBlock<S> {
 
         let num_samples = inputs[0].len().min(outputs[0].len());
 
-        for (out_ch, output) in outputs.iter_mut().enumerate().take(num_outputs) {
+        for (output, gains) in outputs
+            .iter_mut()
+            .take(num_outputs)
+            .zip(self.gains.chunks_exact(self.num_inputs))
+        {
             for i in 0..num_samples {
                 let mut sum = S::ZERO;
-                for (in_ch, input) in inputs.iter().enumerate().take(num_inputs) {
-                    sum += input[i] * self.gains[out_ch][in_ch];
+                for (input, &gain) in inputs.iter().zip(&gains[..num_inputs]) {
+                    sum += input[i] * gain;
                 }
                 output[i] = sum;
             }
@@ -133,6 +140,15 @@ impl<S: Sample> Block<S> for MatrixMixerBlock<S> {
     fn channel_config(&self) -> ChannelConfig {
         ChannelConfig::Explicit
     }
+
+    fn memory_footprint(&self) -> MemoryFootprint {
+        MemoryFootprint::of(self).with_state(size_of_val(&*self.gains))
+    }
+
+    #[inline]
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        true
+    }
 }
 
 #[cfg(test)]
@@ -146,6 +162,9 @@ mod tests {
             num_channels: 2,
             buffer_size: 4,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Stereo,
         }
     }
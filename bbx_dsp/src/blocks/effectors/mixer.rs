@@ -47,7 +47,7 @@ impl<S: Sample> MixerBlock<S> {
     /// * `num_channels` - Number of output channels (e.g., 2 for stereo)
     ///
     /// # Panics
-    /// Panics if the total input count exceeds MAX_BLOCK_INPUTS (16).
+    /// Panics if the total input count exceeds MAX_BLOCK_INPUTS (64).
     pub fn new(num_sources: usize, num_channels: usize) -> Self {
         assert!(num_sources > 0, "Must have at least one source");
         assert!(num_channels > 0, "Must have at least one channel");
@@ -140,6 +140,11 @@ impl<S: Sample> Block<S> for MixerBlock<S> {
     fn channel_config(&self) -> ChannelConfig {
         ChannelConfig::Explicit
     }
+
+    #[inline]
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        true
+    }
 }
 
 #[cfg(test)]
@@ -153,6 +158,9 @@ mod tests {
             num_channels: 2,
             buffer_size: 4,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Stereo,
         }
     }
@@ -304,6 +312,6 @@ mod tests {
     #[test]
     #[should_panic(expected = "exceeds MAX_BLOCK_INPUTS")]
     fn test_mixer_exceeds_max_inputs_panics() {
-        let _ = MixerBlock::<f32>::new(9, 2); // 9*2 = 18 > 16
+        let _ = MixerBlock::<f32>::new(33, 2); // 33*2 = 66 > 64
     }
 }
@@ -6,6 +6,7 @@ use crate::{
     block::{Block, DEFAULT_EFFECTOR_INPUT_COUNT, DEFAULT_EFFECTOR_OUTPUT_COUNT},
     context::DspContext,
     graph::MAX_BLOCK_OUTPUTS,
+    memory::MemoryFootprint,
     parameter::{ModulationOutput, Parameter},
     sample::Sample,
     smoothing::LinearSmoothedValue,
@@ -27,7 +28,7 @@ pub struct OverdriveBlock<S: Sample> {
     pub level: Parameter<S>,
 
     tone: f64,
-    filter_state: [f64; MAX_BLOCK_OUTPUTS],
+    filter_state: Box<[f64; MAX_BLOCK_OUTPUTS]>,
     filter_coefficient: f64,
 
     /// Smoothed drive value for click-free changes.
@@ -45,7 +46,7 @@ impl<S: Sample> OverdriveBlock<S> {
             drive: Parameter::Constant(S::from_f64(drive)),
             level: Parameter::Constant(S::from_f64(level)),
             tone,
-            filter_state: [0.0; MAX_BLOCK_OUTPUTS],
+            filter_state: Box::new([0.0; MAX_BLOCK_OUTPUTS]),
             filter_coefficient: 0.0,
             drive_smoother: LinearSmoothedValue::new(S::from_f64(drive)),
             level_smoother: LinearSmoothedValue::new(S::from_f64(level_val)),
@@ -135,6 +136,10 @@ impl<S: Sample> Block<S> for OverdriveBlock<S> {
         &[]
     }
 
+    fn memory_footprint(&self) -> MemoryFootprint {
+        MemoryFootprint::of(self).with_state(size_of_val(&*self.filter_state))
+    }
+
     fn set_smoothing(&mut self, sample_rate: f64, ramp_time_ms: f64) {
         self.drive_smoother.reset(sample_rate, ramp_time_ms);
         self.level_smoother.reset(sample_rate, ramp_time_ms);
@@ -148,7 +153,21 @@ impl<S: Sample> Block<S> for OverdriveBlock<S> {
     }
 
     fn reset(&mut self) {
-        self.filter_state = [0.0; MAX_BLOCK_OUTPUTS];
+        self.filter_state.fill(0.0);
+    }
+
+    /// Settles the smoothers on constant parameters; the tone filter's
+    /// history is reset and needs audio to settle.
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        if let Parameter::Constant(drive) = self.drive {
+            self.drive_smoother.set_immediate(drive);
+        }
+        if let Parameter::Constant(level) = self.level {
+            self.level_smoother
+                .set_immediate(S::from_f64(level.to_f64().clamp(0.0, 1.0)));
+        }
+        self.reset();
+        false
     }
 }
 
@@ -163,6 +182,9 @@ mod tests {
             num_channels: 6,
             buffer_size,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Surround51,
         }
     }
@@ -8,6 +8,7 @@ use std::simd::{StdFloat, f64x4, num::SimdFloat};
 #[cfg(feature = "simd")]
 use crate::sample::SIMD_LANES;
 use crate::{
+    ambisonic::sn3d_coefficients,
     block::Block,
     channel::{ChannelConfig, ChannelLayout},
     context::DspContext,
@@ -20,6 +21,9 @@ use crate::{
 /// Maximum buffer size for stack-allocated gain arrays.
 const MAX_BUFFER_SIZE: usize = 4096;
 
+/// Maximum number of speakers in a surround layout (7.1).
+const MAX_SURROUND_SPEAKERS: usize = 8;
+
 /// Panning mode determining the algorithm and output format.
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
 pub enum PannerMode {
@@ -44,7 +48,7 @@ pub enum PannerMode {
 ///
 /// # Ambisonic Mode
 /// Encodes mono input to SN3D normalized, ACN ordered B-format.
-/// Supports 1st through 3rd order (4, 9, or 16 channels).
+/// Supports 1st through 5th order (4, 9, 16, 25, or 36 channels).
 pub struct PannerBlock<S: Sample> {
     /// Pan position: -100 (left) to +100 (right). Used in stereo mode.
     pub position: Parameter<S>,
@@ -64,7 +68,7 @@ pub struct PannerBlock<S: Sample> {
     azimuth_smoother: LinearSmoothedValue<S>,
     elevation_smoother: LinearSmoothedValue<S>,
 
-    speaker_azimuths: [f64; MAX_BLOCK_OUTPUTS],
+    speaker_azimuths: [f64; MAX_SURROUND_SPEAKERS],
 }
 
 impl<S: Sample> PannerBlock<S> {
@@ -85,7 +89,7 @@ impl<S: Sample> PannerBlock<S> {
             position_smoother: LinearSmoothedValue::new(pos),
             azimuth_smoother: LinearSmoothedValue::new(S::ZERO),
             elevation_smoother: LinearSmoothedValue::new(S::ZERO),
-            speaker_azimuths: [0.0; MAX_BLOCK_OUTPUTS],
+            speaker_azimuths: [0.0; MAX_SURROUND_SPEAKERS],
         }
     }
 
@@ -108,17 +112,18 @@ impl<S: Sample> PannerBlock<S> {
             position_smoother: LinearSmoothedValue::new(S::ZERO),
             azimuth_smoother: LinearSmoothedValue::new(S::ZERO),
             elevation_smoother: LinearSmoothedValue::new(S::ZERO),
-            speaker_azimuths: [0.0; MAX_BLOCK_OUTPUTS],
+            speaker_azimuths: [0.0; MAX_SURROUND_SPEAKERS],
         };
         panner.initialize_speaker_positions();
         panner
     }
 
-    /// Create an ambisonic encoder for the given order (1-3).
+    /// Create an ambisonic encoder for the given order (1-5).
     ///
     /// - Order 1: First-order ambisonics (4 channels: W, Y, Z, X)
     /// - Order 2: Second-order ambisonics (9 channels)
     /// - Order 3: Third-order ambisonics (16 channels)
+    /// - Orders 4 and 5: Higher-order ambisonics (25 or 36 channels)
     ///
     /// Uses SN3D normalization and ACN channel ordering.
     pub fn new_ambisonic(order: usize) -> Self {
@@ -133,7 +138,7 @@ impl<S: Sample> PannerBlock<S> {
             position_smoother: LinearSmoothedValue::new(S::ZERO),
             azimuth_smoother: LinearSmoothedValue::new(S::ZERO),
             elevation_smoother: LinearSmoothedValue::new(S::ZERO),
-            speaker_azimuths: [0.0; MAX_BLOCK_OUTPUTS],
+            speaker_azimuths: [0.0; MAX_SURROUND_SPEAKERS],
         }
     }
 
@@ -178,8 +183,8 @@ impl<S: Sample> PannerBlock<S> {
     }
 
     /// Calculate VBAP gains for surround panning.
-    fn calculate_vbap_gains(&self, azimuth_deg: f64, _elevation_deg: f64, gains: &mut [f64; MAX_BLOCK_OUTPUTS]) {
-        let num_speakers = self.output_layout.channel_count();
+    fn calculate_vbap_gains(&self, azimuth_deg: f64, _elevation_deg: f64, gains: &mut [f64; MAX_SURROUND_SPEAKERS]) {
+        let num_speakers = self.output_layout.channel_count().min(MAX_SURROUND_SPEAKERS);
         let azimuth_rad = azimuth_deg.to_radians();
 
         for (i, gain) in gains.iter_mut().enumerate().take(num_speakers) {
@@ -220,57 +225,10 @@ impl<S: Sample> PannerBlock<S> {
     }
 
     /// Calculate SN3D normalized spherical harmonic coefficients for ambisonic encoding.
-    fn calculate_ambisonic_gains(&self, azimuth_deg: f64, elevation_deg: f64, gains: &mut [f64; MAX_BLOCK_OUTPUTS]) {
-        let az = azimuth_deg.to_radians();
-        let el = elevation_deg.to_radians();
-
-        let cos_el = el.cos();
-        let sin_el = el.sin();
-        let cos_az = az.cos();
-        let sin_az = az.sin();
-
+    #[inline]
+    fn calculate_ambisonic_gains(&self, azimuth_deg: f64, elevation_deg: f64, gains: &mut [f64]) {
         let order = self.output_layout.ambisonic_order().unwrap_or(1);
-
-        // Order 0 (W channel)
-        gains[0] = 1.0; // W
-
-        if order >= 1 {
-            // Order 1: Y, Z, X (ACN 1, 2, 3)
-            gains[1] = cos_el * sin_az; // Y
-            gains[2] = sin_el; // Z
-            gains[3] = cos_el * cos_az; // X
-        }
-
-        if order >= 2 {
-            // Order 2: ACN 4-8
-            let cos_2az = (2.0 * az).cos();
-            let sin_2az = (2.0 * az).sin();
-            let sin_2el = (2.0 * el).sin();
-            let cos_el_sq = cos_el * cos_el;
-
-            gains[4] = 0.8660254037844386 * cos_el_sq * sin_2az; // V
-            gains[5] = 0.8660254037844386 * sin_2el * sin_az; // T
-            gains[6] = 0.5 * (3.0 * sin_el * sin_el - 1.0); // R
-            gains[7] = 0.8660254037844386 * sin_2el * cos_az; // S
-            gains[8] = 0.8660254037844386 * cos_el_sq * cos_2az; // U
-        }
-
-        if order >= 3 {
-            // Order 3: ACN 9-15
-            let cos_3az = (3.0 * az).cos();
-            let sin_3az = (3.0 * az).sin();
-            let cos_el_sq = cos_el * cos_el;
-            let cos_el_cu = cos_el_sq * cos_el;
-            let sin_el_sq = sin_el * sin_el;
-
-            gains[9] = 0.7905694150420949 * cos_el_cu * sin_3az; // Q
-            gains[10] = 1.9364916731037085 * cos_el_sq * sin_el * (2.0 * az).sin(); // O
-            gains[11] = 0.6123724356957945 * cos_el * (5.0 * sin_el_sq - 1.0) * sin_az; // M
-            gains[12] = 0.5 * sin_el * (5.0 * sin_el_sq - 3.0); // K
-            gains[13] = 0.6123724356957945 * cos_el * (5.0 * sin_el_sq - 1.0) * cos_az; // L
-            gains[14] = 1.9364916731037085 * cos_el_sq * sin_el * (2.0 * az).cos(); // N
-            gains[15] = 0.7905694150420949 * cos_el_cu * cos_3az; // P
-        }
+        sn3d_coefficients(order, azimuth_deg, elevation_deg, gains);
     }
 
     fn process_stereo(&mut self, inputs: &[&[S]], outputs: &mut [&mut [S]], modulation_values: &[S]) {
@@ -392,10 +350,14 @@ impl<S: Sample> PannerBlock<S> {
         }
 
         let mono_in = inputs[0];
-        let num_outputs = self.output_layout.channel_count().min(outputs.len());
+        let num_outputs = self
+            .output_layout
+            .channel_count()
+            .min(outputs.len())
+            .min(MAX_SURROUND_SPEAKERS);
         let num_samples = mono_in.len().min(outputs[0].len()).min(MAX_BUFFER_SIZE);
 
-        let mut gains: [f64; MAX_BLOCK_OUTPUTS] = [0.0; MAX_BLOCK_OUTPUTS];
+        let mut gains: [f64; MAX_SURROUND_SPEAKERS] = [0.0; MAX_SURROUND_SPEAKERS];
 
         for (i, &input_sample) in mono_in.iter().enumerate().take(num_samples) {
             let azimuth = self.azimuth_smoother.get_next_value().to_f64();
@@ -434,7 +396,7 @@ impl<S: Sample> PannerBlock<S> {
             let azimuth = self.azimuth_smoother.get_next_value().to_f64();
             let elevation = self.elevation_smoother.get_next_value().to_f64();
 
-            self.calculate_ambisonic_gains(azimuth, elevation, &mut gains);
+            self.calculate_ambisonic_gains(azimuth, elevation, &mut gains[..num_outputs]);
 
             for ch in 0..num_outputs {
                 outputs[ch][i] = input_sample * S::from_f64(gains[ch]);
@@ -483,6 +445,21 @@ impl<S: Sample> Block<S> for PannerBlock<S> {
         self.azimuth_smoother.reset(context.sample_rate, 10.0);
         self.elevation_smoother.reset(context.sample_rate, 10.0);
     }
+
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        let mut exact = true;
+        for (parameter, smoother) in [
+            (&self.position, &mut self.position_smoother),
+            (&self.azimuth, &mut self.azimuth_smoother),
+            (&self.elevation, &mut self.elevation_smoother),
+        ] {
+            match parameter {
+                Parameter::Constant(value) => smoother.set_immediate(*value),
+                Parameter::Modulated(_) => exact = false,
+            }
+        }
+        exact
+    }
 }
 
 #[cfg(test)]
@@ -496,6 +473,9 @@ mod tests {
             num_channels: 2,
             buffer_size,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Stereo,
         }
     }
@@ -560,6 +540,12 @@ mod tests {
 
         let panner_toa = PannerBlock::<f32>::new_ambisonic(3);
         assert_eq!(panner_toa.output_count(), 16);
+
+        let panner_4oa = PannerBlock::<f32>::new_ambisonic(4);
+        assert_eq!(panner_4oa.output_count(), 25);
+
+        let panner_5oa = PannerBlock::<f32>::new_ambisonic(5);
+        assert_eq!(panner_5oa.output_count(), 36);
     }
 
     #[test]
@@ -62,6 +62,11 @@ impl<S: Sample> Block<S> for VcaBlock<S> {
     fn modulation_outputs(&self) -> &[ModulationOutput] {
         &[]
     }
+
+    #[inline]
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        true
+    }
 }
 
 #[cfg(test)]
@@ -75,6 +80,9 @@ mod tests {
             num_channels: 1,
             buffer_size,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::default(),
         }
     }
@@ -11,7 +11,7 @@ use crate::{
     context::DspContext,
     parameter::{ModulationOutput, Parameter},
     sample::Sample,
-    waveform::{Waveform, process_waveform_scalar},
+    waveform::{Waveform, phase_at, process_waveform_scalar},
 };
 
 /// A waveform oscillator for generating audio signals.
@@ -101,40 +101,16 @@ impl<S: Sample> Block<S> for OscillatorBlock<S> {
                 let remainder_start = chunks * SIMD_LANES;
                 let chunk_phase_step = phase_increment * SIMD_LANES as f64;
 
-                let base_phase = S::simd_splat(S::from_f64(self.phase));
-                let sample_inc_simd = S::simd_splat(S::from_f64(phase_increment));
-                let mut phases = base_phase + S::simd_lane_offsets() * sample_inc_simd;
-                let chunk_inc_simd = S::simd_splat(S::from_f64(chunk_phase_step));
                 let duty = S::from_f64(DEFAULT_DUTY_CYCLE);
-                let two_pi = S::simd_splat(S::TAU);
-                let inv_two_pi = S::simd_splat(S::INV_TAU);
-                let phase_inc_normalized = S::from_f64(phase_increment * S::INV_TAU.to_f64());
-                let tau = S::TAU.to_f64();
-                let inv_tau = 1.0 / tau;
 
                 for chunk_idx in 0..chunks {
-                    let phases_array = S::simd_to_array(phases);
-                    let phases_normalized: [S; SIMD_LANES] = [
-                        S::from_f64(phases_array[0].to_f64().rem_euclid(tau) * inv_tau),
-                        S::from_f64(phases_array[1].to_f64().rem_euclid(tau) * inv_tau),
-                        S::from_f64(phases_array[2].to_f64().rem_euclid(tau) * inv_tau),
-                        S::from_f64(phases_array[3].to_f64().rem_euclid(tau) * inv_tau),
-                    ];
-
-                    if let Some(samples) = generate_waveform_samples_simd::<S>(
-                        self.waveform,
-                        phases,
-                        phases_normalized,
-                        phase_inc_normalized,
-                        duty,
-                        two_pi,
-                        inv_two_pi,
-                    ) {
+                    let chunk_phase = self.phase + chunk_phase_step * chunk_idx as f64;
+                    if let Some(samples) =
+                        generate_waveform_samples_simd::<S>(self.waveform, chunk_phase, phase_increment, duty)
+                    {
                         let base = chunk_idx * SIMD_LANES;
                         outputs[0][base..base + SIMD_LANES].copy_from_slice(&samples);
                     }
-
-                    phases = phases + chunk_inc_simd;
                 }
 
                 self.phase += chunk_phase_step * chunks as f64;
@@ -191,6 +167,26 @@ impl<S: Sample> Block<S> for OscillatorBlock<S> {
     fn reset(&mut self) {
         self.phase = 0.0;
     }
+
+    /// Jumps the phase analytically when the frequency and pitch offset are
+    /// constant. Noise can't be reproduced at an arbitrary position.
+    fn seek(&mut self, position: u64, context: &DspContext) -> bool {
+        let (Parameter::Constant(frequency), Parameter::Constant(pitch_offset)) = (&self.frequency, &self.pitch_offset)
+        else {
+            self.reset();
+            return false;
+        };
+
+        let freq_hz = self.midi_frequency.unwrap_or(*frequency);
+        let freq = if *pitch_offset != S::ZERO {
+            freq_hz * S::from_f64(2.0f64.powf(pitch_offset.to_f64() / 12.0))
+        } else {
+            freq_hz
+        };
+        let phase_increment = freq.to_f64() / context.sample_rate * S::TAU.to_f64();
+        self.phase = phase_at(position, phase_increment);
+        !matches!(self.waveform, Waveform::Noise)
+    }
 }
 
 #[cfg(test)]
@@ -225,6 +221,9 @@ mod tests {
             num_channels: 1,
             buffer_size,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Mono,
         }
     }
@@ -626,4 +625,37 @@ mod tests {
         let varies = output.iter().any(|&x| (x - first).abs() > 0.01);
         assert!(varies, "Noise should produce varying values");
     }
+
+    #[test]
+    fn test_seek_matches_continuous_render() {
+        let buffer_size = 64;
+        let context = test_context(buffer_size);
+        let inputs: [&[f64]; 0] = [];
+        let mut output = vec![0.0; buffer_size];
+
+        let mut continuous = OscillatorBlock::<f64>::new(1234.5, Waveform::Sawtooth, None);
+        for _ in 0..11 {
+            continuous.process(&inputs, &mut [&mut output], &[], &context);
+        }
+
+        let mut seeked = OscillatorBlock::<f64>::new(1234.5, Waveform::Sawtooth, None);
+        assert!(seeked.seek(10 * buffer_size as u64, &context));
+        let mut seeked_output = vec![0.0; buffer_size];
+        seeked.process(&inputs, &mut [&mut seeked_output], &[], &context);
+
+        for (a, b) in output.iter().zip(&seeked_output) {
+            assert!((a - b).abs() < 1e-9, "{a} != {b}");
+        }
+    }
+
+    #[test]
+    fn test_seek_is_inexact_for_noise_and_modulation() {
+        let context = test_context(64);
+        let mut noise = OscillatorBlock::<f32>::new(440.0, Waveform::Noise, Some(1));
+        assert!(!noise.seek(1000, &context));
+
+        let mut modulated = OscillatorBlock::<f32>::new(440.0, Waveform::Sine, None);
+        modulated.frequency = Parameter::Modulated(crate::block::BlockId(0));
+        assert!(!modulated.seek(1000, &context));
+    }
 }
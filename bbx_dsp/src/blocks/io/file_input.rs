@@ -1,11 +1,18 @@
 //! Audio file input block.
 
-use crate::{block::Block, context::DspContext, parameter::ModulationOutput, reader::Reader, sample::Sample};
+use crate::{
+    block::Block, context::DspContext, memory::MemoryFootprint, parameter::ModulationOutput, reader::Reader,
+    sample::Sample,
+};
 
 /// Reads audio from a file into the DSP graph.
 ///
 /// Wraps a [`Reader`] implementation to stream audio samples into the graph.
 /// Supports optional looping for continuous playback.
+///
+/// Samples are copied with [`Reader::read_into`], so compressed readers such
+/// as [`PcmStore`](crate::pcm::PcmStore) decode straight into the output
+/// buffers.
 pub struct FileInputBlock<S: Sample> {
     reader: Box<dyn Reader<S>>,
     current_position: usize,
@@ -66,6 +73,13 @@ impl<S: Sample> FileInputBlock<S> {
 
 impl<S: Sample> Block<S> for FileInputBlock<S> {
     fn process(&mut self, _inputs: &[&[S]], outputs: &mut [&mut [S]], _modulation_values: &[S], context: &DspContext) {
+        if !context.is_playing {
+            for output_buffer in outputs.iter_mut() {
+                output_buffer.fill(S::ZERO);
+            }
+            return;
+        }
+
         let buffer_size = context.buffer_size;
         let num_file_channels = self.reader.num_channels();
         let file_length = self.reader.num_samples();
@@ -76,17 +90,23 @@ impl<S: Sample> Block<S> for FileInputBlock<S> {
                 continue;
             }
 
-            let input_channel = self.reader.read_channel(channel_index);
-
-            for (sample_index, output_sample) in output_buffer.iter_mut().enumerate() {
-                let read_position = self.current_position + sample_index;
-                if read_position < file_length {
-                    *output_sample = input_channel[read_position];
-                } else if self.loop_enabled && file_length > 0 {
-                    *output_sample = input_channel[read_position % file_length];
-                } else {
-                    *output_sample = S::ZERO;
+            // Read up to the end of the file, wrapping to the start when looping
+            let mut read_position = self.current_position;
+            let mut remaining = &mut output_buffer[..];
+            while !remaining.is_empty() {
+                if read_position >= file_length {
+                    if !self.loop_enabled || file_length == 0 {
+                        remaining.fill(S::ZERO);
+                        break;
+                    }
+                    read_position %= file_length;
                 }
+
+                let len = remaining.len().min(file_length - read_position);
+                let (segment, rest) = remaining.split_at_mut(len);
+                self.reader.read_into(channel_index, read_position, segment);
+                read_position += len;
+                remaining = rest;
             }
         }
 
@@ -107,6 +127,22 @@ impl<S: Sample> Block<S> for FileInputBlock<S> {
     fn modulation_outputs(&self) -> &[ModulationOutput] {
         &[]
     }
+
+    fn memory_footprint(&self) -> MemoryFootprint {
+        MemoryFootprint::of(self)
+            .with_state(size_of_val(&*self.reader))
+            .with_shared(self.reader.resident_bytes())
+    }
+
+    fn seek(&mut self, position: u64, _context: &DspContext) -> bool {
+        let file_length = self.reader.num_samples() as u64;
+        self.current_position = if self.loop_enabled && file_length > 0 {
+            (position % file_length) as usize
+        } else {
+            position.min(file_length) as usize
+        };
+        true
+    }
 }
 
 #[cfg(test)]
@@ -149,6 +185,9 @@ mod tests {
             buffer_size,
             num_channels: 2,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Stereo,
         }
     }
@@ -308,4 +347,55 @@ mod tests {
             assert!(sample.abs() < 1e-6);
         }
     }
+
+    #[test]
+    fn test_file_input_block_seek() {
+        let reader = MockReader::new(44100.0, vec![vec![0.0f32; 100]]);
+        let mut block = FileInputBlock::new(Box::new(reader));
+        let context = test_context(10);
+
+        assert!(block.seek(40, &context));
+        assert_eq!(block.get_position(), 40);
+        assert!(block.seek(250, &context));
+        assert!(block.is_finished());
+
+        block.set_loop_enabled(true);
+        assert!(block.seek(250, &context));
+        assert_eq!(block.get_position(), 50);
+    }
+
+    #[test]
+    fn test_file_input_block_holds_while_stopped() {
+        let reader = MockReader::new(44100.0, vec![vec![1.0f32; 100]]);
+        let mut block = FileInputBlock::new(Box::new(reader));
+
+        let mut context = test_context(10);
+        context.is_playing = false;
+        let mut output = vec![0.5f32; 10];
+        let mut outputs: [&mut [f32]; 1] = [&mut output];
+
+        block.process(&[], &mut outputs, &[], &context);
+        assert_eq!(block.get_position(), 0);
+        assert!(output.iter().all(|&x| x == 0.0));
+    }
+
+    #[test]
+    fn test_file_input_block_decodes_pcm_store() {
+        use crate::pcm::{PcmEncoding, PcmStore};
+
+        let samples: Vec<f32> = (0..6).map(|i| i as f32 / 8.0).collect();
+        let store = PcmStore::from_channels(44100.0, &[&samples[..]], PcmEncoding::Pcm16);
+        let mut block = FileInputBlock::<f32>::new(Box::new(store));
+        block.set_loop_enabled(true);
+        assert_eq!(block.memory_footprint().shared, 6 * 2);
+
+        let context = test_context(10);
+        let mut output = vec![0.0f32; 10];
+        let mut outputs: [&mut [f32]; 1] = [&mut output];
+        block.process(&[], &mut outputs, &[], &context);
+
+        let expected: Vec<f32> = (0..10).map(|i| (i % 6) as f32 / 8.0).collect();
+        assert_eq!(output, expected);
+        assert_eq!(block.get_position(), 4);
+    }
 }
@@ -10,7 +10,10 @@ use std::{
 
 use bbx_core::{Consumer, Producer, SpscRingBuffer};
 
-use crate::{block::Block, context::DspContext, parameter::ModulationOutput, sample::Sample, writer::Writer};
+use crate::{
+    block::Block, context::DspContext, memory::MemoryFootprint, parameter::ModulationOutput, sample::Sample,
+    writer::Writer,
+};
 
 /// Default ring buffer capacity in samples (~1 second at 44.1kHz stereo).
 const DEFAULT_RING_BUFFER_CAPACITY: usize = 44100 * 2;
@@ -198,6 +201,17 @@ impl<S: Sample + Send + 'static> Block<S> for FileOutputBlock<S> {
     fn modulation_outputs(&self) -> &[ModulationOutput] {
         &[]
     }
+
+    fn memory_footprint(&self) -> MemoryFootprint {
+        let ring_buffer = self.producer.as_ref().map_or(0, |producer| producer.capacity());
+        MemoryFootprint::of(self).with_shared(ring_buffer * size_of::<S>())
+    }
+
+    /// Recording is unaffected by the transport position.
+    #[inline]
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        true
+    }
 }
 
 impl<S: Sample + Send + 'static> Drop for FileOutputBlock<S> {
@@ -278,6 +292,9 @@ mod tests {
             buffer_size,
             num_channels: 2,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Stereo,
         }
     }
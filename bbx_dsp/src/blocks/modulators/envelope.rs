@@ -34,6 +34,8 @@ pub struct EnvelopeBlock<S: Sample> {
     level: f64,
     stage_time: f64,
     release_level: f64,
+    /// Sustain level from the last `process`, so `seek` honours modulation.
+    sustain_level: f64,
 }
 
 impl<S: Sample> EnvelopeBlock<S> {
@@ -62,6 +64,7 @@ impl<S: Sample> EnvelopeBlock<S> {
             level: 0.0,
             stage_time: 0.0,
             release_level: 0.0,
+            sustain_level: sustain.clamp(0.0, 1.0),
         }
     }
 
@@ -99,6 +102,7 @@ impl<S: Sample> Block<S> for EnvelopeBlock<S> {
         let attack_time = Self::clamp_time(self.attack.get_value(modulation_values).to_f64());
         let decay_time = Self::clamp_time(self.decay.get_value(modulation_values).to_f64());
         let sustain_level = self.sustain.get_value(modulation_values).to_f64().clamp(0.0, 1.0);
+        self.sustain_level = sustain_level;
         let release_time = Self::clamp_time(self.release.get_value(modulation_values).to_f64());
 
         let time_per_sample = 1.0 / context.sample_rate;
@@ -173,6 +177,26 @@ impl<S: Sample> Block<S> for EnvelopeBlock<S> {
         self.stage_time = 0.0;
         self.release_level = 0.0;
     }
+
+    /// The envelope follows note events rather than the timeline, so idle
+    /// and sustaining envelopes are unaffected. A moving stage jumps to where
+    /// it is heading (sustain for attack and decay, idle for release), and
+    /// the seek is reported as inexact.
+    fn seek(&mut self, _position: u64, _context: &DspContext) -> bool {
+        match self.stage {
+            EnvelopeStage::Idle | EnvelopeStage::Sustain => true,
+            EnvelopeStage::Attack | EnvelopeStage::Decay => {
+                self.stage = EnvelopeStage::Sustain;
+                self.level = self.sustain_level;
+                self.stage_time = 0.0;
+                false
+            }
+            EnvelopeStage::Release => {
+                self.reset();
+                false
+            }
+        }
+    }
 }
 
 #[cfg(test)]
@@ -186,6 +210,9 @@ mod tests {
             num_channels: 1,
             buffer_size,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Mono,
         }
     }
@@ -719,4 +746,25 @@ mod tests {
             }
         }
     }
+
+    #[test]
+    fn test_seek_uses_modulated_sustain() {
+        let mut env = EnvelopeBlock::<f32>::new(1.0, 0.1, 0.0, 0.2);
+        env.sustain = Parameter::Modulated(crate::block::BlockId(0));
+        let context = test_context(64, 44100.0);
+
+        env.note_on();
+        let inputs: [&[f32]; 0] = [];
+        let mut output = vec![0.0; context.buffer_size];
+        env.process(&inputs, &mut [&mut output], &[0.7], &context);
+        assert_eq!(env.stage, EnvelopeStage::Attack);
+
+        assert!(!env.seek(0, &context));
+        assert_eq!(env.stage, EnvelopeStage::Sustain);
+        assert!(
+            (env.level - 0.7).abs() < 1e-6,
+            "level {} should be the modulated sustain",
+            env.level
+        );
+    }
 }
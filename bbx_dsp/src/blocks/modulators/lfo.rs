@@ -11,7 +11,7 @@ use crate::{
     context::DspContext,
     parameter::{ModulationOutput, Parameter},
     sample::Sample,
-    waveform::{Waveform, process_waveform_scalar},
+    waveform::{Waveform, phase_at, process_waveform_scalar},
 };
 
 /// A low-frequency oscillator for modulating block parameters.
@@ -67,42 +67,18 @@ impl<S: Sample> Block<S> for LfoBlock<S> {
                 let depth_s = S::from_f64(depth);
                 let depth_vec = S::simd_splat(depth_s);
 
-                let base_phase = S::simd_splat(S::from_f64(self.phase));
-                let sample_inc_simd = S::simd_splat(S::from_f64(phase_increment));
-                let mut phases = base_phase + S::simd_lane_offsets() * sample_inc_simd;
-                let chunk_inc_simd = S::simd_splat(S::from_f64(chunk_phase_step));
                 let duty = S::from_f64(DEFAULT_DUTY_CYCLE);
-                let two_pi = S::simd_splat(S::TAU);
-                let inv_two_pi = S::simd_splat(S::INV_TAU);
-                let phase_inc_normalized = S::from_f64(phase_increment * S::INV_TAU.to_f64());
-                let tau = S::TAU.to_f64();
-                let inv_tau = 1.0 / tau;
 
                 for chunk_idx in 0..chunks {
-                    let phases_array = S::simd_to_array(phases);
-                    let phases_normalized: [S; SIMD_LANES] = [
-                        S::from_f64(phases_array[0].to_f64().rem_euclid(tau) * inv_tau),
-                        S::from_f64(phases_array[1].to_f64().rem_euclid(tau) * inv_tau),
-                        S::from_f64(phases_array[2].to_f64().rem_euclid(tau) * inv_tau),
-                        S::from_f64(phases_array[3].to_f64().rem_euclid(tau) * inv_tau),
-                    ];
-
-                    if let Some(samples) = generate_waveform_samples_simd::<S>(
-                        self.waveform,
-                        phases,
-                        phases_normalized,
-                        phase_inc_normalized,
-                        duty,
-                        two_pi,
-                        inv_two_pi,
-                    ) {
+                    let chunk_phase = self.phase + chunk_phase_step * chunk_idx as f64;
+                    if let Some(samples) =
+                        generate_waveform_samples_simd::<S>(self.waveform, chunk_phase, phase_increment, duty)
+                    {
                         let samples_vec = S::simd_from_slice(&samples);
                         let scaled = samples_vec * depth_vec;
                         let base = chunk_idx * SIMD_LANES;
                         outputs[0][base..base + SIMD_LANES].copy_from_slice(&S::simd_to_array(scaled));
                     }
-
-                    phases = phases + chunk_inc_simd;
                 }
 
                 self.phase += chunk_phase_step * chunks as f64;
@@ -159,6 +135,19 @@ impl<S: Sample> Block<S> for LfoBlock<S> {
     fn reset(&mut self) {
         self.phase = 0.0;
     }
+
+    /// Jumps the phase analytically when the frequency is constant. Noise
+    /// can't be reproduced at an arbitrary position.
+    fn seek(&mut self, position: u64, context: &DspContext) -> bool {
+        let Parameter::Constant(frequency) = self.frequency else {
+            self.reset();
+            return false;
+        };
+
+        let phase_increment = frequency.to_f64() / context.sample_rate * S::TAU.to_f64();
+        self.phase = phase_at(position, phase_increment);
+        !matches!(self.waveform, Waveform::Noise)
+    }
 }
 
 #[cfg(test)]
@@ -172,6 +161,9 @@ mod tests {
             num_channels: 1,
             buffer_size,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::Mono,
         }
     }
@@ -31,6 +31,12 @@ pub enum ChannelLayout {
     /// Third-order ambisonics (16 channels).
     AmbisonicToa,
 
+    /// Fourth-order ambisonics (25 channels).
+    AmbisonicHoa4,
+
+    /// Fifth-order ambisonics (36 channels).
+    AmbisonicHoa5,
+
     /// Custom channel count for non-standard configurations.
     Custom(usize),
 }
@@ -47,6 +53,8 @@ impl ChannelLayout {
             Self::AmbisonicFoa => 4,
             Self::AmbisonicSoa => 9,
             Self::AmbisonicToa => 16,
+            Self::AmbisonicHoa4 => 25,
+            Self::AmbisonicHoa5 => 36,
             Self::Custom(n) => *n,
         }
     }
@@ -54,7 +62,10 @@ impl ChannelLayout {
     /// Returns `true` if this is an ambisonic layout.
     #[inline]
     pub const fn is_ambisonic(&self) -> bool {
-        matches!(self, Self::AmbisonicFoa | Self::AmbisonicSoa | Self::AmbisonicToa)
+        matches!(
+            self,
+            Self::AmbisonicFoa | Self::AmbisonicSoa | Self::AmbisonicToa | Self::AmbisonicHoa4 | Self::AmbisonicHoa5
+        )
     }
 
     /// Returns the ambisonic order if this is an ambisonic layout.
@@ -66,11 +77,13 @@ impl ChannelLayout {
             Self::AmbisonicFoa => Some(1),
             Self::AmbisonicSoa => Some(2),
             Self::AmbisonicToa => Some(3),
+            Self::AmbisonicHoa4 => Some(4),
+            Self::AmbisonicHoa5 => Some(5),
             _ => None,
         }
     }
 
-    /// Creates an ambisonic layout from an order (1-3).
+    /// Creates an ambisonic layout from an order (1-5).
     ///
     /// Returns `None` if the order is out of range.
     #[inline]
@@ -79,6 +92,8 @@ impl ChannelLayout {
             1 => Some(Self::AmbisonicFoa),
             2 => Some(Self::AmbisonicSoa),
             3 => Some(Self::AmbisonicToa),
+            4 => Some(Self::AmbisonicHoa4),
+            5 => Some(Self::AmbisonicHoa5),
             _ => None,
         }
     }
@@ -127,6 +142,8 @@ mod tests {
         assert_eq!(ChannelLayout::AmbisonicFoa.channel_count(), 4);
         assert_eq!(ChannelLayout::AmbisonicSoa.channel_count(), 9);
         assert_eq!(ChannelLayout::AmbisonicToa.channel_count(), 16);
+        assert_eq!(ChannelLayout::AmbisonicHoa4.channel_count(), 25);
+        assert_eq!(ChannelLayout::AmbisonicHoa5.channel_count(), 36);
         assert_eq!(ChannelLayout::Custom(12).channel_count(), 12);
     }
 
@@ -139,6 +156,7 @@ mod tests {
         assert!(ChannelLayout::AmbisonicFoa.is_ambisonic());
         assert!(ChannelLayout::AmbisonicSoa.is_ambisonic());
         assert!(ChannelLayout::AmbisonicToa.is_ambisonic());
+        assert!(ChannelLayout::AmbisonicHoa5.is_ambisonic());
         assert!(!ChannelLayout::Custom(4).is_ambisonic());
     }
 
@@ -149,6 +167,8 @@ mod tests {
         assert_eq!(ChannelLayout::AmbisonicFoa.ambisonic_order(), Some(1));
         assert_eq!(ChannelLayout::AmbisonicSoa.ambisonic_order(), Some(2));
         assert_eq!(ChannelLayout::AmbisonicToa.ambisonic_order(), Some(3));
+        assert_eq!(ChannelLayout::AmbisonicHoa4.ambisonic_order(), Some(4));
+        assert_eq!(ChannelLayout::AmbisonicHoa5.ambisonic_order(), Some(5));
     }
 
     #[test]
@@ -166,7 +186,15 @@ mod tests {
             ChannelLayout::from_ambisonic_order(3),
             Some(ChannelLayout::AmbisonicToa)
         );
-        assert_eq!(ChannelLayout::from_ambisonic_order(4), None);
+        assert_eq!(
+            ChannelLayout::from_ambisonic_order(4),
+            Some(ChannelLayout::AmbisonicHoa4)
+        );
+        assert_eq!(
+            ChannelLayout::from_ambisonic_order(5),
+            Some(ChannelLayout::AmbisonicHoa5)
+        );
+        assert_eq!(ChannelLayout::from_ambisonic_order(6), None);
     }
 
     #[test]
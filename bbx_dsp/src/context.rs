@@ -27,11 +27,159 @@ pub struct DspContext {
     /// The number of samples processed per block.
     pub buffer_size: usize,
 
-    /// The absolute sample position since playback started.
-    /// Increments by `buffer_size` after each process cycle.
+    /// The transport position in samples at the start of the current buffer.
+    /// A graph advances it by `buffer_size` after each process cycle while
+    /// playing, and [`Graph::seek`](crate::graph::Graph::seek) moves it.
     pub current_sample: u64,
 
+    /// Whether the transport is running. Blocks that follow the timeline,
+    /// such as file inputs, hold their position while stopped.
+    pub is_playing: bool,
+
+    /// The tempo in beats per minute, if known.
+    pub tempo: Option<f64>,
+
+    /// The transport position in quarter notes at the start of the current
+    /// buffer, if known. Advanced along with `current_sample` using `tempo`.
+    pub ppq_position: Option<f64>,
+
     /// The channel layout for audio processing.
     /// Describes the speaker/channel configuration (stereo, surround, ambisonics).
     pub channel_layout: ChannelLayout,
 }
+
+impl DspContext {
+    /// Create a context with the transport playing from sample 0 and no tempo.
+    pub fn new(sample_rate: f64, buffer_size: usize, num_channels: usize) -> Self {
+        Self {
+            sample_rate,
+            num_channels,
+            buffer_size,
+            current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
+            channel_layout: ChannelLayout::default(),
+        }
+    }
+
+    /// The transport position in seconds.
+    #[inline]
+    pub fn current_time(&self) -> f64 {
+        self.current_sample as f64 / self.sample_rate
+    }
+
+    /// The number of samples in one beat, if the tempo is known.
+    #[inline]
+    pub fn samples_per_beat(&self) -> Option<f64> {
+        self.tempo.map(|tempo| self.sample_rate * 60.0 / tempo)
+    }
+
+    /// Move the transport to `position`, deriving the quarter-note position
+    /// from the tempo when it is known.
+    pub fn set_position(&mut self, position: u64) {
+        self.current_sample = position;
+        self.ppq_position = self.samples_per_beat().map(|samples| position as f64 / samples);
+    }
+
+    /// Advance the transport by `num_samples` if it is playing.
+    #[inline]
+    pub fn advance(&mut self, num_samples: usize) {
+        if !self.is_playing {
+            return;
+        }
+        self.current_sample += num_samples as u64;
+        if let (Some(ppq), Some(samples)) = (self.ppq_position, self.samples_per_beat()) {
+            self.ppq_position = Some(ppq + num_samples as f64 / samples);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{blocks::FileInputBlock, graph::GraphBuilder, reader::Reader};
+
+    #[test]
+    fn test_advance_only_while_playing() {
+        let mut context = DspContext::new(48000.0, 512, 2);
+        context.advance(512);
+        assert_eq!(context.current_sample, 512);
+        assert!(context.ppq_position.is_none());
+
+        context.is_playing = false;
+        context.advance(512);
+        assert_eq!(context.current_sample, 512);
+    }
+
+    #[test]
+    fn test_ppq_follows_tempo() {
+        let mut context = DspContext::new(48000.0, 512, 2);
+        context.tempo = Some(120.0);
+        assert_eq!(context.samples_per_beat(), Some(24000.0));
+
+        context.set_position(48000);
+        assert_eq!(context.ppq_position, Some(2.0));
+        assert_eq!(context.current_time(), 1.0);
+
+        context.advance(12000);
+        assert_eq!(context.ppq_position, Some(2.5));
+    }
+
+    struct RampReader;
+
+    impl Reader<f32> for RampReader {
+        fn sample_rate(&self) -> f64 {
+            48000.0
+        }
+
+        fn num_channels(&self) -> usize {
+            1
+        }
+
+        fn num_samples(&self) -> usize {
+            RAMP.len()
+        }
+
+        fn read_channel(&self, _channel_index: usize) -> &[f32] {
+            &RAMP
+        }
+    }
+
+    static RAMP: [f32; 1024] = {
+        let mut ramp = [0.0; 1024];
+        let mut i = 0;
+        while i < ramp.len() {
+            ramp[i] = i as f32;
+            i += 1;
+        }
+        ramp
+    };
+
+    #[test]
+    fn test_graph_transport() {
+        let mut builder = GraphBuilder::<f32>::new(48000.0, 64, 1);
+        builder.add(FileInputBlock::new(Box::new(RampReader)));
+        let mut graph = builder.build();
+        let mut output = vec![0.0; 64];
+
+        graph.process_buffers(&mut [&mut output]);
+        assert_eq!(graph.position(), 64);
+
+        assert!(graph.seek(500));
+        graph.process_buffers(&mut [&mut output]);
+        assert_eq!(output[0], 500.0);
+        assert_eq!(graph.position(), 564);
+
+        graph.set_playing(false);
+        graph.process_buffers(&mut [&mut output]);
+        assert_eq!(graph.position(), 564);
+        assert!(output.iter().all(|&x| x == 0.0));
+
+        graph.set_playing(true);
+        graph.set_tempo(Some(60.0));
+        assert_eq!(graph.context().ppq_position, Some(564.0 / 48000.0));
+        graph.process_buffers(&mut [&mut output]);
+        assert_eq!(output[0], 564.0);
+    }
+}
@@ -0,0 +1,720 @@
+//! Differential testing of block processing paths.
+//!
+//! [`check`] runs a block under two [`Path`]s with the same randomized
+//! parameters, inputs and modulation, and compares their outputs sample by
+//! sample within a [`Tolerance`].
+//!
+//! [`Path::Whole`] processes each buffer in one call, which is where the
+//! `simd` kernels run. [`Path::SCALAR`] splits each buffer into single-sample
+//! calls, too short for any SIMD chunk, so every sample goes through the
+//! scalar code: comparing the two checks the SIMD kernels against the scalar
+//! reference within a single build. Without the `simd` feature both paths
+//! are scalar and the check still holds blocks to producing the same output
+//! however a buffer is split. New paths (fused kernels, parallel execution)
+//! are added as [`Path`] variants.
+//!
+//! Modulation values change once per buffer and are held across a chunked
+//! path's calls, matching the graph's control-rate modulation.
+//!
+//! On a mismatch the failing case is shrunk (fewer buffers, then shorter
+//! ones) while it still fails, and the panic reports the smallest case with
+//! the seed needed to replay it.
+
+use std::ops::Range;
+
+use bbx_core::random::XorShiftRng;
+
+use crate::{block::BlockType, context::DspContext, sample::Sample};
+
+/// Longest buffer a randomized case uses.
+const MAX_CASE_BUFFER_SIZE: usize = 700;
+
+/// Most buffers a randomized case processes.
+const MAX_CASE_BUFFERS: usize = 3;
+
+const SAMPLE_RATES: &[f64] = &[44100.0, 48000.0, 96000.0];
+
+/// How a block is driven over one buffer.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub(crate) enum Path {
+    /// One `process` call per buffer.
+    Whole,
+    /// `process` calls of at most this many samples.
+    Chunked(usize),
+}
+
+impl Path {
+    /// Single-sample calls, which never reach a SIMD kernel.
+    pub(crate) const SCALAR: Path = Path::Chunked(1);
+
+    fn run<S: Sample>(
+        self,
+        block: &mut BlockType<S>,
+        inputs: &[Vec<S>],
+        outputs: &mut [Vec<S>],
+        modulation: &[S],
+        context: &DspContext,
+    ) {
+        let len = context.buffer_size;
+        let chunk = match self {
+            Path::Whole => len,
+            Path::Chunked(size) => size,
+        }
+        .max(1);
+
+        let mut start = 0;
+        while start < len {
+            let end = (start + chunk).min(len);
+            let input_slices: Vec<&[S]> = inputs.iter().map(|input| &input[start..end]).collect();
+            let mut output_slices: Vec<&mut [S]> = outputs.iter_mut().map(|output| &mut output[start..end]).collect();
+            let call_context = DspContext {
+                buffer_size: end - start,
+                current_sample: context.current_sample + start as u64,
+                ..context.clone()
+            };
+            block.process(&input_slices, &mut output_slices, modulation, &call_context);
+            start = end;
+        }
+    }
+}
+
+/// Step between neighbouring reference samples above which both count as
+/// next to a discontinuity.
+const EDGE_STEP: f64 = 0.5;
+
+/// How far two outputs may differ.
+///
+/// A sample passes if it is within `max_ulps` units in the last place of the
+/// reference, or if the difference is below `floor_db` (dBFS), so values
+/// near zero aren't held to a relative bound. Samples next to a step of more
+/// than [`EDGE_STEP`] in the reference use `edge_floor_db` instead, for
+/// band-limited edges where rounding in the phase moves the output steeply.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub(crate) struct Tolerance {
+    pub max_ulps: u64,
+    pub floor_db: f64,
+    pub edge_floor_db: f64,
+}
+
+impl Tolerance {
+    /// Bit-identical output.
+    pub(crate) const EXACT: Self = Self::new(0, f64::NEG_INFINITY);
+
+    pub(crate) const fn new(max_ulps: u64, floor_db: f64) -> Self {
+        Self {
+            max_ulps,
+            floor_db,
+            edge_floor_db: floor_db,
+        }
+    }
+
+    /// Use `edge_floor_db` for samples next to a discontinuity.
+    pub(crate) const fn near_edges(self, edge_floor_db: f64) -> Self {
+        Self { edge_floor_db, ..self }
+    }
+
+    fn accepts<S: Sample>(&self, reference: S, candidate: S, near_edge: bool) -> bool {
+        let (a, b) = (reference.to_f64(), candidate.to_f64());
+        if a == b || (a.is_nan() && b.is_nan()) {
+            return true;
+        }
+        let floor_db = if near_edge { self.edge_floor_db } else { self.floor_db };
+        (a - b).abs() <= 10f64.powf(floor_db / 20.0) || ulps(reference, candidate) <= self.max_ulps
+    }
+}
+
+/// Distance between two samples in units in the last place of `S`.
+fn ulps<S: Sample>(a: S, b: S) -> u64 {
+    if size_of::<S>() == size_of::<f32>() {
+        let ordered = |x: f64| {
+            let bits = (x as f32).to_bits() as i32;
+            if bits < 0 { i32::MIN - bits } else { bits }
+        };
+        ordered(a.to_f64()).abs_diff(ordered(b.to_f64())) as u64
+    } else {
+        let ordered = |x: f64| {
+            let bits = x.to_bits() as i64;
+            if bits < 0 { i64::MIN - bits } else { bits }
+        };
+        ordered(a.to_f64()).abs_diff(ordered(b.to_f64()))
+    }
+}
+
+/// Random draws for building subjects and signals.
+pub(crate) struct Draw(XorShiftRng);
+
+impl Draw {
+    pub(crate) fn new(seed: u64) -> Self {
+        Self(XorShiftRng::new(seed))
+    }
+
+    /// A value in `-1.0..=1.0`.
+    pub(crate) fn bipolar(&mut self) -> f64 {
+        self.0.next_noise_sample()
+    }
+
+    /// A value in `range`.
+    pub(crate) fn range(&mut self, range: Range<f64>) -> f64 {
+        range.start + (self.bipolar() * 0.5 + 0.5) * (range.end - range.start)
+    }
+
+    /// An index in `0..len`.
+    pub(crate) fn index(&mut self, len: usize) -> usize {
+        ((self.bipolar() * 0.5 + 0.5) * len as f64).min(len as f64 - 1.0) as usize
+    }
+
+    /// One of `items`.
+    pub(crate) fn pick<T: Copy>(&mut self, items: &[T]) -> T {
+        items[self.index(items.len())]
+    }
+}
+
+/// A block configuration under test.
+pub(crate) struct Subject<S: Sample> {
+    pub name: &'static str,
+    /// Builds the block from random draws. Parameters that read modulation
+    /// slot `i` use `Parameter::Modulated(BlockId(i))`.
+    pub build: fn(&mut Draw) -> BlockType<S>,
+    /// Range of each modulation slot, redrawn every buffer.
+    pub modulation: &'static [Range<f64>],
+    pub tolerance: Tolerance,
+}
+
+/// One randomized run.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+struct Case {
+    seed: u64,
+    buffer_size: usize,
+    buffers: usize,
+}
+
+/// The first sample where two paths disagree.
+#[derive(Debug, Clone, Copy)]
+struct Mismatch {
+    buffer: usize,
+    channel: usize,
+    sample: usize,
+    reference: f64,
+    candidate: f64,
+    ulps: u64,
+}
+
+fn run_case<S: Sample>(subject: &Subject<S>, reference: Path, candidate: Path, case: Case) -> Option<Mismatch> {
+    let mut draw = Draw::new(case.seed);
+    let sample_rate = draw.pick(SAMPLE_RATES);
+    let mut expected_block = (subject.build)(&mut Draw::new(case.seed ^ 0x5eed));
+    let mut actual_block = (subject.build)(&mut Draw::new(case.seed ^ 0x5eed));
+
+    let num_inputs = expected_block.input_count();
+    let num_outputs = expected_block.output_count();
+    let mut context = DspContext::new(sample_rate, case.buffer_size, num_outputs.max(1));
+    expected_block.prepare(&context);
+    actual_block.prepare(&context);
+
+    let mut inputs = vec![vec![S::ZERO; case.buffer_size]; num_inputs];
+    let mut expected = vec![vec![S::ZERO; case.buffer_size]; num_outputs];
+    let mut actual = vec![vec![S::ZERO; case.buffer_size]; num_outputs];
+    // Last reference sample of the previous buffer, for edges across buffers
+    let mut previous = vec![f64::NAN; num_outputs];
+
+    for buffer in 0..case.buffers {
+        for sample in inputs.iter_mut().flatten() {
+            *sample = S::from_f64(0.9 * draw.bipolar());
+        }
+        let modulation: Vec<S> = subject
+            .modulation
+            .iter()
+            .map(|range| S::from_f64(draw.range(range.clone())))
+            .collect();
+
+        reference.run(&mut expected_block, &inputs, &mut expected, &modulation, &context);
+        candidate.run(&mut actual_block, &inputs, &mut actual, &modulation, &context);
+
+        for (channel, (expected, actual)) in expected.iter().zip(&actual).enumerate() {
+            for (sample, (&e, &a)) in expected.iter().zip(actual).enumerate() {
+                let before = if sample > 0 {
+                    expected[sample - 1].to_f64()
+                } else {
+                    previous[channel]
+                };
+                let after = expected.get(sample + 1).map_or(f64::NAN, |next| next.to_f64());
+                let near_edge = (e.to_f64() - before).abs() > EDGE_STEP || (after - e.to_f64()).abs() > EDGE_STEP;
+                if !subject.tolerance.accepts(e, a, near_edge) {
+                    return Some(Mismatch {
+                        buffer,
+                        channel,
+                        sample,
+                        reference: e.to_f64(),
+                        candidate: a.to_f64(),
+                        ulps: ulps(e, a),
+                    });
+                }
+            }
+        }
+
+        for (previous, expected) in previous.iter_mut().zip(&expected) {
+            *previous = expected[case.buffer_size - 1].to_f64();
+        }
+        context.advance(case.buffer_size);
+    }
+
+    None
+}
+
+/// Shrink a failing case while it keeps failing.
+fn minimize<S: Sample>(
+    subject: &Subject<S>,
+    reference: Path,
+    candidate: Path,
+    mut case: Case,
+    mut mismatch: Mismatch,
+) -> (Case, Mismatch) {
+    loop {
+        let smaller = [
+            Case { buffers: 1, ..case },
+            Case {
+                buffer_size: case.buffer_size / 2,
+                ..case
+            },
+            Case {
+                buffer_size: case.buffer_size - 1,
+                ..case
+            },
+        ];
+        let next = smaller
+            .into_iter()
+            .filter(|smaller| smaller.buffer_size > 0 && *smaller != case)
+            .find_map(|smaller| run_case(subject, reference, candidate, smaller).map(|found| (smaller, found)));
+
+        match next {
+            Some((smaller, found)) => (case, mismatch) = (smaller, found),
+            None => return (case, mismatch),
+        }
+    }
+}
+
+/// Run `cases` randomized cases of a subject under two paths, panicking with
+/// a minimized case on the first mismatch.
+pub(crate) fn check<S: Sample>(subject: &Subject<S>, reference: Path, candidate: Path, seed: u64, cases: usize) {
+    let mut draw = Draw::new(seed);
+    for i in 0..cases as u64 {
+        let case = Case {
+            seed: seed.wrapping_add(i),
+            buffer_size: 1 + draw.index(MAX_CASE_BUFFER_SIZE),
+            buffers: 1 + draw.index(MAX_CASE_BUFFERS),
+        };
+        if let Some(mismatch) = run_case(subject, reference, candidate, case) {
+            let (case, mismatch) = minimize(subject, reference, candidate, case, mismatch);
+            panic!(
+                "{} ({}-bit): {candidate:?} differs from {reference:?} at buffer {}, channel {}, sample {}: \
+                 {} vs {} ({} ulps, tolerance {:?}); minimized case: {case:?}",
+                subject.name,
+                8 * size_of::<S>(),
+                mismatch.buffer,
+                mismatch.channel,
+                mismatch.sample,
+                mismatch.reference,
+                mismatch.candidate,
+                mismatch.ulps,
+                subject.tolerance,
+            );
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        block::BlockId,
+        blocks::{
+            AmbisonicDecoderBlock, BinauralDecoderBlock, BinauralStrategy, ChannelMergerBlock, ChannelMode,
+            ChannelRouterBlock, ChannelSplitterBlock, DcBlockerBlock, EnvelopeBlock, FileInputBlock, GainBlock,
+            LfoBlock, LowPassFilterBlock, MatrixMixerBlock, MixerBlock, OscillatorBlock, OutputBlock, OverdriveBlock,
+            PannerBlock, VcaBlock,
+        },
+        channel::ChannelLayout,
+        parameter::Parameter,
+        pcm::{PcmEncoding, PcmStore},
+        precision::F64Block,
+        waveform::Waveform,
+    };
+
+    const CASES: usize = 24;
+
+    /// Waveforms whose band-limiting corrections land on single samples, so
+    /// phase rounding can move a correction to a neighbouring sample.
+    const EDGED_WAVEFORMS: &[Waveform] = &[
+        Waveform::Square,
+        Waveform::Sawtooth,
+        Waveform::Pulse,
+        Waveform::Triangle,
+    ];
+
+    /// Number of [`BlockType`] variants.
+    const BLOCK_TYPES: usize = 20;
+
+    /// Block types without a subject: a file output has no outputs to
+    /// compare, only what it hands its writer.
+    const UNCOVERED: &[usize] = &[1];
+
+    /// Index of a block's variant. The match has no wildcard arm, so a new
+    /// variant doesn't compile until it is given an index here, and
+    /// [`test_subjects_cover_every_block_type`] then fails until it has a
+    /// subject or is listed in [`UNCOVERED`].
+    fn variant<S: Sample>(block: &BlockType<S>) -> usize {
+        match block {
+            BlockType::FileInput(_) => 0,
+            BlockType::FileOutput(_) => 1,
+            BlockType::Output(_) => 2,
+            BlockType::Oscillator(_) => 3,
+            BlockType::AmbisonicDecoder(_) => 4,
+            BlockType::BinauralDecoder(_) => 5,
+            BlockType::ChannelMerger(_) => 6,
+            BlockType::ChannelRouter(_) => 7,
+            BlockType::ChannelSplitter(_) => 8,
+            BlockType::DcBlocker(_) => 9,
+            BlockType::Gain(_) => 10,
+            BlockType::LowPassFilter(_) => 11,
+            BlockType::MatrixMixer(_) => 12,
+            BlockType::Mixer(_) => 13,
+            BlockType::Overdrive(_) => 14,
+            BlockType::Panner(_) => 15,
+            BlockType::Vca(_) => 16,
+            BlockType::Envelope(_) => 17,
+            BlockType::Lfo(_) => 18,
+            BlockType::F64(_) => 19,
+        }
+    }
+
+    /// Pick a tolerance by sample precision.
+    fn by_precision<S: Sample>(f32: Tolerance, f64: Tolerance) -> Tolerance {
+        if size_of::<S>() == size_of::<f32>() { f32 } else { f64 }
+    }
+
+    fn subjects<S: Sample>() -> Vec<Subject<S>> {
+        // The scalar oscillator shapes its waveform in f64 and narrows only the
+        // output. The SIMD kernel wraps each lane's phase in f64 too, but
+        // narrows the wrapped phase to `S` to shape four lanes at once. For
+        // f32 that rounding shows up at about -80 dB, and the steep PolyBLEP
+        // correction either side of an edge amplifies it by up to
+        // 1 / (phase increment in cycles). f64 lanes aren't narrowed.
+        let smooth = by_precision::<S>(Tolerance::new(0, -80.0), Tolerance::new(0, -120.0));
+        let edged = by_precision::<S>(Tolerance::new(0, -80.0).near_edges(-60.0), Tolerance::new(0, -120.0));
+
+        vec![
+            Subject {
+                name: "oscillator (sine)",
+                build: |draw| {
+                    let mut osc = OscillatorBlock::new(draw.range(20.0..5000.0), Waveform::Sine, None);
+                    osc.frequency = Parameter::Modulated(BlockId(0));
+                    osc.into()
+                },
+                modulation: &[-10.0..10.0],
+                tolerance: smooth,
+            },
+            Subject {
+                name: "oscillator (edged)",
+                build: |draw| OscillatorBlock::new(draw.range(20.0..5000.0), draw.pick(EDGED_WAVEFORMS), None).into(),
+                modulation: &[],
+                tolerance: edged,
+            },
+            Subject {
+                name: "oscillator (noise)",
+                build: |draw| OscillatorBlock::new(440.0, Waveform::Noise, Some(1 + draw.index(1000) as u64)).into(),
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "lfo",
+                build: |draw| {
+                    let mut lfo = LfoBlock::new(draw.range(0.1..20.0), 1.0, Waveform::Sine, None);
+                    lfo.depth = Parameter::Modulated(BlockId(0));
+                    lfo.into()
+                },
+                modulation: &[0.0..1.0],
+                tolerance: Tolerance::new(0, -110.0),
+            },
+            Subject {
+                name: "gain",
+                build: |draw| {
+                    let mut gain = GainBlock::new(draw.range(-24.0..6.0), None);
+                    if draw.bipolar() > 0.0 {
+                        gain.level_db = Parameter::Modulated(BlockId(0));
+                    }
+                    gain.into()
+                },
+                modulation: &[-24.0..6.0],
+                tolerance: Tolerance::new(1, -120.0),
+            },
+            Subject {
+                name: "stereo panner",
+                build: |draw| {
+                    let mut panner = PannerBlock::new_stereo(draw.range(-100.0..100.0));
+                    panner.position = Parameter::Modulated(BlockId(0));
+                    panner.into()
+                },
+                modulation: &[-100.0..100.0],
+                tolerance: Tolerance::new(4, -120.0),
+            },
+            Subject {
+                name: "surround panner",
+                build: |draw| {
+                    let layout = draw.pick(&[ChannelLayout::Surround51, ChannelLayout::Surround71]);
+                    let mut panner = PannerBlock::new_surround(layout);
+                    panner.azimuth = Parameter::Modulated(BlockId(0));
+                    panner.into()
+                },
+                modulation: &[-180.0..180.0],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "ambisonic panner",
+                build: |draw| {
+                    let mut panner = PannerBlock::new_ambisonic(1 + draw.index(5));
+                    panner.azimuth = Parameter::Modulated(BlockId(0));
+                    panner.elevation = Parameter::Modulated(BlockId(1));
+                    panner.into()
+                },
+                modulation: &[-180.0..180.0, -90.0..90.0],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "mixer",
+                build: |draw| MixerBlock::new(1 + draw.index(4), 1 + draw.index(4)).into(),
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "matrix mixer",
+                build: |draw| {
+                    let (inputs, outputs) = (1 + draw.index(8), 1 + draw.index(8));
+                    let mut mixer = MatrixMixerBlock::new(inputs, outputs);
+                    for input in 0..inputs {
+                        for output in 0..outputs {
+                            mixer.set_gain(input, output, S::from_f64(draw.bipolar()));
+                        }
+                    }
+                    mixer.into()
+                },
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "overdrive",
+                build: |draw| {
+                    let mut overdrive = OverdriveBlock::new(draw.range(1.0..10.0), 0.8, draw.range(0.0..1.0), 48000.0);
+                    overdrive.drive = Parameter::Modulated(BlockId(0));
+                    overdrive.into()
+                },
+                modulation: &[1.0..10.0],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "low-pass filter",
+                build: |draw| {
+                    let mut filter = LowPassFilterBlock::new(draw.range(50.0..15000.0), draw.range(0.5..8.0));
+                    filter.cutoff = Parameter::Modulated(BlockId(0));
+                    filter.into()
+                },
+                modulation: &[50.0..15000.0],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "dc blocker",
+                build: |_| DcBlockerBlock::new(true).into(),
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "vca",
+                build: |_| VcaBlock::new().into(),
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "envelope",
+                build: |draw| {
+                    let mut envelope = EnvelopeBlock::new(draw.range(0.001..0.01), draw.range(0.001..0.01), 0.5, 0.1);
+                    envelope.sustain = Parameter::Modulated(BlockId(0));
+                    envelope.note_on();
+                    envelope.into()
+                },
+                modulation: &[0.0..1.0],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "ambisonic decoder",
+                build: |draw| {
+                    let layout = draw.pick(&[
+                        ChannelLayout::Stereo,
+                        ChannelLayout::Surround51,
+                        ChannelLayout::Surround71,
+                    ]);
+                    AmbisonicDecoderBlock::new(1 + draw.index(3), layout).into()
+                },
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "binaural decoder",
+                build: |draw| {
+                    let strategy = draw.pick(&[BinauralStrategy::Matrix, BinauralStrategy::Hrtf]);
+                    BinauralDecoderBlock::with_strategy(1 + draw.index(3), strategy).into()
+                },
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "channel router",
+                build: |draw| {
+                    let mode = draw.pick(&[
+                        ChannelMode::Stereo,
+                        ChannelMode::Left,
+                        ChannelMode::Right,
+                        ChannelMode::Swap,
+                    ]);
+                    ChannelRouterBlock::new(mode, draw.bipolar() > 0.0, draw.bipolar() > 0.0, draw.bipolar() > 0.0)
+                        .into()
+                },
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "channel merger",
+                build: |draw| ChannelMergerBlock::new(1 + draw.index(8)).into(),
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "channel splitter",
+                build: |draw| ChannelSplitterBlock::new(1 + draw.index(8)).into(),
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "file input",
+                build: |draw| {
+                    // Shorter than a case, so reads wrap around the loop
+                    let len = 100 + draw.index(1000);
+                    let channels: Vec<Vec<f64>> = (0..1 + draw.index(2))
+                        .map(|_| (0..len).map(|_| 0.9 * draw.bipolar()).collect())
+                        .collect();
+                    let channels: Vec<&[f64]> = channels.iter().map(Vec::as_slice).collect();
+                    let encoding = draw.pick(&[PcmEncoding::Pcm16, PcmEncoding::Pcm24]);
+                    let mut input =
+                        FileInputBlock::new(Box::new(PcmStore::from_channels(48000.0, &channels, encoding)));
+                    input.set_loop_enabled(true);
+                    input.into()
+                },
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "output",
+                build: |draw| OutputBlock::new(1 + draw.index(8)).into(),
+                modulation: &[],
+                tolerance: Tolerance::EXACT,
+            },
+            Subject {
+                name: "f64 low-pass filter",
+                build: |draw| {
+                    let mut filter = LowPassFilterBlock::new(draw.range(50.0..15000.0), draw.range(0.5..8.0));
+                    filter.cutoff = Parameter::Modulated(BlockId(0));
+                    let mut block = F64Block::new(filter);
+                    block.reserve(0, 1);
+                    block.into()
+                },
+                modulation: &[50.0..15000.0],
+                tolerance: Tolerance::EXACT,
+            },
+        ]
+    }
+
+    #[test]
+    fn test_subjects_cover_every_block_type() {
+        let mut covered = [false; BLOCK_TYPES];
+        for &index in UNCOVERED {
+            covered[index] = true;
+        }
+        for subject in subjects::<f32>() {
+            let block = (subject.build)(&mut Draw::new(1));
+            covered[variant(&block)] = true;
+        }
+        let missing: Vec<usize> = (0..BLOCK_TYPES).filter(|&index| !covered[index]).collect();
+        assert!(missing.is_empty(), "block types without a subject: {missing:?}");
+    }
+
+    fn check_all<S: Sample>(seed: u64) {
+        for subject in subjects::<S>() {
+            check(&subject, Path::SCALAR, Path::Whole, seed, CASES);
+        }
+    }
+
+    #[test]
+    fn test_whole_buffers_match_scalar_reference_f32() {
+        check_all::<f32>(0x00d1_ff32);
+    }
+
+    #[test]
+    fn test_whole_buffers_match_scalar_reference_f64() {
+        check_all::<f64>(0x00d1_ff64);
+    }
+
+    #[test]
+    fn test_uneven_chunks_match_whole_buffers() {
+        for subject in subjects::<f32>() {
+            check(&subject, Path::Whole, Path::Chunked(7), 0xc4u64, CASES / 2);
+        }
+    }
+
+    #[test]
+    fn test_ulps_and_tolerance() {
+        assert_eq!(ulps(1.0f32, 1.0 + f32::EPSILON), 1);
+        assert_eq!(ulps(-0.0f64, 0.0), 0);
+        assert_eq!(
+            ulps(-f64::MIN_POSITIVE, f64::MIN_POSITIVE),
+            2 * f64::MIN_POSITIVE.to_bits()
+        );
+
+        let tolerance = Tolerance::new(2, -160.0);
+        assert!(tolerance.accepts(1.0f32, 1.0 + 2.0 * f32::EPSILON, false));
+        assert!(!tolerance.accepts(1.0f32, 1.0 + 4.0 * f32::EPSILON, false));
+        assert!(tolerance.accepts(0.0f32, 1e-9, false));
+        assert!(!Tolerance::EXACT.accepts(0.0f32, 1e-30, false));
+
+        let edged = Tolerance::new(0, -80.0).near_edges(-60.0);
+        assert!(!edged.accepts(0.5f32, 0.5005, false));
+        assert!(edged.accepts(0.5f32, 0.5005, true));
+        assert!(!edged.accepts(0.5f32, 0.502, true));
+    }
+
+    #[test]
+    fn test_mismatch_is_minimized() {
+        use std::sync::atomic::{AtomicU64, Ordering};
+
+        // Every second build gets a slightly different gain, so the reference
+        // and candidate always disagree on the first sample
+        static BUILDS: AtomicU64 = AtomicU64::new(0);
+        let subject = Subject::<f32> {
+            name: "gain",
+            build: |_| {
+                let offset = (BUILDS.fetch_add(1, Ordering::Relaxed) % 2) as f64;
+                GainBlock::new(-6.0 + offset, None).into()
+            },
+            modulation: &[],
+            tolerance: Tolerance::EXACT,
+        };
+        let case = Case {
+            seed: 7,
+            buffer_size: 500,
+            buffers: 3,
+        };
+
+        let mismatch = run_case(&subject, Path::SCALAR, Path::Whole, case).expect("builds differ");
+        assert_eq!((mismatch.buffer, mismatch.channel, mismatch.sample), (0, 0, 0));
+
+        let (minimized, _) = minimize(&subject, Path::SCALAR, Path::Whole, case, mismatch);
+        assert_eq!((minimized.buffers, minimized.buffer_size), (1, 1));
+    }
+}
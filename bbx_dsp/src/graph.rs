@@ -7,26 +7,33 @@
 //! buffer allocation, execution ordering via topological sort, and modulation
 //! value collection.
 
-use std::collections::HashMap;
-
-use bbx_core::StackVec;
+use std::{collections::HashMap, ptr};
 
+#[cfg(feature = "trace")]
+use crate::trace::{self, CALLBACK_ID, TraceConsumer, TraceRecorder};
 use crate::{
     block::{BlockCategory, BlockId, BlockType},
     blocks::{effectors::mixer::MixerBlock, io::output::OutputBlock},
     buffer::{AudioBuffer, Buffer},
     channel::ChannelLayout,
     context::DspContext,
+    memory::{BlockMemory, MemoryBudgetExceeded, MemoryReport},
+    modulation::{ModulationMatrix, ModulationRoute, RouteId},
     parameter::Parameter,
+    precision::F64Block,
+    profile::{BlockLoad, BlockProfiler},
     sample::Sample,
+    tap::MeterTaps,
 };
 
-/// Maximum number of inputs a block can have (realtime-safe stack allocation).
-/// Set to 16 to support third-order ambisonics (16 channels).
-pub const MAX_BLOCK_INPUTS: usize = 16;
-/// Maximum number of outputs a block can have (realtime-safe stack allocation).
-/// Set to 16 to support third-order ambisonics (16 channels).
-pub const MAX_BLOCK_OUTPUTS: usize = 16;
+/// Maximum number of inputs a block can have, checked when the graph is built.
+/// Set to 64 for 64-speaker arrays; ambisonic blocks go up to fifth order
+/// ([`MAX_AMBISONIC_ORDER`](crate::ambisonic::MAX_AMBISONIC_ORDER), 36 channels).
+pub const MAX_BLOCK_INPUTS: usize = 64;
+/// Maximum number of outputs a block can have, checked when the graph is built.
+/// Set to 64 for 64-speaker arrays; ambisonic blocks go up to fifth order
+/// ([`MAX_AMBISONIC_ORDER`](crate::ambisonic::MAX_AMBISONIC_ORDER), 36 channels).
+pub const MAX_BLOCK_OUTPUTS: usize = 64;
 
 /// Describes an audio connection between two blocks.
 ///
@@ -98,6 +105,34 @@ pub struct GraphTopologySnapshot {
     pub modulation_connections: Vec<ModulationConnectionSnapshot>,
 }
 
+/// Slice tables passed to each block's `process`, refilled per block.
+///
+/// Sized in `prepare()` to the widest block in the graph rather than to the
+/// I/O limits, so raising the limits costs nothing per call and a graph of
+/// stereo blocks fills the same few entries it always did.
+struct SliceTables<S> {
+    inputs: Box<[*const [S]]>,
+    outputs: Box<[*mut [S]]>,
+}
+
+// SAFETY: The tables only hold pointers into the graph's own audio buffers,
+// written and read inside `process_block_unsafe` on whichever thread owns the
+// graph; nothing dereferences them outside that call.
+unsafe impl<S: Send> Send for SliceTables<S> {}
+
+impl<S> SliceTables<S> {
+    fn new(max_inputs: usize, max_outputs: usize) -> Self {
+        Self {
+            inputs: vec![ptr::slice_from_raw_parts(ptr::null(), 0); max_inputs].into_boxed_slice(),
+            outputs: vec![ptr::slice_from_raw_parts_mut(ptr::null_mut(), 0); max_outputs].into_boxed_slice(),
+        }
+    }
+
+    fn heap_size(&self) -> usize {
+        size_of_val(&*self.inputs) + size_of_val(&*self.outputs)
+    }
+}
+
 /// A directed acyclic graph of connected DSP blocks.
 ///
 /// The graph manages block storage, buffer allocation, and execution ordering.
@@ -113,6 +148,11 @@ pub struct Graph<S: Sample> {
     audio_buffers: Vec<AudioBuffer<S>>,
     modulation_values: Vec<S>,
 
+    // Modulation matrix: routes as added, and the table compiled from them
+    // whenever a route or block is added
+    modulation_routes: Vec<ModulationRoute>,
+    modulation_matrix: ModulationMatrix<S>,
+
     // Buffer management
     block_buffer_start: Vec<usize>,
     buffer_size: usize,
@@ -121,6 +161,21 @@ pub struct Graph<S: Sample> {
     // Pre-computed connection lookups: block_id -> [input buffer indices]
     // Computed once in prepare() for O(1) lookup during processing
     block_input_buffers: Vec<Vec<usize>>,
+    slice_tables: SliceTables<S>,
+
+    // f64 islands, computed in prepare(): for each input of an F64 block, the
+    // F64 block and output it reads from directly, if any; and for each block,
+    // whether its f64 outputs must be narrowed into the graph's buffers
+    wide_input_sources: Vec<Vec<Option<(usize, usize)>>>,
+    narrow_outputs: Vec<bool>,
+
+    memory_budget: Option<usize>,
+    budget_exceeded: Option<MemoryBudgetExceeded>,
+    profiler: Option<BlockProfiler>,
+    taps: Option<MeterTaps>,
+
+    #[cfg(feature = "trace")]
+    tracer: Option<TraceRecorder>,
 }
 
 impl<S: Sample> Graph<S> {
@@ -131,6 +186,9 @@ impl<S: Sample> Graph<S> {
             buffer_size,
             num_channels,
             current_sample: 0,
+            is_playing: true,
+            tempo: None,
+            ppq_position: None,
             channel_layout: ChannelLayout::default(),
         };
 
@@ -141,10 +199,21 @@ impl<S: Sample> Graph<S> {
             output_block: None,
             audio_buffers: Vec::new(),
             modulation_values: Vec::new(),
+            modulation_routes: Vec::new(),
+            modulation_matrix: ModulationMatrix::empty(),
             block_buffer_start: Vec::new(),
             buffer_size,
             context,
             block_input_buffers: Vec::new(),
+            slice_tables: SliceTables::new(0, 0),
+            wide_input_sources: Vec::new(),
+            narrow_outputs: Vec::new(),
+            memory_budget: None,
+            budget_exceeded: None,
+            profiler: None,
+            taps: None,
+            #[cfg(feature = "trace")]
+            tracer: None,
         }
     }
 
@@ -179,7 +248,26 @@ impl<S: Sample> Graph<S> {
     /// * `sample_rate` - Sample rate in Hz
     /// * `buffer_size` - Buffer size in samples
     /// * `num_channels` - Number of audio channels
+    ///
+    /// A graph over its memory budget (see
+    /// [`set_memory_budget`](Self::set_memory_budget)) is still prepared; the
+    /// overrun is kept in [`memory_budget_exceeded`](Self::memory_budget_exceeded).
+    /// Use [`try_prepare`](Self::try_prepare) to get it as an error.
     pub fn prepare(&mut self, sample_rate: f64, buffer_size: usize, num_channels: usize) {
+        let _ = self.try_prepare(sample_rate, buffer_size, num_channels);
+    }
+
+    /// Prepare the graph like [`prepare`](Self::prepare), returning an error
+    /// if it exceeds its memory budget.
+    ///
+    /// The graph is fully prepared either way; the error only reports that
+    /// it holds more memory than allowed.
+    pub fn try_prepare(
+        &mut self,
+        sample_rate: f64,
+        buffer_size: usize,
+        num_channels: usize,
+    ) -> Result<(), MemoryBudgetExceeded> {
         self.context.sample_rate = sample_rate;
         self.context.buffer_size = buffer_size;
         self.context.num_channels = num_channels;
@@ -190,8 +278,7 @@ impl<S: Sample> Graph<S> {
         }
 
         // Compute execution order and pre-allocate modulation value storage
-        self.execution_order = self.topological_sort();
-        self.modulation_values.resize(self.blocks.len(), S::ZERO);
+        self.prepare_modulation();
 
         // Pre-compute input buffer indices for each block (O(1) lookup during processing)
         self.block_input_buffers = vec![Vec::new(); self.blocks.len()];
@@ -200,8 +287,220 @@ impl<S: Sample> Graph<S> {
             self.block_input_buffers[conn.to.0].push(buffer_idx);
         }
 
+        let max_inputs = self.block_input_buffers.iter().map(Vec::len).max().unwrap_or(0);
+        let max_outputs = self.blocks.iter().map(BlockType::output_count).max().unwrap_or(0);
+        self.slice_tables = SliceTables::new(max_inputs, max_outputs);
+        self.prepare_islands();
+
         #[cfg(debug_assertions)]
         self.validate_buffer_indices();
+
+        self.budget_exceeded = self.memory_budget.and_then(|budget| {
+            let report = self.memory_report();
+            (report.total() > budget).then(|| MemoryBudgetExceeded::new(&report, budget))
+        });
+        match &self.budget_exceeded {
+            Some(e) => Err(e.clone()),
+            None => Ok(()),
+        }
+    }
+
+    /// Limit the memory the graph may hold, in bytes, checked on every
+    /// [`prepare`](Self::prepare). `None` removes the limit.
+    pub fn set_memory_budget(&mut self, budget: Option<usize>) {
+        self.memory_budget = budget;
+    }
+
+    /// Get the configured memory budget in bytes.
+    pub fn memory_budget(&self) -> Option<usize> {
+        self.memory_budget
+    }
+
+    /// How far the graph exceeded its memory budget at the last prepare, if it did.
+    pub fn memory_budget_exceeded(&self) -> Option<&MemoryBudgetExceeded> {
+        self.budget_exceeded.as_ref()
+    }
+
+    /// Report the memory the graph holds, broken down by block.
+    ///
+    /// Each block is charged for its output buffers plus the state and
+    /// shared data it reports through
+    /// [`Block::memory_footprint`](crate::block::Block::memory_footprint).
+    /// Everything else the graph allocates (connections, execution order,
+    /// buffer lookups, unused block slots) is reported as `graph`.
+    /// Allocates; call it off the audio thread.
+    pub fn memory_report(&self) -> MemoryReport {
+        let blocks = self
+            .blocks
+            .iter()
+            .enumerate()
+            .map(|(id, block)| {
+                let start = self.block_buffer_start[id];
+                let buffers = self.audio_buffers[start..start + block.output_count()]
+                    .iter()
+                    .map(|buffer| buffer.capacity() * size_of::<S>())
+                    .sum();
+                let footprint = block.memory_footprint();
+                BlockMemory {
+                    id: BlockId(id),
+                    name: block.name(),
+                    category: block.category(),
+                    buffers,
+                    state: footprint.state,
+                    shared: footprint.shared,
+                }
+            })
+            .collect();
+
+        let input_lookups: usize = self
+            .block_input_buffers
+            .iter()
+            .map(|inputs| inputs.capacity() * size_of::<usize>())
+            .sum();
+        let wide_lookups: usize = self
+            .wide_input_sources
+            .iter()
+            .map(|sources| sources.capacity() * size_of::<Option<(usize, usize)>>())
+            .sum();
+        let graph = size_of::<Self>()
+            + (self.blocks.capacity() - self.blocks.len()) * size_of::<BlockType<S>>()
+            + self.connections.capacity() * size_of::<Connection>()
+            + self.execution_order.capacity() * size_of::<BlockId>()
+            + self.audio_buffers.capacity() * size_of::<AudioBuffer<S>>()
+            + self.modulation_values.capacity() * size_of::<S>()
+            + self.modulation_routes.capacity() * size_of::<ModulationRoute>()
+            + self.modulation_matrix.heap_size()
+            + self.block_buffer_start.capacity() * size_of::<usize>()
+            + self.block_input_buffers.capacity() * size_of::<Vec<usize>>()
+            + input_lookups
+            + self.slice_tables.heap_size()
+            + self.wide_input_sources.capacity() * size_of::<Vec<Option<(usize, usize)>>>()
+            + wide_lookups
+            + self.narrow_outputs.capacity() * size_of::<bool>();
+
+        MemoryReport { blocks, graph }
+    }
+
+    /// Add a route to the modulation matrix.
+    ///
+    /// The routed parameter is pointed at its slot, the slot is allocated and
+    /// the execution order is updated straight away, so a prepared graph
+    /// picks up the route on its next buffer. Adding a route may move other
+    /// routed parameters to new slots; they are repointed at the same time.
+    /// Allocates, so call it off the audio thread. Returns an error if the
+    /// source isn't a modulator block, or if the target block has no
+    /// parameter with the given name.
+    pub fn add_route(&mut self, route: ModulationRoute) -> Result<RouteId, String> {
+        let source = self
+            .blocks
+            .get(route.source.0)
+            .ok_or_else(|| format!("Unknown modulation source: block {}", route.source.0))?;
+        if !source.is_modulator() {
+            return Err(format!("Modulation source block {} is not a modulator", route.source.0));
+        }
+        if route.target.0 >= self.blocks.len() {
+            return Err(format!("Unknown modulation target: block {}", route.target.0));
+        }
+
+        self.modulation_routes.push(route);
+        if let Err(e) = self.compile_modulation_matrix() {
+            self.modulation_routes.pop();
+            self.compile_modulation_matrix()?;
+            return Err(e);
+        }
+        self.prepare_modulation();
+        Ok(RouteId(self.modulation_routes.len() - 1))
+    }
+
+    /// Get the routes in the modulation matrix, indexed by [`RouteId`].
+    #[inline]
+    pub fn modulation_routes(&self) -> &[ModulationRoute] {
+        &self.modulation_routes
+    }
+
+    /// Change the depth of a route without re-preparing the graph.
+    ///
+    /// Realtime-safe, so it can be driven from the audio thread, for example
+    /// from [`PluginDsp::apply_parameters`](crate::PluginDsp::apply_parameters).
+    /// Returns `false` if the route doesn't exist.
+    #[inline]
+    pub fn set_route_depth(&mut self, route: RouteId, depth: f64) -> bool {
+        let Some(spec) = self.modulation_routes.get_mut(route.0) else {
+            return false;
+        };
+        spec.depth = depth;
+        self.modulation_matrix.set_depth(route, S::from_f64(depth));
+        true
+    }
+
+    /// Work out where f64 islands need conversions, and size their buffers.
+    ///
+    /// An F64 block reads inputs from other F64 blocks without converting
+    /// them. Its outputs are narrowed into the graph's buffers only if a
+    /// narrow block reads them, or if it is a modulator or has no outgoing
+    /// connections.
+    fn prepare_islands(&mut self) {
+        let is_wide: Vec<bool> = self
+            .blocks
+            .iter()
+            .map(|block| matches!(block, BlockType::F64(_)))
+            .collect();
+
+        self.wide_input_sources = vec![Vec::new(); self.blocks.len()];
+        self.narrow_outputs = self
+            .blocks
+            .iter()
+            .enumerate()
+            .map(|(id, block)| {
+                is_wide[id] && (block.is_modulator() || !self.connections.iter().any(|c| c.from.0 == id))
+            })
+            .collect();
+
+        for conn in &self.connections {
+            if is_wide[conn.to.0] {
+                let source = is_wide[conn.from.0].then_some((conn.from.0, conn.from_output));
+                self.wide_input_sources[conn.to.0].push(source);
+            } else if is_wide[conn.from.0] {
+                self.narrow_outputs[conn.from.0] = true;
+            }
+        }
+
+        let num_modulation_values = self.modulation_values.len();
+        for (block, inputs) in self.blocks.iter_mut().zip(&self.block_input_buffers) {
+            if let BlockType::F64(block) = block {
+                block.reserve(inputs.len(), num_modulation_values);
+            }
+        }
+    }
+
+    /// Order the blocks and size the modulation values for every block and
+    /// routed parameter, including the copies F64 blocks keep.
+    fn prepare_modulation(&mut self) {
+        self.execution_order = self.topological_sort();
+        self.modulation_values
+            .resize(self.blocks.len() + self.modulation_matrix.num_destinations(), S::ZERO);
+
+        let num_modulation_values = self.modulation_values.len();
+        for (block, inputs) in self.blocks.iter_mut().zip(&self.block_input_buffers) {
+            if let BlockType::F64(block) = block {
+                block.reserve(inputs.len(), num_modulation_values);
+            }
+        }
+    }
+
+    /// Compile the modulation routes and point each routed parameter at its slot.
+    ///
+    /// Slots follow the blocks, so this runs again whenever a block is added.
+    fn compile_modulation_matrix(&mut self) -> Result<(), String> {
+        let num_blocks = self.blocks.len();
+        let (matrix, destinations) = ModulationMatrix::compile(&self.modulation_routes, num_blocks);
+        for (index, (target, parameter)) in destinations.into_iter().enumerate() {
+            if let Some(block) = self.blocks.get_mut(target.0) {
+                block.set_parameter(parameter, Parameter::Modulated(BlockId(num_blocks + index)))?;
+            }
+        }
+        self.modulation_matrix = matrix;
+        Ok(())
     }
 
     /// Reset all blocks in the graph to their initial state.
@@ -215,6 +514,132 @@ impl<S: Sample> Graph<S> {
         }
     }
 
+    /// The transport position in samples.
+    #[inline]
+    pub fn position(&self) -> u64 {
+        self.context.current_sample
+    }
+
+    /// Whether the transport is running.
+    #[inline]
+    pub fn is_playing(&self) -> bool {
+        self.context.is_playing
+    }
+
+    /// Start or stop the transport.
+    ///
+    /// While stopped the position holds, and blocks that follow the timeline
+    /// (file inputs) output silence. Generators keep running so tails and
+    /// monitoring still sound.
+    pub fn set_playing(&mut self, playing: bool) {
+        self.context.is_playing = playing;
+    }
+
+    /// Set the tempo in beats per minute, or `None` if unknown.
+    ///
+    /// The quarter-note position is recomputed from the current sample
+    /// position.
+    pub fn set_tempo(&mut self, tempo: Option<f64>) {
+        self.context.tempo = tempo;
+        self.context.set_position(self.context.current_sample);
+    }
+
+    /// Move the transport to `position` samples and bring every block's state
+    /// to that point.
+    ///
+    /// Blocks whose state is a function of time alone (oscillators and LFOs at
+    /// a constant frequency, file inputs, stateless effects) jump there
+    /// exactly. Blocks whose state depends on the signal history (filters,
+    /// modulated oscillators) are reset instead, and need a short pre-roll
+    /// before their output matches an uninterrupted render.
+    ///
+    /// Envelopes keep their note: one in attack or decay moves straight to
+    /// its last sustain level, and one in release goes idle. Both count as
+    /// inexact. An idle or sustaining envelope is already where it would be.
+    ///
+    /// Returns `true` if every block seeked exactly. Cost is one call per
+    /// block, independent of `position`.
+    pub fn seek(&mut self, position: u64) -> bool {
+        self.context.set_position(position);
+        let mut exact = true;
+        for block in &mut self.blocks {
+            exact &= block.seek(position, &self.context);
+        }
+        exact
+    }
+
+    /// Start measuring each block's share of the callback budget.
+    ///
+    /// Loads are averaged over `window` calls to `process_buffers` and
+    /// published lock-free through the returned handle, indexed by block ID.
+    /// Replaces any profile already in progress.
+    pub fn enable_profiling(&mut self, window: usize) -> BlockLoad {
+        let (profiler, load) = BlockProfiler::new(self.blocks.len(), window);
+        self.profiler = Some(profiler);
+        load
+    }
+
+    /// Stop measuring block loads.
+    pub fn disable_profiling(&mut self) {
+        self.profiler = None;
+    }
+
+    /// Get the handle for metering taps on block outputs, creating it on
+    /// first use.
+    ///
+    /// All taps start switched off; switch them with
+    /// [`MeterTaps::set`] from any thread while the graph runs.
+    pub fn enable_taps(&mut self) -> MeterTaps {
+        let output_counts = self.blocks.iter().map(|block| block.output_count());
+        self.taps.get_or_insert_with(|| MeterTaps::new(output_counts)).clone()
+    }
+
+    /// Remove metering taps. Existing handles keep their last readings.
+    pub fn disable_taps(&mut self) {
+        self.taps = None;
+    }
+
+    /// Start recording per-block and per-callback timing.
+    ///
+    /// Allocates a ring of `capacity` events; each `process_buffers` call
+    /// records one event per block plus one for the whole call. Events are
+    /// labelled with the block's name and index. Pass the returned consumer
+    /// to a [`TraceWriter`](crate::trace::TraceWriter) or drain it yourself.
+    /// Replaces any trace already in progress.
+    #[cfg(feature = "trace")]
+    pub fn enable_tracing(&mut self, capacity: usize) -> TraceConsumer {
+        let names = self
+            .blocks
+            .iter()
+            .enumerate()
+            .map(|(id, block)| format!("{} #{id}", block.name()))
+            .collect();
+        let (recorder, consumer) = trace::trace_channel(capacity, names, "process_buffers");
+        self.tracer = Some(recorder);
+        consumer
+    }
+
+    /// Stop recording timing.
+    #[cfg(feature = "trace")]
+    pub fn disable_tracing(&mut self) {
+        self.tracer = None;
+    }
+
+    /// Current trace time, or 0 without reading the clock when not tracing.
+    #[cfg(feature = "trace")]
+    #[inline]
+    fn trace_start(&self) -> u64 {
+        if self.tracer.is_some() { trace::now_ns() } else { 0 }
+    }
+
+    #[cfg(feature = "trace")]
+    #[inline]
+    fn trace_end(&mut self, id: u32, start_ns: u64) {
+        if let Some(tracer) = &mut self.tracer {
+            tracer.record(id, start_ns);
+        }
+    }
+
     /// Add an arbitrary block to the `Graph`.
     pub fn add_block(&mut self, block: BlockType<S>) -> BlockId {
         let block_id = BlockId(self.blocks.len());
@@ -227,6 +652,11 @@ impl<S: Sample> Graph<S> {
             self.audio_buffers.push(AudioBuffer::new(self.buffer_size));
         }
 
+        if !self.modulation_routes.is_empty() {
+            // Routes were validated when added, so this can't fail.
+            let _ = self.compile_modulation_matrix();
+        }
+
         block_id
     }
 
@@ -273,13 +703,34 @@ impl<S: Sample> Graph<S> {
         }
     }
 
+    /// Order blocks so each runs after the blocks it reads audio from and the
+    /// modulators routed to its parameters.
     fn topological_sort(&self) -> Vec<BlockId> {
+        let connections = self.connections.iter().map(|c| (c.from, c.to));
+        let routes = self
+            .modulation_routes
+            .iter()
+            .filter(|route| route.source != route.target)
+            .map(|route| (route.source, route.target));
+
+        // Routes between modulators can form a cycle. Order by connections
+        // alone then, so those targets read the previous buffer's values.
+        let order = self.sort_edges(connections.clone().chain(routes));
+        if order.len() == self.blocks.len() {
+            order
+        } else {
+            self.sort_edges(connections)
+        }
+    }
+
+    /// Order blocks so each runs after the sources of its incoming `edges`.
+    fn sort_edges(&self, edges: impl Iterator<Item = (BlockId, BlockId)>) -> Vec<BlockId> {
         let mut in_degree = vec![0; self.blocks.len()];
         let mut adjacency_list: HashMap<BlockId, Vec<BlockId>> = HashMap::new();
 
-        for connection in &self.connections {
-            adjacency_list.entry(connection.from).or_default().push(connection.to);
-            in_degree[connection.to.0] += 1;
+        for (from, to) in edges {
+            adjacency_list.entry(from).or_default().push(to);
+            in_degree[to.0] += 1;
         }
 
         // Kahn's algorithm
@@ -313,73 +764,113 @@ impl<S: Sample> Graph<S> {
     /// to the provided buffers (one per channel).
     #[inline]
     pub fn process_buffers(&mut self, output_buffers: &mut [&mut [S]]) {
+        #[cfg(feature = "trace")]
+        let callback_start = self.trace_start();
+
+        if let Some(profiler) = &mut self.profiler {
+            profiler.begin_callback();
+        }
+
         for buffer in &mut self.audio_buffers {
             buffer.zeroize();
         }
 
         for i in 0..self.execution_order.len() {
             let block_id = self.execution_order[i];
+            #[cfg(feature = "trace")]
+            let block_start = self.trace_start();
+
+            self.modulation_matrix.evaluate(block_id.0, &mut self.modulation_values);
             self.process_block_unsafe(block_id);
             self.collect_modulation_values(block_id);
+            self.measure_taps(block_id);
+
+            if let Some(profiler) = &mut self.profiler {
+                profiler.block_done(block_id.0);
+            }
+
+            #[cfg(feature = "trace")]
+            self.trace_end(block_id.0 as u32, block_start);
         }
 
         self.copy_to_output_buffer(output_buffers);
+
+        if let Some(profiler) = &mut self.profiler {
+            let budget_ns = 1e9 * self.context.buffer_size as f64 / self.context.sample_rate;
+            profiler.end_callback(budget_ns);
+        }
+
+        self.context.advance(self.buffer_size);
+
+        #[cfg(feature = "trace")]
+        self.trace_end(CALLBACK_ID, callback_start);
     }
 
     #[inline]
     fn process_block_unsafe(&mut self, block_id: BlockId) {
         // Use pre-computed input buffer indices (O(1) lookup instead of O(n) scan)
         let input_indices = &self.block_input_buffers[block_id.0];
-
-        // Build output indices using stack allocation (no heap allocation)
-        let mut output_indices: StackVec<usize, MAX_BLOCK_OUTPUTS> = StackVec::new();
+        let output_start = self.block_buffer_start[block_id.0];
         let output_count = self.blocks[block_id.0].output_count();
+
+        let tables = &mut self.slice_tables;
         debug_assert!(
-            output_count <= MAX_BLOCK_OUTPUTS,
-            "Block output count {output_count} exceeds MAX_BLOCK_OUTPUTS {MAX_BLOCK_OUTPUTS}"
+            input_indices.len() <= tables.inputs.len() && output_count <= tables.outputs.len(),
+            "Block {} has more inputs or outputs than the slice tables sized in prepare()",
+            block_id.0
         );
-        for output_index in 0..output_count {
-            let buffer_index = self.get_buffer_index(block_id, output_index);
-            output_indices.push_unchecked(buffer_index);
-        }
+        let input_count = input_indices.len().min(tables.inputs.len());
+        let output_count = output_count.min(tables.outputs.len());
 
         // SAFETY: Our buffer indexing guarantees that:
         // 1. Input indices come from other blocks' outputs.
         // 2. Output indices are unique to this block.
         // 3. Therefore, input_indices and output_indices NEVER overlap.
         // 4. All indices are valid (within the bounds of self.audio_buffers).
+        // The tables are refilled for this block before being read, and
+        // `*const [S]`/`*mut [S]` have the same layout as `&[S]`/`&mut [S]`.
         unsafe {
             let buffers_ptr = self.audio_buffers.as_mut_ptr();
 
-            // Build input slices using stack allocation (no heap allocation)
-            let mut input_slices: StackVec<&[S], MAX_BLOCK_INPUTS> = StackVec::new();
-            let input_count = input_indices.len();
-            debug_assert!(
-                input_count <= MAX_BLOCK_INPUTS,
-                "Block input count {input_count} exceeds MAX_BLOCK_INPUTS {MAX_BLOCK_INPUTS}"
-            );
-            for &index in input_indices {
-                let buffer_ptr = buffers_ptr.add(index);
-                let slice = std::slice::from_raw_parts((*buffer_ptr).as_ptr(), (*buffer_ptr).len());
-                // SAFETY: We verified input_indices.len() <= MAX_BLOCK_INPUTS via debug_assert
-                input_slices.push_unchecked(slice);
+            for (slot, &index) in tables.inputs.iter_mut().zip(input_indices) {
+                let buffer = &*buffers_ptr.add(index);
+                *slot = ptr::slice_from_raw_parts(buffer.as_ptr(), buffer.len());
             }
 
-            // Build output slices using stack allocation (no heap allocation)
-            let mut output_slices: StackVec<&mut [S], MAX_BLOCK_OUTPUTS> = StackVec::new();
-            for &index in output_indices.as_slice() {
-                let buffer_ptr = buffers_ptr.add(index);
-                let slice = std::slice::from_raw_parts_mut((*buffer_ptr).as_mut_ptr(), (*buffer_ptr).len());
-                // SAFETY: output_indices.len() <= MAX_BLOCK_OUTPUTS (already verified above)
-                output_slices.push_unchecked(slice);
+            for (output_index, slot) in tables.outputs[..output_count].iter_mut().enumerate() {
+                let buffer = &mut *buffers_ptr.add(output_start + output_index);
+                *slot = ptr::slice_from_raw_parts_mut(buffer.as_mut_ptr(), buffer.len());
             }
 
-            self.blocks[block_id.0].process(
-                input_slices.as_slice(),
-                output_slices.as_mut_slice(),
-                &self.modulation_values,
-                &self.context,
-            );
+            let input_slices = &*(ptr::from_ref(&tables.inputs[..input_count]) as *const [&[S]]);
+            let output_slices = &mut *(ptr::from_mut(&mut tables.outputs[..output_count]) as *mut [&mut [S]]);
+
+            let blocks_ptr = self.blocks.as_mut_ptr();
+            match &mut *blocks_ptr.add(block_id.0) {
+                BlockType::F64(block) => {
+                    // Inputs from other F64 blocks are read in f64. The
+                    // execution order excludes cycles, so a block never reads
+                    // its own outputs.
+                    for (index, &source) in self.wide_input_sources[block_id.0].iter().enumerate() {
+                        let wide = source.and_then(|(source_id, output)| match &*blocks_ptr.add(source_id) {
+                            BlockType::F64(source) => Some(source.output(output)),
+                            _ => None,
+                        });
+                        block.set_wide_input(index, wide);
+                    }
+
+                    block.process_mixed(input_slices, self.buffer_size, &self.modulation_values, &self.context);
+
+                    let narrow_all = self.narrow_outputs[block_id.0];
+                    let tapped = self.taps.as_ref().map_or(0, |taps| taps.enabled_outputs(block_id.0));
+                    for (index, output) in output_slices.iter_mut().enumerate() {
+                        if narrow_all || (tapped >> index) & 1 != 0 {
+                            block.narrow_output(index, output);
+                        }
+                    }
+                }
+                block => block.process(input_slices, output_slices, &self.modulation_values, &self.context),
+            }
         }
     }
 
@@ -418,6 +909,21 @@ impl<S: Sample> Graph<S> {
         }
     }
 
+    #[inline]
+    fn measure_taps(&self, block_id: BlockId) {
+        let Some(taps) = &self.taps else {
+            return;
+        };
+        let mut enabled = taps.enabled_outputs(block_id.0);
+        while enabled != 0 {
+            let output = enabled.trailing_zeros() as usize;
+            enabled &= enabled - 1;
+            if let Some(buffer) = self.audio_buffers.get(self.get_buffer_index(block_id, output)) {
+                taps.measure(block_id.0, output, buffer.as_slice());
+            }
+        }
+    }
+
     fn copy_to_output_buffer(&self, output_buffer: &mut [&mut [S]]) {
         // In a more complex system, there could be multiple output blocks...
         if let Some(output_block_id) = self.output_block {
@@ -487,6 +993,26 @@ impl<S: Sample> GraphBuilder<S> {
         self.graph.add_block(block.into())
     }
 
+    /// Add a block that runs in `f64`, whatever the graph's sample type.
+    ///
+    /// Use it for blocks that lose precision in `f32`, such as filters with
+    /// low cutoffs or long integrators, and keep the rest of the graph in
+    /// `f32`. Signals are converted only where they cross between `f32` and
+    /// `f64` blocks; see [`precision`](crate::precision).
+    ///
+    /// # Example
+    ///
+    /// ```ignore
+    /// let mut builder = GraphBuilder::<f32>::new(44100.0, 512, 2);
+    /// let osc = builder.add(OscillatorBlock::new(110.0, Waveform::Sawtooth, None));
+    /// let filter = builder.add_f64(LowPassFilterBlock::new(40.0, 0.707));
+    /// let gain = builder.add(GainBlock::new(-6.0, None));
+    /// builder.connect(osc, 0, filter, 0).connect(filter, 0, gain, 0);
+    /// ```
+    pub fn add_f64<B: Into<BlockType<f64>>>(&mut self, block: B) -> BlockId {
+        self.add(F64Block::new(block))
+    }
+
     /// Form a `Connection` between two particular blocks.
     pub fn connect(&mut self, from: BlockId, from_output: usize, to: BlockId, to_input: usize) -> &mut Self {
         self.graph.connect(from, from_output, to, to_input);
@@ -501,6 +1027,32 @@ impl<S: Sample> GraphBuilder<S> {
         self
     }
 
+    /// Add a route to the modulation matrix.
+    ///
+    /// Unlike [`modulate`](Self::modulate), any number of routes can target
+    /// the same parameter, each with its own depth, offset and curve; their
+    /// contributions are summed. Keep the returned [`RouteId`] to change the
+    /// route's depth later with [`Graph::set_route_depth`].
+    ///
+    /// # Example
+    ///
+    /// ```ignore
+    /// let vibrato = builder.route(ModulationRoute::new(lfo, osc, "frequency").depth(5.0))?;
+    /// builder.route(ModulationRoute::new(env, osc, "frequency").depth(220.0).offset(440.0))?;
+    /// ```
+    pub fn route(&mut self, route: ModulationRoute) -> Result<RouteId, String> {
+        self.graph.add_route(route)
+    }
+
+    /// Limit the memory the built graph may hold, in bytes.
+    ///
+    /// The budget is checked when the graph is prepared, both by
+    /// [`build`](Self::build) and by later calls to [`Graph::prepare`].
+    pub fn memory_budget(&mut self, bytes: usize) -> &mut Self {
+        self.graph.set_memory_budget(Some(bytes));
+        self
+    }
+
     /// Capture a snapshot of the current graph topology for visualization.
     ///
     /// Returns owned data suitable for cross-thread transfer to a visualization
@@ -533,6 +1085,9 @@ impl<S: Sample> GraphBuilder<S> {
             })
             .collect();
 
+        // Parameters driven by the modulation matrix reference a slot past the
+        // blocks rather than a source, so list their routes instead.
+        let num_blocks = self.graph.blocks.len();
         let modulation_connections = self
             .graph
             .blocks
@@ -542,12 +1097,23 @@ impl<S: Sample> GraphBuilder<S> {
                 block
                     .get_modulated_parameters()
                     .into_iter()
+                    .filter(move |(_, source_id)| source_id.0 < num_blocks)
                     .map(move |(param_name, source_id)| ModulationConnectionSnapshot {
                         from_block: source_id.0,
                         to_block: target_id,
                         parameter_name: param_name.to_string(),
                     })
             })
+            .chain(
+                self.graph
+                    .modulation_routes
+                    .iter()
+                    .map(|route| ModulationConnectionSnapshot {
+                        from_block: route.source.0,
+                        to_block: route.target.0,
+                        parameter_name: route.parameter.clone(),
+                    }),
+            )
             .collect();
 
         GraphTopologySnapshot {
@@ -567,6 +1133,9 @@ impl<S: Sample> GraphBuilder<S> {
     ///
     /// Panics if any block has more inputs or outputs than the realtime-safe
     /// limits (`MAX_BLOCK_INPUTS` or `MAX_BLOCK_OUTPUTS`).
+    ///
+    /// A graph over its [memory budget](Self::memory_budget) is still built;
+    /// see [`Graph::memory_budget_exceeded`] or use [`try_build`](Self::try_build).
     pub fn build(mut self) -> Graph<S> {
         let sample_rate = self.graph.context.sample_rate;
         let buffer_size = self.graph.context.buffer_size;
@@ -654,6 +1223,21 @@ impl<S: Sample> GraphBuilder<S> {
         self.graph
     }
 
+    /// Prepare the final DSP `Graph` like [`build`](Self::build), returning
+    /// an error if it exceeds its memory budget.
+    ///
+    /// # Panics
+    ///
+    /// Panics if any block has more inputs or outputs than the realtime-safe
+    /// limits (`MAX_BLOCK_INPUTS` or `MAX_BLOCK_OUTPUTS`).
+    pub fn try_build(self) -> Result<Graph<S>, MemoryBudgetExceeded> {
+        let graph = self.build();
+        match graph.memory_budget_exceeded() {
+            Some(e) => Err(e.clone()),
+            None => Ok(graph),
+        }
+    }
+
     /// Find an explicit mixer (Mixer or MatrixMixer) that has connections from terminal blocks.
     fn find_explicit_mixer(&self, terminal_blocks: &[BlockId]) -> Option<BlockId> {
         for (idx, block) in self.graph.blocks.iter().enumerate() {
@@ -684,3 +1268,28 @@ impl<S: Sample> GraphBuilder<S> {
         }
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        blocks::{GainBlock, LfoBlock, OscillatorBlock},
+        waveform::Waveform,
+    };
+
+    #[test]
+    fn test_modulator_added_after_target_runs_first() {
+        let mut builder = GraphBuilder::<f32>::new(44100.0, 64, 1);
+        let gain = builder.add(GainBlock::new(0.0, None));
+        let lfo = builder.add(LfoBlock::new(1.0, 1.0, Waveform::Sine, None));
+        let osc = builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+        builder.connect(osc, 0, gain, 0);
+        builder.route(ModulationRoute::new(lfo, gain, "level")).unwrap();
+        let graph = builder.build();
+
+        let position = |id: BlockId| graph.execution_order.iter().position(|&block| block == id).unwrap();
+        assert!(position(lfo) < position(gain), "order: {:?}", graph.execution_order);
+        assert!(position(osc) < position(gain));
+        assert_eq!(graph.execution_order.len(), graph.blocks.len());
+    }
+}
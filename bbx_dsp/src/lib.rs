@@ -35,17 +35,25 @@
 
 #![cfg_attr(feature = "simd", feature(portable_simd))]
 
+pub mod ambisonic;
 pub mod block;
 pub mod blocks;
 pub mod buffer;
 pub mod channel;
 pub mod context;
+#[cfg(test)]
+pub(crate) mod differential;
 pub mod frame;
 pub mod graph;
+pub mod memory;
+pub mod modulation;
 pub mod parameter;
+pub mod pcm;
 pub mod plugin;
 pub mod polyblep;
+pub mod precision;
 pub mod prelude;
+pub mod profile;
 pub mod reader;
 pub mod sample {
     //! Audio sample type abstraction.
@@ -54,6 +62,9 @@ pub mod sample {
     pub use bbx_core::sample::*;
 }
 pub mod smoothing;
+pub mod tap;
+#[cfg(feature = "trace")]
+pub mod trace;
 pub mod voice;
 pub mod waveform;
 pub mod writer;
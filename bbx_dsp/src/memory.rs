@@ -0,0 +1,241 @@
+//! Memory accounting for graphs and blocks.
+//!
+//! Each block reports its own [`MemoryFootprint`] through
+//! [`Block::memory_footprint`](crate::block::Block::memory_footprint), and
+//! [`Graph::memory_report`](crate::graph::Graph::memory_report) combines those
+//! with the audio buffers and scheduling tables the graph owns.
+//!
+//! Sizes are bytes held, not bytes touched per callback: allocated capacity
+//! counts even when unused. Data a block shares with other owners, such as a
+//! reader's decoded samples or a ring buffer shared with a writer thread, is
+//! reported separately as `shared` so it isn't mistaken for per-block state.
+
+use std::fmt;
+
+use crate::block::{BlockCategory, BlockId};
+
+/// Memory held by one block, excluding the graph's audio buffers.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct MemoryFootprint {
+    /// The block itself plus any heap storage only it owns.
+    pub state: usize,
+    /// Data the block shares with other owners or threads.
+    pub shared: usize,
+}
+
+impl MemoryFootprint {
+    /// Footprint of a value with no heap storage.
+    #[inline]
+    pub fn of<T: ?Sized>(value: &T) -> Self {
+        Self {
+            state: size_of_val(value),
+            shared: 0,
+        }
+    }
+
+    /// Add owned heap storage to the state.
+    #[inline]
+    pub fn with_state(mut self, bytes: usize) -> Self {
+        self.state += bytes;
+        self
+    }
+
+    /// Add shared data.
+    #[inline]
+    pub fn with_shared(mut self, bytes: usize) -> Self {
+        self.shared += bytes;
+        self
+    }
+
+    /// State and shared data combined.
+    #[inline]
+    pub fn total(&self) -> usize {
+        self.state + self.shared
+    }
+}
+
+/// Memory attributed to one block of a graph.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct BlockMemory {
+    /// The block's ID in the graph.
+    pub id: BlockId,
+    /// The block's display name.
+    pub name: &'static str,
+    /// The block's category.
+    pub category: BlockCategory,
+    /// Audio buffers the graph allocates for the block's outputs.
+    pub buffers: usize,
+    /// The block's own state, as reported by the block.
+    pub state: usize,
+    /// Shared data the block references, as reported by the block.
+    pub shared: usize,
+}
+
+impl BlockMemory {
+    /// Buffers, state and shared data combined.
+    pub fn total(&self) -> usize {
+        self.buffers + self.state + self.shared
+    }
+}
+
+/// Memory held by a graph, broken down by block.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct MemoryReport {
+    /// Per-block memory, indexed by block ID.
+    pub blocks: Vec<BlockMemory>,
+    /// Scheduling tables, connection lists and other graph bookkeeping.
+    pub graph: usize,
+}
+
+impl MemoryReport {
+    /// Total audio buffer memory.
+    pub fn buffers(&self) -> usize {
+        self.blocks.iter().map(|block| block.buffers).sum()
+    }
+
+    /// Total block state memory.
+    pub fn state(&self) -> usize {
+        self.blocks.iter().map(|block| block.state).sum()
+    }
+
+    /// Total shared data referenced by blocks.
+    pub fn shared(&self) -> usize {
+        self.blocks.iter().map(|block| block.shared).sum()
+    }
+
+    /// Total memory of all blocks in a category.
+    pub fn category(&self, category: BlockCategory) -> usize {
+        self.blocks
+            .iter()
+            .filter(|block| block.category == category)
+            .map(BlockMemory::total)
+            .sum()
+    }
+
+    /// Everything the graph holds.
+    pub fn total(&self) -> usize {
+        self.buffers() + self.state() + self.shared() + self.graph
+    }
+
+    /// The block holding the most memory.
+    pub fn largest_block(&self) -> Option<&BlockMemory> {
+        self.blocks.iter().max_by_key(|block| block.total())
+    }
+}
+
+/// Error returned when a graph needs more memory than its budget allows.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct MemoryBudgetExceeded {
+    /// Bytes the graph holds after preparing.
+    pub used: usize,
+    /// The configured budget in bytes.
+    pub budget: usize,
+    /// The block holding the most memory, with its total in bytes.
+    pub largest_block: Option<(BlockId, &'static str, usize)>,
+}
+
+impl MemoryBudgetExceeded {
+    pub(crate) fn new(report: &MemoryReport, budget: usize) -> Self {
+        Self {
+            used: report.total(),
+            budget,
+            largest_block: report
+                .largest_block()
+                .map(|block| (block.id, block.name, block.total())),
+        }
+    }
+}
+
+impl fmt::Display for MemoryBudgetExceeded {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(
+            f,
+            "graph uses {} bytes, exceeding its memory budget of {} bytes",
+            self.used, self.budget
+        )?;
+        if let Some((id, name, bytes)) = self.largest_block {
+            write!(f, " (largest block: {name} #{}, {bytes} bytes)", id.0)?;
+        }
+        Ok(())
+    }
+}
+
+impl std::error::Error for MemoryBudgetExceeded {}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        blocks::{AmbisonicDecoderBlock, GainBlock, OscillatorBlock},
+        channel::ChannelLayout,
+        graph::GraphBuilder,
+        waveform::Waveform,
+    };
+
+    #[test]
+    fn test_report_accounts_for_buffers_and_state() {
+        let mut builder = GraphBuilder::<f32>::new(48000.0, 512, 1);
+        let osc = builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+        let gain = builder.add(GainBlock::new(-6.0, None));
+        builder.connect(osc, 0, gain, 0);
+        let graph = builder.build();
+
+        let report = graph.memory_report();
+        let osc_memory = &report.blocks[osc.0];
+        assert_eq!(osc_memory.name, "Oscillator");
+        assert_eq!(osc_memory.buffers, 512 * size_of::<f32>());
+        assert!(osc_memory.state >= size_of::<OscillatorBlock<f32>>());
+        assert_eq!(osc_memory.shared, 0);
+        assert!(report.graph > 0);
+        assert_eq!(
+            report.total(),
+            report.buffers() + report.state() + report.shared() + report.graph
+        );
+        assert_eq!(report.category(BlockCategory::Generator), osc_memory.total());
+    }
+
+    #[test]
+    fn test_boxed_state_is_counted() {
+        let decoder = AmbisonicDecoderBlock::<f32>::new(1, ChannelLayout::Stereo);
+        let footprint = crate::block::Block::memory_footprint(&decoder);
+        assert!(footprint.state > size_of::<AmbisonicDecoderBlock<f32>>());
+    }
+
+    #[test]
+    fn test_budget_is_checked_at_prepare() {
+        let mut builder = GraphBuilder::<f32>::new(48000.0, 512, 2);
+        builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+        let mut graph = builder.build();
+        let used = graph.memory_report().total();
+
+        graph.set_memory_budget(Some(used));
+        assert!(graph.try_prepare(48000.0, 512, 2).is_ok());
+
+        graph.set_memory_budget(Some(used / 2));
+        let error = graph.try_prepare(48000.0, 512, 2).unwrap_err();
+        assert_eq!(error.budget, used / 2);
+        assert!(error.used >= used);
+        assert!(error.to_string().contains("exceeding its memory budget"));
+    }
+
+    #[test]
+    fn test_prepare_records_budget_overrun() {
+        let mut builder = GraphBuilder::<f32>::new(48000.0, 512, 2);
+        builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+        builder.memory_budget(64);
+        let mut graph = builder.build();
+        assert_eq!(graph.memory_budget_exceeded().map(|e| e.budget), Some(64));
+
+        graph.set_memory_budget(None);
+        graph.prepare(48000.0, 512, 2);
+        assert!(graph.memory_budget_exceeded().is_none());
+    }
+
+    #[test]
+    fn test_try_build_reports_budget_error() {
+        let mut builder = GraphBuilder::<f32>::new(48000.0, 512, 2);
+        builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+        builder.memory_budget(64);
+        assert!(builder.try_build().is_err());
+    }
+}
@@ -0,0 +1,392 @@
+//! Modulation matrix.
+//!
+//! A [`ModulationRoute`] connects a modulator block to a named parameter with
+//! its own depth, offset and curve. Any number of routes can target the same
+//! parameter; their contributions are summed:
+//!
+//! ```text
+//! value = Σ (offset + depth · curve(source))
+//! ```
+//!
+//! As routes are added, they are compiled into a flat table sorted by target
+//! block. Each routed parameter gets a slot in the graph's modulation values,
+//! past the per-block entries, and is switched to
+//! [`Parameter::Modulated`](crate::parameter::Parameter::Modulated) with that
+//! slot. Blocks are ordered so every route's source runs before its target,
+//! and before a block processes, the graph evaluates the routes that target
+//! it in one pass over the table, so blocks read the summed value exactly as
+//! they would read a single modulator.
+//!
+//! Like direct modulation, routes run at control rate: each source
+//! contributes the first sample of its buffer.
+
+use crate::{block::BlockId, sample::Sample};
+
+/// Shape applied to a modulation source before depth and offset.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum ModulationCurve {
+    /// The source value unchanged.
+    #[default]
+    Linear,
+    /// Maps a bipolar source (-1 to 1) to 0 to 1.
+    Unipolar,
+    /// Squares the source, keeping its sign, for finer control near zero.
+    Quadratic,
+}
+
+impl ModulationCurve {
+    /// Apply the curve to a source value.
+    #[inline]
+    pub fn apply<S: Sample>(self, value: S) -> S {
+        match self {
+            ModulationCurve::Linear => value,
+            ModulationCurve::Unipolar => (value + S::ONE) * S::from_f64(0.5),
+            ModulationCurve::Quadratic => value * value.abs(),
+        }
+    }
+}
+
+/// Identifies a route in a graph's modulation matrix, in the order routes
+/// were added.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub struct RouteId(pub usize);
+
+/// A connection from a modulator block to a parameter of another block.
+#[derive(Debug, Clone, PartialEq)]
+pub struct ModulationRoute {
+    /// The modulator block.
+    pub source: BlockId,
+    /// The block whose parameter is modulated.
+    pub target: BlockId,
+    /// Name of the modulated parameter, as accepted by
+    /// [`BlockType::set_parameter`](crate::block::BlockType::set_parameter).
+    pub parameter: String,
+    /// Scale applied to the curved source value.
+    pub depth: f64,
+    /// Value added to the route's contribution.
+    pub offset: f64,
+    /// Shape applied to the source value.
+    pub curve: ModulationCurve,
+}
+
+impl ModulationRoute {
+    /// Create a linear route with depth 1 and no offset.
+    pub fn new(source: BlockId, target: BlockId, parameter: &str) -> Self {
+        Self {
+            source,
+            target,
+            parameter: parameter.to_string(),
+            depth: 1.0,
+            offset: 0.0,
+            curve: ModulationCurve::Linear,
+        }
+    }
+
+    /// Set the depth.
+    pub fn depth(mut self, depth: f64) -> Self {
+        self.depth = depth;
+        self
+    }
+
+    /// Set the offset.
+    pub fn offset(mut self, offset: f64) -> Self {
+        self.offset = offset;
+        self
+    }
+
+    /// Set the curve.
+    pub fn curve(mut self, curve: ModulationCurve) -> Self {
+        self.curve = curve;
+        self
+    }
+}
+
+/// Routes compiled into a flat table, grouped by destination and sorted by
+/// target block.
+pub(crate) struct ModulationMatrix<S: Sample> {
+    // Per route, in table order
+    sources: Box<[usize]>,
+    depths: Box<[S]>,
+    offsets: Box<[S]>,
+    curves: Box<[ModulationCurve]>,
+
+    // Per destination: its slot in the modulation values, and the start of
+    // its routes (with a final end entry)
+    slots: Box<[usize]>,
+    route_start: Box<[usize]>,
+
+    // Per block: the start of its destinations (with a final end entry)
+    destination_start: Box<[usize]>,
+
+    // Table position of each route, by route ID
+    positions: Box<[usize]>,
+}
+
+impl<S: Sample> ModulationMatrix<S> {
+    /// An empty matrix.
+    pub(crate) fn empty() -> Self {
+        Self {
+            sources: Box::default(),
+            depths: Box::default(),
+            offsets: Box::default(),
+            curves: Box::default(),
+            slots: Box::default(),
+            route_start: Box::new([0]),
+            destination_start: Box::default(),
+            positions: Box::default(),
+        }
+    }
+
+    /// Compile `routes` for a graph of `num_blocks` blocks.
+    ///
+    /// Returns the matrix and, for each destination in slot order, the target
+    /// block and parameter name. Destination `i` uses slot `num_blocks + i`.
+    pub(crate) fn compile(routes: &[ModulationRoute], num_blocks: usize) -> (Self, Vec<(BlockId, &str)>) {
+        let mut order: Vec<usize> = (0..routes.len()).collect();
+        order.sort_by(|&a, &b| {
+            let (a, b) = (&routes[a], &routes[b]);
+            (a.target.0, a.parameter.to_lowercase()).cmp(&(b.target.0, b.parameter.to_lowercase()))
+        });
+
+        let mut destinations: Vec<(BlockId, &str)> = Vec::new();
+        let mut route_start = Vec::new();
+        let mut positions = vec![0; routes.len()];
+        for (position, &index) in order.iter().enumerate() {
+            let route = &routes[index];
+            let is_new = destinations.last().is_none_or(|&(target, parameter)| {
+                target != route.target || !parameter.eq_ignore_ascii_case(&route.parameter)
+            });
+            if is_new {
+                destinations.push((route.target, route.parameter.as_str()));
+                route_start.push(position);
+            }
+            positions[index] = position;
+        }
+        route_start.push(order.len());
+
+        let mut destination_start = vec![0; num_blocks + 1];
+        for &(target, _) in &destinations {
+            if target.0 < num_blocks {
+                destination_start[target.0 + 1] += 1;
+            }
+        }
+        for block in 0..num_blocks {
+            destination_start[block + 1] += destination_start[block];
+        }
+
+        let matrix = Self {
+            sources: order.iter().map(|&i| routes[i].source.0).collect(),
+            depths: order.iter().map(|&i| S::from_f64(routes[i].depth)).collect(),
+            offsets: order.iter().map(|&i| S::from_f64(routes[i].offset)).collect(),
+            curves: order.iter().map(|&i| routes[i].curve).collect(),
+            slots: (num_blocks..num_blocks + destinations.len()).collect(),
+            route_start: route_start.into_boxed_slice(),
+            destination_start: destination_start.into_boxed_slice(),
+            positions: positions.into_boxed_slice(),
+        };
+        (matrix, destinations)
+    }
+
+    /// Number of routed parameters.
+    #[inline]
+    pub(crate) fn num_destinations(&self) -> usize {
+        self.slots.len()
+    }
+
+    /// Sum the routes targeting `block` into their slots of `values`.
+    #[inline]
+    pub(crate) fn evaluate(&self, block: usize, values: &mut [S]) {
+        let (Some(&first), Some(&last)) = (self.destination_start.get(block), self.destination_start.get(block + 1))
+        else {
+            return;
+        };
+
+        // Scalar on purpose: a block has a handful of routes, and gathering
+        // their sources and scattering the sums costs more than the lanes save
+        for destination in first..last {
+            let routes = self.route_start[destination]..self.route_start[destination + 1];
+            let mut sum = S::ZERO;
+            for route in routes {
+                let source = values.get(self.sources[route]).copied().unwrap_or(S::ZERO);
+                sum += self.offsets[route] + self.depths[route] * self.curves[route].apply(source);
+            }
+            if let Some(value) = values.get_mut(self.slots[destination]) {
+                *value = sum;
+            }
+        }
+    }
+
+    /// Change the depth of a compiled route. Returns `false` if the route
+    /// isn't in the table.
+    #[inline]
+    pub(crate) fn set_depth(&mut self, route: RouteId, depth: S) -> bool {
+        match self.positions.get(route.0) {
+            Some(&position) => {
+                self.depths[position] = depth;
+                true
+            }
+            None => false,
+        }
+    }
+
+    /// Heap storage held by the table, in bytes.
+    pub(crate) fn heap_size(&self) -> usize {
+        size_of_val(&*self.sources)
+            + size_of_val(&*self.depths)
+            + size_of_val(&*self.offsets)
+            + size_of_val(&*self.curves)
+            + size_of_val(&*self.slots)
+            + size_of_val(&*self.route_start)
+            + size_of_val(&*self.destination_start)
+            + size_of_val(&*self.positions)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        blocks::{GainBlock, LfoBlock, OscillatorBlock},
+        graph::GraphBuilder,
+        parameter::Parameter,
+        waveform::Waveform,
+    };
+
+    #[test]
+    fn test_curves() {
+        assert_eq!(ModulationCurve::Linear.apply(-0.5f32), -0.5);
+        assert_eq!(ModulationCurve::Unipolar.apply(-1.0f32), 0.0);
+        assert_eq!(ModulationCurve::Unipolar.apply(1.0f32), 1.0);
+        assert_eq!(ModulationCurve::Quadratic.apply(-0.5f32), -0.25);
+    }
+
+    #[test]
+    fn test_routes_sum_per_destination() {
+        let routes = [
+            ModulationRoute::new(BlockId(0), BlockId(2), "cutoff").depth(100.0),
+            ModulationRoute::new(BlockId(1), BlockId(3), "level").offset(-6.0),
+            ModulationRoute::new(BlockId(1), BlockId(2), "Cutoff")
+                .depth(10.0)
+                .offset(1000.0)
+                .curve(ModulationCurve::Unipolar),
+        ];
+        let (mut matrix, destinations) = ModulationMatrix::<f64>::compile(&routes, 4);
+        assert_eq!(destinations, vec![(BlockId(2), "cutoff"), (BlockId(3), "level")]);
+
+        let mut values = vec![0.5, 0.0, 0.0, 0.0, 0.0, 0.0];
+        matrix.evaluate(2, &mut values);
+        assert_eq!(values[4], 0.5 * 100.0 + 1000.0 + 10.0 * 0.5);
+        assert_eq!(values[5], 0.0);
+
+        matrix.evaluate(3, &mut values);
+        assert_eq!(values[5], -6.0);
+
+        assert!(matrix.set_depth(RouteId(2), 0.0));
+        assert!(!matrix.set_depth(RouteId(3), 0.0));
+        matrix.evaluate(2, &mut values);
+        assert_eq!(values[4], 0.5 * 100.0 + 1000.0);
+    }
+
+    #[test]
+    fn test_graph_routes_parameter_through_matrix() {
+        // A slow square LFO holds +1 for the first few seconds
+        let mut builder = GraphBuilder::<f32>::new(44100.0, 64, 1);
+        let lfo = builder.add(LfoBlock::new(0.1, 1.0, Waveform::Square, None));
+        let osc = builder.add(OscillatorBlock::new(441.0, Waveform::Sine, None));
+        let gain = builder.add(GainBlock::new(0.0, None));
+        builder.connect(osc, 0, gain, 0);
+        let first = builder
+            .route(ModulationRoute::new(lfo, gain, "level").depth(-3.0))
+            .unwrap();
+        builder
+            .route(ModulationRoute::new(lfo, gain, "level").depth(-6.0).offset(3.0))
+            .unwrap();
+        assert!(builder.route(ModulationRoute::new(lfo, gain, "bogus")).is_err());
+        assert!(builder.route(ModulationRoute::new(osc, gain, "level")).is_err());
+
+        let topology = builder.capture_topology();
+        assert_eq!(topology.modulation_connections.len(), 2);
+
+        let mut graph = builder.build();
+        let Some(crate::block::BlockType::Gain(block)) = graph.get_block(gain) else {
+            panic!("expected a gain block");
+        };
+        assert!(matches!(block.level_db, Parameter::Modulated(BlockId(slot)) if slot >= 4));
+
+        let mut output = vec![0.0; 64];
+        let mut peak = |graph: &mut crate::graph::Graph<f32>| {
+            for _ in 0..20 {
+                graph.process_buffers(&mut [&mut output]);
+            }
+            output.iter().fold(0.0f32, |peak, x| peak.max(x.abs()))
+        };
+
+        // -3 dB + (3 - 6) dB
+        let summed = peak(&mut graph);
+        assert!((summed - 0.501).abs() < 0.01, "routes should sum to -6 dB: {summed}");
+
+        assert!(graph.set_route_depth(first, 0.0));
+        assert!(!graph.set_route_depth(RouteId(5), 0.0));
+        let reduced = peak(&mut graph);
+        assert!((reduced - 0.708).abs() < 0.01, "second route alone is -3 dB: {reduced}");
+    }
+
+    #[test]
+    fn test_routed_parameter_gets_its_slot_when_added() {
+        let mut graph = crate::graph::Graph::<f32>::new(44100.0, 64, 1);
+        let lfo = graph.add_block(LfoBlock::new(1.0, 1.0, Waveform::Sine, None).into());
+        let gain = graph.add_block(GainBlock::new(0.0, None).into());
+        graph.add_route(ModulationRoute::new(lfo, gain, "level")).unwrap();
+        let slot = |graph: &crate::graph::Graph<f32>| match graph.get_block(gain) {
+            Some(crate::block::BlockType::Gain(block)) => block.level_db.clone(),
+            _ => panic!("expected a gain block"),
+        };
+        assert!(matches!(slot(&graph), Parameter::Modulated(BlockId(2))));
+
+        // Slots follow the blocks, so adding one moves them along
+        graph.add_block(GainBlock::new(0.0, None).into());
+        assert!(matches!(slot(&graph), Parameter::Modulated(BlockId(3))));
+    }
+
+    #[test]
+    fn test_route_added_while_running() {
+        let mut builder = GraphBuilder::<f32>::new(44100.0, 64, 1);
+        let lfo = builder.add(LfoBlock::new(0.1, 1.0, Waveform::Square, None));
+        let osc = builder.add(OscillatorBlock::new(441.0, Waveform::Sine, None));
+        let gain = builder.add(GainBlock::new(0.0, None));
+        builder.connect(osc, 0, gain, 0);
+        let mut graph = builder.build();
+
+        let mut output = vec![0.0; 64];
+        graph.process_buffers(&mut [&mut output]);
+        graph
+            .add_route(ModulationRoute::new(lfo, gain, "level").depth(-6.0))
+            .unwrap();
+        for _ in 0..20 {
+            graph.process_buffers(&mut [&mut output]);
+        }
+        let peak = output.iter().fold(0.0f32, |peak, x| peak.max(x.abs()));
+        assert!(
+            (peak - 0.501).abs() < 0.01,
+            "route should apply -6 dB without re-preparing: {peak}"
+        );
+    }
+
+    #[test]
+    fn test_routes_between_modulators_keep_every_block() {
+        let mut builder = GraphBuilder::<f32>::new(44100.0, 64, 1);
+        let a = builder.add(LfoBlock::new(1.0, 1.0, Waveform::Sine, None));
+        let b = builder.add(LfoBlock::new(2.0, 1.0, Waveform::Sine, None));
+        let osc = builder.add(OscillatorBlock::new(441.0, Waveform::Sine, None));
+        builder.route(ModulationRoute::new(a, b, "frequency")).unwrap();
+        builder.route(ModulationRoute::new(b, a, "frequency")).unwrap();
+        builder
+            .route(ModulationRoute::new(a, osc, "frequency").depth(10.0).offset(441.0))
+            .unwrap();
+        let mut graph = builder.build();
+
+        let mut output = vec![0.0; 64];
+        graph.process_buffers(&mut [&mut output]);
+        assert!(output.iter().any(|&x| x.abs() > 0.1), "the oscillator should still run");
+    }
+}
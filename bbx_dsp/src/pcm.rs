@@ -0,0 +1,307 @@
+//! Compressed in-memory sample storage.
+//!
+//! [`PcmStore`] keeps audio as 16- or 24-bit integer PCM instead of full-width
+//! samples and decodes it while reading. Against decoded `f64` samples that is
+//! a quarter (16-bit) or three eighths (24-bit) of the memory; against `f32`,
+//! a half or three quarters. 24-bit PCM is transparent for any source that
+//! came from a 24-bit or lower file.
+//!
+//! The store implements [`Reader`] for both sample types, so one store can feed
+//! [`FileInputBlock`](crate::blocks::FileInputBlock)s in `f32` and `f64`
+//! graphs. Decoding happens in [`Reader::read_into`], without allocating, and
+//! uses SIMD when the `simd` feature is enabled.
+
+#[cfg(feature = "simd")]
+use bbx_core::simd::{decode_pcm16, decode_pcm24};
+
+use crate::{reader::Reader, sample::Sample};
+
+/// Samples decoded per block when encoding from a [`Reader`].
+const ENCODE_BLOCK_SIZE: usize = 4096;
+
+const PCM16_FULL_SCALE: f64 = 32768.0;
+const PCM24_FULL_SCALE: f64 = 8388608.0;
+
+/// Integer format of a [`PcmStore`].
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum PcmEncoding {
+    /// 16-bit PCM, about 96 dB of dynamic range.
+    Pcm16,
+    /// Packed 24-bit PCM, about 144 dB of dynamic range.
+    #[default]
+    Pcm24,
+}
+
+impl PcmEncoding {
+    /// Bytes used per stored sample.
+    #[inline]
+    pub const fn bytes_per_sample(self) -> usize {
+        match self {
+            PcmEncoding::Pcm16 => 2,
+            PcmEncoding::Pcm24 => 3,
+        }
+    }
+}
+
+enum PcmChannel {
+    Pcm16(Box<[i16]>),
+    /// Little-endian, three bytes per sample.
+    Pcm24(Box<[u8]>),
+}
+
+impl PcmChannel {
+    fn silent(num_samples: usize, encoding: PcmEncoding) -> Self {
+        match encoding {
+            PcmEncoding::Pcm16 => PcmChannel::Pcm16(vec![0; num_samples].into_boxed_slice()),
+            PcmEncoding::Pcm24 => PcmChannel::Pcm24(vec![0; num_samples * 3].into_boxed_slice()),
+        }
+    }
+
+    /// Encode `samples` over the channel starting at `start`.
+    fn write<S: Sample>(&mut self, start: usize, samples: &[S]) {
+        match self {
+            PcmChannel::Pcm16(stored) => {
+                for (out, x) in stored[start..].iter_mut().zip(samples) {
+                    *out = quantize(x.to_f64(), PCM16_FULL_SCALE) as i16;
+                }
+            }
+            PcmChannel::Pcm24(bytes) => {
+                for (out, x) in bytes[start * 3..].chunks_exact_mut(3).zip(samples) {
+                    out.copy_from_slice(&quantize(x.to_f64(), PCM24_FULL_SCALE).to_le_bytes()[..3]);
+                }
+            }
+        }
+    }
+
+    fn heap_size(&self) -> usize {
+        match self {
+            PcmChannel::Pcm16(samples) => size_of_val(&**samples),
+            PcmChannel::Pcm24(bytes) => bytes.len(),
+        }
+    }
+}
+
+/// Round to the nearest integer step, clipping to the format's range.
+#[inline]
+fn quantize(value: f64, full_scale: f64) -> i32 {
+    (value * full_scale).round().clamp(-full_scale, full_scale - 1.0) as i32
+}
+
+/// Audio held in memory as integer PCM and decoded on read.
+pub struct PcmStore {
+    sample_rate: f64,
+    num_samples: usize,
+    encoding: PcmEncoding,
+    channels: Vec<PcmChannel>,
+}
+
+impl PcmStore {
+    /// Create an empty store for channels of `num_samples` samples.
+    pub fn new(sample_rate: f64, num_samples: usize, encoding: PcmEncoding) -> Self {
+        Self {
+            sample_rate,
+            num_samples,
+            encoding,
+            channels: Vec::new(),
+        }
+    }
+
+    /// Encode channels of samples. The store is as long as the longest
+    /// channel; shorter channels are padded with silence.
+    pub fn from_channels<S: Sample>(sample_rate: f64, channels: &[&[S]], encoding: PcmEncoding) -> Self {
+        let num_samples = channels.iter().map(|c| c.len()).max().unwrap_or(0);
+        let mut store = Self::new(sample_rate, num_samples, encoding);
+        for channel in channels {
+            store.push_channel(channel);
+        }
+        store
+    }
+
+    /// Encode every channel of a reader, a block at a time.
+    pub fn from_reader<S: Sample, R: Reader<S> + ?Sized>(reader: &R, encoding: PcmEncoding) -> Self {
+        let num_samples = reader.num_samples();
+        let mut store = Self::new(reader.sample_rate(), num_samples, encoding);
+        let mut block = [S::ZERO; ENCODE_BLOCK_SIZE];
+
+        for channel_index in 0..reader.num_channels() {
+            let mut channel = PcmChannel::silent(num_samples, encoding);
+            for start in (0..num_samples).step_by(ENCODE_BLOCK_SIZE) {
+                let len = ENCODE_BLOCK_SIZE.min(num_samples - start);
+                reader.read_into(channel_index, start, &mut block[..len]);
+                channel.write(start, &block[..len]);
+            }
+            store.channels.push(channel);
+        }
+
+        store
+    }
+
+    /// Encode and append a channel. Samples past the store's length are
+    /// dropped and missing ones are stored as silence.
+    pub fn push_channel<S: Sample>(&mut self, samples: &[S]) {
+        let mut channel = PcmChannel::silent(self.num_samples, self.encoding);
+        channel.write(0, &samples[..samples.len().min(self.num_samples)]);
+        self.channels.push(channel);
+    }
+
+    /// The store's integer format.
+    #[inline]
+    pub fn encoding(&self) -> PcmEncoding {
+        self.encoding
+    }
+
+    /// Decode samples of a channel starting at `position` into `output`.
+    /// Samples past the end, or of a missing channel, are written as zero.
+    pub fn decode<S: Sample>(&self, channel_index: usize, position: usize, output: &mut [S]) {
+        let available = self.num_samples.saturating_sub(position).min(output.len());
+        let (head, tail) = output.split_at_mut(available);
+        tail.fill(S::ZERO);
+        if available == 0 {
+            return;
+        }
+
+        match self.channels.get(channel_index) {
+            Some(PcmChannel::Pcm16(samples)) => decode_16(&samples[position..position + available], head),
+            Some(PcmChannel::Pcm24(bytes)) => decode_24(&bytes[position * 3..(position + available) * 3], head),
+            None => head.fill(S::ZERO),
+        }
+    }
+}
+
+#[inline]
+fn decode_16<S: Sample>(input: &[i16], output: &mut [S]) {
+    #[cfg(feature = "simd")]
+    decode_pcm16(input, output);
+
+    #[cfg(not(feature = "simd"))]
+    for (out, &x) in output.iter_mut().zip(input) {
+        *out = S::from_f64(x as f64 / PCM16_FULL_SCALE);
+    }
+}
+
+#[inline]
+fn decode_24<S: Sample>(input: &[u8], output: &mut [S]) {
+    #[cfg(feature = "simd")]
+    decode_pcm24(input, output);
+
+    #[cfg(not(feature = "simd"))]
+    for (out, bytes) in output.iter_mut().zip(input.chunks_exact(3)) {
+        let x = i32::from_le_bytes([0, bytes[0], bytes[1], bytes[2]]) >> 8;
+        *out = S::from_f64(x as f64 / PCM24_FULL_SCALE);
+    }
+}
+
+impl<S: Sample> Reader<S> for PcmStore {
+    fn sample_rate(&self) -> f64 {
+        self.sample_rate
+    }
+
+    fn num_channels(&self) -> usize {
+        self.channels.len()
+    }
+
+    fn num_samples(&self) -> usize {
+        self.num_samples
+    }
+
+    /// Samples are only held encoded; read them with
+    /// [`read_into`](Reader::read_into).
+    fn read_channel(&self, _channel_index: usize) -> &[S] {
+        debug_assert!(false, "PcmStore holds encoded samples; use Reader::read_into");
+        &[]
+    }
+
+    fn is_encoded(&self) -> bool {
+        true
+    }
+
+    #[inline]
+    fn read_into(&self, channel_index: usize, position: usize, output: &mut [S]) {
+        self.decode(channel_index, position, output);
+    }
+
+    fn resident_bytes(&self) -> usize {
+        self.channels.iter().map(PcmChannel::heap_size).sum()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn ramp(len: usize) -> Vec<f64> {
+        (0..len).map(|i| (i as f64 * 0.37).sin() * 0.99).collect()
+    }
+
+    #[test]
+    fn test_round_trip_within_one_step() {
+        let source = ramp(1003);
+        for (encoding, step) in [
+            (PcmEncoding::Pcm16, 1.0 / PCM16_FULL_SCALE),
+            (PcmEncoding::Pcm24, 1.0 / PCM24_FULL_SCALE),
+        ] {
+            let store = PcmStore::from_channels(48000.0, &[&source], encoding);
+            let mut output = vec![0.0f64; source.len()];
+            store.decode(0, 0, &mut output);
+            for (i, (&x, &y)) in source.iter().zip(&output).enumerate() {
+                assert!((x - y).abs() <= step / 2.0, "{encoding:?} sample {i}: {x} vs {y}");
+            }
+        }
+    }
+
+    #[test]
+    fn test_full_scale_clips() {
+        let store = PcmStore::from_channels(48000.0, &[&[1.5f32, -1.5, 1.0, -1.0][..]], PcmEncoding::Pcm16);
+        let mut output = [0.0f32; 4];
+        store.decode(0, 0, &mut output);
+        assert_eq!(output, [32767.0 / 32768.0, -1.0, 32767.0 / 32768.0, -1.0]);
+    }
+
+    #[test]
+    fn test_decode_past_end_and_missing_channel() {
+        let store = PcmStore::from_channels(48000.0, &[&[0.5f32; 10][..]], PcmEncoding::Pcm24);
+        let mut output = [1.0f32; 8];
+        store.decode(0, 6, &mut output);
+        assert_eq!(output, [0.5, 0.5, 0.5, 0.5, 0.0, 0.0, 0.0, 0.0]);
+
+        let mut output = [1.0f32; 4];
+        store.decode(3, 0, &mut output);
+        assert_eq!(output, [0.0; 4]);
+
+        let mut output = [1.0f32; 4];
+        store.decode(0, 50, &mut output);
+        assert_eq!(output, [0.0; 4]);
+    }
+
+    #[test]
+    fn test_reader_matches_decode_and_reports_resident_bytes() {
+        let left = ramp(500);
+        let right: Vec<f64> = left.iter().map(|x| -x).collect();
+        let store = PcmStore::from_channels(44100.0, &[&left, &right[..300]], PcmEncoding::Pcm16);
+
+        assert_eq!(Reader::<f64>::num_channels(&store), 2);
+        assert_eq!(Reader::<f64>::num_samples(&store), 500);
+        assert_eq!(Reader::<f64>::resident_bytes(&store), 2 * 500 * 2);
+        assert!(Reader::<f64>::is_encoded(&store));
+
+        // Re-encoding through the reader interface is lossless
+        let copy = PcmStore::from_reader::<f32, _>(&store, PcmEncoding::Pcm16);
+        for channel in 0..2 {
+            let (mut a, mut b) = ([0.0f32; 500], [0.0f32; 500]);
+            Reader::<f32>::read_into(&store, channel, 0, &mut a);
+            Reader::<f32>::read_into(&copy, channel, 0, &mut b);
+            assert_eq!(a, b);
+        }
+        let mut tail = [1.0f32; 10];
+        Reader::<f32>::read_into(&store, 1, 300, &mut tail);
+        assert_eq!(tail, [0.0; 10]);
+    }
+
+    #[test]
+    #[cfg(debug_assertions)]
+    #[should_panic(expected = "use Reader::read_into")]
+    fn test_read_channel_on_encoded_store_panics_in_debug() {
+        let store = PcmStore::from_channels(44100.0, &[&[0.5f32; 8][..]], PcmEncoding::Pcm16);
+        let _ = Reader::<f32>::read_channel(&store, 0);
+    }
+}
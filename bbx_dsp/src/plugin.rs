@@ -5,7 +5,7 @@
 
 use bbx_midi::MidiEvent;
 
-use crate::context::DspContext;
+use crate::{context::DspContext, memory::MemoryReport, tap::MeterTaps};
 
 /// Trait for plugin-specific DSP implementations.
 ///
@@ -101,4 +101,27 @@ pub trait PluginDsp: Default + Send + 'static {
     /// Default implementation does nothing.
     #[allow(unused_variables)]
     fn pitch_bend(&mut self, value: i16, sample_offset: u32) {}
+
+    /// Metering taps exposed to the host over FFI.
+    ///
+    /// Return the handle from [`Graph::enable_taps`](crate::graph::Graph::enable_taps)
+    /// to let the host switch and read taps with `bbx_graph_set_tap` and
+    /// `bbx_graph_read_tap`. Queried after `new()` and each `prepare()`.
+    ///
+    /// Default implementation exposes no taps.
+    fn meter_taps(&self) -> Option<MeterTaps> {
+        None
+    }
+
+    /// Memory held by the plugin's graph, reported to the host over FFI.
+    ///
+    /// Return [`Graph::memory_report`](crate::graph::Graph::memory_report) to
+    /// let the host query it with `bbx_graph_get_memory_usage`. Called when
+    /// the plugin is created and after each `prepare`, never while
+    /// processing; the host reads that snapshot.
+    ///
+    /// Default implementation reports nothing.
+    fn memory_report(&self) -> Option<MemoryReport> {
+        None
+    }
 }
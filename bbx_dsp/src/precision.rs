@@ -0,0 +1,468 @@
+//! Mixed-precision processing.
+//!
+//! A [`Graph`](crate::graph::Graph) has one sample type, and most chains are
+//! best run in `f32`, where the SIMD paths process twice as many samples per
+//! instruction as in `f64`. Blocks that need more precision than that, such as
+//! filters with poles near the unit circle or long integrators, can be
+//! wrapped in an [`F64Block`] to run in `f64` inside a graph of any sample
+//! type, forming an `f64` island.
+//!
+//! The graph converts signals only at the edges of an island:
+//!
+//! - Inputs from narrow blocks are widened to `f64` before the block runs.
+//! - Inputs from another `F64Block` are read from its `f64` outputs directly, so a chain of wrapped blocks converts
+//!   once on the way in and once on the way out.
+//! - Outputs are narrowed into the graph's buffers only when something reads them there: a narrow block, the output, a
+//!   modulation target or an enabled metering tap.
+//!
+//! Conversions use SIMD when the `simd` feature is enabled.
+
+use std::{marker::PhantomData, ptr};
+
+#[cfg(feature = "simd")]
+use bbx_core::simd::{convert_from_f64, convert_to_f64};
+
+use crate::{
+    block::{Block, BlockType},
+    buffer::{AudioBuffer, Buffer},
+    channel::ChannelConfig,
+    context::DspContext,
+    graph::MAX_BLOCK_INPUTS,
+    memory::MemoryFootprint,
+    parameter::{ModulationOutput, Parameter},
+    sample::Sample,
+};
+
+/// Widen samples to `f64`.
+#[inline]
+pub fn widen<S: Sample>(input: &[S], output: &mut [f64]) {
+    #[cfg(feature = "simd")]
+    convert_to_f64(input, output);
+
+    #[cfg(not(feature = "simd"))]
+    for (out, &x) in output.iter_mut().zip(input) {
+        *out = x.to_f64();
+    }
+}
+
+/// Convert `f64` samples to another sample type.
+#[inline]
+pub fn narrow<S: Sample>(input: &[f64], output: &mut [S]) {
+    #[cfg(feature = "simd")]
+    convert_from_f64(input, output);
+
+    #[cfg(not(feature = "simd"))]
+    for (out, &x) in output.iter_mut().zip(input) {
+        *out = S::from_f64(x);
+    }
+}
+
+/// Table entry for an input that isn't passed through in `f64`.
+const NARROW_INPUT: *const [f64] = ptr::slice_from_raw_parts(ptr::null(), 0);
+
+/// Runs a block in `f64` inside a graph of another sample type.
+///
+/// Add one with [`GraphBuilder::add_f64`](crate::graph::GraphBuilder::add_f64).
+/// Parameters set through [`BlockType::set_parameter`] are passed to the
+/// wrapped block; reach its fields with [`inner_mut`](Self::inner_mut).
+pub struct F64Block<S: Sample> {
+    block: Box<BlockType<f64>>,
+
+    // Widened inputs, wide outputs and modulation values, sized in prepare()
+    inputs: Vec<AudioBuffer<f64>>,
+    outputs: Vec<AudioBuffer<f64>>,
+    modulation_values: Vec<f64>,
+    buffer_size: usize,
+
+    // Slice tables passed to the wrapped block, sized with the buffers rather
+    // than to the I/O limits. `wide_inputs` holds the f64 outputs of other
+    // F64 blocks set by the graph for the next call; other inputs are widened.
+    wide_inputs: Box<[*const [f64]]>,
+    input_table: Box<[*const [f64]]>,
+    output_table: Box<[*mut [f64]]>,
+
+    _phantom: PhantomData<S>,
+}
+
+// SAFETY: The tables only hold pointers into this block's own buffers and,
+// for wide inputs, into other F64 blocks' outputs in the same graph. They are
+// written and read inside `process_mixed`, which takes `&mut self`, on
+// whichever thread owns the graph; nothing dereferences them through `&self`.
+unsafe impl<S: Sample> Send for F64Block<S> {}
+unsafe impl<S: Sample> Sync for F64Block<S> {}
+
+impl<S: Sample> F64Block<S> {
+    /// Wrap a block to run in `f64`.
+    pub fn new<B: Into<BlockType<f64>>>(block: B) -> Self {
+        // An island inside an island is the same island
+        let block = match block.into() {
+            BlockType::F64(wrapped) => wrapped.block,
+            block => Box::new(block),
+        };
+
+        Self {
+            block,
+            inputs: Vec::new(),
+            outputs: Vec::new(),
+            modulation_values: Vec::new(),
+            buffer_size: 0,
+            wide_inputs: Box::default(),
+            input_table: Box::default(),
+            output_table: Box::default(),
+            _phantom: PhantomData,
+        }
+    }
+
+    /// The wrapped block.
+    #[inline]
+    pub fn inner(&self) -> &BlockType<f64> {
+        &self.block
+    }
+
+    /// The wrapped block, mutably.
+    #[inline]
+    pub fn inner_mut(&mut self) -> &mut BlockType<f64> {
+        &mut self.block
+    }
+
+    /// Reserve room for `num_inputs` connected inputs and
+    /// `num_modulation_values` modulation values.
+    ///
+    /// The graph calls this when it is prepared. Outside a graph, call it
+    /// after [`prepare`](Block::prepare) to feed the block more inputs than it
+    /// declares or to pass it modulation values; inputs and values past the
+    /// reserved counts are ignored.
+    pub fn reserve(&mut self, num_inputs: usize, num_modulation_values: usize) {
+        let num_inputs = num_inputs.min(MAX_BLOCK_INPUTS);
+        if self.inputs.len() < num_inputs {
+            self.inputs
+                .resize_with(num_inputs, || AudioBuffer::new(self.buffer_size));
+            self.size_tables();
+        }
+        self.modulation_values.resize(num_modulation_values, 0.0);
+    }
+
+    fn size_tables(&mut self) {
+        self.wide_inputs = vec![NARROW_INPUT; self.inputs.len()].into_boxed_slice();
+        self.input_table = vec![NARROW_INPUT; self.inputs.len()].into_boxed_slice();
+        self.output_table =
+            vec![ptr::slice_from_raw_parts_mut(ptr::null_mut(), 0); self.outputs.len()].into_boxed_slice();
+    }
+
+    /// Pass input `index` through in `f64` from `wide` on the next call
+    /// instead of widening it, or widen it again if `wide` is `None`.
+    ///
+    /// `wide` must stay valid until then; the graph points it at another F64
+    /// block's output just before processing.
+    #[inline]
+    pub(crate) fn set_wide_input(&mut self, index: usize, wide: Option<&[f64]>) {
+        if let Some(slot) = self.wide_inputs.get_mut(index) {
+            *slot = wide.map_or(NARROW_INPUT, ptr::from_ref);
+        }
+    }
+
+    /// Set a parameter of the wrapped block.
+    pub fn set_parameter(&mut self, parameter_name: &str, parameter: Parameter<S>) -> Result<(), String> {
+        let parameter = match parameter {
+            Parameter::Constant(value) => Parameter::Constant(value.to_f64()),
+            Parameter::Modulated(id) => Parameter::Modulated(id),
+        };
+        self.block.set_parameter(parameter_name, parameter)
+    }
+
+    /// An output of the last processed buffer, in `f64`.
+    #[inline]
+    pub fn output(&self, index: usize) -> &[f64] {
+        self.outputs.get(index).map_or(&[], |buffer| buffer.as_slice())
+    }
+
+    /// Narrow an output of the last processed buffer into `output`.
+    #[inline]
+    pub(crate) fn narrow_output(&self, index: usize, output: &mut [S]) {
+        let input = self.output(index);
+        let len = input.len().min(output.len());
+        narrow(&input[..len], &mut output[..len]);
+    }
+
+    /// Process `num_samples` samples through the wrapped block.
+    ///
+    /// Inputs set with [`set_wide_input`](Self::set_wide_input) are read in
+    /// `f64`; the rest are widened from `inputs`. Outputs stay in `f64`; see
+    /// [`narrow_output`](Self::narrow_output).
+    pub(crate) fn process_mixed(
+        &mut self,
+        inputs: &[&[S]],
+        num_samples: usize,
+        modulation_values: &[S],
+        context: &DspContext,
+    ) {
+        let num_samples = num_samples.min(self.buffer_size);
+        let num_inputs = inputs.len().min(self.input_table.len());
+
+        for (index, input) in inputs[..num_inputs].iter().enumerate() {
+            let wide = self.wide_inputs[index];
+            self.input_table[index] = if wide.is_null() {
+                let len = num_samples.min(input.len());
+                let scratch = &mut self.inputs[index].as_mut_slice()[..len];
+                widen(&input[..len], scratch);
+                ptr::from_ref(scratch)
+            } else {
+                ptr::slice_from_raw_parts(wide.cast::<f64>(), num_samples.min(wide.len()))
+            };
+        }
+
+        for (slot, buffer) in self.output_table.iter_mut().zip(&mut self.outputs) {
+            *slot = ptr::from_mut(&mut buffer.as_mut_slice()[..num_samples]);
+        }
+
+        let len = self.modulation_values.len().min(modulation_values.len());
+        widen(&modulation_values[..len], &mut self.modulation_values[..len]);
+
+        // SAFETY: The tables were just refilled with this block's own input
+        // scratch and output buffers, and with wide inputs the graph set from
+        // other blocks' outputs for this call, so no input overlaps an output.
+        // `*const [f64]`/`*mut [f64]` have the same layout as `&[f64]`/`&mut [f64]`.
+        unsafe {
+            let input_slices = &*(ptr::from_ref(&self.input_table[..num_inputs]) as *const [&[f64]]);
+            let output_slices = &mut *(ptr::from_mut(&mut *self.output_table) as *mut [&mut [f64]]);
+            self.block
+                .process(input_slices, output_slices, &self.modulation_values, context);
+        }
+    }
+}
+
+impl<S: Sample> Block<S> for F64Block<S> {
+    fn process(&mut self, inputs: &[&[S]], outputs: &mut [&mut [S]], modulation_values: &[S], context: &DspContext) {
+        let num_samples = outputs
+            .first()
+            .map(|output| output.len())
+            .or_else(|| inputs.first().map(|input| input.len()))
+            .unwrap_or(self.buffer_size);
+
+        self.wide_inputs.fill(NARROW_INPUT);
+        self.process_mixed(inputs, num_samples, modulation_values, context);
+
+        for (index, output) in outputs.iter_mut().enumerate() {
+            self.narrow_output(index, output);
+        }
+    }
+
+    #[inline]
+    fn input_count(&self) -> usize {
+        self.block.input_count()
+    }
+
+    #[inline]
+    fn output_count(&self) -> usize {
+        self.block.output_count()
+    }
+
+    #[inline]
+    fn modulation_outputs(&self) -> &[ModulationOutput] {
+        self.block.modulation_outputs()
+    }
+
+    #[inline]
+    fn channel_config(&self) -> ChannelConfig {
+        self.block.channel_config()
+    }
+
+    fn set_smoothing(&mut self, sample_rate: f64, ramp_time_ms: f64) {
+        self.block.set_smoothing(sample_rate, ramp_time_ms);
+    }
+
+    fn prepare(&mut self, context: &DspContext) {
+        self.block.prepare(context);
+
+        self.buffer_size = context.buffer_size;
+        let num_inputs = self.inputs.len().max(self.block.input_count()).min(MAX_BLOCK_INPUTS);
+        self.inputs = (0..num_inputs).map(|_| AudioBuffer::new(self.buffer_size)).collect();
+        self.outputs = (0..self.block.output_count())
+            .map(|_| AudioBuffer::new(self.buffer_size))
+            .collect();
+        self.size_tables();
+    }
+
+    fn reset(&mut self) {
+        self.block.reset();
+    }
+
+    fn seek(&mut self, position: u64, context: &DspContext) -> bool {
+        self.block.seek(position, context)
+    }
+
+    fn memory_footprint(&self) -> MemoryFootprint {
+        let buffers: usize = self
+            .inputs
+            .iter()
+            .chain(&self.outputs)
+            .map(|buffer| buffer.capacity() * size_of::<f64>())
+            .sum();
+        self.block.memory_footprint().with_state(
+            size_of_val(self)
+                + buffers
+                + self.inputs.capacity() * size_of::<AudioBuffer<f64>>()
+                + self.outputs.capacity() * size_of::<AudioBuffer<f64>>()
+                + self.modulation_values.capacity() * size_of::<f64>()
+                + size_of_val(&*self.wide_inputs)
+                + size_of_val(&*self.input_table)
+                + size_of_val(&*self.output_table),
+        )
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        block::BlockId,
+        blocks::{GainBlock, LfoBlock, LowPassFilterBlock, OscillatorBlock},
+        graph::{Graph, GraphBuilder},
+        waveform::Waveform,
+    };
+
+    const BUFFER_SIZE: usize = 64;
+
+    fn render(graph: &mut Graph<f32>, buffers: usize) -> Vec<f32> {
+        let mut rendered = Vec::new();
+        let mut output = [0.0f32; BUFFER_SIZE];
+        for _ in 0..buffers {
+            graph.process_buffers(&mut [&mut output]);
+            rendered.extend_from_slice(&output);
+        }
+        rendered
+    }
+
+    fn saw() -> OscillatorBlock<f32> {
+        OscillatorBlock::new(110.0, Waveform::Sawtooth, None)
+    }
+
+    #[test]
+    fn test_island_chain_converts_only_at_its_edges() {
+        let mut builder = GraphBuilder::<f32>::new(44100.0, BUFFER_SIZE, 1);
+        let osc = builder.add(saw());
+        let first = builder.add_f64(LowPassFilterBlock::new(300.0, 2.0));
+        let second = builder.add_f64(LowPassFilterBlock::new(60.0, 0.707));
+        builder.connect(osc, 0, first, 0).connect(first, 0, second, 0);
+        let mut graph = builder.build();
+        let island = render(&mut graph, 20);
+
+        // The same filters run in f64 on the widened oscillator, rounded once
+        let mut builder = GraphBuilder::<f32>::new(44100.0, BUFFER_SIZE, 1);
+        builder.add(saw());
+        let mut source = builder.build();
+        let context = source.context().clone();
+        let mut filters = [
+            LowPassFilterBlock::<f64>::new(300.0, 2.0),
+            LowPassFilterBlock::<f64>::new(60.0, 0.707),
+        ];
+        for filter in &mut filters {
+            filter.prepare(&context);
+        }
+
+        let mut expected = Vec::new();
+        for input in render(&mut source, 20).chunks(BUFFER_SIZE) {
+            let mut signal = [0.0f64; BUFFER_SIZE];
+            widen(input, &mut signal);
+            for filter in &mut filters {
+                let mut filtered = [0.0f64; BUFFER_SIZE];
+                filter.process(&[&signal], &mut [&mut filtered], &[], &context);
+                signal = filtered;
+            }
+            let mut output = [0.0f32; BUFFER_SIZE];
+            narrow(&signal, &mut output);
+            expected.extend_from_slice(&output);
+        }
+
+        assert_eq!(island, expected);
+    }
+
+    #[test]
+    fn test_standalone_process_matches_graph() {
+        let context = GraphBuilder::<f32>::new(44100.0, BUFFER_SIZE, 1)
+            .build()
+            .context()
+            .clone();
+        let mut wrapped = F64Block::<f32>::new(LowPassFilterBlock::new(500.0, 1.0));
+        let mut reference = LowPassFilterBlock::<f64>::new(500.0, 1.0);
+        wrapped.prepare(&context);
+        reference.prepare(&context);
+
+        // Shorter than the buffer, as when a host splits a callback
+        let input: Vec<f32> = (0..40).map(|i| (i as f32 * 0.3).sin()).collect();
+        let mut output = [0.0f32; 40];
+        wrapped.process(&[&input], &mut [&mut output], &[], &context);
+
+        let mut wide_input = [0.0f64; 40];
+        widen(&input, &mut wide_input);
+        let mut wide_output = [0.0f64; 40];
+        reference.process(&[&wide_input], &mut [&mut wide_output], &[], &context);
+
+        for (&x, &y) in output.iter().zip(&wide_output) {
+            assert_eq!(x, y as f32);
+        }
+    }
+
+    #[test]
+    fn test_wide_modulator_drives_narrow_parameter() {
+        let mut builder = GraphBuilder::<f32>::new(44100.0, BUFFER_SIZE, 1);
+        let lfo = builder.add_f64(LfoBlock::new(0.5, 1.0, Waveform::Sine, None));
+        let osc = builder.add(OscillatorBlock::new(441.0, Waveform::Sine, None));
+        let gain = builder.add_f64(GainBlock::new(0.0, None));
+        builder.connect(osc, 0, gain, 0).modulate(lfo, gain, "level");
+
+        let topology = builder.capture_topology();
+        assert_eq!(topology.blocks[lfo.0].name, "LFO");
+        assert_eq!(topology.modulation_connections.len(), 1);
+
+        let mut graph = builder.build();
+        let Some(BlockType::F64(block)) = graph.get_block(gain) else {
+            panic!("expected an f64 block");
+        };
+        assert!(
+            matches!(block.inner(), BlockType::Gain(gain) if matches!(gain.level_db, Parameter::Modulated(BlockId(0))))
+        );
+
+        // The LFO reads zero on its first sample, then swings the level by up
+        // to ±1 dB
+        let rendered = render(&mut graph, 200);
+        let peak = rendered.iter().fold(0.0f32, |peak, x| peak.max(x.abs()));
+        assert!(peak > 1.0 && peak < 1.13, "{peak}");
+    }
+
+    #[test]
+    fn test_tap_inside_island_measures_narrowed_output() {
+        let mut builder = GraphBuilder::<f32>::new(44100.0, BUFFER_SIZE, 1);
+        let osc = builder.add(OscillatorBlock::new(441.0, Waveform::Square, None));
+        let boost = builder.add_f64(GainBlock::new(6.0, None));
+        let cut = builder.add_f64(GainBlock::new(-6.0, None));
+        builder.connect(osc, 0, boost, 0).connect(boost, 0, cut, 0);
+        let mut graph = builder.build();
+        let taps = graph.enable_taps();
+
+        // The boost feeds only another F64 block, so it is narrowed only
+        // while its tap is on
+        render(&mut graph, 1);
+        assert!(taps.read(boost, 0).is_none());
+
+        taps.set(boost, 0, true);
+        render(&mut graph, 1);
+        let reading = taps.read(boost, 0).unwrap();
+        assert!((reading.peak_db() - 6.0).abs() < 0.1, "{}", reading.peak_db());
+    }
+
+    #[test]
+    fn test_memory_report_counts_wide_buffers() {
+        let mut builder = GraphBuilder::<f32>::new(44100.0, BUFFER_SIZE, 1);
+        let osc = builder.add(saw());
+        let filter = builder.add_f64(LowPassFilterBlock::new(300.0, 0.707));
+        builder.connect(osc, 0, filter, 0);
+        let graph = builder.build();
+
+        let report = graph.memory_report();
+        let plain = LowPassFilterBlock::<f64>::new(300.0, 0.707).memory_footprint().state;
+        let wide_buffers = 2 * BUFFER_SIZE * size_of::<f64>();
+        assert!(report.blocks[filter.0].state >= plain + wide_buffers);
+        assert_eq!(report.blocks[filter.0].buffers, BUFFER_SIZE * size_of::<f32>());
+    }
+}
@@ -50,7 +50,9 @@ pub use crate::{
     buffer::AudioBuffer,
     context::{DEFAULT_BUFFER_SIZE, DEFAULT_SAMPLE_RATE, DspContext},
     graph::{Graph, GraphBuilder},
+    modulation::{ModulationCurve, ModulationRoute, RouteId},
     parameter::Parameter,
+    precision::F64Block,
     sample::Sample,
     smoothing::{
         Linear, LinearSmoothedValue, Multiplicative, MultiplicativeSmoothedValue, SmoothedValue, SmoothingStrategy,
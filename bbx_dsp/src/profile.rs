@@ -0,0 +1,223 @@
+//! Live per-block processing load.
+//!
+//! [`Graph::enable_profiling`](crate::graph::Graph::enable_profiling) times
+//! every block on the audio thread and publishes, once per window of
+//! callbacks, each block's average share of the callback budget (the time one
+//! buffer represents at the current sample rate). A share of `1.0` means the
+//! block alone used the whole budget.
+//!
+//! Timing reads the clock once per block boundary, accumulates into
+//! preallocated storage, and publishes with relaxed atomic stores, so the
+//! audio thread never allocates, locks or blocks. Readers get a
+//! [`BlockLoad`] handle that can be cloned and polled from any thread.
+
+use std::{
+    sync::{
+        Arc,
+        atomic::{AtomicU32, AtomicU64, Ordering},
+    },
+    time::Instant,
+};
+
+/// Published loads, stored as `f32` bits.
+struct LoadShared {
+    blocks: Box<[AtomicU32]>,
+    callback: AtomicU32,
+    updates: AtomicU64,
+}
+
+/// Audio-thread side of a block profile.
+pub struct BlockProfiler {
+    shared: Arc<LoadShared>,
+    elapsed_ns: Box<[u64]>,
+    callback_ns: u64,
+    callbacks: usize,
+    window: usize,
+    callback_start: Instant,
+    last: Instant,
+}
+
+impl BlockProfiler {
+    /// Create a profiler for `num_blocks` blocks that publishes every
+    /// `window` callbacks, along with its reading handle.
+    pub fn new(num_blocks: usize, window: usize) -> (Self, BlockLoad) {
+        let shared = Arc::new(LoadShared {
+            blocks: (0..num_blocks).map(|_| AtomicU32::new(0)).collect(),
+            callback: AtomicU32::new(0),
+            updates: AtomicU64::new(0),
+        });
+        let now = Instant::now();
+        let profiler = Self {
+            shared: Arc::clone(&shared),
+            elapsed_ns: vec![0; num_blocks].into_boxed_slice(),
+            callback_ns: 0,
+            callbacks: 0,
+            window: window.max(1),
+            callback_start: now,
+            last: now,
+        };
+        (profiler, BlockLoad { shared })
+    }
+
+    /// Mark the start of a processing callback.
+    #[inline]
+    pub fn begin_callback(&mut self) {
+        self.callback_start = Instant::now();
+        self.last = self.callback_start;
+    }
+
+    /// Attribute the time since the previous boundary to block `index`.
+    #[inline]
+    pub fn block_done(&mut self, index: usize) {
+        let now = Instant::now();
+        if let Some(elapsed) = self.elapsed_ns.get_mut(index) {
+            *elapsed += now.duration_since(self.last).as_nanos() as u64;
+        }
+        self.last = now;
+    }
+
+    /// Mark the end of a processing callback whose budget is `budget_ns`,
+    /// publishing the window's averages when it is complete.
+    #[inline]
+    pub fn end_callback(&mut self, budget_ns: f64) {
+        self.callback_ns += self.callback_start.elapsed().as_nanos() as u64;
+        self.callbacks += 1;
+        if self.callbacks < self.window {
+            return;
+        }
+
+        let scale = 1.0 / (budget_ns * self.callbacks as f64);
+        for (elapsed, load) in self.elapsed_ns.iter_mut().zip(self.shared.blocks.iter()) {
+            load.store(((*elapsed as f64 * scale) as f32).to_bits(), Ordering::Relaxed);
+            *elapsed = 0;
+        }
+        self.shared
+            .callback
+            .store(((self.callback_ns as f64 * scale) as f32).to_bits(), Ordering::Relaxed);
+        self.shared.updates.fetch_add(1, Ordering::Release);
+        self.callback_ns = 0;
+        self.callbacks = 0;
+    }
+}
+
+/// Reading side of a block profile.
+///
+/// Cheap to clone; every clone reads the same published values.
+#[derive(Clone)]
+pub struct BlockLoad {
+    shared: Arc<LoadShared>,
+}
+
+impl BlockLoad {
+    /// Number of blocks being profiled, indexed by block ID.
+    pub fn num_blocks(&self) -> usize {
+        self.shared.blocks.len()
+    }
+
+    /// Share of the callback budget used by a block in the last window,
+    /// or 0.0 for an unknown block.
+    #[inline]
+    pub fn load(&self, index: usize) -> f32 {
+        self.shared
+            .blocks
+            .get(index)
+            .map_or(0.0, |load| f32::from_bits(load.load(Ordering::Relaxed)))
+    }
+
+    /// Share of the callback budget used by the whole callback in the last window.
+    #[inline]
+    pub fn callback_load(&self) -> f32 {
+        f32::from_bits(self.shared.callback.load(Ordering::Relaxed))
+    }
+
+    /// Copy block loads into `out`, up to the shorter of the two lengths.
+    pub fn read_into(&self, out: &mut [f32]) {
+        for (index, value) in out.iter_mut().enumerate().take(self.num_blocks()) {
+            *value = self.load(index);
+        }
+    }
+
+    /// Number of windows published so far.
+    ///
+    /// Unchanged between two reads means no new data.
+    pub fn updates(&self) -> u64 {
+        self.shared.updates.load(Ordering::Acquire)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::{thread, time::Duration};
+
+    use super::*;
+    use crate::{
+        blocks::{GainBlock, OscillatorBlock},
+        graph::GraphBuilder,
+        waveform::Waveform,
+    };
+
+    #[test]
+    fn test_publishes_once_per_window() {
+        let (mut profiler, load) = BlockProfiler::new(2, 3);
+
+        for callback in 0..3 {
+            profiler.begin_callback();
+            thread::sleep(Duration::from_millis(1));
+            profiler.block_done(1);
+            profiler.block_done(0);
+            profiler.end_callback(1_000_000.0);
+
+            let expected_updates = if callback < 2 { 0 } else { 1 };
+            assert_eq!(load.updates(), expected_updates);
+        }
+
+        assert!(load.load(1) >= 1.0, "block 1 slept a full budget: {}", load.load(1));
+        assert!(load.load(0) < load.load(1));
+        assert!(load.callback_load() >= load.load(0) + load.load(1) - 1e-3);
+        assert_eq!(load.load(7), 0.0);
+    }
+
+    #[test]
+    fn test_window_is_reset_after_publishing() {
+        let (mut profiler, load) = BlockProfiler::new(1, 1);
+
+        profiler.begin_callback();
+        thread::sleep(Duration::from_millis(1));
+        profiler.block_done(0);
+        profiler.end_callback(1_000_000.0);
+        let busy = load.load(0);
+
+        profiler.begin_callback();
+        profiler.block_done(0);
+        profiler.end_callback(1_000_000.0);
+
+        assert_eq!(load.updates(), 2);
+        assert!(load.load(0) < busy);
+    }
+
+    #[test]
+    fn test_graph_profiles_every_block() {
+        let mut builder = GraphBuilder::<f32>::new(44100.0, 64, 1);
+        let osc = builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+        let gain = builder.add(GainBlock::new(-6.0, None));
+        builder.connect(osc, 0, gain, 0);
+        let mut graph = builder.build();
+        let load = graph.enable_profiling(4);
+
+        let mut output = vec![0.0; 64];
+        for _ in 0..4 {
+            graph.process_buffers(&mut [&mut output]);
+        }
+
+        assert_eq!(load.updates(), 1);
+        assert_eq!(load.num_blocks(), 3);
+        let mut loads = [0.0; 3];
+        load.read_into(&mut loads);
+        assert!(loads.iter().all(|&share| share > 0.0));
+        assert!(load.callback_load() >= loads.iter().sum::<f32>() - 1e-6);
+
+        graph.disable_profiling();
+        graph.process_buffers(&mut [&mut output]);
+        assert_eq!(load.updates(), 1);
+    }
+}
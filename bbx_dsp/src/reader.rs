@@ -3,12 +3,19 @@
 //! This module defines the [`Reader`] trait for reading audio file data.
 //! Implementations are provided by the `bbx_file` crate (e.g., WAV reader).
 
+use std::sync::Arc;
+
 use crate::sample::Sample;
 
 /// Trait for reading audio data from files.
 ///
 /// Implementations should load audio data on construction and provide
 /// access to the decoded samples via [`read_channel`](Self::read_channel).
+///
+/// Readers that keep their samples encoded, such as
+/// [`PcmStore`](crate::pcm::PcmStore), report it through
+/// [`is_encoded`](Self::is_encoded) and have no slices to lend: they decode
+/// on demand in [`read_into`](Self::read_into), which works for every reader.
 pub trait Reader<S: Sample>: Send + Sync {
     /// Get the sample rate of the audio file being read.
     fn sample_rate(&self) -> f64;
@@ -20,5 +27,64 @@ pub trait Reader<S: Sample>: Send + Sync {
     fn num_samples(&self) -> usize;
 
     /// Read samples from a specific channel of the audio file.
+    ///
+    /// Only meaningful when [`is_encoded`](Self::is_encoded) is `false`;
+    /// encoded readers panic in debug builds and return an empty slice
+    /// otherwise.
     fn read_channel(&self, channel_index: usize) -> &[S];
+
+    /// Whether samples are held encoded, so [`read_channel`](Self::read_channel)
+    /// has nothing to return and [`read_into`](Self::read_into) must be used.
+    fn is_encoded(&self) -> bool {
+        false
+    }
+
+    /// Copy samples of a channel starting at `position` into `output`.
+    /// Samples past the end of the file are written as zero.
+    fn read_into(&self, channel_index: usize, position: usize, output: &mut [S]) {
+        let channel = self.read_channel(channel_index);
+        let available = channel.len().saturating_sub(position).min(output.len());
+        let (head, tail) = output.split_at_mut(available);
+        if available > 0 {
+            head.copy_from_slice(&channel[position..position + available]);
+        }
+        tail.fill(S::ZERO);
+    }
+
+    /// Bytes of sample data the reader keeps in memory.
+    fn resident_bytes(&self) -> usize {
+        self.num_channels() * self.num_samples() * size_of::<S>()
+    }
+}
+
+/// Shares one decoded file between several readers, e.g. the graphs of a
+/// parallel render.
+impl<S: Sample, R: Reader<S> + ?Sized> Reader<S> for Arc<R> {
+    fn sample_rate(&self) -> f64 {
+        (**self).sample_rate()
+    }
+
+    fn num_channels(&self) -> usize {
+        (**self).num_channels()
+    }
+
+    fn num_samples(&self) -> usize {
+        (**self).num_samples()
+    }
+
+    fn read_channel(&self, channel_index: usize) -> &[S] {
+        (**self).read_channel(channel_index)
+    }
+
+    fn is_encoded(&self) -> bool {
+        (**self).is_encoded()
+    }
+
+    fn read_into(&self, channel_index: usize, position: usize, output: &mut [S]) {
+        (**self).read_into(channel_index, position, output)
+    }
+
+    fn resident_bytes(&self) -> usize {
+        (**self).resident_bytes()
+    }
 }
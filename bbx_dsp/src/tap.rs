@@ -0,0 +1,285 @@
+//! Metering taps on block outputs.
+//!
+//! [`Graph::enable_taps`](crate::graph::Graph::enable_taps) returns a
+//! [`MeterTaps`] handle that can switch a tap on any block output (and so on
+//! every [`Connection`] leaving it) while the graph runs. After a tapped
+//! block processes, the graph measures peak, RMS and clipped samples on each
+//! tapped output and publishes them into that output's slot.
+//!
+//! Slots are latest-value cells of plain atomics: publishing is a few relaxed
+//! stores and reading is a few relaxed loads, so neither side ever waits.
+//! Peak and RMS are packed into one word so a reader always sees a matching
+//! pair. A block with no tapped outputs costs one atomic load per callback.
+
+use std::sync::{
+    Arc,
+    atomic::{AtomicU64, Ordering},
+};
+
+use crate::{block::BlockId, graph::Connection, sample::Sample};
+
+/// Magnitude above which a sample counts as clipped.
+const CLIP_LEVEL: f64 = 1.0;
+
+/// Latest measurement of one tapped output.
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct TapReading {
+    /// Peak magnitude over the last processed buffer.
+    pub peak: f32,
+    /// RMS level over the last processed buffer.
+    pub rms: f32,
+    /// Samples above full scale since the tap was enabled or last reset.
+    pub clips: u64,
+    /// Number of buffers measured since the tap was enabled.
+    pub updates: u64,
+}
+
+impl TapReading {
+    /// Peak level in dBFS.
+    pub fn peak_db(&self) -> f32 {
+        20.0 * self.peak.max(1e-10).log10()
+    }
+
+    /// RMS level in dBFS.
+    pub fn rms_db(&self) -> f32 {
+        20.0 * self.rms.max(1e-10).log10()
+    }
+}
+
+#[derive(Default)]
+struct TapSlot {
+    /// Peak bits in the high half, RMS bits in the low half.
+    levels: AtomicU64,
+    clips: AtomicU64,
+    updates: AtomicU64,
+}
+
+struct TapBank {
+    slots: Box<[TapSlot]>,
+    /// Bitmask of tapped outputs, per block.
+    enabled: Box<[AtomicU64]>,
+    first_slot: Box<[usize]>,
+    output_counts: Box<[usize]>,
+}
+
+/// Shared handle for switching and reading metering taps.
+///
+/// Cheap to clone and usable from any thread. Outputs are addressed by block
+/// ID and output port, the same as the source of a [`Connection`].
+#[derive(Clone)]
+pub struct MeterTaps {
+    bank: Arc<TapBank>,
+}
+
+impl MeterTaps {
+    /// Create taps for blocks with the given output counts.
+    pub(crate) fn new(output_counts: impl IntoIterator<Item = usize>) -> Self {
+        let output_counts: Box<[usize]> = output_counts.into_iter().collect();
+        let mut first_slot = Vec::with_capacity(output_counts.len());
+        let mut total = 0;
+        for &count in output_counts.iter() {
+            first_slot.push(total);
+            total += count;
+        }
+
+        Self {
+            bank: Arc::new(TapBank {
+                slots: (0..total).map(|_| TapSlot::default()).collect(),
+                enabled: (0..output_counts.len()).map(|_| AtomicU64::new(0)).collect(),
+                first_slot: first_slot.into_boxed_slice(),
+                output_counts,
+            }),
+        }
+    }
+
+    fn slot(&self, block: BlockId, output: usize) -> Option<&TapSlot> {
+        let count = *self.bank.output_counts.get(block.0)?;
+        if output >= count || output >= u64::BITS as usize {
+            return None;
+        }
+        self.bank.slots.get(self.bank.first_slot[block.0] + output)
+    }
+
+    /// Switch the tap on a block output on or off.
+    ///
+    /// Enabling a tap clears its previous reading. Returns `false` if the
+    /// block or output doesn't exist.
+    pub fn set(&self, block: BlockId, output: usize, enabled: bool) -> bool {
+        let Some(slot) = self.slot(block, output) else {
+            return false;
+        };
+        let bit = 1 << output;
+        if enabled {
+            slot.levels.store(0, Ordering::Relaxed);
+            slot.clips.store(0, Ordering::Relaxed);
+            slot.updates.store(0, Ordering::Relaxed);
+            self.bank.enabled[block.0].fetch_or(bit, Ordering::Release);
+        } else {
+            self.bank.enabled[block.0].fetch_and(!bit, Ordering::Release);
+        }
+        true
+    }
+
+    /// Switch the tap on the source of a connection on or off.
+    pub fn set_connection(&self, connection: &Connection, enabled: bool) -> bool {
+        self.set(connection.from, connection.from_output, enabled)
+    }
+
+    /// Turn off every tap.
+    pub fn disable_all(&self) {
+        for mask in self.bank.enabled.iter() {
+            mask.store(0, Ordering::Release);
+        }
+    }
+
+    /// Whether the tap on a block output is on.
+    pub fn is_enabled(&self, block: BlockId, output: usize) -> bool {
+        self.slot(block, output).is_some() && self.bank.enabled[block.0].load(Ordering::Relaxed) & (1 << output) != 0
+    }
+
+    /// Latest reading of a block output, or `None` if its tap is off.
+    pub fn read(&self, block: BlockId, output: usize) -> Option<TapReading> {
+        if !self.is_enabled(block, output) {
+            return None;
+        }
+        let slot = self.slot(block, output)?;
+        // Acquiring the update count first means the levels and clips read
+        // after it are at least as new as that update
+        let updates = slot.updates.load(Ordering::Acquire);
+        let levels = slot.levels.load(Ordering::Relaxed);
+        Some(TapReading {
+            peak: f32::from_bits((levels >> 32) as u32),
+            rms: f32::from_bits(levels as u32),
+            clips: slot.clips.load(Ordering::Relaxed),
+            updates,
+        })
+    }
+
+    /// Reset the clip count of a block output.
+    pub fn reset_clips(&self, block: BlockId, output: usize) {
+        if let Some(slot) = self.slot(block, output) {
+            slot.clips.store(0, Ordering::Relaxed);
+        }
+    }
+
+    /// Bitmask of tapped outputs of a block.
+    #[inline]
+    pub(crate) fn enabled_outputs(&self, block: usize) -> u64 {
+        self.bank
+            .enabled
+            .get(block)
+            .map_or(0, |mask| mask.load(Ordering::Acquire))
+    }
+
+    /// Measure one buffer of a block output and publish the result.
+    #[inline]
+    pub(crate) fn measure<S: Sample>(&self, block: usize, output: usize, samples: &[S]) {
+        let Some(slot) = self.slot(BlockId(block), output) else {
+            return;
+        };
+        let (peak, sum_squares, clips) = level_stats(samples);
+        let rms = if samples.is_empty() {
+            0.0
+        } else {
+            (sum_squares.to_f64() / samples.len() as f64).sqrt()
+        };
+
+        let levels = ((peak.to_f64() as f32).to_bits() as u64) << 32 | (rms as f32).to_bits() as u64;
+        slot.levels.store(levels, Ordering::Relaxed);
+        if clips > 0 {
+            slot.clips.fetch_add(clips as u64, Ordering::Relaxed);
+        }
+        slot.updates.fetch_add(1, Ordering::Release);
+    }
+}
+
+#[cfg(feature = "simd")]
+#[inline]
+fn level_stats<S: Sample>(samples: &[S]) -> (S, S, usize) {
+    bbx_core::simd::level_stats(samples, S::from_f64(CLIP_LEVEL))
+}
+
+#[cfg(not(feature = "simd"))]
+#[inline]
+fn level_stats<S: Sample>(samples: &[S]) -> (S, S, usize) {
+    let clip_level = S::from_f64(CLIP_LEVEL);
+    let mut peak = S::ZERO;
+    let mut sum_squares = S::ZERO;
+    let mut clips = 0;
+    for &sample in samples {
+        let magnitude = sample.abs();
+        if magnitude > peak {
+            peak = magnitude;
+        }
+        sum_squares += sample * sample;
+        if magnitude > clip_level {
+            clips += 1;
+        }
+    }
+    (peak, sum_squares, clips)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        blocks::{GainBlock, OscillatorBlock},
+        graph::GraphBuilder,
+        waveform::Waveform,
+    };
+
+    #[test]
+    fn test_measure_publishes_levels() {
+        let taps = MeterTaps::new([1, 2]);
+        assert!(taps.set(BlockId(1), 1, true));
+        assert!(!taps.set(BlockId(1), 2, true));
+        assert!(!taps.set(BlockId(2), 0, true));
+
+        let wide = MeterTaps::new([36]);
+        assert!(wide.set(BlockId(0), 35, true));
+        assert!(wide.is_enabled(BlockId(0), 35));
+
+        taps.measure(1, 1, &[0.5f32, -2.0, 0.5, -0.5]);
+        taps.measure(1, 1, &[0.5f32, -1.5, 0.5, -0.5]);
+
+        let reading = taps.read(BlockId(1), 1).unwrap();
+        assert_eq!(reading.peak, 1.5);
+        assert!((reading.rms - (3.0f32 / 4.0).sqrt()).abs() < 1e-6);
+        assert_eq!(reading.clips, 2);
+        assert_eq!(reading.updates, 2);
+        assert!(taps.read(BlockId(0), 0).is_none());
+
+        taps.reset_clips(BlockId(1), 1);
+        assert_eq!(taps.read(BlockId(1), 1).unwrap().clips, 0);
+    }
+
+    #[test]
+    fn test_graph_measures_only_tapped_outputs() {
+        let mut builder = GraphBuilder::<f32>::new(44100.0, 256, 1);
+        let osc = builder.add(OscillatorBlock::new(441.0, Waveform::Square, None));
+        let gain = builder.add(GainBlock::new(6.0, None));
+        builder.connect(osc, 0, gain, 0);
+        let mut graph = builder.build();
+        let taps = graph.enable_taps();
+
+        let mut output = vec![0.0; 256];
+        graph.process_buffers(&mut [&mut output]);
+        assert!(taps.read(osc, 0).is_none());
+
+        taps.set(osc, 0, true);
+        taps.set(gain, 0, true);
+        graph.process_buffers(&mut [&mut output]);
+
+        let source = taps.read(osc, 0).unwrap();
+        let boosted = taps.read(gain, 0).unwrap();
+        assert_eq!(source.updates, 1);
+        assert!(source.peak > 0.9 && source.clips == 0);
+        assert!((boosted.peak_db() - source.peak_db() - 6.0).abs() < 0.1);
+        assert!(boosted.clips > 0);
+
+        taps.set(osc, 0, false);
+        graph.process_buffers(&mut [&mut output]);
+        assert!(taps.read(osc, 0).is_none());
+        assert_eq!(taps.read(gain, 0).unwrap().updates, 2);
+    }
+}
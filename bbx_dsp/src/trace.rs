@@ -0,0 +1,322 @@
+//! Audio-thread timing traces.
+//!
+//! With the `trace` feature enabled, [`Graph`](crate::graph::Graph) can
+//! record the start and end time of every block and of each
+//! `process_buffers` call. Events go into a preallocated SPSC ring, so
+//! recording never allocates, locks or blocks; when the ring is full, events
+//! are counted as dropped instead.
+//!
+//! A [`TraceWriter`] drains the ring on a background thread into a Chrome
+//! trace JSON file, which can be opened in `chrome://tracing` or
+//! [Perfetto](https://ui.perfetto.dev).
+//!
+//! Without the feature, none of this is compiled and the processing path is
+//! unchanged.
+
+use std::{
+    fs::File,
+    io::{self, BufWriter, Write},
+    path::Path,
+    sync::{
+        Arc, OnceLock,
+        atomic::{AtomicBool, AtomicU64, Ordering},
+    },
+    thread::{self, JoinHandle},
+    time::{Duration, Instant},
+};
+
+use bbx_core::spsc::{Consumer, Producer, SpscRingBuffer};
+
+/// Event id used for a whole processing callback rather than one block.
+pub const CALLBACK_ID: u32 = u32::MAX;
+
+/// How often the writer thread drains the ring.
+const DRAIN_INTERVAL: Duration = Duration::from_millis(10);
+
+static EPOCH: OnceLock<Instant> = OnceLock::new();
+
+/// Monotonic time in nanoseconds since the first trace was started.
+#[inline]
+pub fn now_ns() -> u64 {
+    EPOCH.get_or_init(Instant::now).elapsed().as_nanos() as u64
+}
+
+/// One timed span on the audio thread.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct TraceEvent {
+    /// Block index, or [`CALLBACK_ID`] for the whole callback.
+    pub id: u32,
+    /// Start time from [`now_ns`].
+    pub start_ns: u64,
+    /// End time from [`now_ns`].
+    pub end_ns: u64,
+}
+
+/// Audio-thread side of a trace.
+pub struct TraceRecorder {
+    producer: Producer<TraceEvent>,
+    dropped: Arc<AtomicU64>,
+}
+
+impl TraceRecorder {
+    /// Record a span ending now.
+    #[inline]
+    pub fn record(&mut self, id: u32, start_ns: u64) {
+        let event = TraceEvent {
+            id,
+            start_ns,
+            end_ns: now_ns(),
+        };
+        if self.producer.try_push(event).is_err() {
+            self.dropped.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+}
+
+/// Reading side of a trace, with the names needed to label events.
+pub struct TraceConsumer {
+    consumer: Consumer<TraceEvent>,
+    names: Vec<String>,
+    callback_name: String,
+    dropped: Arc<AtomicU64>,
+}
+
+impl TraceConsumer {
+    /// Pop the oldest recorded event.
+    #[inline]
+    pub fn try_pop(&mut self) -> Option<TraceEvent> {
+        self.consumer.try_pop()
+    }
+
+    /// Display name for an event id.
+    pub fn name(&self, id: u32) -> &str {
+        if id == CALLBACK_ID {
+            return &self.callback_name;
+        }
+        self.names.get(id as usize).map_or("unknown", String::as_str)
+    }
+
+    /// Number of events dropped because the ring was full.
+    pub fn dropped(&self) -> u64 {
+        self.dropped.load(Ordering::Relaxed)
+    }
+}
+
+/// Create a trace ring holding up to `capacity` events.
+///
+/// `names[i]` labels events with id `i`; `callback_name` labels
+/// [`CALLBACK_ID`] events.
+pub fn trace_channel(
+    capacity: usize,
+    names: Vec<String>,
+    callback_name: impl Into<String>,
+) -> (TraceRecorder, TraceConsumer) {
+    EPOCH.get_or_init(Instant::now);
+
+    let (producer, consumer) = SpscRingBuffer::new(capacity);
+    let dropped = Arc::new(AtomicU64::new(0));
+    (
+        TraceRecorder {
+            producer,
+            dropped: Arc::clone(&dropped),
+        },
+        TraceConsumer {
+            consumer,
+            names,
+            callback_name: callback_name.into(),
+            dropped,
+        },
+    )
+}
+
+/// Streaming writer for the Chrome trace event JSON format.
+pub struct ChromeTraceWriter<W: Write> {
+    writer: W,
+    events: usize,
+}
+
+impl<W: Write> ChromeTraceWriter<W> {
+    /// Start a trace document.
+    pub fn new(mut writer: W) -> io::Result<Self> {
+        writer.write_all(b"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[")?;
+        Ok(Self { writer, events: 0 })
+    }
+
+    /// Append one complete (`"ph":"X"`) event.
+    pub fn write_event(&mut self, event: &TraceEvent, name: &str) -> io::Result<()> {
+        if self.events > 0 {
+            self.writer.write_all(b",")?;
+        }
+        self.writer.write_all(b"\n{\"name\":")?;
+        write_json_string(&mut self.writer, name)?;
+        write!(
+            self.writer,
+            ",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3},\"dur\":{:.3},\"pid\":1,\"tid\":1}}",
+            if event.id == CALLBACK_ID { "callback" } else { "block" },
+            event.start_ns as f64 / 1000.0,
+            event.end_ns.saturating_sub(event.start_ns) as f64 / 1000.0,
+        )?;
+        self.events += 1;
+        Ok(())
+    }
+
+    /// Number of events written so far.
+    pub fn events(&self) -> usize {
+        self.events
+    }
+
+    /// Close the document and return the underlying writer.
+    pub fn finish(mut self) -> io::Result<W> {
+        self.writer.write_all(b"\n]}\n")?;
+        self.writer.flush()?;
+        Ok(self.writer)
+    }
+}
+
+fn write_json_string(writer: &mut impl Write, value: &str) -> io::Result<()> {
+    writer.write_all(b"\"")?;
+    for c in value.chars() {
+        match c {
+            '"' => writer.write_all(b"\\\"")?,
+            '\\' => writer.write_all(b"\\\\")?,
+            c if c.is_control() => write!(writer, "\\u{:04x}", c as u32)?,
+            c => write!(writer, "{c}")?,
+        }
+    }
+    writer.write_all(b"\"")
+}
+
+/// Totals reported when a [`TraceWriter`] stops.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct TraceStats {
+    /// Events written to the file.
+    pub written: usize,
+    /// Events dropped on the audio thread because the ring was full.
+    pub dropped: u64,
+}
+
+/// Background thread that drains a [`TraceConsumer`] into a Chrome trace file.
+pub struct TraceWriter {
+    running: Arc<AtomicBool>,
+    handle: JoinHandle<io::Result<TraceStats>>,
+}
+
+impl TraceWriter {
+    /// Create `path` and start writing events to it.
+    pub fn spawn(mut consumer: TraceConsumer, path: impl AsRef<Path>) -> io::Result<Self> {
+        let mut writer = ChromeTraceWriter::new(BufWriter::new(File::create(path)?))?;
+        let running = Arc::new(AtomicBool::new(true));
+        let flag = Arc::clone(&running);
+
+        let handle = thread::spawn(move || {
+            loop {
+                // Read the flag before draining so the final pass sees every
+                // event pushed before `stop()`.
+                let keep_running = flag.load(Ordering::Acquire);
+                while let Some(event) = consumer.try_pop() {
+                    writer.write_event(&event, consumer.name(event.id))?;
+                }
+                if !keep_running {
+                    break;
+                }
+                thread::sleep(DRAIN_INTERVAL);
+            }
+
+            let written = writer.events();
+            writer.finish()?;
+            Ok(TraceStats {
+                written,
+                dropped: consumer.dropped(),
+            })
+        });
+
+        Ok(Self { running, handle })
+    }
+
+    /// Write any remaining events, close the file and return the totals.
+    pub fn stop(self) -> io::Result<TraceStats> {
+        self.running.store(false, Ordering::Release);
+        self.handle
+            .join()
+            .unwrap_or_else(|_| Err(io::Error::other("trace writer thread panicked")))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{blocks::OscillatorBlock, graph::GraphBuilder, waveform::Waveform};
+
+    #[test]
+    fn test_recorder_counts_dropped_events() {
+        let (mut recorder, mut consumer) = trace_channel(2, vec!["osc".into()], "callback");
+        for _ in 0..3 {
+            recorder.record(0, now_ns());
+        }
+
+        assert_eq!(consumer.dropped(), 1);
+        let event = consumer.try_pop().unwrap();
+        assert!(event.end_ns >= event.start_ns);
+        assert_eq!(consumer.name(0), "osc");
+        assert_eq!(consumer.name(CALLBACK_ID), "callback");
+        assert_eq!(consumer.name(7), "unknown");
+    }
+
+    #[test]
+    fn test_chrome_trace_json() {
+        let mut writer = ChromeTraceWriter::new(Vec::new()).unwrap();
+        let event = TraceEvent {
+            id: 0,
+            start_ns: 1_500,
+            end_ns: 4_000,
+        };
+        writer.write_event(&event, "Gain \"A\"\n\\").unwrap();
+        writer.write_event(&event, "Gain").unwrap();
+        let json: serde_json::Value = serde_json::from_slice(&writer.finish().unwrap()).unwrap();
+
+        let events = json["traceEvents"].as_array().unwrap();
+        assert_eq!(events.len(), 2);
+        assert_eq!(events[0]["name"], "Gain \"A\"\n\\");
+        assert_eq!(events[0]["ph"], "X");
+        assert_eq!(events[0]["ts"], 1.5);
+        assert_eq!(events[0]["dur"], 2.5);
+    }
+
+    #[test]
+    fn test_graph_records_blocks_and_callback() {
+        let mut builder = GraphBuilder::<f32>::new(44100.0, 64, 1);
+        builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+        let mut graph = builder.build();
+        let mut consumer = graph.enable_tracing(64);
+
+        let mut output = vec![0.0; 64];
+        graph.process_buffers(&mut [&mut output]);
+
+        let events: Vec<_> = std::iter::from_fn(|| consumer.try_pop()).collect();
+        assert_eq!(events.len(), 3);
+        assert_eq!(consumer.name(events[0].id), "Oscillator #0");
+        assert_eq!(events[2].id, CALLBACK_ID);
+        assert!(events[2].start_ns <= events[0].start_ns && events[2].end_ns >= events[1].end_ns);
+
+        graph.disable_tracing();
+        graph.process_buffers(&mut [&mut output]);
+        assert!(consumer.try_pop().is_none());
+    }
+
+    #[test]
+    fn test_writer_thread_writes_file() {
+        let path = std::env::temp_dir().join(format!("bbx_trace_{}.json", std::process::id()));
+        let (mut recorder, consumer) = trace_channel(16, vec!["osc".into()], "callback");
+        let writer = TraceWriter::spawn(consumer, &path).unwrap();
+
+        let start = now_ns();
+        recorder.record(0, start);
+        recorder.record(CALLBACK_ID, start);
+        let stats = writer.stop().unwrap();
+
+        let json: serde_json::Value = serde_json::from_str(&std::fs::read_to_string(&path).unwrap()).unwrap();
+        std::fs::remove_file(&path).ok();
+        assert_eq!(stats, TraceStats { written: 2, dropped: 0 });
+        assert_eq!(json["traceEvents"][1]["cat"], "callback");
+    }
+}
@@ -3,7 +3,7 @@
 //! This module defines standard waveform shapes used by oscillators and LFOs.
 
 #[cfg(feature = "simd")]
-use std::simd::StdFloat;
+use std::simd::{StdFloat, f64x4};
 
 use bbx_core::random::XorShiftRng;
 
@@ -40,14 +40,14 @@ pub(crate) const DEFAULT_DUTY_CYCLE: f64 = 0.5;
 
 /// Generate 4 naive samples of a waveform using SIMD (internal helper).
 ///
+/// `phases` are in radians and `normalized` in cycles, both already wrapped.
 /// Returns `None` for Noise waveform (requires sequential RNG).
 #[cfg(feature = "simd")]
 fn generate_naive_samples_simd<S: Sample>(
     waveform: Waveform,
     phases: S::Simd,
+    normalized: S::Simd,
     duty_cycle: S,
-    two_pi: S::Simd,
-    inv_two_pi: S::Simd,
 ) -> Option<[S; SIMD_LANES]> {
     match waveform {
         Waveform::Sine => Some(S::simd_to_array(phases.sin())),
@@ -56,14 +56,12 @@ fn generate_naive_samples_simd<S: Sample>(
             let half = S::simd_splat(S::from_f64(0.5));
             let one = S::simd_splat(S::ONE);
             let neg_one = S::simd_splat(-S::ONE);
-            let normalized = (phases % two_pi) * inv_two_pi;
             Some(S::simd_to_array(S::simd_select_lt(normalized, half, one, neg_one)))
         }
 
         Waveform::Sawtooth => {
             let two = S::simd_splat(S::from_f64(2.0));
             let one = S::simd_splat(S::ONE);
-            let normalized = (phases % two_pi) * inv_two_pi;
             Some(S::simd_to_array(two * normalized - one))
         }
 
@@ -73,7 +71,6 @@ fn generate_naive_samples_simd<S: Sample>(
             let one = S::simd_splat(S::ONE);
             let three = S::simd_splat(S::from_f64(3.0));
 
-            let normalized = (phases % two_pi) * inv_two_pi;
             let rising = four * normalized - one;
             let falling = three - four * normalized;
             Some(S::simd_to_array(S::simd_select_lt(normalized, half, rising, falling)))
@@ -84,7 +81,6 @@ fn generate_naive_samples_simd<S: Sample>(
             let one = S::simd_splat(S::ONE);
             let neg_one = S::simd_splat(-S::ONE);
 
-            let normalized = (phases % two_pi) * inv_two_pi;
             Some(S::simd_to_array(S::simd_select_lt(normalized, duty, one, neg_one)))
         }
 
@@ -136,20 +132,36 @@ pub(crate) fn process_waveform_scalar<S: Sample>(
     *phase = phase.rem_euclid(<f64 as Sample>::TAU);
 }
 
+/// Phase reached after `position` samples at a constant `phase_increment`,
+/// wrapped to `[0, TAU)`.
+#[inline]
+pub(crate) fn phase_at(position: u64, phase_increment: f64) -> f64 {
+    (position as f64 * phase_increment).rem_euclid(<f64 as Sample>::TAU)
+}
+
 /// Generate 4 band-limited waveform samples using SIMD with PolyBLEP corrections.
 ///
-/// Generates naive samples via SIMD, then applies PolyBLEP/PolyBLAMP corrections.
+/// The samples start at `phase` and advance by `phase_increment` (radians).
+/// Each lane's phase is computed and wrapped in f64 before narrowing to `S`,
+/// like the scalar path, so f32 phase error doesn't build up over a buffer
+/// and the naive waveform and its correction agree on which side of an edge
+/// a sample falls.
 #[cfg(feature = "simd")]
 pub(crate) fn generate_waveform_samples_simd<S: Sample>(
     waveform: Waveform,
-    phases: S::Simd,
-    phases_normalized: [S; SIMD_LANES],
-    phase_inc_normalized: S,
+    phase: f64,
+    phase_increment: f64,
     duty_cycle: S,
-    two_pi: S::Simd,
-    inv_two_pi: S::Simd,
 ) -> Option<[S; SIMD_LANES]> {
-    let mut samples = generate_naive_samples_simd(waveform, phases, duty_cycle, two_pi, inv_two_pi)?;
+    let tau = f64x4::splat(<f64 as Sample>::TAU);
+    let inv_tau = f64x4::splat(<f64 as Sample>::INV_TAU);
+    let phases = f64x4::splat(phase) + <f64 as Sample>::simd_lane_offsets() * f64x4::splat(phase_increment);
+    let wrapped = phases - (phases * inv_tau).floor() * tau;
+    let normalized = S::simd_from_f64(wrapped * inv_tau);
+    let phases_normalized = S::simd_to_array(normalized);
+    let phase_inc_normalized = S::from_f64(phase_increment * <f64 as Sample>::INV_TAU);
+
+    let mut samples = generate_naive_samples_simd(waveform, S::simd_from_f64(wrapped), normalized, duty_cycle)?;
 
     match waveform {
         Waveform::Sine | Waveform::Noise => {}
@@ -1,8 +1,14 @@
 //! Integration tests for the DSP graph system.
 
 use bbx_dsp::{
-    blocks::{EnvelopeBlock, GainBlock, LfoBlock, MixerBlock, OscillatorBlock, OverdriveBlock, PannerBlock},
+    block::BlockType,
+    blocks::{
+        AmbisonicDecoderBlock, EnvelopeBlock, GainBlock, LfoBlock, MixerBlock, OscillatorBlock, OverdriveBlock,
+        PannerBlock,
+    },
+    channel::ChannelLayout,
     graph::GraphBuilder,
+    parameter::Parameter,
     waveform::Waveform,
 };
 
@@ -398,3 +404,41 @@ fn test_graph_reset_clears_block_state() {
         max2
     );
 }
+
+#[test]
+fn test_fifth_order_ambisonic_bus() {
+    let sample_rate = 44100.0;
+    let buffer_size = 512;
+    let num_channels = 2;
+
+    let mut builder = GraphBuilder::<f32>::new(sample_rate, buffer_size, num_channels);
+    let osc = builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+    let panner = builder.add(PannerBlock::new_ambisonic(5));
+    let decoder = builder.add(AmbisonicDecoderBlock::new(5, ChannelLayout::Stereo));
+    builder.connect(osc, 0, panner, 0);
+
+    let bus_width = ChannelLayout::AmbisonicHoa5.channel_count();
+    for ch in 0..bus_width {
+        builder.connect(panner, ch, decoder, ch);
+    }
+
+    let mut graph = builder.build();
+    if let Some(BlockType::Panner(panner)) = graph.get_block_mut(panner) {
+        panner.azimuth = Parameter::Constant(90.0);
+    }
+
+    let mut left = vec![0.0f32; buffer_size];
+    let mut right = vec![0.0f32; buffer_size];
+    for _ in 0..4 {
+        let mut output_buffers: Vec<&mut [f32]> = vec![&mut left, &mut right];
+        graph.process_buffers(&mut output_buffers);
+    }
+
+    let left_peak = left.iter().map(|s| s.abs()).fold(0.0f32, f32::max);
+    let right_peak = right.iter().map(|s| s.abs()).fold(0.0f32, f32::max);
+    assert!(
+        left_peak > right_peak && right_peak > 0.0,
+        "A source panned left across a {bus_width}-channel bus should decode louder on the left: \
+         L={left_peak:.4}, R={right_peak:.4}"
+    );
+}
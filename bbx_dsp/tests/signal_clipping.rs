@@ -33,6 +33,9 @@ fn make_context(sample_rate: f64, buffer_size: usize) -> DspContext {
         num_channels: 1,
         buffer_size,
         current_sample: 0,
+        is_playing: true,
+        tempo: None,
+        ppq_position: None,
         channel_layout: ChannelLayout::default(),
     }
 }
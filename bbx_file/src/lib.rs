@@ -33,8 +33,10 @@
 //! let stats = renderer.render(RenderDuration::Duration(30))?;
 //! ```
 
+pub mod parallel;
 pub mod readers;
 pub mod renderer;
 pub mod writers;
 
+pub use parallel::{ParallelRenderOptions, ParallelRenderer};
 pub use renderer::{OfflineRenderer, RenderDuration, RenderError, RenderStats};
@@ -0,0 +1,483 @@
+//! Parallel offline rendering by time segment.
+//!
+//! [`ParallelRenderer`] splits a timeline into segments and renders several
+//! at once, each on its own graph built by a factory closure. A graph can't
+//! be cloned mid-render, so each segment starts from a fresh graph that is
+//! moved to the segment with [`Graph::seek`], and reaches the right state one
+//! of two ways:
+//!
+//! - **Exact seek**: every block jumps to the segment start (file inputs, oscillators at a constant frequency,
+//!   stateless effects), and no preroll is needed.
+//! - **Preroll**: otherwise the graph seeks `preroll_samples` early and discards them, so blocks whose state depends on
+//!   a bounded stretch of history (filters, short delays, envelopes) settle into the state a sequential render would
+//!   have had.
+//!
+//! Each segment also renders `verify_samples` past its end, and those samples
+//! are compared with the start of the next segment. A difference above the
+//! tolerance means the graph's state outlives the preroll (a modulated
+//! oscillator's phase, for instance), and the render fails rather than
+//! writing a glitch.
+//!
+//! Segments are rendered in rounds of `threads` and written in order after
+//! each round, so memory use is bounded by one round rather than the whole
+//! timeline.
+
+use std::{num::NonZeroUsize, thread, time::Instant};
+
+use bbx_dsp::{graph::Graph, sample::Sample, writer::Writer};
+
+use crate::renderer::{RenderDuration, RenderError, RenderStats, assert_writer_matches, duration_samples};
+
+/// Segmentation settings for a [`ParallelRenderer`].
+#[derive(Debug, Clone, PartialEq)]
+pub struct ParallelRenderOptions {
+    /// Segments rendered at once. Defaults to the available parallelism.
+    pub threads: usize,
+    /// Length of each segment in samples, rounded up to whole buffers.
+    pub segment_samples: usize,
+    /// Samples rendered and discarded before each segment, rounded up to
+    /// whole buffers. Unused when every block seeks exactly.
+    pub preroll_samples: usize,
+    /// Samples each segment renders past its end to check against the next.
+    pub verify_samples: usize,
+    /// Largest difference allowed between overlapping samples.
+    pub tolerance: f64,
+}
+
+impl Default for ParallelRenderOptions {
+    fn default() -> Self {
+        Self {
+            threads: thread::available_parallelism().map_or(1, NonZeroUsize::get),
+            segment_samples: 1 << 20,
+            preroll_samples: 1 << 16,
+            verify_samples: 64,
+            tolerance: 1e-4,
+        }
+    }
+}
+
+/// Offline renderer that renders time segments of a graph in parallel.
+///
+/// # Example
+///
+/// ```ignore
+/// use bbx_file::{ParallelRenderer, RenderDuration, readers::wav::WavFileReader, writers::wav::WavFileWriter};
+///
+/// let reader = Arc::new(WavFileReader::<f32>::from_path("stems.wav")?);
+/// let factory = || {
+///     let mut builder = GraphBuilder::<f32>::new(48000.0, 512, 2);
+///     let file = builder.add(FileInputBlock::new(Box::new(Arc::clone(&reader))));
+///     let filter = builder.add(LowPassFilterBlock::new(800.0, 0.707));
+///     builder.connect(file, 0, filter, 0);
+///     builder.build()
+/// };
+///
+/// let writer = WavFileWriter::new("output.wav", 48000.0, 2)?;
+/// let mut renderer = ParallelRenderer::new(factory, Box::new(writer));
+/// let stats = renderer.render(RenderDuration::Duration(3600))?;
+/// ```
+pub struct ParallelRenderer<S: Sample, F> {
+    factory: F,
+    writer: Box<dyn Writer<S>>,
+    options: ParallelRenderOptions,
+    first_graph: Option<Graph<S>>,
+    buffer_size: usize,
+    sample_rate: f64,
+    num_channels: usize,
+}
+
+/// Samples of one segment, per channel, from its start to its verify tail.
+type Segment<S> = Vec<Vec<S>>;
+
+impl<S: Sample, F: Fn() -> Graph<S> + Sync> ParallelRenderer<S, F> {
+    /// Create a parallel renderer with default options.
+    ///
+    /// `factory` builds a graph positioned at sample 0; the renderer seeks it
+    /// to each segment. Every graph it builds must have the same context. The
+    /// first graph is built here and used for the first segment.
+    ///
+    /// # Panics
+    ///
+    /// Panics if the writer's sample rate or channel count doesn't match the graph.
+    pub fn new(factory: F, writer: Box<dyn Writer<S>>) -> Self {
+        let graph = factory();
+        let context = graph.context();
+        let buffer_size = context.buffer_size;
+        let sample_rate = context.sample_rate;
+        let num_channels = context.num_channels;
+        assert_writer_matches(writer.as_ref(), context);
+
+        Self {
+            factory,
+            writer,
+            options: ParallelRenderOptions::default(),
+            first_graph: Some(graph),
+            buffer_size,
+            sample_rate,
+            num_channels,
+        }
+    }
+
+    /// Replace the segmentation options.
+    pub fn with_options(mut self, options: ParallelRenderOptions) -> Self {
+        self.options = options;
+        self
+    }
+
+    /// Get the segmentation options.
+    #[inline]
+    pub fn options(&self) -> &ParallelRenderOptions {
+        &self.options
+    }
+
+    /// Render audio for the specified duration.
+    ///
+    /// Writes segments in order and finalizes the writer when complete. On
+    /// [`RenderError::SegmentMismatch`] the segments before the mismatch have
+    /// already been written and the writer is not finalized.
+    pub fn render(&mut self, duration: RenderDuration) -> Result<RenderStats, RenderError> {
+        let num_samples = duration_samples(duration, self.sample_rate)?;
+
+        let buffer_size = self.buffer_size as u64;
+        let round_up = |samples: usize| (samples as u64).div_ceil(buffer_size) * buffer_size;
+        let segment_len = round_up(self.options.segment_samples).max(buffer_size);
+        let preroll = round_up(self.options.preroll_samples);
+        let verify = (self.options.verify_samples as u64).min(segment_len);
+        let threads = self.options.threads.max(1) as u64;
+        let num_segments = num_samples.div_ceil(segment_len);
+
+        let start_time = Instant::now();
+        let mut previous_tail: Option<Segment<S>> = None;
+
+        for round_start in (0..num_segments).step_by(threads as usize) {
+            let round_end = (round_start + threads).min(num_segments);
+            let plan = move |index: u64| {
+                let start = index * segment_len;
+                let end = (start + segment_len).min(num_samples);
+                (start.saturating_sub(preroll), start, (end + verify).min(num_samples))
+            };
+
+            let factory = &self.factory;
+            let first_graph = self.first_graph.take().filter(|_| round_start == 0);
+            let (buffer_size, num_channels) = (self.buffer_size, self.num_channels);
+
+            let segments: Vec<Segment<S>> = thread::scope(|scope| {
+                let workers: Vec<_> = (round_start + 1..round_end)
+                    .map(|index| {
+                        scope.spawn(move || {
+                            let (warm_start, start, end) = plan(index);
+                            let mut graph = factory();
+                            let from = seek_segment(&mut graph, warm_start, start);
+                            render_segment(&mut graph, from, start, end, buffer_size, num_channels)
+                        })
+                    })
+                    .collect();
+
+                let (warm_start, start, end) = plan(round_start);
+                let (mut graph, from) = match first_graph {
+                    Some(graph) => (graph, start),
+                    None => {
+                        let mut graph = factory();
+                        let from = seek_segment(&mut graph, warm_start, start);
+                        (graph, from)
+                    }
+                };
+                let mut segments = vec![render_segment(&mut graph, from, start, end, buffer_size, num_channels)];
+                segments.extend(
+                    workers
+                        .into_iter()
+                        .map(|worker| worker.join().expect("segment render thread panicked")),
+                );
+                segments
+            });
+
+            for (index, mut segment) in (round_start..round_end).zip(segments) {
+                if let Some(tail) = previous_tail.take() {
+                    let max_difference = max_difference(&tail, &segment);
+                    if max_difference > self.options.tolerance {
+                        return Err(RenderError::SegmentMismatch {
+                            segment: index as usize,
+                            max_difference,
+                        });
+                    }
+                }
+
+                let len = segment_len.min(num_samples - index * segment_len) as usize;
+                let tail = segment.iter_mut().map(|channel| channel.split_off(len)).collect();
+                for (channel_idx, channel) in segment.iter().enumerate() {
+                    self.writer
+                        .write_channel(channel_idx, channel)
+                        .map_err(RenderError::WriteFailed)?;
+                }
+                previous_tail = Some(tail);
+            }
+        }
+
+        self.writer.finalize().map_err(RenderError::FinalizeFailed)?;
+
+        let render_time = start_time.elapsed().as_secs_f64();
+        let duration_seconds = num_samples as f64 / self.sample_rate;
+
+        Ok(RenderStats {
+            samples_rendered: num_samples,
+            duration_seconds,
+            render_time_seconds: render_time,
+            speedup: duration_seconds / render_time,
+        })
+    }
+
+    /// Get the sample rate of the renderer.
+    #[inline]
+    pub fn sample_rate(&self) -> f64 {
+        self.sample_rate
+    }
+
+    /// Get the number of channels.
+    #[inline]
+    pub fn num_channels(&self) -> usize {
+        self.num_channels
+    }
+
+    /// Get the buffer size.
+    #[inline]
+    pub fn buffer_size(&self) -> usize {
+        self.buffer_size
+    }
+}
+
+/// Seek a fresh graph to a segment, returning the sample rendering begins
+/// at: `start` if every block seeked exactly, otherwise `warm_start`.
+fn seek_segment<S: Sample>(graph: &mut Graph<S>, warm_start: u64, start: u64) -> u64 {
+    if graph.seek(start) {
+        start
+    } else {
+        graph.seek(warm_start);
+        warm_start
+    }
+}
+
+/// Render `graph` from `warm_start` to `end`, keeping samples from `start` on.
+fn render_segment<S: Sample>(
+    graph: &mut Graph<S>,
+    warm_start: u64,
+    start: u64,
+    end: u64,
+    buffer_size: usize,
+    num_channels: usize,
+) -> Segment<S> {
+    let mut buffers = vec![vec![S::ZERO; buffer_size]; num_channels];
+    let mut segment: Segment<S> = (0..num_channels)
+        .map(|_| Vec::with_capacity((end - start) as usize))
+        .collect();
+
+    let mut position = warm_start;
+    while position < end {
+        let mut output_refs: Vec<&mut [S]> = buffers.iter_mut().map(Vec::as_mut_slice).collect();
+        graph.process_buffers(&mut output_refs);
+
+        if position >= start {
+            let samples_to_keep = (buffer_size as u64).min(end - position) as usize;
+            for (channel, buffer) in segment.iter_mut().zip(&buffers) {
+                channel.extend_from_slice(&buffer[..samples_to_keep]);
+            }
+        }
+        position += buffer_size as u64;
+    }
+
+    segment
+}
+
+/// Largest difference between the overlapping samples of two segments.
+fn max_difference<S: Sample>(tail: &Segment<S>, next: &Segment<S>) -> f64 {
+    tail.iter()
+        .zip(next)
+        .flat_map(|(a, b)| a.iter().zip(b))
+        .map(|(&a, &b)| (a.to_f64() - b.to_f64()).abs())
+        .fold(0.0, f64::max)
+}
+
+#[cfg(test)]
+mod tests {
+    use std::sync::{Arc, Mutex};
+
+    use bbx_dsp::{
+        blocks::{FileInputBlock, LowPassFilterBlock, OscillatorBlock},
+        graph::GraphBuilder,
+        reader::Reader,
+        waveform::Waveform,
+    };
+
+    use super::*;
+    use crate::renderer::OfflineRenderer;
+
+    const SAMPLE_RATE: f64 = 44100.0;
+    const BUFFER_SIZE: usize = 64;
+
+    #[derive(Clone, Default)]
+    struct Recording {
+        samples: Vec<f32>,
+        finalized: bool,
+    }
+
+    /// Mono writer whose recording can be inspected after it is boxed.
+    struct SharedWriter {
+        recording: Arc<Mutex<Recording>>,
+    }
+
+    impl SharedWriter {
+        fn new() -> (Self, Arc<Mutex<Recording>>) {
+            let recording = Arc::new(Mutex::new(Recording::default()));
+            let writer = Self {
+                recording: Arc::clone(&recording),
+            };
+            (writer, recording)
+        }
+    }
+
+    impl Writer<f32> for SharedWriter {
+        fn sample_rate(&self) -> f64 {
+            SAMPLE_RATE
+        }
+
+        fn num_channels(&self) -> usize {
+            1
+        }
+
+        fn can_write(&self) -> bool {
+            !self.recording.lock().unwrap().finalized
+        }
+
+        fn write_channel(&mut self, _channel_index: usize, samples: &[f32]) -> Result<(), Box<dyn std::error::Error>> {
+            self.recording.lock().unwrap().samples.extend_from_slice(samples);
+            Ok(())
+        }
+
+        fn finalize(&mut self) -> Result<(), Box<dyn std::error::Error>> {
+            self.recording.lock().unwrap().finalized = true;
+            Ok(())
+        }
+    }
+
+    struct NoiseReader {
+        samples: Vec<f32>,
+    }
+
+    impl Reader<f32> for NoiseReader {
+        fn sample_rate(&self) -> f64 {
+            SAMPLE_RATE
+        }
+
+        fn num_channels(&self) -> usize {
+            1
+        }
+
+        fn num_samples(&self) -> usize {
+            self.samples.len()
+        }
+
+        fn read_channel(&self, _channel_index: usize) -> &[f32] {
+            &self.samples
+        }
+    }
+
+    fn noise(len: usize) -> Arc<NoiseReader> {
+        let mut state = 0x1234_5678u32;
+        let samples = (0..len)
+            .map(|_| {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                state as f32 / u32::MAX as f32 * 2.0 - 1.0
+            })
+            .collect();
+        Arc::new(NoiseReader { samples })
+    }
+
+    fn filtered_noise(reader: &Arc<NoiseReader>) -> Graph<f32> {
+        let mut builder = GraphBuilder::<f32>::new(SAMPLE_RATE, BUFFER_SIZE, 1);
+        let file = builder.add(FileInputBlock::new(Box::new(Arc::clone(reader))));
+        let filter = builder.add(LowPassFilterBlock::new(2000.0, 0.707));
+        builder.connect(file, 0, filter, 0);
+        builder.build()
+    }
+
+    fn options(threads: usize) -> ParallelRenderOptions {
+        ParallelRenderOptions {
+            threads,
+            segment_samples: 1000,
+            preroll_samples: 512,
+            verify_samples: 32,
+            tolerance: 1e-4,
+        }
+    }
+
+    fn sequential(graph: Graph<f32>, num_samples: usize) -> Vec<f32> {
+        let (writer, recording) = SharedWriter::new();
+        let mut renderer = OfflineRenderer::new(graph, Box::new(writer));
+        renderer.render(RenderDuration::Samples(num_samples)).unwrap();
+        recording.lock().unwrap().samples.clone()
+    }
+
+    fn max_error(a: &[f32], b: &[f32]) -> f32 {
+        a.iter().zip(b).map(|(a, b)| (a - b).abs()).fold(0.0, f32::max)
+    }
+
+    fn sine() -> Graph<f32> {
+        let mut builder = GraphBuilder::<f32>::new(SAMPLE_RATE, BUFFER_SIZE, 1);
+        builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+        builder.build()
+    }
+
+    #[test]
+    fn test_matches_sequential_render() {
+        let reader = noise(10_000);
+        let num_samples = 9_500;
+        let expected = sequential(filtered_noise(&reader), num_samples);
+
+        let (writer, parallel) = SharedWriter::new();
+        let mut renderer = ParallelRenderer::new(|| filtered_noise(&reader), Box::new(writer)).with_options(options(3));
+        let stats = renderer.render(RenderDuration::Samples(num_samples)).unwrap();
+
+        let parallel = parallel.lock().unwrap().clone();
+        assert_eq!(stats.samples_rendered, num_samples as u64);
+        assert!(parallel.finalized);
+        assert_eq!(parallel.samples.len(), num_samples);
+        let difference = max_error(&expected, &parallel.samples);
+        assert!(difference < 1e-4, "max difference {difference}");
+    }
+
+    #[test]
+    fn test_seekable_graph_needs_no_preroll() {
+        let num_samples = 5_000;
+        let expected = sequential(sine(), num_samples);
+
+        let (writer, parallel) = SharedWriter::new();
+        let options = ParallelRenderOptions {
+            preroll_samples: 0,
+            ..options(2)
+        };
+        let mut renderer = ParallelRenderer::new(sine, Box::new(writer)).with_options(options);
+        renderer.render(RenderDuration::Samples(num_samples)).unwrap();
+
+        let parallel = parallel.lock().unwrap().clone();
+        assert_eq!(parallel.samples.len(), num_samples);
+        let difference = max_error(&expected, &parallel.samples);
+        assert!(difference < 1e-4, "max difference {difference}");
+    }
+
+    #[test]
+    fn test_insufficient_preroll_fails_verification() {
+        let reader = noise(10_000);
+        let options = ParallelRenderOptions {
+            preroll_samples: 0,
+            ..options(2)
+        };
+
+        let (writer, output) = SharedWriter::new();
+        let mut renderer = ParallelRenderer::new(|| filtered_noise(&reader), Box::new(writer)).with_options(options);
+        let result = renderer.render(RenderDuration::Samples(5_000));
+
+        assert!(matches!(result, Err(RenderError::SegmentMismatch { segment: 1, .. })));
+        assert!(!output.lock().unwrap().finalized);
+    }
+}
@@ -4,6 +4,7 @@ use std::path::Path;
 
 use bbx_dsp::{
     buffer::{AudioBuffer, Buffer},
+    pcm::{PcmEncoding, PcmStore},
     reader::Reader,
     sample::Sample,
 };
@@ -12,7 +13,9 @@ use wavers::Wav;
 /// A WAV file reader implementing [`Reader`].
 ///
 /// Loads the entire WAV file into memory on construction, providing
-/// sample data via the `read_channel` method.
+/// sample data via the `read_channel` method. For code that also accepts
+/// encoded readers such as the [`PcmStore`] from [`load_pcm`], use
+/// `read_into` instead.
 pub struct WavFileReader<S: Sample> {
     channel_buffers: Vec<AudioBuffer<S>>,
     sample_rate: f64,
@@ -50,6 +53,24 @@ impl<S: Sample> WavFileReader<S> {
     }
 }
 
+/// Load a WAV file into a [`PcmStore`], keeping its samples as integer PCM.
+///
+/// Channels are encoded as they are read, so only one channel is held at
+/// full width while loading.
+pub fn load_pcm(file_path: &str, encoding: PcmEncoding) -> Result<PcmStore, Box<dyn std::error::Error>> {
+    let mut reader: Wav<f32> = Wav::from_path(Path::new(file_path))?;
+
+    let sample_rate = reader.sample_rate() as f64;
+    let num_channels = (reader.n_channels() as usize).max(1);
+    let mut store = PcmStore::new(sample_rate, reader.n_samples() / num_channels, encoding);
+
+    for channel in reader.channels() {
+        store.push_channel(&channel);
+    }
+
+    Ok(store)
+}
+
 impl<S: Sample> Reader<S> for WavFileReader<S> {
     fn sample_rate(&self) -> f64 {
         self.sample_rate
@@ -178,6 +199,26 @@ mod tests {
         assert_eq!(reader.sample_rate(), 96000.0);
     }
 
+    #[test]
+    fn test_load_pcm_matches_reader() {
+        let left: Vec<f32> = (0..100).map(|i| (i as f32 * 0.1).sin() * 0.8).collect();
+        let right: Vec<f32> = left.iter().map(|x| -x).collect();
+        let temp_file = create_test_wav(48000, 2, &[left.clone(), right.clone()]);
+
+        let store = load_pcm(temp_file.path().to_str().unwrap(), PcmEncoding::Pcm24).unwrap();
+        assert_eq!(Reader::<f64>::num_channels(&store), 2);
+        assert_eq!(Reader::<f64>::num_samples(&store), 100);
+        assert_eq!(Reader::<f64>::sample_rate(&store), 48000.0);
+
+        for (channel, expected) in [left, right].iter().enumerate() {
+            let mut decoded = vec![0.0f64; 100];
+            store.decode(channel, 0, &mut decoded);
+            for (i, (&x, &y)) in expected.iter().zip(&decoded).enumerate() {
+                assert!((x as f64 - y).abs() < 1e-6, "channel {channel} sample {i}: {x} vs {y}");
+            }
+        }
+    }
+
     #[test]
     fn test_wav_reader_invalid_path() {
         let result = WavFileReader::<f32>::from_path("/nonexistent/path/audio.wav");
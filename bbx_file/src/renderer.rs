@@ -4,6 +4,7 @@ use std::time::Instant;
 
 use bbx_dsp::{
     buffer::{AudioBuffer, Buffer},
+    context::DspContext,
     graph::Graph,
     sample::Sample,
     writer::Writer,
@@ -27,6 +28,14 @@ pub enum RenderError {
     FinalizeFailed(Box<dyn std::error::Error>),
     /// Invalid duration specified.
     InvalidDuration(String),
+    /// A parallel render segment didn't match the end of the previous one,
+    /// so the graph's state outlasts the preroll.
+    SegmentMismatch {
+        /// Index of the segment that didn't match.
+        segment: usize,
+        /// Largest difference between the overlapping samples.
+        max_difference: f64,
+    },
 }
 
 impl std::fmt::Display for RenderError {
@@ -35,6 +44,13 @@ impl std::fmt::Display for RenderError {
             RenderError::WriteFailed(e) => write!(f, "write failed: {e}"),
             RenderError::FinalizeFailed(e) => write!(f, "finalize failed: {e}"),
             RenderError::InvalidDuration(msg) => write!(f, "invalid duration: {msg}"),
+            RenderError::SegmentMismatch {
+                segment,
+                max_difference,
+            } => write!(
+                f,
+                "segment {segment} differs from the previous segment by up to {max_difference}; increase the preroll"
+            ),
         }
     }
 }
@@ -103,20 +119,7 @@ impl<S: Sample> OfflineRenderer<S> {
         let buffer_size = context.buffer_size;
         let sample_rate = context.sample_rate;
         let num_channels = context.num_channels;
-
-        assert!(
-            (writer.sample_rate() - sample_rate).abs() < 1.0,
-            "Writer sample rate ({}) must match graph sample rate ({})",
-            writer.sample_rate(),
-            sample_rate
-        );
-        assert_eq!(
-            writer.num_channels(),
-            num_channels,
-            "Writer channel count ({}) must match graph channel count ({})",
-            writer.num_channels(),
-            num_channels
-        );
+        assert_writer_matches(writer.as_ref(), context);
 
         let output_buffers = (0..num_channels).map(|_| AudioBuffer::new(buffer_size)).collect();
 
@@ -143,22 +146,7 @@ impl<S: Sample> OfflineRenderer<S> {
     ///
     /// Statistics about the render including speedup factor.
     pub fn render(&mut self, duration: RenderDuration) -> Result<RenderStats, RenderError> {
-        let num_samples = match duration {
-            RenderDuration::Duration(secs) => {
-                if secs == 0 {
-                    return Err(RenderError::InvalidDuration("Duration must be positive".to_string()));
-                }
-                (secs as f64 * self.sample_rate) as u64
-            }
-            RenderDuration::Samples(samples) => {
-                if samples == 0 {
-                    return Err(RenderError::InvalidDuration(
-                        "Sample count must be positive".to_string(),
-                    ));
-                }
-                samples as u64
-            }
-        };
+        let num_samples = duration_samples(duration, self.sample_rate)?;
 
         let start_time = Instant::now();
         let mut samples_rendered: u64 = 0;
@@ -192,6 +180,16 @@ impl<S: Sample> OfflineRenderer<S> {
         })
     }
 
+    /// Move the graph's transport to `position` samples so the next render
+    /// starts there, for bouncing a region of a longer timeline.
+    ///
+    /// Returns `true` if every block jumped there exactly. Otherwise blocks
+    /// with signal-dependent state were reset, and a short stretch rendered
+    /// from slightly earlier lets them settle. See [`Graph::seek`].
+    pub fn seek(&mut self, position: u64) -> bool {
+        self.graph.seek(position)
+    }
+
     /// Get the sample rate of the renderer.
     #[inline]
     pub fn sample_rate(&self) -> f64 {
@@ -219,6 +217,43 @@ impl<S: Sample> OfflineRenderer<S> {
     }
 }
 
+/// Convert a render duration to samples per channel.
+pub(crate) fn duration_samples(duration: RenderDuration, sample_rate: f64) -> Result<u64, RenderError> {
+    match duration {
+        RenderDuration::Duration(secs) => {
+            if secs == 0 {
+                return Err(RenderError::InvalidDuration("Duration must be positive".to_string()));
+            }
+            Ok((secs as f64 * sample_rate) as u64)
+        }
+        RenderDuration::Samples(samples) => {
+            if samples == 0 {
+                return Err(RenderError::InvalidDuration(
+                    "Sample count must be positive".to_string(),
+                ));
+            }
+            Ok(samples as u64)
+        }
+    }
+}
+
+/// Panic if a writer's sample rate or channel count doesn't match a graph's context.
+pub(crate) fn assert_writer_matches<S: Sample>(writer: &dyn Writer<S>, context: &DspContext) {
+    assert!(
+        (writer.sample_rate() - context.sample_rate).abs() < 1.0,
+        "Writer sample rate ({}) must match graph sample rate ({})",
+        writer.sample_rate(),
+        context.sample_rate
+    );
+    assert_eq!(
+        writer.num_channels(),
+        context.num_channels,
+        "Writer channel count ({}) must match graph channel count ({})",
+        writer.num_channels(),
+        context.num_channels
+    );
+}
+
 #[cfg(test)]
 mod tests {
     use bbx_dsp::{blocks::OscillatorBlock, context::DEFAULT_SAMPLE_RATE, graph::GraphBuilder, waveform::Waveform};
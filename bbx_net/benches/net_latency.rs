@@ -0,0 +1,447 @@
+//! End-to-end control latency benchmark for the OSC and WebSocket servers.
+//!
+//! Runs each server on loopback with simulated clients sending parameter
+//! changes at a fixed rate. Every message is timestamped when the client
+//! sends it and again when a simulated audio thread drains it from the
+//! `NetBufferConsumer`, so the reported latency covers socket, parsing, the
+//! lock-free buffer, and the wait for the next audio block.
+//!
+//! ```sh
+//! cargo bench -p bbx_net --features osc,websocket --bench net_latency
+//! BBX_NET_BENCH_CLIENTS=1,20 BBX_NET_BENCH_RATE=500 cargo bench -p bbx_net --features osc,websocket --bench net_latency
+//! ```
+//!
+//! | Variable | Default | Description |
+//! |----------|---------|-------------|
+//! | `BBX_NET_BENCH_PROTOCOLS` | `osc,ws` | Servers to benchmark |
+//! | `BBX_NET_BENCH_CLIENTS` | `1,10,50` | Client counts to run |
+//! | `BBX_NET_BENCH_RATE` | `100` | Messages per second per client |
+//! | `BBX_NET_BENCH_SECS` | `3` | Duration of each run |
+//! | `BBX_NET_BENCH_BLOCK_US` | `1000` | Audio block period of the drain thread |
+//!
+//! Server CPU is the time spent in the server threads as a percentage of one
+//! core, read from `/proc` (Linux only).
+
+use std::{
+    net::{SocketAddr, UdpSocket},
+    sync::{
+        Arc,
+        atomic::{AtomicBool, AtomicU32, AtomicU64, Ordering},
+    },
+    thread,
+    time::{Duration, Instant},
+};
+
+use bbx_net::{
+    NetBufferConsumer, net_buffer,
+    osc::{OscServer, OscServerConfig},
+    websocket::{ServerCommand, WsServer, WsServerConfig},
+};
+use futures_util::{SinkExt, StreamExt};
+use rosc::{OscMessage, OscPacket, OscType};
+use tokio::{net::TcpListener, runtime::Runtime};
+use tokio_tungstenite::tungstenite::Message;
+
+/// Thread name prefix for server threads, used to attribute CPU time.
+const SERVER_THREAD: &str = "bbx-bench-srv";
+
+/// Time allowed for in-flight messages to drain after clients stop.
+const GRACE: Duration = Duration::from_millis(250);
+
+/// Largest message ID that survives the round trip through an `f32` value.
+const MAX_MESSAGE_ID: usize = 1 << 24;
+
+#[derive(Clone, Copy, PartialEq, Eq)]
+enum Protocol {
+    Osc,
+    Ws,
+}
+
+impl Protocol {
+    fn name(self) -> &'static str {
+        match self {
+            Protocol::Osc => "osc",
+            Protocol::Ws => "ws",
+        }
+    }
+}
+
+struct BenchConfig {
+    protocols: Vec<Protocol>,
+    client_counts: Vec<usize>,
+    rate_hz: u64,
+    duration: Duration,
+    block_period: Duration,
+}
+
+impl BenchConfig {
+    fn from_env() -> Self {
+        let protocols = env_list("BBX_NET_BENCH_PROTOCOLS", "osc,ws")
+            .iter()
+            .filter_map(|p| match p.as_str() {
+                "osc" => Some(Protocol::Osc),
+                "ws" => Some(Protocol::Ws),
+                _ => None,
+            })
+            .collect();
+        let client_counts = env_list("BBX_NET_BENCH_CLIENTS", "1,10,50")
+            .iter()
+            .filter_map(|n| n.parse().ok())
+            .collect();
+
+        Self {
+            protocols,
+            client_counts,
+            rate_hz: env_u64("BBX_NET_BENCH_RATE", 100).max(1),
+            duration: Duration::from_secs(env_u64("BBX_NET_BENCH_SECS", 3).max(1)),
+            block_period: Duration::from_micros(env_u64("BBX_NET_BENCH_BLOCK_US", 1000)),
+        }
+    }
+}
+
+fn env_list(name: &str, default: &str) -> Vec<String> {
+    std::env::var(name)
+        .unwrap_or_else(|_| default.to_string())
+        .split(',')
+        .map(|s| s.trim().to_lowercase())
+        .filter(|s| !s.is_empty())
+        .collect()
+}
+
+fn env_u64(name: &str, default: u64) -> u64 {
+    std::env::var(name).ok().and_then(|v| v.parse().ok()).unwrap_or(default)
+}
+
+/// Send times shared between clients and the drain thread.
+struct SendLog {
+    epoch: Instant,
+    next_id: AtomicU32,
+    sent_at: Box<[AtomicU64]>,
+}
+
+impl SendLog {
+    fn new(capacity: usize) -> Self {
+        Self {
+            epoch: Instant::now(),
+            next_id: AtomicU32::new(0),
+            sent_at: (0..capacity.min(MAX_MESSAGE_ID)).map(|_| AtomicU64::new(0)).collect(),
+        }
+    }
+
+    fn now_us(&self) -> u64 {
+        self.epoch.elapsed().as_micros() as u64 + 1
+    }
+
+    /// Reserve an ID and record its send time, or `None` if the log is full.
+    fn stamp(&self) -> Option<u32> {
+        let id = self.next_id.fetch_add(1, Ordering::Relaxed);
+        let slot = self.sent_at.get(id as usize)?;
+        slot.store(self.now_us(), Ordering::Relaxed);
+        Some(id)
+    }
+
+    fn sent(&self) -> usize {
+        (self.next_id.load(Ordering::Relaxed) as usize).min(self.sent_at.len())
+    }
+}
+
+/// Simulated audio thread: drains the buffer once per block period.
+fn spawn_drain(
+    mut consumer: NetBufferConsumer,
+    log: Arc<SendLog>,
+    block_period: Duration,
+    stop: Arc<AtomicBool>,
+) -> thread::JoinHandle<Vec<u64>> {
+    thread::spawn(move || {
+        let mut latencies = Vec::with_capacity(log.sent_at.len());
+        let mut next_block = Instant::now();
+
+        while !stop.load(Ordering::Relaxed) {
+            for msg in consumer.drain_into_stack() {
+                let now = log.now_us();
+                let Some(id) = msg.payload.value() else {
+                    continue;
+                };
+                let sent = log.sent_at.get(id as usize).map_or(0, |t| t.load(Ordering::Relaxed));
+                if sent != 0 {
+                    latencies.push(now.saturating_sub(sent));
+                }
+            }
+
+            next_block += block_period;
+            let now = Instant::now();
+            if next_block > now {
+                thread::sleep(next_block - now);
+            } else {
+                next_block = now;
+            }
+        }
+
+        latencies
+    })
+}
+
+/// Sleep until each send deadline, then send, for `duration`.
+fn paced(rate_hz: u64, duration: Duration, mut send: impl FnMut() -> bool) {
+    let interval = Duration::from_nanos(1_000_000_000 / rate_hz);
+    let start = Instant::now();
+    let mut deadline = start;
+
+    while deadline - start < duration {
+        let now = Instant::now();
+        if deadline > now {
+            thread::sleep(deadline - now);
+        }
+        if !send() {
+            return;
+        }
+        deadline += interval;
+    }
+}
+
+fn run_osc_clients(server: SocketAddr, clients: usize, config: &BenchConfig, log: &Arc<SendLog>) {
+    let handles: Vec<_> = (0..clients)
+        .map(|_| {
+            let log = Arc::clone(log);
+            let (rate, duration) = (config.rate_hz, config.duration);
+            thread::spawn(move || {
+                let socket = UdpSocket::bind("127.0.0.1:0").unwrap();
+                paced(rate, duration, || {
+                    let Some(id) = log.stamp() else {
+                        return false;
+                    };
+                    let packet = OscPacket::Message(OscMessage {
+                        addr: "/blocks/param/bench".to_string(),
+                        args: vec![OscType::Float(id as f32)],
+                    });
+                    let bytes = rosc::encoder::encode(&packet).unwrap();
+                    socket.send_to(&bytes, server).is_ok()
+                });
+            })
+        })
+        .collect();
+
+    for handle in handles {
+        let _ = handle.join();
+    }
+}
+
+async fn ws_client(addr: SocketAddr, code: String, rate_hz: u64, duration: Duration, log: Arc<SendLog>) {
+    let url = format!("ws://{addr}");
+    let Ok((mut ws, _)) = tokio_tungstenite::connect_async(url.as_str()).await else {
+        return;
+    };
+    let join = format!(r#"{{"type":"join","room_code":"{code}"}}"#);
+    if ws.send(Message::Text(join)).await.is_err() {
+        return;
+    }
+    while let Some(Ok(msg)) = ws.next().await {
+        if matches!(&msg, Message::Text(text) if text.contains("\"welcome\"")) {
+            break;
+        }
+    }
+
+    let mut interval = tokio::time::interval(Duration::from_nanos(1_000_000_000 / rate_hz));
+    interval.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Burst);
+    let start = tokio::time::Instant::now();
+
+    // Drain server broadcasts so the socket never backs up.
+    let (mut sink, mut stream) = ws.split();
+    let reader = tokio::spawn(async move { while stream.next().await.is_some() {} });
+
+    while start.elapsed() < duration {
+        interval.tick().await;
+        let Some(id) = log.stamp() else {
+            break;
+        };
+        let msg = format!(r#"{{"type":"param","param":"bench","value":{id}}}"#);
+        if sink.send(Message::Text(msg)).await.is_err() {
+            break;
+        }
+    }
+
+    let _ = sink.close().await;
+    reader.abort();
+}
+
+fn server_runtime() -> Runtime {
+    tokio::runtime::Builder::new_multi_thread()
+        .worker_threads(2)
+        .thread_name(SERVER_THREAD)
+        .enable_all()
+        .build()
+        .unwrap()
+}
+
+fn client_runtime() -> Runtime {
+    tokio::runtime::Builder::new_multi_thread()
+        .thread_name("bbx-bench-client")
+        .enable_all()
+        .build()
+        .unwrap()
+}
+
+/// CPU time (user + system) of all server threads, if available.
+fn server_cpu_time() -> Option<Duration> {
+    // Clock ticks per second; 100 on every mainstream Linux configuration.
+    const CLOCK_TICKS: u64 = 100;
+
+    let mut ticks = 0;
+    for entry in std::fs::read_dir("/proc/self/task").ok()? {
+        let Ok(stat) = std::fs::read_to_string(entry.ok()?.path().join("stat")) else {
+            continue;
+        };
+        let (Some(open), Some(close)) = (stat.find('('), stat.rfind(')')) else {
+            continue;
+        };
+        if !stat[open + 1..close].starts_with(SERVER_THREAD) {
+            continue;
+        }
+        // Fields after the command: state is field 3, utime 14, stime 15.
+        let fields: Vec<&str> = stat[close + 2..].split(' ').collect();
+        let utime: u64 = fields.get(11)?.parse().ok()?;
+        let stime: u64 = fields.get(12)?.parse().ok()?;
+        ticks += utime + stime;
+    }
+
+    Some(Duration::from_millis(ticks * 1000 / CLOCK_TICKS))
+}
+
+fn percentile(sorted: &[u64], p: f64) -> f64 {
+    if sorted.is_empty() {
+        return 0.0;
+    }
+    let index = ((sorted.len() - 1) as f64 * p).round() as usize;
+    sorted[index] as f64 / 1000.0
+}
+
+fn run(protocol: Protocol, clients: usize, config: &BenchConfig) {
+    let expected = clients * (config.rate_hz * config.duration.as_secs()) as usize;
+    let log = Arc::new(SendLog::new(expected + clients * 16));
+    let (producer, consumer) = net_buffer(4096);
+    let stop = Arc::new(AtomicBool::new(false));
+    let drain = spawn_drain(consumer, Arc::clone(&log), config.block_period, Arc::clone(&stop));
+
+    let server_rt = server_runtime();
+    let mut osc_thread = None;
+
+    let cpu_before = server_cpu_time();
+    let start = Instant::now();
+
+    match protocol {
+        Protocol::Osc => {
+            let socket = UdpSocket::bind("127.0.0.1:0").unwrap();
+            let addr = socket.local_addr().unwrap();
+            drop(socket);
+
+            let server = OscServer::new(
+                OscServerConfig {
+                    bind_addr: addr,
+                    ..Default::default()
+                },
+                producer,
+            );
+            osc_thread = Some(
+                thread::Builder::new()
+                    .name(format!("{SERVER_THREAD}-osc"))
+                    .spawn(move || server.run())
+                    .unwrap(),
+            );
+            thread::sleep(Duration::from_millis(50));
+
+            run_osc_clients(addr, clients, config, &log);
+        }
+        Protocol::Ws => {
+            let (command_tx, command_rx) = WsServer::command_channel();
+            let addr = server_rt.block_on(async {
+                let listener = TcpListener::bind("127.0.0.1:0").await.unwrap();
+                let addr = listener.local_addr().unwrap();
+                let ws_config = WsServerConfig {
+                    max_connections_per_room: clients.max(1),
+                    ..Default::default()
+                };
+                tokio::spawn(WsServer::new(ws_config, producer, command_rx).run_with_listener(listener));
+                addr
+            });
+
+            let (response, rx) = tokio::sync::oneshot::channel();
+            server_rt
+                .block_on(command_tx.send(ServerCommand::CreateRoom { response }))
+                .unwrap();
+            let code = server_rt.block_on(rx).unwrap();
+
+            let client_rt = client_runtime();
+            client_rt.block_on(async {
+                let handles: Vec<_> = (0..clients)
+                    .map(|_| {
+                        tokio::spawn(ws_client(
+                            addr,
+                            code.clone(),
+                            config.rate_hz,
+                            config.duration,
+                            Arc::clone(&log),
+                        ))
+                    })
+                    .collect();
+                for handle in handles {
+                    let _ = handle.await;
+                }
+            });
+
+            let _ = server_rt.block_on(command_tx.send(ServerCommand::Shutdown));
+        }
+    }
+
+    thread::sleep(GRACE);
+    let elapsed = start.elapsed();
+    let cpu_after = server_cpu_time();
+
+    stop.store(true, Ordering::Relaxed);
+    let mut latencies = drain.join().unwrap();
+    drop(server_rt);
+    // The OSC server blocks on its socket forever; leave the thread behind.
+    drop(osc_thread);
+
+    let sent = log.sent();
+    let received = latencies.len();
+    let drop_rate = if sent == 0 {
+        0.0
+    } else {
+        100.0 * sent.saturating_sub(received) as f64 / sent as f64
+    };
+    let cpu = match (cpu_before, cpu_after) {
+        (Some(before), Some(after)) => {
+            format!(
+                "{:>5.1}%",
+                100.0 * (after - before).as_secs_f64() / elapsed.as_secs_f64()
+            )
+        }
+        _ => "   n/a".to_string(),
+    };
+
+    latencies.sort_unstable();
+    println!(
+        "{:<3} clients={clients:<4} sent={sent:<7} recv={received:<7} drop={drop_rate:>5.2}% p50={:>6.2}ms p90={:>6.2}ms p99={:>6.2}ms max={:>7.2}ms cpu={cpu}",
+        protocol.name(),
+        percentile(&latencies, 0.50),
+        percentile(&latencies, 0.90),
+        percentile(&latencies, 0.99),
+        latencies.last().copied().unwrap_or_default() as f64 / 1000.0,
+    );
+}
+
+fn main() {
+    let config = BenchConfig::from_env();
+    println!(
+        "rate={}/s per client, duration={}s, audio block={}us",
+        config.rate_hz,
+        config.duration.as_secs(),
+        config.block_period.as_micros()
+    );
+
+    for &protocol in &config.protocols {
+        for &clients in &config.client_counts {
+            run(protocol, clients, &config);
+        }
+    }
+}
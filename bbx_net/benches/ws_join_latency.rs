@@ -0,0 +1,125 @@
+//! Join latency load test for the WebSocket server.
+//!
+//! Simulates a crowd of phones joining the same room at once (e.g. after
+//! scanning a QR code) and reports the time from TCP connect to `welcome`.
+//!
+//! ```sh
+//! cargo bench -p bbx_net --features websocket --bench ws_join_latency
+//! BBX_WS_LOAD_CLIENTS=500,2000 cargo bench -p bbx_net --features websocket --bench ws_join_latency
+//! ```
+//!
+//! Each simulated client holds two sockets (client and server side), so large
+//! runs may need a higher open file limit (`ulimit -n 32768`).
+
+use std::{
+    net::SocketAddr,
+    time::{Duration, Instant},
+};
+
+use bbx_net::{
+    net_buffer,
+    websocket::{ServerCommand, WsServer, WsServerConfig},
+};
+use futures_util::{SinkExt, StreamExt};
+use tokio::{net::TcpListener, sync::mpsc};
+use tokio_tungstenite::tungstenite::Message;
+
+const DEFAULT_CLIENT_COUNTS: &[usize] = &[1000, 2000, 5000, 10000];
+const JOIN_TIMEOUT: Duration = Duration::from_secs(30);
+
+type ClientStream = tokio_tungstenite::WebSocketStream<tokio_tungstenite::MaybeTlsStream<tokio::net::TcpStream>>;
+
+fn client_counts() -> Vec<usize> {
+    std::env::var("BBX_WS_LOAD_CLIENTS")
+        .ok()
+        .map(|v| v.split(',').filter_map(|n| n.trim().parse().ok()).collect())
+        .filter(|v: &Vec<usize>| !v.is_empty())
+        .unwrap_or_else(|| DEFAULT_CLIENT_COUNTS.to_vec())
+}
+
+async fn start_server(max_clients: usize) -> (SocketAddr, mpsc::Sender<ServerCommand>, String) {
+    let listener = TcpListener::bind("127.0.0.1:0").await.unwrap();
+    let addr = listener.local_addr().unwrap();
+    let (producer, _consumer) = net_buffer(1024);
+    let (command_tx, command_rx) = WsServer::command_channel();
+
+    let config = WsServerConfig {
+        max_connections_per_room: max_clients,
+        ..Default::default()
+    };
+    tokio::spawn(WsServer::new(config, producer, command_rx).run_with_listener(listener));
+
+    let (response, rx) = tokio::sync::oneshot::channel();
+    command_tx.send(ServerCommand::CreateRoom { response }).await.unwrap();
+    let code = rx.await.unwrap();
+
+    (addr, command_tx, code)
+}
+
+async fn join(addr: SocketAddr, code: String) -> Option<(Duration, ClientStream)> {
+    let start = Instant::now();
+    let url = format!("ws://{addr}");
+
+    let (mut ws, _) = tokio_tungstenite::connect_async(url.as_str()).await.ok()?;
+    let join = format!(r#"{{"type":"join","room_code":"{code}"}}"#);
+    ws.send(Message::Text(join)).await.ok()?;
+
+    while let Some(msg) = ws.next().await {
+        if let Message::Text(text) = msg.ok()? {
+            return text.contains("\"welcome\"").then(|| (start.elapsed(), ws));
+        }
+    }
+    None
+}
+
+fn percentile(sorted: &[Duration], p: f64) -> Duration {
+    if sorted.is_empty() {
+        return Duration::ZERO;
+    }
+    let index = ((sorted.len() - 1) as f64 * p).round() as usize;
+    sorted[index]
+}
+
+async fn run(clients: usize) {
+    let (addr, command_tx, code) = start_server(clients).await;
+
+    let start = Instant::now();
+    let handles: Vec<_> = (0..clients)
+        .map(|_| {
+            let code = code.clone();
+            tokio::spawn(async move { tokio::time::timeout(JOIN_TIMEOUT, join(addr, code)).await })
+        })
+        .collect();
+
+    let mut latencies = Vec::with_capacity(clients);
+    let mut streams = Vec::with_capacity(clients);
+    for handle in handles {
+        if let Ok(Ok(Some((latency, ws)))) = handle.await {
+            latencies.push(latency);
+            streams.push(ws);
+        }
+    }
+    let wall = start.elapsed();
+    let failures = clients - latencies.len();
+
+    latencies.sort_unstable();
+    println!(
+        "clients={clients:<6} ok={:<6} failed={failures:<5} wall={:>8.1}ms p50={:>7.2}ms p90={:>7.2}ms p99={:>7.2}ms max={:>7.2}ms",
+        latencies.len(),
+        wall.as_secs_f64() * 1e3,
+        percentile(&latencies, 0.50).as_secs_f64() * 1e3,
+        percentile(&latencies, 0.90).as_secs_f64() * 1e3,
+        percentile(&latencies, 0.99).as_secs_f64() * 1e3,
+        latencies.last().copied().unwrap_or_default().as_secs_f64() * 1e3,
+    );
+
+    drop(streams);
+    let _ = command_tx.send(ServerCommand::Shutdown).await;
+}
+
+#[tokio::main]
+async fn main() {
+    for clients in client_counts() {
+        run(clients).await;
+    }
+}
@@ -60,7 +60,7 @@ export interface IBbxClientConfig {
     reconnectDelay?: number
     /** Max reconnection attempts before giving up. Default: `5`. */
     maxReconnectAttempts?: number
-    /** Interval between ping messages in ms. Default: `5000`. */
+    /** Initial interval between ping messages in ms; the server may adjust it. Default: `5000`. */
     pingInterval?: number
     /** Connection timeout in ms. Default: `10000`. */
     connectionTimeout?: number
@@ -174,7 +174,7 @@ export class BbxClient {
      * Send a parameter change to the server.
      * @param param - Parameter name
      * @param value - New value
-     * @param at - Optional server timestamp (µs) for scheduled execution. Use {@link toServerTime} to convert.
+     * @param at - Optional local timestamp (µs, e.g. `Date.now() * 1000`) for scheduled execution
      */
     setParam(param: string, value: number, at?: number): void {
         this.connection.send({
@@ -188,7 +188,7 @@ export class BbxClient {
     /**
      * Send a trigger event to the server.
      * @param name - Trigger name
-     * @param at - Optional server timestamp (µs) for scheduled execution
+     * @param at - Optional local timestamp (µs, e.g. `Date.now() * 1000`) for scheduled execution
      */
     trigger(name: string, at?: number): void {
         this.connection.send({
@@ -70,7 +70,9 @@ export class Connection {
     private reconnectTimeout: ReturnType<typeof setTimeout> | null = null
     private connectionTimeoutId: ReturnType<typeof setTimeout> | null = null
     private pingInterval: ReturnType<typeof setInterval> | null = null
+    private currentPingInterval = 0
     private lastPingTime = 0
+    private lastPongReceived: number | null = null
     private _latency = 0
     private _clockOffset = 0
     private _state: ConnectionState = 'disconnected'
@@ -197,6 +199,9 @@ export class Connection {
 
                 case 'pong':
                     this.handlePong(message.client_time, message.server_time)
+                    if (message.ping_interval_ms !== undefined) {
+                        this.updatePingInterval(message.ping_interval_ms)
+                    }
                     break
 
                 case 'error':
@@ -245,9 +250,25 @@ export class Connection {
 
     private startPingInterval(): void {
         this.stopPingInterval()
+        this.lastPongReceived = null
+        this.sendPing()
+        this.schedulePings(this.config.pingInterval)
+    }
+
+    private schedulePings(intervalMs: number): void {
+        if (this.pingInterval) {
+            clearInterval(this.pingInterval)
+        }
+        this.currentPingInterval = intervalMs
         this.pingInterval = setInterval(() => {
             this.sendPing()
-        }, this.config.pingInterval)
+        }, intervalMs)
+    }
+
+    private updatePingInterval(intervalMs: number): void {
+        if (this.pingInterval && intervalMs > 0 && intervalMs !== this.currentPingInterval) {
+            this.schedulePings(intervalMs)
+        }
     }
 
     private stopPingInterval(): void {
@@ -269,12 +290,15 @@ export class Connection {
         this.send({
             type: 'ping',
             client_time: this.lastPingTime,
+            pong_received: this.lastPongReceived ?? undefined,
         })
     }
 
     private handlePong(clientTime: number, serverTime: number): void {
         const now = Date.now() * 1000
         const rtt = now - clientTime
+        const firstPong = this.lastPongReceived === null
+        this.lastPongReceived = now
 
         this._latency = rtt / 2 / 1000
 
@@ -285,6 +309,11 @@ export class Connection {
         this._clockOffset = ((t2 - t1 + (t3 - t4)) / 2 / 1000) | 0
 
         this.callbacks.onLatency(this._latency)
+
+        // Report the first exchange right away so the server can honor scheduled times
+        if (firstPong) {
+            this.sendPing()
+        }
     }
 
     private calculateClockOffset(serverTime: number): number {
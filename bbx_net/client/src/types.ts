@@ -37,7 +37,7 @@ export interface IParamMessage {
     param: string
     /** The new value for the parameter. */
     value: number
-    /** Optional server timestamp (µs) for scheduled execution. */
+    /** Optional local timestamp (µs) for scheduled execution. The server translates it to its own clock. */
     at?: number
 }
 
@@ -46,7 +46,7 @@ export interface ITriggerMessage {
     type: 'trigger'
     /** The trigger name. */
     name: string
-    /** Optional server timestamp (µs) for scheduled execution. */
+    /** Optional local timestamp (µs) for scheduled execution. The server translates it to its own clock. */
     at?: number
 }
 
@@ -60,6 +60,8 @@ export interface IPingMessage {
     type: 'ping'
     /** Client timestamp in microseconds when the ping was sent. */
     client_time: number
+    /** Client timestamp in microseconds when the previous pong was received. */
+    pong_received?: number
 }
 
 /** Request to leave the current room. */
@@ -116,6 +118,8 @@ export interface IPongMessage {
     client_time: number
     /** Server timestamp when the pong was sent. */
     server_time: number
+    /** Suggested delay before the next ping in milliseconds, adapted to clock sync accuracy. */
+    ping_interval_ms?: number
 }
 
 /** Error notification from the server. */
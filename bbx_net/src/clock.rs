@@ -1,7 +1,8 @@
 //! Clock synchronization for distributed audio timing.
 //!
-//! Provides `SyncedTimestamp` for representing synchronized time across nodes
-//! and `ClockSync` for managing clock synchronization state.
+//! Provides `SyncedTimestamp` for representing synchronized time across nodes,
+//! `ClockSync` for managing clock synchronization state, and `ClockEstimator`
+//! for tracking a remote clock's offset and drift from ping/pong exchanges.
 
 use std::{
     sync::atomic::{AtomicU64, Ordering},
@@ -142,7 +143,8 @@ impl ClockSync {
     ///
     /// # Returns
     ///
-    /// Clock offset in microseconds (positive = client ahead, negative = client behind)
+    /// Clock offset in microseconds, server time minus client time (positive = client behind,
+    /// negative = client ahead)
     pub fn calculate_offset(
         client_send_time: u64,
         server_receive_time: u64,
@@ -164,10 +166,245 @@ impl Default for ClockSync {
     }
 }
 
+/// Number of ping/pong samples kept by [`ClockEstimator`].
+pub const CLOCK_ESTIMATOR_WINDOW: usize = 32;
+
+/// Largest drift rate the estimator will accept, as a fraction (500 ppm).
+///
+/// Real crystal oscillators stay well under 100 ppm; anything larger is a
+/// fitting artifact of jittery samples.
+const MAX_DRIFT: f64 = 500e-6;
+
+/// Client-time span (µs) the fitted samples must cover before drift is estimated.
+const MIN_DRIFT_SPAN_US: f64 = 2_000_000.0;
+
+/// Minimum number of low-RTT samples used in a fit.
+const MIN_FIT_SAMPLES: usize = 4;
+
+/// Extra round-trip time (µs) beyond twice the best sample still accepted for fitting.
+const RTT_SLACK_US: u64 = 500;
+
+/// A single NTP-style clock measurement.
+#[derive(Debug, Clone, Copy, Default)]
+struct ClockSample {
+    /// Client time at the midpoint of the exchange.
+    client_time: u64,
+    /// Server time minus client time, in microseconds.
+    offset: i64,
+    /// Round-trip time excluding server processing, in microseconds.
+    rtt: u64,
+}
+
+/// Filtered estimate of a remote clock's offset and drift.
+///
+/// Keeps a window of ping/pong samples and fits `offset + drift * t` by
+/// least squares over the samples with the lowest round-trip time. Samples
+/// delayed by network queueing carry asymmetric delay and are ignored, so a
+/// few Wi-Fi outliers do not move the estimate.
+///
+/// Times passed in are in the remote (client) and local (server) clocks in
+/// microseconds; offsets are server time minus client time.
+#[derive(Debug, Clone)]
+pub struct ClockEstimator {
+    samples: [ClockSample; CLOCK_ESTIMATOR_WINDOW],
+    len: usize,
+    next: usize,
+    reference: u64,
+    offset: f64,
+    drift: f64,
+    error_us: f64,
+}
+
+impl ClockEstimator {
+    /// Create an estimator with no samples.
+    pub const fn new() -> Self {
+        Self {
+            samples: [ClockSample {
+                client_time: 0,
+                offset: 0,
+                rtt: 0,
+            }; CLOCK_ESTIMATOR_WINDOW],
+            len: 0,
+            next: 0,
+            reference: 0,
+            offset: 0.0,
+            drift: 0.0,
+            error_us: f64::INFINITY,
+        }
+    }
+
+    /// Add a ping/pong exchange and refit the estimate.
+    ///
+    /// Returns `false` (and ignores the sample) if the timestamps are
+    /// inconsistent, e.g. the round trip is negative.
+    ///
+    /// # Arguments
+    ///
+    /// * `client_send` - Client timestamp when ping was sent
+    /// * `server_receive` - Server timestamp when ping was received
+    /// * `server_send` - Server timestamp when pong was sent
+    /// * `client_receive` - Client timestamp when pong was received
+    pub fn add_sample(&mut self, client_send: u64, server_receive: u64, server_send: u64, client_receive: u64) -> bool {
+        if client_receive < client_send || server_send < server_receive {
+            return false;
+        }
+        let round_trip = client_receive - client_send;
+        let processing = server_send - server_receive;
+        if processing > round_trip {
+            return false;
+        }
+
+        self.samples[self.next] = ClockSample {
+            client_time: client_send + round_trip / 2,
+            offset: ClockSync::calculate_offset(client_send, server_receive, server_send, client_receive),
+            rtt: round_trip - processing,
+        };
+        self.next = (self.next + 1) % CLOCK_ESTIMATOR_WINDOW;
+        self.len = (self.len + 1).min(CLOCK_ESTIMATOR_WINDOW);
+
+        self.refit();
+        true
+    }
+
+    /// Number of samples currently in the window.
+    #[inline]
+    pub fn sample_count(&self) -> usize {
+        self.len
+    }
+
+    /// Whether at least one sample has been added.
+    #[inline]
+    pub fn is_synced(&self) -> bool {
+        self.len > 0
+    }
+
+    /// Estimated offset (server minus client, µs) at the given client time.
+    pub fn offset_at(&self, client_time: u64) -> f64 {
+        self.offset + self.drift * (client_time as f64 - self.reference as f64)
+    }
+
+    /// Estimated drift rate of the offset, in parts per million.
+    ///
+    /// Positive when the client clock runs slow relative to the server.
+    pub fn drift_ppm(&self) -> f64 {
+        self.drift * 1e6
+    }
+
+    /// Estimated bound on the offset error in microseconds.
+    ///
+    /// Half the best round-trip time (the worst case for asymmetric delay)
+    /// plus the RMS residual of the fit. Infinite until the first sample.
+    pub fn error_bound_us(&self) -> f64 {
+        self.error_us
+    }
+
+    /// Convert a client timestamp to server time.
+    pub fn client_to_server_time(&self, client_time: u64) -> u64 {
+        (client_time as f64 + self.offset_at(client_time)).round().max(0.0) as u64
+    }
+
+    /// Convert a server timestamp to client time.
+    pub fn server_to_client_time(&self, server_time: u64) -> u64 {
+        // Solve server = client + offset + drift * (client - reference) for client.
+        let client = (server_time as f64 - self.offset + self.drift * self.reference as f64) / (1.0 + self.drift);
+        client.round().max(0.0) as u64
+    }
+
+    /// Suggest how long to wait before the next ping, in milliseconds.
+    ///
+    /// Pings at `min_ms` while the window fills or while the error bound is
+    /// above `target_error_us`, backing off toward `max_ms` as the estimate
+    /// settles below the target.
+    pub fn suggested_ping_interval_ms(&self, target_error_us: f64, min_ms: u64, max_ms: u64) -> u64 {
+        let max_ms = max_ms.max(min_ms);
+        if self.len < MIN_FIT_SAMPLES || !self.error_us.is_finite() || self.error_us <= 0.0 {
+            return if self.error_us <= 0.0 { max_ms } else { min_ms };
+        }
+
+        let interval = max_ms as f64 * (target_error_us / self.error_us);
+        (interval as u64).clamp(min_ms, max_ms)
+    }
+
+    /// Discard all samples.
+    pub fn reset(&mut self) {
+        *self = Self::new();
+    }
+
+    fn refit(&mut self) {
+        let samples = &self.samples[..self.len];
+
+        // Rank samples by round-trip time; only the fastest exchanges are fitted.
+        let mut order = [0usize; CLOCK_ESTIMATOR_WINDOW];
+        for (i, slot) in order.iter_mut().enumerate().take(self.len) {
+            *slot = i;
+        }
+        let order = &mut order[..self.len];
+        order.sort_unstable_by_key(|&i| samples[i].rtt);
+
+        // Keep the fastest quarter of the window (at least MIN_FIT_SAMPLES), but
+        // never samples that took much longer than the best round trip.
+        let rtt_limit = samples[order[0]].rtt * 2 + RTT_SLACK_US;
+        let fit_count = order
+            .iter()
+            .take((self.len / 4).max(MIN_FIT_SAMPLES))
+            .take_while(|&&i| samples[i].rtt <= rtt_limit)
+            .count();
+        let selected = &order[..fit_count];
+
+        let reference = samples.iter().map(|s| s.client_time).max().unwrap_or(0);
+        let x = |i: usize| samples[i].client_time as f64 - reference as f64;
+        let y = |i: usize| samples[i].offset as f64;
+
+        let n = fit_count as f64;
+        let mean_x = selected.iter().map(|&i| x(i)).sum::<f64>() / n;
+        let mean_y = selected.iter().map(|&i| y(i)).sum::<f64>() / n;
+        let (min_x, max_x) = selected
+            .iter()
+            .fold((f64::MAX, f64::MIN), |(lo, hi), &i| (lo.min(x(i)), hi.max(x(i))));
+
+        let (offset, drift) = if fit_count >= 3 && max_x - min_x >= MIN_DRIFT_SPAN_US {
+            let mut sxx = 0.0;
+            let mut sxy = 0.0;
+            for &i in selected {
+                let dx = x(i) - mean_x;
+                sxx += dx * dx;
+                sxy += dx * (y(i) - mean_y);
+            }
+            let drift = (sxy / sxx).clamp(-MAX_DRIFT, MAX_DRIFT);
+            (mean_y - drift * mean_x, drift)
+        } else {
+            (y(order[0]), 0.0)
+        };
+
+        let residual = (selected
+            .iter()
+            .map(|&i| {
+                let r = y(i) - (offset + drift * x(i));
+                r * r
+            })
+            .sum::<f64>()
+            / n)
+            .sqrt();
+
+        self.reference = reference;
+        self.offset = offset;
+        self.drift = drift;
+        self.error_us = samples[order[0]].rtt as f64 / 2.0 + residual;
+    }
+}
+
+impl Default for ClockEstimator {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use std::{thread, time::Duration};
 
+    use bbx_core::random::XorShiftRng;
+
     use super::*;
 
     #[test]
@@ -263,4 +500,134 @@ mod tests {
         let offset = ClockSync::calculate_offset(100, 250, 250, 300);
         assert!(offset > 0);
     }
+
+    /// Simulated client whose clock runs at `1 + drift` of server rate,
+    /// starting `start` µs ahead of the server.
+    struct SimulatedClient {
+        start: f64,
+        drift: f64,
+        rng: XorShiftRng,
+    }
+
+    impl SimulatedClient {
+        fn client_time(&self, server_time: f64) -> f64 {
+            self.start + server_time * (1.0 + self.drift)
+        }
+
+        fn true_server_time(&self, client_time: f64) -> f64 {
+            (client_time - self.start) / (1.0 + self.drift)
+        }
+
+        /// One-way delay: 2ms base, up to 1ms jitter, occasional 20-40ms queueing spike.
+        fn delay(&mut self) -> f64 {
+            let jitter = (self.rng.next_noise_sample() + 1.0) * 500.0;
+            let spike = if self.rng.next_noise_sample() > 0.5 {
+                30_000.0 + self.rng.next_noise_sample() * 10_000.0
+            } else {
+                0.0
+            };
+            2_000.0 + jitter + spike
+        }
+
+        fn exchange(&mut self, estimator: &mut ClockEstimator, server_send_ping: f64) {
+            let t1 = self.client_time(server_send_ping);
+            let t2 = server_send_ping + self.delay();
+            let t3 = t2 + 50.0;
+            let back = self.delay();
+            let t4 = self.client_time(t3 + back);
+            assert!(estimator.add_sample(t1 as u64, t2 as u64, t3 as u64, t4 as u64));
+        }
+    }
+
+    #[test]
+    fn test_estimator_empty() {
+        let estimator = ClockEstimator::new();
+        assert!(!estimator.is_synced());
+        assert!(estimator.error_bound_us().is_infinite());
+        assert_eq!(estimator.suggested_ping_interval_ms(250.0, 500, 5000), 500);
+    }
+
+    #[test]
+    fn test_estimator_single_sample_matches_ntp() {
+        let mut estimator = ClockEstimator::new();
+        assert!(estimator.add_sample(10_000, 15_200, 15_200, 10_400));
+
+        assert!((estimator.offset_at(10_200) - 5000.0).abs() < 1e-9);
+        assert_eq!(estimator.client_to_server_time(12_000), 17_000);
+        assert_eq!(estimator.server_to_client_time(17_000), 12_000);
+        assert!((estimator.error_bound_us() - 200.0).abs() < 1e-9);
+    }
+
+    #[test]
+    fn test_estimator_rejects_inconsistent_sample() {
+        let mut estimator = ClockEstimator::new();
+        assert!(!estimator.add_sample(10_000, 15_200, 15_200, 9_000));
+        assert!(!estimator.add_sample(10_000, 15_200, 16_000, 10_400));
+        assert!(!estimator.is_synced());
+    }
+
+    #[test]
+    fn test_estimator_ignores_rtt_outliers() {
+        let mut client = SimulatedClient {
+            start: 1_000_000_000.0,
+            drift: 0.0,
+            rng: XorShiftRng::new(7),
+        };
+        let mut estimator = ClockEstimator::new();
+
+        for i in 0..CLOCK_ESTIMATOR_WINDOW {
+            client.exchange(&mut estimator, i as f64 * 500_000.0);
+        }
+
+        let probe = client.client_time(20_000_000.0);
+        let error = estimator.client_to_server_time(probe as u64) as f64 - client.true_server_time(probe);
+        assert!(error.abs() < 500.0, "error {error}us");
+        // Bounded by half the fastest round trip (~4ms), not the 60ms+ spikes.
+        assert!(estimator.error_bound_us() < 3_000.0);
+    }
+
+    #[test]
+    fn test_estimator_tracks_drift() {
+        let mut client = SimulatedClient {
+            start: 1_000_000_000.0,
+            drift: 80e-6,
+            rng: XorShiftRng::new(12345),
+        };
+        let mut estimator = ClockEstimator::new();
+
+        // A minute of pings every two seconds.
+        for i in 0..30 {
+            client.exchange(&mut estimator, i as f64 * 2_000_000.0);
+        }
+
+        assert!(
+            (estimator.drift_ppm() + 80.0).abs() < 10.0,
+            "drift {}ppm",
+            estimator.drift_ppm()
+        );
+
+        // Extrapolate five seconds past the last sample; a fixed offset would be off by ~5ms.
+        let probe = client.client_time(65_000_000.0);
+        let error = estimator.client_to_server_time(probe as u64) as f64 - client.true_server_time(probe);
+        assert!(error.abs() < 500.0, "error {error}us");
+
+        let server = estimator.client_to_server_time(probe as u64);
+        let round_trip = estimator.server_to_client_time(server) as f64;
+        assert!((round_trip - probe).abs() <= 1.0);
+    }
+
+    #[test]
+    fn test_ping_interval_backs_off_when_settled() {
+        let mut estimator = ClockEstimator::new();
+
+        // Perfectly symmetric 100us round trips: error bound is 50us.
+        for i in 0..8u64 {
+            let t1 = 1_000_000 + i * 1_000_000;
+            estimator.add_sample(t1, t1 + 5_050, t1 + 5_050, t1 + 100);
+        }
+
+        assert!(estimator.error_bound_us() < 100.0);
+        assert_eq!(estimator.suggested_ping_interval_ms(250.0, 500, 5000), 5000);
+        assert_eq!(estimator.suggested_ping_interval_ms(10.0, 500, 5000), 1000);
+    }
 }
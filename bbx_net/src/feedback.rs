@@ -0,0 +1,328 @@
+//! Rate-limited parameter feedback from the audio engine to controllers.
+//!
+//! The audio thread writes current parameter values into a shared table of
+//! atomics through a [`FeedbackWriter`]. A [`FeedbackPublisher`] on a network
+//! thread samples the table at a fixed rate, diffs it against what was last
+//! sent, and hands back only the changed values. Protocol front ends (the
+//! WebSocket server and the OSC feedback sender) turn each batch into a single
+//! outbound message, so traffic is bounded by the publish rate rather than by
+//! how often parameters move.
+
+use std::{
+    sync::{
+        Arc,
+        atomic::{AtomicU32, Ordering},
+    },
+    time::Duration,
+};
+
+use crate::message::hash_param_name;
+
+/// Default publish rate in Hz.
+pub const DEFAULT_FEEDBACK_RATE_HZ: f64 = 30.0;
+
+/// Parameter table shared between writer and publisher.
+struct FeedbackTable {
+    names: Box<[String]>,
+    hashes: Box<[u32]>,
+    values: Box<[AtomicU32]>,
+}
+
+/// Audio-thread handle for publishing parameter values.
+///
+/// All methods are lock-free, wait-free, and do not allocate.
+#[derive(Clone)]
+pub struct FeedbackWriter {
+    table: Arc<FeedbackTable>,
+}
+
+impl FeedbackWriter {
+    /// Store the current value of the parameter at `index`.
+    ///
+    /// Out-of-range indices are ignored.
+    #[inline]
+    pub fn set(&self, index: usize, value: f32) {
+        if let Some(slot) = self.table.values.get(index) {
+            slot.store(value.to_bits(), Ordering::Relaxed);
+        }
+    }
+
+    /// Store a value by parameter name hash (see [`hash_param_name`]).
+    ///
+    /// Linear in the number of parameters; prefer [`set`](Self::set) with an
+    /// index from [`index_of`](Self::index_of) in hot paths.
+    #[inline]
+    pub fn set_by_hash(&self, param_hash: u32, value: f32) {
+        if let Some(index) = self.table.hashes.iter().position(|&h| h == param_hash) {
+            self.set(index, value);
+        }
+    }
+
+    /// Look up the index of a parameter by name.
+    pub fn index_of(&self, name: &str) -> Option<usize> {
+        let hash = hash_param_name(name);
+        self.table.hashes.iter().position(|&h| h == hash)
+    }
+
+    /// Number of parameters in the table.
+    pub fn len(&self) -> usize {
+        self.table.values.len()
+    }
+
+    /// Returns `true` if the table has no parameters.
+    pub fn is_empty(&self) -> bool {
+        self.table.values.is_empty()
+    }
+}
+
+/// A changed parameter value ready to be sent.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct FeedbackChange {
+    /// Index of the parameter in the feedback table.
+    pub index: usize,
+    /// Current value.
+    pub value: f32,
+}
+
+/// Samples the feedback table and reports values that changed since the last send.
+pub struct FeedbackPublisher {
+    table: Arc<FeedbackTable>,
+    last_sent: Box<[f32]>,
+    interval: Duration,
+    threshold: f32,
+    max_changes_per_tick: usize,
+    cursor: usize,
+}
+
+impl FeedbackPublisher {
+    /// Set the publish rate in Hz.
+    pub fn with_rate(mut self, rate_hz: f64) -> Self {
+        self.interval = Duration::from_secs_f64(1.0 / rate_hz.max(0.001));
+        self
+    }
+
+    /// Set the minimum change that counts as a new value.
+    ///
+    /// Defaults to `0.0` (any change is sent).
+    pub fn with_threshold(mut self, threshold: f32) -> Self {
+        self.threshold = threshold.max(0.0);
+        self
+    }
+
+    /// Cap the number of values sent per tick.
+    ///
+    /// Parameters beyond the cap are sent on later ticks, in round-robin
+    /// order, so no parameter is starved. Defaults to unlimited.
+    pub fn with_max_changes_per_tick(mut self, max_changes: usize) -> Self {
+        self.max_changes_per_tick = max_changes.max(1);
+        self
+    }
+
+    /// Time between publish ticks.
+    pub fn interval(&self) -> Duration {
+        self.interval
+    }
+
+    /// Name of the parameter at `index`.
+    pub fn name(&self, index: usize) -> &str {
+        &self.table.names[index]
+    }
+
+    /// Number of parameters in the table.
+    pub fn len(&self) -> usize {
+        self.table.values.len()
+    }
+
+    /// Returns `true` if the table has no parameters.
+    pub fn is_empty(&self) -> bool {
+        self.table.values.is_empty()
+    }
+
+    /// Forget what was last sent, so the next poll reports every parameter.
+    ///
+    /// Call when a new controller connects and needs the full state.
+    pub fn resync(&mut self) {
+        self.last_sent.fill(f32::NAN);
+    }
+
+    /// Collect values that changed since they were last sent.
+    ///
+    /// Clears `out`, fills it with at most `max_changes_per_tick` changes, and
+    /// marks them as sent. Returns the number of changes.
+    pub fn poll(&mut self, out: &mut Vec<FeedbackChange>) -> usize {
+        out.clear();
+
+        let len = self.table.values.len();
+        for step in 0..len {
+            if out.len() >= self.max_changes_per_tick {
+                self.cursor = (self.cursor + step) % len;
+                return out.len();
+            }
+
+            let index = (self.cursor + step) % len;
+            let value = f32::from_bits(self.table.values[index].load(Ordering::Relaxed));
+            let last = self.last_sent[index];
+
+            let changed = if last.is_nan() || value.is_nan() {
+                last.to_bits() != value.to_bits()
+            } else {
+                (value - last).abs() > self.threshold
+            };
+
+            if changed {
+                self.last_sent[index] = value;
+                out.push(FeedbackChange { index, value });
+            }
+        }
+
+        out.len()
+    }
+}
+
+/// Create a feedback writer/publisher pair for the given parameter names.
+///
+/// Every parameter starts at `0.0`, and the first poll reports all of them.
+///
+/// # Examples
+///
+/// ```
+/// use bbx_net::feedback_channel;
+///
+/// let (writer, mut publisher) = feedback_channel(&["gain", "cutoff"]);
+///
+/// // Audio thread (realtime-safe)
+/// writer.set(0, 0.5);
+///
+/// // Network thread, once per tick
+/// let mut changes = Vec::new();
+/// publisher.poll(&mut changes);
+/// assert_eq!(changes.len(), 2);
+/// ```
+pub fn feedback_channel<S: AsRef<str>>(names: &[S]) -> (FeedbackWriter, FeedbackPublisher) {
+    let table = Arc::new(FeedbackTable {
+        names: names.iter().map(|n| n.as_ref().to_string()).collect(),
+        hashes: names.iter().map(|n| hash_param_name(n.as_ref())).collect(),
+        values: names.iter().map(|_| AtomicU32::new(0.0f32.to_bits())).collect(),
+    });
+
+    let publisher = FeedbackPublisher {
+        table: Arc::clone(&table),
+        last_sent: vec![f32::NAN; names.len()].into_boxed_slice(),
+        interval: Duration::ZERO,
+        threshold: 0.0,
+        max_changes_per_tick: usize::MAX,
+        cursor: 0,
+    }
+    .with_rate(DEFAULT_FEEDBACK_RATE_HZ);
+
+    (FeedbackWriter { table }, publisher)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_first_poll_reports_all() {
+        let (_writer, mut publisher) = feedback_channel(&["a", "b", "c"]);
+        let mut changes = Vec::new();
+
+        assert_eq!(publisher.poll(&mut changes), 3);
+        assert_eq!(publisher.poll(&mut changes), 0);
+    }
+
+    #[test]
+    fn test_only_changed_values_reported() {
+        let (writer, mut publisher) = feedback_channel(&["gain", "cutoff", "pan"]);
+        let mut changes = Vec::new();
+        publisher.poll(&mut changes);
+
+        writer.set(1, 0.25);
+        writer.set(1, 0.75);
+
+        assert_eq!(publisher.poll(&mut changes), 1);
+        assert_eq!(changes[0], FeedbackChange { index: 1, value: 0.75 });
+        assert_eq!(publisher.name(1), "cutoff");
+    }
+
+    #[test]
+    fn test_threshold_suppresses_small_changes() {
+        let (writer, mut publisher) = feedback_channel(&["gain"]);
+        let mut publisher = {
+            let mut changes = Vec::new();
+            publisher.poll(&mut changes);
+            publisher.with_threshold(0.01)
+        };
+        let mut changes = Vec::new();
+
+        writer.set(0, 0.005);
+        assert_eq!(publisher.poll(&mut changes), 0);
+
+        writer.set(0, 0.02);
+        assert_eq!(publisher.poll(&mut changes), 1);
+    }
+
+    #[test]
+    fn test_max_changes_round_robin() {
+        let names: Vec<String> = (0..10).map(|i| format!("p{i}")).collect();
+        let (_writer, publisher) = feedback_channel(&names);
+        let mut publisher = publisher.with_max_changes_per_tick(4);
+        let mut changes = Vec::new();
+
+        let mut seen = Vec::new();
+        for _ in 0..3 {
+            assert!(publisher.poll(&mut changes) <= 4);
+            seen.extend(changes.iter().map(|c| c.index));
+        }
+
+        seen.sort_unstable();
+        assert_eq!(seen, (0..10).collect::<Vec<_>>());
+    }
+
+    #[test]
+    fn test_resync_reports_all_again() {
+        let (_writer, mut publisher) = feedback_channel(&["a", "b"]);
+        let mut changes = Vec::new();
+        publisher.poll(&mut changes);
+
+        publisher.resync();
+        assert_eq!(publisher.poll(&mut changes), 2);
+    }
+
+    #[test]
+    fn test_set_by_hash_and_index_of() {
+        let (writer, mut publisher) = feedback_channel(&["gain", "freq"]);
+        let mut changes = Vec::new();
+        publisher.poll(&mut changes);
+
+        assert_eq!(writer.index_of("freq"), Some(1));
+        assert_eq!(writer.index_of("missing"), None);
+
+        writer.set_by_hash(hash_param_name("freq"), 440.0);
+        publisher.poll(&mut changes);
+        assert_eq!(changes, vec![FeedbackChange { index: 1, value: 440.0 }]);
+    }
+
+    #[test]
+    fn test_rate_sets_interval() {
+        let (_writer, publisher) = feedback_channel(&["a"]);
+        assert_eq!(publisher.with_rate(50.0).interval(), Duration::from_millis(20));
+    }
+
+    #[test]
+    fn test_concurrent_writes_are_observed() {
+        let (writer, mut publisher) = feedback_channel(&["x"]);
+        let mut changes = Vec::new();
+        publisher.poll(&mut changes);
+
+        let handle = std::thread::spawn(move || {
+            for i in 0..1000 {
+                writer.set(0, i as f32);
+            }
+        });
+        handle.join().unwrap();
+
+        publisher.poll(&mut changes);
+        assert_eq!(changes[0].value, 999.0);
+    }
+}
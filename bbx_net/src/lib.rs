@@ -7,11 +7,13 @@
 //!
 //! - **OSC (UDP)**: For TouchOSC, Max/MSP, and other creative tools
 //! - **WebSocket**: For phone PWA interfaces
+//! - **Audio streaming (UDP)**: For monitoring a mix remotely on the LAN
 //!
 //! ## Features
 //!
 //! - `osc` - Enable OSC protocol support (requires `rosc` crate)
 //! - `websocket` - Enable WebSocket support (requires tokio runtime)
+//! - `stream` - Enable UDP audio streaming (requires `bbx_dsp`)
 //! - `full` - Enable all protocols
 //!
 //! ## Example
@@ -42,16 +44,23 @@ pub mod address;
 pub mod buffer;
 pub mod clock;
 pub mod error;
+pub mod feedback;
 pub mod message;
+pub mod scheduler;
 
 #[cfg(feature = "osc")]
 pub mod osc;
 
+#[cfg(feature = "stream")]
+pub mod stream;
+
 #[cfg(feature = "websocket")]
 pub mod websocket;
 
 pub use address::{AddressPath, NodeId};
 pub use buffer::{MAX_NET_EVENTS_PER_BUFFER, NetBufferConsumer, NetBufferProducer, net_buffer};
-pub use clock::{ClockSync, SyncedTimestamp};
+pub use clock::{CLOCK_ESTIMATOR_WINDOW, ClockEstimator, ClockSync, SyncedTimestamp};
 pub use error::{NetError, Result};
+pub use feedback::{DEFAULT_FEEDBACK_RATE_HZ, FeedbackChange, FeedbackPublisher, FeedbackWriter, feedback_channel};
 pub use message::{NetEvent, NetMessage, NetMessageType, NetPayload, hash_param_name};
+pub use scheduler::{MAX_PENDING_NET_EVENTS, NetEventScheduler};
@@ -0,0 +1,265 @@
+//! OSC feedback sender for mirroring engine state to controllers.
+
+use std::{
+    net::{SocketAddr, UdpSocket},
+    thread::{self, JoinHandle},
+};
+
+use rosc::{OscBundle, OscMessage, OscPacket, OscTime, OscType};
+
+use crate::{
+    address::AddressPath,
+    error::{NetError, Result},
+    feedback::{FeedbackChange, FeedbackPublisher},
+};
+
+/// OSC time tag meaning "apply immediately".
+const IMMEDIATE: OscTime = OscTime {
+    seconds: 0,
+    fractional: 1,
+};
+
+/// Configuration for the OSC feedback sender.
+pub struct OscFeedbackConfig {
+    /// Local address to send from (e.g., "0.0.0.0:0" for any port).
+    pub bind_addr: SocketAddr,
+    /// Controllers to send feedback to (e.g., TouchOSC on port 9001).
+    pub targets: Vec<SocketAddr>,
+    /// Maximum messages per bundle.
+    ///
+    /// Keeps each datagram under a typical Ethernet MTU; larger batches are
+    /// split across several bundles.
+    pub max_messages_per_bundle: usize,
+}
+
+impl Default for OscFeedbackConfig {
+    fn default() -> Self {
+        Self {
+            bind_addr: "0.0.0.0:0".parse().unwrap(),
+            targets: Vec::new(),
+            max_messages_per_bundle: 32,
+        }
+    }
+}
+
+/// Sends batched parameter feedback to OSC controllers.
+///
+/// Each tick, changed values from a [`FeedbackPublisher`] are sent as one OSC
+/// bundle of `/blocks/param/<name>` messages, the same addresses
+/// [`OscServer`](crate::osc::OscServer) accepts, so a TouchOSC layout can use
+/// one address per control in both directions.
+///
+/// A failed send to one target is counted in
+/// [`send_errors`](Self::send_errors) and skipped, so an unreachable
+/// controller doesn't stop feedback to the others.
+pub struct OscFeedbackSender {
+    config: OscFeedbackConfig,
+    socket: UdpSocket,
+    publisher: FeedbackPublisher,
+    addresses: Box<[String]>,
+    changes: Vec<FeedbackChange>,
+    send_errors: Vec<u64>,
+}
+
+impl OscFeedbackSender {
+    /// Create a feedback sender bound to `config.bind_addr`.
+    pub fn new(config: OscFeedbackConfig, publisher: FeedbackPublisher) -> Result<Self> {
+        let socket = UdpSocket::bind(config.bind_addr)?;
+        let addresses = (0..publisher.len())
+            .map(|i| {
+                AddressPath {
+                    block_id: None,
+                    param_name: publisher.name(i).to_string(),
+                }
+                .to_address_string()
+            })
+            .collect();
+
+        Ok(Self {
+            changes: Vec::with_capacity(publisher.len()),
+            send_errors: vec![0; config.targets.len()],
+            config,
+            socket,
+            publisher,
+            addresses,
+        })
+    }
+
+    /// Add a controller to send feedback to.
+    pub fn add_target(&mut self, target: SocketAddr) {
+        if !self.config.targets.contains(&target) {
+            self.config.targets.push(target);
+            self.send_errors.push(0);
+            self.publisher.resync();
+        }
+    }
+
+    /// Number of bundles that failed to send to each target, in the order
+    /// the targets were added.
+    pub fn send_errors(&self) -> &[u64] {
+        &self.send_errors
+    }
+
+    /// Send all values that changed since the last call.
+    ///
+    /// Returns the number of parameter values sent.
+    pub fn send_changes(&mut self) -> Result<usize> {
+        let count = self.publisher.poll(&mut self.changes);
+        if count == 0 || self.config.targets.is_empty() {
+            return Ok(count);
+        }
+
+        for chunk in self.changes.chunks(self.config.max_messages_per_bundle.max(1)) {
+            let content = chunk
+                .iter()
+                .map(|change| {
+                    OscPacket::Message(OscMessage {
+                        addr: self.addresses[change.index].clone(),
+                        args: vec![OscType::Float(change.value)],
+                    })
+                })
+                .collect();
+
+            let packet = OscPacket::Bundle(OscBundle {
+                timetag: IMMEDIATE,
+                content,
+            });
+            let bytes = rosc::encoder::encode(&packet).map_err(|_| NetError::ParseError)?;
+
+            for (target, errors) in self.config.targets.iter().zip(self.send_errors.iter_mut()) {
+                if self.socket.send_to(&bytes, target).is_err() {
+                    *errors += 1;
+                }
+            }
+        }
+
+        Ok(count)
+    }
+
+    /// Run the feedback loop in the current thread (blocking).
+    ///
+    /// Sends changes at the publisher's rate. Failed sends are counted per
+    /// target and don't stop the loop; it only returns if a bundle can't be
+    /// encoded.
+    pub fn run(mut self) -> Result<()> {
+        let interval = self.publisher.interval();
+        loop {
+            self.send_changes()?;
+            thread::sleep(interval);
+        }
+    }
+
+    /// Run the feedback loop in a background thread.
+    pub fn spawn(self) -> JoinHandle<Result<()>> {
+        thread::spawn(move || self.run())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::time::Duration;
+
+    use super::*;
+    use crate::{address::NodeId, feedback::feedback_channel, osc::parse_osc_message};
+
+    fn receiver() -> (UdpSocket, SocketAddr) {
+        let socket = UdpSocket::bind("127.0.0.1:0").unwrap();
+        socket.set_read_timeout(Some(Duration::from_secs(2))).unwrap();
+        let addr = socket.local_addr().unwrap();
+        (socket, addr)
+    }
+
+    #[test]
+    fn test_sends_changes_as_bundle() {
+        let (rx, target) = receiver();
+        let (writer, publisher) = feedback_channel(&["gain", "cutoff"]);
+        let config = OscFeedbackConfig {
+            bind_addr: "127.0.0.1:0".parse().unwrap(),
+            targets: vec![target],
+            ..Default::default()
+        };
+        let mut sender = OscFeedbackSender::new(config, publisher).unwrap();
+        sender.send_changes().unwrap();
+
+        let mut buf = [0u8; 1024];
+        rx.recv(&mut buf).unwrap();
+
+        writer.set(1, 0.25);
+        writer.set(1, 0.5);
+        assert_eq!(sender.send_changes().unwrap(), 1);
+
+        let len = rx.recv(&mut buf).unwrap();
+        let messages = parse_osc_message(&buf[..len], NodeId::default()).unwrap();
+        assert_eq!(messages.len(), 1);
+        assert_eq!(messages[0].param_hash, crate::message::hash_param_name("cutoff"));
+        assert_eq!(messages[0].payload.value(), Some(0.5));
+    }
+
+    #[test]
+    fn test_large_batches_are_split() {
+        let (rx, target) = receiver();
+        let names: Vec<String> = (0..10).map(|i| format!("p{i}")).collect();
+        let (_writer, publisher) = feedback_channel(&names);
+        let config = OscFeedbackConfig {
+            bind_addr: "127.0.0.1:0".parse().unwrap(),
+            targets: vec![target],
+            max_messages_per_bundle: 4,
+        };
+        let mut sender = OscFeedbackSender::new(config, publisher).unwrap();
+
+        assert_eq!(sender.send_changes().unwrap(), 10);
+
+        let mut buf = [0u8; 1024];
+        let mut total = 0;
+        for _ in 0..3 {
+            let len = rx.recv(&mut buf).unwrap();
+            total += parse_osc_message(&buf[..len], NodeId::default()).unwrap().len();
+        }
+        assert_eq!(total, 10);
+    }
+
+    #[test]
+    fn test_no_changes_sends_nothing() {
+        let (rx, target) = receiver();
+        rx.set_read_timeout(Some(Duration::from_millis(50))).unwrap();
+        let (_writer, publisher) = feedback_channel(&["gain"]);
+        let config = OscFeedbackConfig {
+            bind_addr: "127.0.0.1:0".parse().unwrap(),
+            targets: vec![target],
+            ..Default::default()
+        };
+        let mut sender = OscFeedbackSender::new(config, publisher).unwrap();
+        sender.send_changes().unwrap();
+
+        let mut buf = [0u8; 1024];
+        rx.recv(&mut buf).unwrap();
+
+        assert_eq!(sender.send_changes().unwrap(), 0);
+        assert!(rx.recv(&mut buf).is_err());
+    }
+
+    #[test]
+    fn test_failed_target_does_not_stop_others() {
+        let (rx, target) = receiver();
+        let (writer, publisher) = feedback_channel(&["gain"]);
+        let config = OscFeedbackConfig {
+            bind_addr: "127.0.0.1:0".parse().unwrap(),
+            // Port 0 can't be sent to
+            targets: vec!["127.0.0.1:0".parse().unwrap()],
+            ..Default::default()
+        };
+        let mut sender = OscFeedbackSender::new(config, publisher).unwrap();
+        sender.add_target(target);
+
+        assert_eq!(sender.send_changes().unwrap(), 1);
+        writer.set(0, 0.5);
+        assert_eq!(sender.send_changes().unwrap(), 1);
+        assert_eq!(sender.send_errors(), &[2, 0]);
+
+        let mut buf = [0u8; 1024];
+        rx.recv(&mut buf).unwrap();
+        let len = rx.recv(&mut buf).unwrap();
+        let messages = parse_osc_message(&buf[..len], NodeId::default()).unwrap();
+        assert_eq!(messages[0].payload.value(), Some(0.5));
+    }
+}
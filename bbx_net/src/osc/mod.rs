@@ -1,12 +1,15 @@
 //! OSC (Open Sound Control) protocol support.
 //!
-//! This module provides OSC message parsing and a UDP server for receiving
-//! control messages from TouchOSC, Max/MSP, and other OSC-compatible tools.
+//! This module provides OSC message parsing, a UDP server for receiving
+//! control messages from TouchOSC, Max/MSP, and other OSC-compatible tools,
+//! and a feedback sender for mirroring engine state back to them.
 //!
 //! Enable with the `osc` feature flag.
 
+mod feedback;
 mod parser;
 mod server;
 
+pub use feedback::{OscFeedbackConfig, OscFeedbackSender};
 pub use parser::parse_osc_message;
 pub use server::{OscServer, OscServerConfig};
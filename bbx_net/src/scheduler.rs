@@ -0,0 +1,266 @@
+//! Sample-accurate scheduling of timestamped network messages.
+//!
+//! Network messages carry a [`SyncedTimestamp`] for when they should take
+//! effect. [`NetEventScheduler`] holds messages that are due in a future
+//! audio buffer and releases them as [`NetEvent`]s with the sample offset at
+//! which they land in the current buffer.
+
+use bbx_core::StackVec;
+
+use crate::{
+    buffer::{MAX_NET_EVENTS_PER_BUFFER, NetBufferConsumer},
+    clock::SyncedTimestamp,
+    message::{NetEvent, NetMessage},
+};
+
+/// Maximum number of messages held for future buffers.
+pub const MAX_PENDING_NET_EVENTS: usize = 256;
+
+/// Holds timestamped network messages until the audio buffer they fall in.
+///
+/// All storage is fixed-capacity and inline, so scheduling is realtime-safe.
+/// The network buffer is drained every call, so due messages are never held
+/// up behind future ones. When the pending queue is full, the message due
+/// latest is dropped and counted in [`dropped`](Self::dropped).
+pub struct NetEventScheduler {
+    pending: StackVec<NetMessage, MAX_PENDING_NET_EVENTS>,
+    dropped: u64,
+}
+
+impl NetEventScheduler {
+    /// Create an empty scheduler.
+    pub const fn new() -> Self {
+        Self {
+            pending: StackVec::new(),
+            dropped: 0,
+        }
+    }
+
+    /// Number of messages waiting for a future buffer.
+    #[inline]
+    pub fn pending_len(&self) -> usize {
+        self.pending.len()
+    }
+
+    /// Number of messages dropped because the pending queue was full.
+    #[inline]
+    pub fn dropped(&self) -> u64 {
+        self.dropped
+    }
+
+    /// Drop all pending messages.
+    pub fn clear(&mut self) {
+        self.pending.clear();
+    }
+
+    /// Pull new messages from `consumer` and return those due in this buffer.
+    ///
+    /// Events are returned in sample-offset order; events with equal offsets
+    /// keep their arrival order. Messages scheduled in the past (or with no
+    /// timestamp) are due at offset 0. At most `MAX_NET_EVENTS_PER_BUFFER`
+    /// events are returned; any overflow is held like a future message and
+    /// delivered in the next buffer.
+    ///
+    /// # Arguments
+    ///
+    /// * `consumer` - Network buffer to drain
+    /// * `buffer_start` - Synced time of the first sample in this buffer
+    /// * `sample_rate` - Audio sample rate in Hz
+    /// * `buffer_size` - Number of samples in this buffer
+    pub fn schedule(
+        &mut self,
+        consumer: &mut NetBufferConsumer,
+        buffer_start: SyncedTimestamp,
+        sample_rate: f64,
+        buffer_size: usize,
+    ) -> StackVec<NetEvent, MAX_NET_EVENTS_PER_BUFFER> {
+        let mut due: StackVec<NetEvent, MAX_NET_EVENTS_PER_BUFFER> = StackVec::new();
+
+        // Pending messages arrived first, so they go first among equal offsets
+        let pending = self.pending.as_mut_slice();
+        let mut kept = 0;
+
+        for i in 0..pending.len() {
+            let msg = pending[i];
+            let offset = msg.timestamp.to_sample_offset(buffer_start, sample_rate, buffer_size);
+            match offset {
+                Some(offset) if !due.is_full() => due.push_unchecked(NetEvent::new(msg, offset)),
+                _ => {
+                    pending[kept] = msg;
+                    kept += 1;
+                }
+            }
+        }
+
+        while self.pending.len() > kept {
+            self.pending.pop();
+        }
+
+        while let Some(msg) = consumer.try_pop() {
+            match msg.timestamp.to_sample_offset(buffer_start, sample_rate, buffer_size) {
+                Some(offset) if !due.is_full() => due.push_unchecked(NetEvent::new(msg, offset)),
+                _ => self.hold(msg),
+            }
+        }
+
+        sort_by_offset(due.as_mut_slice());
+        due
+    }
+
+    /// Queue a message for a later buffer, dropping whichever of it and the
+    /// pending messages is due latest if the queue is full.
+    fn hold(&mut self, msg: NetMessage) {
+        if !self.pending.is_full() {
+            self.pending.push_unchecked(msg);
+            return;
+        }
+
+        self.dropped += 1;
+        let pending = self.pending.as_mut_slice();
+        let Some(latest) = (0..pending.len()).max_by_key(|&i| pending[i].timestamp) else {
+            return;
+        };
+        if msg.timestamp < pending[latest].timestamp {
+            pending[latest..].rotate_left(1);
+            pending[pending.len() - 1] = msg;
+        }
+    }
+}
+
+impl Default for NetEventScheduler {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Stable insertion sort by sample offset (allocation-free, small N).
+fn sort_by_offset(events: &mut [NetEvent]) {
+    for i in 1..events.len() {
+        let mut j = i;
+        while j > 0 && events[j - 1].sample_offset > events[j].sample_offset {
+            events.swap(j - 1, j);
+            j -= 1;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{address::NodeId, buffer::net_buffer};
+
+    const SAMPLE_RATE: f64 = 48000.0;
+    const BUFFER_SIZE: usize = 480;
+    const BUFFER_MICROS: u64 = 10_000;
+
+    fn param_at(value: f32, micros: u64) -> NetMessage {
+        NetMessage::param_change("gain", value, NodeId::from_parts(1, 2)).with_timestamp(SyncedTimestamp(micros))
+    }
+
+    #[test]
+    fn test_unscheduled_is_immediate() {
+        let (mut producer, mut consumer) = net_buffer(8);
+        let mut scheduler = NetEventScheduler::new();
+
+        producer.try_send(NetMessage::trigger("hit", NodeId::default()));
+
+        let events = scheduler.schedule(&mut consumer, SyncedTimestamp(50_000), SAMPLE_RATE, BUFFER_SIZE);
+        assert_eq!(events.len(), 1);
+        assert_eq!(events[0].sample_offset, 0);
+    }
+
+    #[test]
+    fn test_future_event_held_until_its_buffer() {
+        let (mut producer, mut consumer) = net_buffer(8);
+        let mut scheduler = NetEventScheduler::new();
+
+        // 2.5 buffers ahead: lands in the third buffer at sample 240.
+        producer.try_send(param_at(0.5, 25_000));
+
+        for block in 0..2 {
+            let start = SyncedTimestamp(block * BUFFER_MICROS);
+            let events = scheduler.schedule(&mut consumer, start, SAMPLE_RATE, BUFFER_SIZE);
+            assert!(events.is_empty());
+            assert_eq!(scheduler.pending_len(), 1);
+        }
+
+        let events = scheduler.schedule(&mut consumer, SyncedTimestamp(20_000), SAMPLE_RATE, BUFFER_SIZE);
+        assert_eq!(events.len(), 1);
+        assert_eq!(events[0].sample_offset, 240);
+        assert_eq!(scheduler.pending_len(), 0);
+    }
+
+    #[test]
+    fn test_events_sorted_by_offset() {
+        let (mut producer, mut consumer) = net_buffer(8);
+        let mut scheduler = NetEventScheduler::new();
+
+        producer.try_send(param_at(0.3, 7_500));
+        producer.try_send(param_at(0.1, 2_500));
+        producer.try_send(param_at(0.2, 2_500));
+
+        let events = scheduler.schedule(&mut consumer, SyncedTimestamp(0), SAMPLE_RATE, BUFFER_SIZE);
+        let offsets: Vec<u32> = events.as_slice().iter().map(|e| e.sample_offset).collect();
+        let values: Vec<f32> = events
+            .as_slice()
+            .iter()
+            .map(|e| e.message.payload.value().unwrap())
+            .collect();
+
+        assert_eq!(offsets, vec![120, 120, 360]);
+        assert_eq!(values, vec![0.1, 0.2, 0.3]);
+    }
+
+    #[test]
+    fn test_overflow_carries_to_next_buffer() {
+        let (mut producer, mut consumer) = net_buffer(128);
+        let mut scheduler = NetEventScheduler::new();
+
+        for i in 0..(MAX_NET_EVENTS_PER_BUFFER + 10) {
+            producer.try_send(param_at(i as f32, 0));
+        }
+
+        let events = scheduler.schedule(&mut consumer, SyncedTimestamp(0), SAMPLE_RATE, BUFFER_SIZE);
+        assert_eq!(events.len(), MAX_NET_EVENTS_PER_BUFFER);
+
+        let events = scheduler.schedule(&mut consumer, SyncedTimestamp(BUFFER_MICROS), SAMPLE_RATE, BUFFER_SIZE);
+        assert_eq!(events.len(), 10);
+        assert!(events.as_slice().iter().all(|e| e.sample_offset == 0));
+    }
+
+    #[test]
+    fn test_full_pending_still_delivers_due_messages() {
+        let (mut producer, mut consumer) = net_buffer(MAX_PENDING_NET_EVENTS * 2);
+        let mut scheduler = NetEventScheduler::new();
+
+        for _ in 0..(MAX_PENDING_NET_EVENTS + 5) {
+            producer.try_send(param_at(1.0, 1_000_000));
+        }
+        producer.try_send(NetMessage::trigger("hit", NodeId::default()));
+
+        let events = scheduler.schedule(&mut consumer, SyncedTimestamp(0), SAMPLE_RATE, BUFFER_SIZE);
+        assert_eq!(events.len(), 1);
+        assert_eq!(scheduler.pending_len(), MAX_PENDING_NET_EVENTS);
+        assert_eq!(scheduler.dropped(), 5);
+        assert!(consumer.is_empty());
+    }
+
+    #[test]
+    fn test_full_pending_drops_latest_deadline() {
+        let (mut producer, mut consumer) = net_buffer(MAX_PENDING_NET_EVENTS * 2);
+        let mut scheduler = NetEventScheduler::new();
+
+        for _ in 0..MAX_PENDING_NET_EVENTS {
+            producer.try_send(param_at(1.0, 1_000_000));
+        }
+        producer.try_send(param_at(0.5, 25_000));
+        scheduler.schedule(&mut consumer, SyncedTimestamp(0), SAMPLE_RATE, BUFFER_SIZE);
+        assert_eq!(scheduler.dropped(), 1);
+
+        // The nearer message replaced one of the far ones
+        let events = scheduler.schedule(&mut consumer, SyncedTimestamp(20_000), SAMPLE_RATE, BUFFER_SIZE);
+        assert_eq!(events.len(), 1);
+        assert_eq!(events[0].message.payload.value(), Some(0.5));
+        assert_eq!(scheduler.pending_len(), MAX_PENDING_NET_EVENTS - 1);
+    }
+}
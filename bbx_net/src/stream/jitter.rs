@@ -0,0 +1,488 @@
+//! Adaptive jitter buffer with packet loss concealment.
+
+use bbx_core::spsc::Consumer;
+use bbx_dsp::frame::Frame;
+
+use super::packet::StreamPacket;
+
+/// Gain applied per consecutive concealed packet.
+const CONCEAL_DECAY: f32 = 0.5;
+
+/// Concealed packets in a row before playback stops and rebuffers.
+const MAX_CONSECUTIVE_CONCEALED: u32 = 4;
+
+/// Smoothing factor for the interarrival jitter estimate (RFC 3550).
+const JITTER_SMOOTHING: f64 = 1.0 / 16.0;
+
+/// Target delay in multiples of the jitter estimate.
+const JITTER_MULTIPLIER: f64 = 4.0;
+
+/// Packets above the target depth before one is skipped to cut latency.
+const EXCESS_PACKETS: usize = 2;
+
+/// Configuration for the jitter buffer.
+#[derive(Debug, Clone)]
+pub struct JitterConfig {
+    /// Number of packet slots.
+    pub capacity: usize,
+    /// Lower bound for the playout delay in milliseconds.
+    pub min_delay_ms: f64,
+    /// Upper bound for the playout delay in milliseconds.
+    pub max_delay_ms: f64,
+}
+
+impl Default for JitterConfig {
+    fn default() -> Self {
+        Self {
+            capacity: 64,
+            min_delay_ms: 5.0,
+            max_delay_ms: 200.0,
+        }
+    }
+}
+
+/// Jitter buffer statistics.
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct JitterStats {
+    /// Packets received.
+    pub received: u64,
+    /// Packets missing from the sequence (gaps not later filled).
+    pub lost: u64,
+    /// Packets that arrived after their playout time and were dropped.
+    pub late: u64,
+    /// Packets replaced by concealment during playback.
+    pub concealed: u64,
+    /// Packets skipped to reduce latency after a burst.
+    pub skipped: u64,
+    /// Times playback ran dry and had to rebuffer.
+    pub underruns: u64,
+    /// Smoothed interarrival jitter in microseconds.
+    pub jitter_us: f64,
+    /// Current playout delay target in microseconds.
+    pub target_delay_us: f64,
+    /// Audio currently buffered in microseconds.
+    pub buffered_us: f64,
+    /// Arrival time minus send time of the last packet in microseconds.
+    ///
+    /// Only meaningful when sender and receiver share a clock.
+    pub transit_us: i64,
+}
+
+/// Reorders received packets and plays them out at a steady rate.
+///
+/// The playout delay adapts to the measured network jitter: playback starts
+/// once enough audio is buffered to ride out the expected variation, and
+/// excess packets are skipped when the buffer grows well beyond it. Missing
+/// packets are concealed by repeating the previous packet with a decaying
+/// gain.
+///
+/// Packet slots are allocated at construction; [`read`](Self::read) is
+/// realtime-safe and does not allocate.
+pub struct JitterBuffer {
+    consumer: Consumer<StreamPacket>,
+    slots: Box<[Option<StreamPacket>]>,
+    config: JitterConfig,
+
+    anchored: bool,
+    playing: bool,
+    rewindable: bool,
+    next_seq: u32,
+    highest_seq: u32,
+
+    current: Frame,
+    position: usize,
+    gain_start: f32,
+    gain_end: f32,
+    consecutive_concealed: u32,
+
+    last_transit: Option<i64>,
+    packet_us: f64,
+    stats: JitterStats,
+}
+
+impl JitterBuffer {
+    pub(crate) fn new(consumer: Consumer<StreamPacket>, config: JitterConfig) -> Self {
+        let capacity = config.capacity.max(2);
+        Self {
+            consumer,
+            slots: (0..capacity).map(|_| None).collect(),
+            config,
+            anchored: false,
+            playing: false,
+            rewindable: false,
+            next_seq: 0,
+            highest_seq: 0,
+            current: Frame::new(&[], 0, 0),
+            position: 0,
+            gain_start: 1.0,
+            gain_end: 1.0,
+            consecutive_concealed: 0,
+            last_transit: None,
+            packet_us: 0.0,
+            stats: JitterStats::default(),
+        }
+    }
+
+    /// Sample rate of the stream, or 0 before the first packet.
+    pub fn sample_rate(&self) -> u32 {
+        self.current.sample_rate
+    }
+
+    /// Channel count of the stream, or 0 before the first packet.
+    pub fn num_channels(&self) -> usize {
+        self.current.num_channels
+    }
+
+    /// Returns `true` while audio is being played out (not buffering).
+    pub fn is_playing(&self) -> bool {
+        self.playing
+    }
+
+    /// Current statistics.
+    pub fn stats(&self) -> JitterStats {
+        let mut stats = self.stats;
+        stats.target_delay_us = self.target_delay_us();
+        stats.buffered_us = self.buffered_packets() as f64 * self.packet_us;
+        stats
+    }
+
+    /// Fill `out` with interleaved samples in the stream's channel layout.
+    ///
+    /// Outputs silence while buffering.
+    pub fn read(&mut self, out: &mut [f32]) {
+        self.receive();
+
+        let mut written = 0;
+        while written < out.len() {
+            let available = self.current.samples.len() - self.position;
+            if available > 0 {
+                let n = available.min(out.len() - written);
+                self.copy_current(&mut out[written..written + n]);
+                written += n;
+                continue;
+            }
+
+            if !self.playing {
+                if self.anchored && self.buffered_packets() >= self.target_packets() {
+                    self.playing = true;
+                    self.rewindable = false;
+                } else {
+                    out[written..].fill(0.0);
+                    return;
+                }
+            }
+
+            self.advance();
+        }
+    }
+
+    /// Move packets from the receiver into their slots.
+    fn receive(&mut self) {
+        while let Some(packet) = self.consumer.try_pop() {
+            self.insert(packet);
+        }
+    }
+
+    fn insert(&mut self, packet: StreamPacket) {
+        self.stats.received += 1;
+        self.update_jitter(&packet);
+
+        let capacity = self.slots.len();
+        let seq = packet.sequence;
+
+        if !self.anchored {
+            self.reset_to(seq);
+        }
+
+        let ahead = seq.wrapping_sub(self.next_seq) as i32;
+        if ahead < 0 {
+            let behind_highest = self.highest_seq.wrapping_sub(seq) as usize;
+            if self.rewindable && behind_highest < capacity {
+                // Reordered before playback started: play from here instead.
+                self.next_seq = seq;
+            } else if -ahead < capacity as i32 {
+                self.stats.late += 1;
+                return;
+            } else {
+                // Far behind: the sender restarted.
+                self.reset_to(seq);
+            }
+        } else if ahead as usize >= capacity {
+            self.stats.lost += seq.wrapping_sub(self.highest_seq).wrapping_sub(1) as u64;
+            self.reset_to(seq);
+        }
+
+        let since_highest = seq.wrapping_sub(self.highest_seq) as i32;
+        if since_highest > 0 {
+            self.stats.lost += (since_highest - 1) as u64;
+            self.highest_seq = seq;
+        } else if self.stats.lost > 0 && since_highest < 0 {
+            // Reordered packet filling an earlier gap.
+            self.stats.lost -= 1;
+        }
+
+        let slot = &mut self.slots[seq as usize % capacity];
+        if slot.as_ref().is_none_or(|p| p.sequence != seq) {
+            *slot = Some(packet);
+        }
+    }
+
+    fn reset_to(&mut self, seq: u32) {
+        self.slots.iter_mut().for_each(|slot| *slot = None);
+        self.anchored = true;
+        self.playing = false;
+        self.rewindable = true;
+        self.next_seq = seq;
+        self.highest_seq = seq;
+    }
+
+    fn update_jitter(&mut self, packet: &StreamPacket) {
+        let transit = packet.arrival.delta(packet.timestamp);
+        if let Some(last) = self.last_transit {
+            let d = (transit - last).unsigned_abs() as f64;
+            self.stats.jitter_us += (d - self.stats.jitter_us) * JITTER_SMOOTHING;
+        }
+        self.last_transit = Some(transit);
+        self.stats.transit_us = transit;
+
+        let frame = &packet.frame;
+        if frame.sample_rate > 0 {
+            self.packet_us = frame.samples_per_channel() as f64 * 1_000_000.0 / frame.sample_rate as f64;
+        }
+    }
+
+    fn target_delay_us(&self) -> f64 {
+        let min_us = self.config.min_delay_ms * 1000.0;
+        let max_us = (self.config.max_delay_ms * 1000.0).max(min_us);
+        (self.stats.jitter_us * JITTER_MULTIPLIER + self.packet_us).clamp(min_us, max_us)
+    }
+
+    fn target_packets(&self) -> usize {
+        if self.packet_us <= 0.0 {
+            return 1;
+        }
+        ((self.target_delay_us() / self.packet_us).ceil() as usize).clamp(1, self.slots.len())
+    }
+
+    /// Packets from the playout position up to the newest received.
+    fn buffered_packets(&self) -> usize {
+        if !self.anchored {
+            return 0;
+        }
+        let span = self.highest_seq.wrapping_sub(self.next_seq).wrapping_add(1) as i32;
+        span.max(0) as usize
+    }
+
+    /// Switch to the next packet, concealing it if missing.
+    fn advance(&mut self) {
+        let capacity = self.slots.len();
+
+        if self.buffered_packets() > self.target_packets() + EXCESS_PACKETS {
+            self.slots[self.next_seq as usize % capacity] = None;
+            self.next_seq = self.next_seq.wrapping_add(1);
+            self.stats.skipped += 1;
+        }
+
+        let seq = self.next_seq;
+        let slot = &mut self.slots[seq as usize % capacity];
+        if let Some(packet) = slot.take_if(|p| p.sequence == seq) {
+            self.current = packet.frame;
+            self.gain_start = 1.0;
+            self.gain_end = 1.0;
+            self.consecutive_concealed = 0;
+        } else if self.consecutive_concealed < MAX_CONSECUTIVE_CONCEALED && !self.current.samples.is_empty() {
+            // Repeat the previous packet, fading out further each time.
+            self.gain_start = self.gain_end;
+            self.gain_end *= CONCEAL_DECAY;
+            self.consecutive_concealed += 1;
+            self.stats.concealed += 1;
+        } else {
+            self.stats.underruns += 1;
+            self.playing = false;
+            self.current.samples.clear();
+            self.position = 0;
+            self.consecutive_concealed = 0;
+            return;
+        }
+
+        self.position = 0;
+        self.next_seq = seq.wrapping_add(1);
+        if self.buffered_packets() == 0 {
+            self.highest_seq = seq;
+        }
+    }
+
+    fn copy_current(&mut self, out: &mut [f32]) {
+        let samples = &self.current.samples.as_slice()[self.position..self.position + out.len()];
+
+        if self.gain_start == 1.0 && self.gain_end == 1.0 {
+            out.copy_from_slice(samples);
+        } else {
+            let num_channels = self.current.num_channels.max(1);
+            let frames = self.current.samples_per_channel().max(1) as f32;
+            let step = (self.gain_end - self.gain_start) / frames;
+            for (i, (o, &s)) in out.iter_mut().zip(samples).enumerate() {
+                let frame = ((self.position + i) / num_channels) as f32;
+                *o = s * (self.gain_start + step * frame);
+            }
+        }
+
+        self.position += out.len();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use bbx_core::spsc::{Producer, SpscRingBuffer};
+
+    use super::*;
+    use crate::clock::SyncedTimestamp;
+
+    const SAMPLE_RATE: u32 = 48000;
+    const FRAMES: usize = 48;
+    const PACKET_US: u64 = 1000;
+
+    fn buffer(config: JitterConfig) -> (Producer<StreamPacket>, JitterBuffer) {
+        let (producer, consumer) = SpscRingBuffer::new(256);
+        (producer, JitterBuffer::new(consumer, config))
+    }
+
+    fn packet(seq: u32, value: f32, arrival_us: u64) -> StreamPacket {
+        StreamPacket {
+            sequence: seq,
+            timestamp: SyncedTimestamp(seq as u64 * PACKET_US),
+            arrival: SyncedTimestamp(arrival_us),
+            frame: Frame::new(&[value; FRAMES], SAMPLE_RATE, 1),
+        }
+    }
+
+    fn config(min_delay_ms: f64) -> JitterConfig {
+        JitterConfig {
+            min_delay_ms,
+            ..Default::default()
+        }
+    }
+
+    fn low_latency() -> JitterConfig {
+        config(2.0)
+    }
+
+    #[test]
+    fn test_silence_until_target_buffered() {
+        let (mut producer, mut jitter) = buffer(low_latency());
+        let mut out = [1.0f32; FRAMES];
+
+        jitter.read(&mut out);
+        assert!(out.iter().all(|&s| s == 0.0));
+
+        producer.try_push(packet(0, 0.5, 100)).ok();
+        jitter.read(&mut out);
+        assert!(!jitter.is_playing());
+        assert!(out.iter().all(|&s| s == 0.0));
+
+        producer.try_push(packet(1, 0.6, 1100)).ok();
+        jitter.read(&mut out);
+        assert!(jitter.is_playing());
+        assert!(out.iter().all(|&s| s == 0.5));
+        assert_eq!(jitter.num_channels(), 1);
+        assert_eq!(jitter.sample_rate(), SAMPLE_RATE);
+    }
+
+    #[test]
+    fn test_reorders_packets() {
+        let (mut producer, mut jitter) = buffer(low_latency());
+        for (seq, value) in [(1, 0.2), (0, 0.1), (3, 0.4), (2, 0.3)] {
+            producer.try_push(packet(seq, value, seq as u64 * PACKET_US)).ok();
+        }
+
+        let mut out = [0.0f32; FRAMES * 4];
+        jitter.read(&mut out);
+
+        let firsts: Vec<f32> = out.chunks(FRAMES).map(|c| c[0]).collect();
+        assert_eq!(firsts, vec![0.1, 0.2, 0.3, 0.4]);
+        assert_eq!(jitter.stats().lost, 0);
+    }
+
+    #[test]
+    fn test_conceals_missing_packet_with_fade() {
+        let (mut producer, mut jitter) = buffer(config(4.0));
+        for seq in [0, 1, 3, 4] {
+            producer.try_push(packet(seq, 1.0, seq as u64 * PACKET_US)).ok();
+        }
+
+        let mut out = [0.0f32; FRAMES * 4];
+        jitter.read(&mut out);
+
+        let concealed = &out[FRAMES * 2..FRAMES * 3];
+        assert_eq!(concealed[0], 1.0);
+        assert!(concealed[FRAMES - 1] < 0.6 && concealed[FRAMES - 1] > 0.5);
+        assert_eq!(out[FRAMES * 3], 1.0);
+
+        let stats = jitter.stats();
+        assert_eq!(stats.concealed, 1);
+        assert_eq!(stats.lost, 1);
+    }
+
+    #[test]
+    fn test_late_packet_dropped() {
+        let (mut producer, mut jitter) = buffer(config(4.0));
+        for seq in [0, 1, 3] {
+            producer.try_push(packet(seq, 1.0, seq as u64 * PACKET_US)).ok();
+        }
+
+        let mut out = [0.0f32; FRAMES * 3];
+        jitter.read(&mut out);
+
+        producer.try_push(packet(2, 1.0, 5000)).ok();
+        jitter.read(&mut out[..FRAMES]);
+
+        assert_eq!(jitter.stats().late, 1);
+    }
+
+    #[test]
+    fn test_underrun_rebuffers() {
+        let (mut producer, mut jitter) = buffer(low_latency());
+        producer.try_push(packet(0, 1.0, 0)).ok();
+        producer.try_push(packet(1, 1.0, 1000)).ok();
+
+        let mut out = [0.0f32; FRAMES * 8];
+        jitter.read(&mut out);
+
+        assert!(!jitter.is_playing());
+        assert_eq!(jitter.stats().underruns, 1);
+        assert!(out[FRAMES * 7..].iter().all(|&s| s == 0.0));
+    }
+
+    #[test]
+    fn test_jitter_raises_target_delay() {
+        let (mut producer, mut jitter) = buffer(low_latency());
+        let mut out = [0.0f32; FRAMES];
+
+        // Arrivals alternate between on time and 3 ms late.
+        for seq in 0..64u32 {
+            let late = if seq % 2 == 0 { 0 } else { 3000 };
+            producer.try_push(packet(seq, 1.0, seq as u64 * PACKET_US + late)).ok();
+            jitter.read(&mut out);
+        }
+
+        let stats = jitter.stats();
+        assert!(stats.jitter_us > 2000.0, "jitter {}", stats.jitter_us);
+        assert!(stats.target_delay_us > 8000.0, "target {}", stats.target_delay_us);
+    }
+
+    #[test]
+    fn test_excess_packets_skipped() {
+        let (mut producer, mut jitter) = buffer(low_latency());
+        for seq in 0..20u32 {
+            producer.try_push(packet(seq, seq as f32, seq as u64 * PACKET_US)).ok();
+        }
+
+        let mut out = [0.0f32; FRAMES];
+        for _ in 0..10 {
+            jitter.read(&mut out);
+        }
+
+        assert!(jitter.stats().skipped > 0);
+        assert!(jitter.stats().buffered_us <= 6000.0);
+    }
+}
@@ -0,0 +1,120 @@
+//! UDP audio streaming for remote monitoring.
+//!
+//! An [`AudioTap`] on the audio thread queues [`Frame`](bbx_dsp::Frame)s
+//! through a lock-free ring buffer. An [`AudioStreamSender`] on a network
+//! thread packetizes them with sequence numbers and [`SyncedTimestamp`]s
+//! and sends them over UDP, optionally as 16-bit PCM. On the listening side,
+//! an [`AudioStreamReceiver`] feeds a [`JitterBuffer`], which reorders
+//! packets, adapts its delay to the network jitter, and conceals lost
+//! packets.
+//!
+//! [`SyncedTimestamp`]: crate::clock::SyncedTimestamp
+
+mod jitter;
+mod packet;
+mod receiver;
+mod sender;
+
+pub use jitter::{JitterBuffer, JitterConfig, JitterStats};
+pub use packet::{MAX_DATAGRAM_LEN, STREAM_HEADER_LEN, SampleEncoding, StreamPacket};
+pub use receiver::{AudioReceiverConfig, AudioStreamReceiver, audio_stream_receiver};
+pub use sender::{AudioStreamConfig, AudioStreamSender, AudioTap, AudioTapConsumer, audio_tap};
+
+#[cfg(test)]
+mod tests {
+    use std::{net::UdpSocket, sync::Arc};
+
+    use bbx_dsp::Frame;
+
+    use super::*;
+    use crate::clock::ClockSync;
+
+    const FRAMES: usize = 128;
+
+    fn loopback(
+        encoding: SampleEncoding,
+        clock: Arc<ClockSync>,
+    ) -> (AudioTap, AudioStreamSender, AudioStreamReceiver, JitterBuffer) {
+        let (receiver, jitter) = audio_stream_receiver(AudioReceiverConfig {
+            bind_addr: "127.0.0.1:0".parse().unwrap(),
+            jitter: JitterConfig {
+                min_delay_ms: 1.0,
+                ..Default::default()
+            },
+            ..Default::default()
+        })
+        .unwrap();
+        let receiver = receiver.with_clock(clock);
+
+        let (tap, consumer) = audio_tap(16);
+        let sender = AudioStreamSender::new(
+            AudioStreamConfig {
+                bind_addr: "127.0.0.1:0".parse().unwrap(),
+                targets: vec![receiver.local_addr().unwrap()],
+                encoding,
+                ..Default::default()
+            },
+            consumer,
+        )
+        .unwrap();
+
+        (tap, sender, receiver, jitter)
+    }
+
+    fn ramp(block: usize) -> Vec<f32> {
+        (0..FRAMES * 2)
+            .map(|i| ((block * FRAMES * 2 + i) % 1000) as f32 / 1000.0)
+            .collect()
+    }
+
+    fn stream_blocks(encoding: SampleEncoding, blocks: usize) -> (Vec<f32>, JitterBuffer) {
+        let clock = Arc::new(ClockSync::new());
+        let (mut tap, mut sender, mut receiver, mut jitter) = loopback(encoding, Arc::clone(&clock));
+
+        for block in 0..blocks {
+            assert!(tap.try_send(Frame::new(&ramp(block), 48000, 2), clock.now()));
+            assert_eq!(sender.send_pending().unwrap(), 1);
+            assert!(receiver.recv().unwrap());
+        }
+
+        let mut out = vec![0.0f32; FRAMES * 2 * blocks];
+        jitter.read(&mut out);
+        (out, jitter)
+    }
+
+    #[test]
+    fn test_loopback_f32_is_lossless() {
+        let (out, jitter) = stream_blocks(SampleEncoding::F32, 4);
+        let expected: Vec<f32> = (0..4).flat_map(ramp).collect();
+
+        assert_eq!(jitter.num_channels(), 2);
+        assert_eq!(jitter.sample_rate(), 48000);
+        assert_eq!(out, expected);
+
+        let stats = jitter.stats();
+        assert_eq!(stats.received, 4);
+        assert_eq!(stats.lost, 0);
+        assert_eq!(stats.concealed, 0);
+        assert!(stats.transit_us >= 0);
+    }
+
+    #[test]
+    fn test_loopback_pcm16() {
+        let (out, _jitter) = stream_blocks(SampleEncoding::Pcm16, 4);
+        let expected: Vec<f32> = (0..4).flat_map(ramp).collect();
+
+        for (&received, &sent) in out.iter().zip(&expected) {
+            assert!((received - sent).abs() <= 1.0 / i16::MAX as f32);
+        }
+    }
+
+    #[test]
+    fn test_receiver_counts_malformed_packets() {
+        let (_tap, _sender, mut receiver, _jitter) = loopback(SampleEncoding::F32, Arc::new(ClockSync::new()));
+        let socket = UdpSocket::bind("127.0.0.1:0").unwrap();
+        socket.send_to(b"not audio", receiver.local_addr().unwrap()).unwrap();
+
+        assert!(!receiver.recv().unwrap());
+        assert_eq!(receiver.malformed(), 1);
+    }
+}
@@ -0,0 +1,247 @@
+//! Wire format for audio stream packets.
+//!
+//! Each UDP datagram carries one packet: a fixed 24-byte little-endian header
+//! followed by interleaved samples.
+//!
+//! | Offset | Size | Field                                   |
+//! |--------|------|-----------------------------------------|
+//! | 0      | 2    | Magic (`"BX"`)                          |
+//! | 2      | 1    | Version                                 |
+//! | 3      | 1    | Sample encoding                         |
+//! | 4      | 4    | Sequence number                         |
+//! | 8      | 8    | Timestamp of the first sample (µs)      |
+//! | 16     | 4    | Sample rate (Hz)                        |
+//! | 20     | 2    | Number of channels                      |
+//! | 22     | 2    | Samples per channel                     |
+
+use bbx_core::StackVec;
+use bbx_dsp::frame::{Frame, MAX_FRAME_SAMPLES};
+
+use crate::{
+    clock::SyncedTimestamp,
+    error::{NetError, Result},
+};
+
+/// Packet magic bytes.
+const MAGIC: [u8; 2] = *b"BX";
+
+/// Wire format version.
+const VERSION: u8 = 1;
+
+/// Size of the packet header in bytes.
+pub const STREAM_HEADER_LEN: usize = 24;
+
+/// Largest UDP payload that can be sent over IPv4.
+pub const MAX_DATAGRAM_LEN: usize = 65_507;
+
+/// How samples are encoded on the wire.
+#[repr(u8)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum SampleEncoding {
+    /// 32-bit float, lossless.
+    #[default]
+    F32 = 0,
+    /// 16-bit signed PCM, half the bandwidth of `F32`.
+    Pcm16 = 1,
+}
+
+impl SampleEncoding {
+    /// Bytes per encoded sample.
+    #[inline]
+    pub const fn bytes_per_sample(self) -> usize {
+        match self {
+            SampleEncoding::F32 => 4,
+            SampleEncoding::Pcm16 => 2,
+        }
+    }
+
+    fn from_u8(value: u8) -> Option<Self> {
+        match value {
+            0 => Some(SampleEncoding::F32),
+            1 => Some(SampleEncoding::Pcm16),
+            _ => None,
+        }
+    }
+}
+
+/// A decoded audio stream packet.
+#[derive(Clone)]
+pub struct StreamPacket {
+    /// Sequence number, incremented by one per packet.
+    pub sequence: u32,
+    /// Sender time of the first sample.
+    pub timestamp: SyncedTimestamp,
+    /// Receiver time when the packet arrived.
+    pub arrival: SyncedTimestamp,
+    /// Decoded samples.
+    pub frame: Frame,
+}
+
+/// Header fields for encoding a packet.
+pub(crate) struct PacketHeader {
+    pub encoding: SampleEncoding,
+    pub sequence: u32,
+    pub timestamp: SyncedTimestamp,
+    pub sample_rate: u32,
+    pub num_channels: u16,
+}
+
+/// Encode a packet into `buf`, returning the number of bytes written.
+///
+/// `samples` must be interleaved with `header.num_channels` channels, and
+/// `buf` must hold the header plus every encoded sample.
+pub(crate) fn encode_packet(buf: &mut [u8], header: &PacketHeader, samples: &[f32]) -> usize {
+    let frames = samples.len() / header.num_channels.max(1) as usize;
+    let len = STREAM_HEADER_LEN + samples.len() * header.encoding.bytes_per_sample();
+    debug_assert!(buf.len() >= len, "packet buffer too small");
+
+    buf[0..2].copy_from_slice(&MAGIC);
+    buf[2] = VERSION;
+    buf[3] = header.encoding as u8;
+    buf[4..8].copy_from_slice(&header.sequence.to_le_bytes());
+    buf[8..16].copy_from_slice(&header.timestamp.0.to_le_bytes());
+    buf[16..20].copy_from_slice(&header.sample_rate.to_le_bytes());
+    buf[20..22].copy_from_slice(&header.num_channels.to_le_bytes());
+    buf[22..24].copy_from_slice(&(frames as u16).to_le_bytes());
+
+    let payload = &mut buf[STREAM_HEADER_LEN..len];
+    match header.encoding {
+        SampleEncoding::F32 => {
+            for (bytes, &sample) in payload.chunks_exact_mut(4).zip(samples) {
+                bytes.copy_from_slice(&sample.to_le_bytes());
+            }
+        }
+        SampleEncoding::Pcm16 => {
+            for (bytes, &sample) in payload.chunks_exact_mut(2).zip(samples) {
+                let pcm = (sample.clamp(-1.0, 1.0) * i16::MAX as f32).round() as i16;
+                bytes.copy_from_slice(&pcm.to_le_bytes());
+            }
+        }
+    }
+
+    len
+}
+
+/// Decode a packet received at `arrival`.
+///
+/// Returns `NetError::ParseError` for foreign, truncated, or oversized packets.
+pub(crate) fn decode_packet(buf: &[u8], arrival: SyncedTimestamp) -> Result<StreamPacket> {
+    if buf.len() < STREAM_HEADER_LEN || buf[0..2] != MAGIC || buf[2] != VERSION {
+        return Err(NetError::ParseError);
+    }
+
+    let encoding = SampleEncoding::from_u8(buf[3]).ok_or(NetError::ParseError)?;
+    let sequence = u32::from_le_bytes(buf[4..8].try_into().unwrap());
+    let timestamp = u64::from_le_bytes(buf[8..16].try_into().unwrap());
+    let sample_rate = u32::from_le_bytes(buf[16..20].try_into().unwrap());
+    let num_channels = u16::from_le_bytes(buf[20..22].try_into().unwrap()) as usize;
+    let frames = u16::from_le_bytes(buf[22..24].try_into().unwrap()) as usize;
+
+    let num_samples = frames * num_channels;
+    if num_channels == 0 || num_samples > MAX_FRAME_SAMPLES {
+        return Err(NetError::ParseError);
+    }
+
+    let payload = &buf[STREAM_HEADER_LEN..];
+    if payload.len() != num_samples * encoding.bytes_per_sample() {
+        return Err(NetError::ParseError);
+    }
+
+    let mut samples = StackVec::new();
+    match encoding {
+        SampleEncoding::F32 => {
+            for bytes in payload.chunks_exact(4) {
+                samples.push_unchecked(f32::from_le_bytes(bytes.try_into().unwrap()));
+            }
+        }
+        SampleEncoding::Pcm16 => {
+            for bytes in payload.chunks_exact(2) {
+                let pcm = i16::from_le_bytes(bytes.try_into().unwrap());
+                samples.push_unchecked(pcm as f32 / i16::MAX as f32);
+            }
+        }
+    }
+
+    Ok(StreamPacket {
+        sequence,
+        timestamp: SyncedTimestamp(timestamp),
+        arrival,
+        frame: Frame {
+            samples,
+            sample_rate,
+            num_channels,
+        },
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn header(encoding: SampleEncoding) -> PacketHeader {
+        PacketHeader {
+            encoding,
+            sequence: 42,
+            timestamp: SyncedTimestamp(123_456),
+            sample_rate: 48000,
+            num_channels: 2,
+        }
+    }
+
+    #[test]
+    fn test_f32_roundtrip() {
+        let samples = [0.5f32, -0.5, 0.25, -0.25];
+        let mut buf = [0u8; 256];
+        let len = encode_packet(&mut buf, &header(SampleEncoding::F32), &samples);
+        assert_eq!(len, STREAM_HEADER_LEN + 16);
+
+        let packet = decode_packet(&buf[..len], SyncedTimestamp(200_000)).unwrap();
+        assert_eq!(packet.sequence, 42);
+        assert_eq!(packet.timestamp, SyncedTimestamp(123_456));
+        assert_eq!(packet.arrival, SyncedTimestamp(200_000));
+        assert_eq!(packet.frame.sample_rate, 48000);
+        assert_eq!(packet.frame.num_channels, 2);
+        assert_eq!(packet.frame.samples.as_slice(), &samples);
+    }
+
+    #[test]
+    fn test_pcm16_roundtrip_within_quantization() {
+        let samples = [0.5f32, -0.5, 1.0, -1.0, 0.001, 0.0];
+        let mut buf = [0u8; 256];
+        let len = encode_packet(&mut buf, &header(SampleEncoding::Pcm16), &samples);
+        assert_eq!(len, STREAM_HEADER_LEN + 12);
+
+        let packet = decode_packet(&buf[..len], SyncedTimestamp(0)).unwrap();
+        for (&decoded, &original) in packet.frame.samples.as_slice().iter().zip(&samples) {
+            assert!((decoded - original).abs() <= 1.0 / i16::MAX as f32);
+        }
+    }
+
+    #[test]
+    fn test_pcm16_clamps_out_of_range() {
+        let samples = [2.0f32, -2.0];
+        let mut buf = [0u8; 64];
+        let len = encode_packet(&mut buf, &header(SampleEncoding::Pcm16), &samples);
+
+        let packet = decode_packet(&buf[..len], SyncedTimestamp(0)).unwrap();
+        assert_eq!(packet.frame.samples.as_slice(), &[1.0, -1.0]);
+    }
+
+    #[test]
+    fn test_rejects_malformed_packets() {
+        let samples = [0.0f32; 4];
+        let mut buf = [0u8; 256];
+        let len = encode_packet(&mut buf, &header(SampleEncoding::F32), &samples);
+
+        assert!(decode_packet(&buf[..len - 1], SyncedTimestamp(0)).is_err());
+        assert!(decode_packet(&buf[..10], SyncedTimestamp(0)).is_err());
+
+        let mut bad_magic = buf;
+        bad_magic[0] = b'Z';
+        assert!(decode_packet(&bad_magic[..len], SyncedTimestamp(0)).is_err());
+
+        let mut bad_encoding = buf;
+        bad_encoding[3] = 9;
+        assert!(decode_packet(&bad_encoding[..len], SyncedTimestamp(0)).is_err());
+    }
+}
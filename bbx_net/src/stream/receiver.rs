@@ -0,0 +1,132 @@
+//! UDP receiver for monitoring streams.
+
+use std::{
+    io::ErrorKind,
+    net::{SocketAddr, UdpSocket},
+    sync::Arc,
+    thread::{self, JoinHandle},
+    time::Duration,
+};
+
+use bbx_core::spsc::{Producer, SpscRingBuffer};
+
+use super::{
+    jitter::{JitterBuffer, JitterConfig},
+    packet::{MAX_DATAGRAM_LEN, StreamPacket, decode_packet},
+};
+use crate::{clock::ClockSync, error::Result};
+
+/// Configuration for the audio stream receiver.
+#[derive(Debug, Clone)]
+pub struct AudioReceiverConfig {
+    /// Address to listen on (e.g., "0.0.0.0:9100").
+    pub bind_addr: SocketAddr,
+    /// Packets that can be queued between the receiver and the jitter buffer.
+    pub queue_capacity: usize,
+    /// Jitter buffer settings.
+    pub jitter: JitterConfig,
+}
+
+impl Default for AudioReceiverConfig {
+    fn default() -> Self {
+        Self {
+            bind_addr: "0.0.0.0:9100".parse().unwrap(),
+            queue_capacity: 64,
+            jitter: JitterConfig::default(),
+        }
+    }
+}
+
+/// Receives audio stream packets and forwards them to a [`JitterBuffer`].
+///
+/// Runs on a network thread; the jitter buffer is read from the audio thread.
+pub struct AudioStreamReceiver {
+    socket: UdpSocket,
+    producer: Producer<StreamPacket>,
+    clock: Arc<ClockSync>,
+    buf: Box<[u8]>,
+    malformed: u64,
+    dropped: u64,
+}
+
+impl AudioStreamReceiver {
+    /// Stamp arrivals with a shared clock.
+    ///
+    /// When the sender uses the same clock, [`JitterStats::transit_us`] reports
+    /// the network latency.
+    ///
+    /// [`JitterStats::transit_us`]: super::JitterStats::transit_us
+    pub fn with_clock(mut self, clock: Arc<ClockSync>) -> Self {
+        self.clock = clock;
+        self
+    }
+
+    /// Get the local address the receiver is bound to.
+    pub fn local_addr(&self) -> Result<SocketAddr> {
+        Ok(self.socket.local_addr()?)
+    }
+
+    /// Number of packets that failed to decode.
+    pub fn malformed(&self) -> u64 {
+        self.malformed
+    }
+
+    /// Number of packets dropped because the jitter buffer queue was full.
+    pub fn dropped(&self) -> u64 {
+        self.dropped
+    }
+
+    /// Receive one packet, waiting up to the socket read timeout.
+    ///
+    /// Returns `Ok(true)` if a packet was queued, `Ok(false)` on timeout or
+    /// when the packet was malformed or dropped.
+    pub fn recv(&mut self) -> Result<bool> {
+        let len = match self.socket.recv(&mut self.buf) {
+            Ok(len) => len,
+            Err(e) if matches!(e.kind(), ErrorKind::WouldBlock | ErrorKind::TimedOut) => return Ok(false),
+            Err(e) => return Err(e.into()),
+        };
+
+        let Ok(packet) = decode_packet(&self.buf[..len], self.clock.now()) else {
+            self.malformed += 1;
+            return Ok(false);
+        };
+
+        if self.producer.try_push(packet).is_err() {
+            self.dropped += 1;
+            return Ok(false);
+        }
+
+        Ok(true)
+    }
+
+    /// Run the receiver in the current thread (blocking).
+    pub fn run(mut self) -> Result<()> {
+        loop {
+            self.recv()?;
+        }
+    }
+
+    /// Run the receiver in a background thread.
+    pub fn spawn(self) -> JoinHandle<Result<()>> {
+        thread::spawn(move || self.run())
+    }
+}
+
+/// Create a receiver bound to `config.bind_addr` and its jitter buffer.
+pub fn audio_stream_receiver(config: AudioReceiverConfig) -> Result<(AudioStreamReceiver, JitterBuffer)> {
+    let socket = UdpSocket::bind(config.bind_addr)?;
+    socket.set_read_timeout(Some(Duration::from_millis(100)))?;
+
+    let (producer, consumer) = SpscRingBuffer::new(config.queue_capacity);
+    let receiver = AudioStreamReceiver {
+        socket,
+        producer,
+        clock: Arc::new(ClockSync::new()),
+        buf: vec![0u8; MAX_DATAGRAM_LEN].into_boxed_slice(),
+        malformed: 0,
+        dropped: 0,
+    };
+
+    Ok((receiver, JitterBuffer::new(consumer, config.jitter)))
+}
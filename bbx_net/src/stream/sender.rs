@@ -0,0 +1,321 @@
+//! Audio-thread tap and UDP sender for monitoring streams.
+
+use std::{
+    net::{SocketAddr, UdpSocket},
+    thread::{self, JoinHandle},
+    time::Duration,
+};
+
+use bbx_core::spsc::{Consumer, Producer, SpscRingBuffer};
+use bbx_dsp::frame::Frame;
+
+use super::packet::{MAX_DATAGRAM_LEN, PacketHeader, STREAM_HEADER_LEN, SampleEncoding, encode_packet};
+use crate::{clock::SyncedTimestamp, error::Result};
+
+/// Audio-thread side of a monitoring tap.
+///
+/// All methods are realtime-safe and do not allocate.
+pub struct AudioTap {
+    producer: Producer<(SyncedTimestamp, Frame)>,
+}
+
+impl AudioTap {
+    /// Try to queue a frame for streaming.
+    ///
+    /// `timestamp` is the synced time of the frame's first sample (e.g.
+    /// [`ClockSync::cached_now()`](crate::clock::ClockSync::cached_now)).
+    /// Returns `false` if the tap is full; the frame is dropped.
+    #[inline]
+    pub fn try_send(&mut self, frame: Frame, timestamp: SyncedTimestamp) -> bool {
+        self.producer.try_push((timestamp, frame)).is_ok()
+    }
+
+    /// Check if the tap is full.
+    #[inline]
+    pub fn is_full(&self) -> bool {
+        self.producer.is_full()
+    }
+}
+
+/// Network-thread side of a monitoring tap, consumed by [`AudioStreamSender`].
+pub struct AudioTapConsumer {
+    consumer: Consumer<(SyncedTimestamp, Frame)>,
+}
+
+impl AudioTapConsumer {
+    /// Returns the number of frames waiting to be sent.
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.consumer.len()
+    }
+
+    /// Check if there are no frames waiting.
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.consumer.is_empty()
+    }
+}
+
+/// Create a monitoring tap pair.
+///
+/// The `capacity` determines how many frames can be queued between the audio
+/// thread and the sender. A typical value is 16-64 frames.
+pub fn audio_tap(capacity: usize) -> (AudioTap, AudioTapConsumer) {
+    let (producer, consumer) = SpscRingBuffer::new(capacity);
+    (AudioTap { producer }, AudioTapConsumer { consumer })
+}
+
+/// Configuration for the audio stream sender.
+#[derive(Debug, Clone)]
+pub struct AudioStreamConfig {
+    /// Local address to send from (e.g., "0.0.0.0:0" for any port).
+    pub bind_addr: SocketAddr,
+    /// Receivers to stream to.
+    pub targets: Vec<SocketAddr>,
+    /// Sample encoding on the wire.
+    pub encoding: SampleEncoding,
+    /// Maximum datagram size in bytes.
+    ///
+    /// Frames larger than this are split across several packets. The default
+    /// keeps datagrams under a typical Ethernet MTU so they are never
+    /// fragmented.
+    pub max_packet_bytes: usize,
+    /// How long the sender sleeps when the tap is empty.
+    pub poll_interval_us: u64,
+}
+
+impl Default for AudioStreamConfig {
+    fn default() -> Self {
+        Self {
+            bind_addr: "0.0.0.0:0".parse().unwrap(),
+            targets: Vec::new(),
+            encoding: SampleEncoding::F32,
+            max_packet_bytes: 1400,
+            poll_interval_us: 500,
+        }
+    }
+}
+
+/// Streams tapped audio frames to receivers over UDP.
+///
+/// The packet buffer is allocated once at construction, so sending does not
+/// allocate. A failed send to one target is counted in
+/// [`send_errors`](Self::send_errors) and skipped, so an unreachable receiver
+/// doesn't interrupt the stream to the others.
+pub struct AudioStreamSender {
+    config: AudioStreamConfig,
+    socket: UdpSocket,
+    consumer: AudioTapConsumer,
+    packet: Box<[u8]>,
+    sequence: u32,
+    packets_sent: u64,
+    send_errors: Box<[u64]>,
+}
+
+impl AudioStreamSender {
+    /// Create a sender bound to `config.bind_addr`.
+    pub fn new(mut config: AudioStreamConfig, consumer: AudioTapConsumer) -> Result<Self> {
+        let socket = UdpSocket::bind(config.bind_addr)?;
+        let min_packet = STREAM_HEADER_LEN + config.encoding.bytes_per_sample();
+        config.max_packet_bytes = config.max_packet_bytes.clamp(min_packet, MAX_DATAGRAM_LEN);
+
+        Ok(Self {
+            packet: vec![0u8; config.max_packet_bytes].into_boxed_slice(),
+            send_errors: vec![0; config.targets.len()].into_boxed_slice(),
+            config,
+            socket,
+            consumer,
+            sequence: 0,
+            packets_sent: 0,
+        })
+    }
+
+    /// Get the local address the sender is bound to.
+    pub fn local_addr(&self) -> Result<SocketAddr> {
+        Ok(self.socket.local_addr()?)
+    }
+
+    /// Total number of packets sent.
+    pub fn packets_sent(&self) -> u64 {
+        self.packets_sent
+    }
+
+    /// Number of packets that failed to send to each target, in the order of
+    /// `config.targets`.
+    pub fn send_errors(&self) -> &[u64] {
+        &self.send_errors
+    }
+
+    /// Send every frame waiting in the tap.
+    ///
+    /// Returns the number of packets sent.
+    pub fn send_pending(&mut self) -> Result<usize> {
+        let mut sent = 0;
+        while let Some((timestamp, frame)) = self.consumer.consumer.try_pop() {
+            sent += self.send_frame(&frame, timestamp)?;
+        }
+        Ok(sent)
+    }
+
+    /// Packetize and send one frame, returning the number of packets sent.
+    fn send_frame(&mut self, frame: &Frame, timestamp: SyncedTimestamp) -> Result<usize> {
+        let num_channels = frame.num_channels;
+        if num_channels == 0 || num_channels > u16::MAX as usize || frame.sample_rate == 0 {
+            return Ok(0);
+        }
+
+        let capacity = (self.config.max_packet_bytes - STREAM_HEADER_LEN) / self.config.encoding.bytes_per_sample();
+        let frames_per_packet = (capacity / num_channels).max(1);
+
+        let mut sent = 0;
+        for (i, samples) in frame
+            .samples
+            .as_slice()
+            .chunks(frames_per_packet * num_channels)
+            .enumerate()
+        {
+            let offset_frames = (i * frames_per_packet) as u64;
+            let header = PacketHeader {
+                encoding: self.config.encoding,
+                sequence: self.sequence,
+                timestamp: SyncedTimestamp(timestamp.0 + offset_frames * 1_000_000 / frame.sample_rate as u64),
+                sample_rate: frame.sample_rate,
+                num_channels: num_channels as u16,
+            };
+            let len = encode_packet(&mut self.packet, &header, samples);
+
+            for (target, errors) in self.config.targets.iter().zip(self.send_errors.iter_mut()) {
+                if self.socket.send_to(&self.packet[..len], target).is_err() {
+                    *errors += 1;
+                }
+            }
+
+            self.sequence = self.sequence.wrapping_add(1);
+            self.packets_sent += 1;
+            sent += 1;
+        }
+
+        Ok(sent)
+    }
+
+    /// Run the sender in the current thread (blocking).
+    ///
+    /// Sends frames as they arrive. Sending on a bound UDP socket only fails
+    /// for a particular target (unreachable, refused, wrong address family),
+    /// so failures are counted per target and the sender keeps running.
+    pub fn run(mut self) -> Result<()> {
+        let idle = Duration::from_micros(self.config.poll_interval_us);
+        loop {
+            if self.send_pending()? == 0 {
+                thread::sleep(idle);
+            }
+        }
+    }
+
+    /// Run the sender in a background thread.
+    pub fn spawn(self) -> JoinHandle<Result<()>> {
+        thread::spawn(move || self.run())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::stream::packet::decode_packet;
+
+    fn receiver() -> (UdpSocket, SocketAddr) {
+        let socket = UdpSocket::bind("127.0.0.1:0").unwrap();
+        socket.set_read_timeout(Some(Duration::from_secs(2))).unwrap();
+        let addr = socket.local_addr().unwrap();
+        (socket, addr)
+    }
+
+    fn sender(target: SocketAddr, max_packet_bytes: usize) -> (AudioTap, AudioStreamSender) {
+        let (tap, consumer) = audio_tap(8);
+        let config = AudioStreamConfig {
+            bind_addr: "127.0.0.1:0".parse().unwrap(),
+            targets: vec![target],
+            max_packet_bytes,
+            ..Default::default()
+        };
+        (tap, AudioStreamSender::new(config, consumer).unwrap())
+    }
+
+    #[test]
+    fn test_frame_sent_as_single_packet() {
+        let (rx, target) = receiver();
+        let (mut tap, mut sender) = sender(target, 1400);
+
+        let samples: Vec<f32> = (0..256).map(|i| i as f32 / 256.0).collect();
+        assert!(tap.try_send(Frame::new(&samples, 48000, 2), SyncedTimestamp(1000)));
+        assert_eq!(sender.send_pending().unwrap(), 1);
+
+        let mut buf = [0u8; 2048];
+        let len = rx.recv(&mut buf).unwrap();
+        let packet = decode_packet(&buf[..len], SyncedTimestamp(0)).unwrap();
+        assert_eq!(packet.sequence, 0);
+        assert_eq!(packet.timestamp, SyncedTimestamp(1000));
+        assert_eq!(packet.frame.samples.as_slice(), samples.as_slice());
+    }
+
+    #[test]
+    fn test_large_frame_split_with_advancing_timestamps() {
+        let (rx, target) = receiver();
+        // Room for 100 f32 samples = 50 stereo frames per packet.
+        let (mut tap, mut sender) = sender(target, STREAM_HEADER_LEN + 400);
+
+        let samples = [0.0f32; 240];
+        tap.try_send(Frame::new(&samples, 48000, 2), SyncedTimestamp(0));
+        assert_eq!(sender.send_pending().unwrap(), 3);
+
+        let mut buf = [0u8; 2048];
+        let mut timestamps = Vec::new();
+        for expected_seq in 0..3 {
+            let len = rx.recv(&mut buf).unwrap();
+            assert!(len <= STREAM_HEADER_LEN + 400);
+            let packet = decode_packet(&buf[..len], SyncedTimestamp(0)).unwrap();
+            assert_eq!(packet.sequence, expected_seq);
+            timestamps.push(packet.timestamp.0);
+        }
+
+        // 50 frames at 48 kHz = 1041 µs per packet.
+        assert_eq!(timestamps, vec![0, 1041, 2083]);
+    }
+
+    #[test]
+    fn test_failed_target_does_not_stop_others() {
+        let (rx, target) = receiver();
+        let (mut tap, consumer) = audio_tap(8);
+        let config = AudioStreamConfig {
+            bind_addr: "127.0.0.1:0".parse().unwrap(),
+            // Port 0 can't be sent to
+            targets: vec!["127.0.0.1:0".parse().unwrap(), target],
+            ..Default::default()
+        };
+        let mut sender = AudioStreamSender::new(config, consumer).unwrap();
+
+        let frame = Frame::new(&[0.25f32; 64], 48000, 2);
+        tap.try_send(frame.clone(), SyncedTimestamp(0));
+        tap.try_send(frame, SyncedTimestamp(0));
+        assert_eq!(sender.send_pending().unwrap(), 2);
+        assert_eq!(sender.send_errors(), &[2, 0]);
+
+        let mut buf = [0u8; 2048];
+        for expected_seq in 0..2 {
+            let len = rx.recv(&mut buf).unwrap();
+            let packet = decode_packet(&buf[..len], SyncedTimestamp(0)).unwrap();
+            assert_eq!(packet.sequence, expected_seq);
+        }
+    }
+
+    #[test]
+    fn test_full_tap_drops_frames() {
+        let (mut tap, _consumer) = audio_tap(2);
+        let frame = Frame::new(&[0.0; 4], 48000, 2);
+
+        assert!(tap.try_send(frame.clone(), SyncedTimestamp(0)));
+        assert!(tap.try_send(frame.clone(), SyncedTimestamp(0)));
+        assert!(!tap.try_send(frame, SyncedTimestamp(0)));
+        assert!(tap.is_full());
+    }
+}
@@ -1,8 +1,13 @@
 //! WebSocket connection state management.
 
-use std::time::Instant;
+use std::{
+    collections::{HashMap, hash_map::Entry},
+    time::Instant,
+};
 
-use crate::address::NodeId;
+use tokio::sync::RwLock;
+
+use crate::{address::NodeId, clock::ClockEstimator};
 
 /// Connection state for a single WebSocket client.
 #[derive(Debug, Clone)]
@@ -21,8 +26,13 @@ pub struct ConnectionState {
     pub latency_us: u64,
     /// Number of reconnections for this node.
     pub reconnect_count: u32,
-    /// Clock offset in microseconds (positive = client ahead).
+    /// Clock offset in microseconds (server time minus client time).
     pub clock_offset: i64,
+    /// Filtered offset and drift estimate built from ping/pong exchanges.
+    pub clock: ClockEstimator,
+    /// Client and server timestamps of the last pong sent, awaiting the
+    /// client's receive time to complete the exchange.
+    pending_pong: Option<(u64, u64)>,
 }
 
 impl ConnectionState {
@@ -38,6 +48,8 @@ impl ConnectionState {
             latency_us: 0,
             reconnect_count: 0,
             clock_offset: 0,
+            clock: ClockEstimator::new(),
+            pending_pong: None,
         }
     }
 
@@ -53,8 +65,9 @@ impl ConnectionState {
 
     /// Update clock offset from ping/pong exchange.
     ///
-    /// Uses NTP-style calculation to determine the difference between
-    /// client and server clocks.
+    /// Feeds the NTP-style sample into the connection's [`ClockEstimator`],
+    /// which filters out high-latency exchanges and tracks drift. Inconsistent
+    /// samples (negative round trip) are ignored.
     pub fn update_clock_offset(
         &mut self,
         client_send: u64,
@@ -62,16 +75,47 @@ impl ConnectionState {
         server_send: u64,
         client_receive: u64,
     ) {
-        let t1 = client_send as i64;
-        let t2 = server_receive as i64;
-        let t3 = server_send as i64;
-        let t4 = client_receive as i64;
+        if !self
+            .clock
+            .add_sample(client_send, server_receive, server_send, client_receive)
+        {
+            return;
+        }
+
+        let round_trip = (client_receive - client_send) - (server_send - server_receive);
+        let midpoint = client_send + (client_receive - client_send) / 2;
 
-        self.clock_offset = ((t2 - t1) + (t3 - t4)) / 2;
-        self.latency_us = ((t4 - t1) - (t3 - t2)) as u64 / 2;
+        self.clock_offset = self.clock.offset_at(midpoint).round() as i64;
+        self.latency_us = round_trip / 2;
         self.last_ping = Instant::now();
     }
 
+    /// Estimated bound on the clock offset error in microseconds.
+    pub fn clock_error_us(&self) -> f64 {
+        self.clock.error_bound_us()
+    }
+
+    /// Remember a pong sent to the client.
+    ///
+    /// The exchange is completed by [`complete_pong`](Self::complete_pong)
+    /// once the client reports when it received the pong.
+    pub fn record_pong(&mut self, client_send: u64, server_time: u64) {
+        self.pending_pong = Some((client_send, server_time));
+    }
+
+    /// Complete the last recorded ping/pong exchange and update the clock offset.
+    ///
+    /// Returns `false` if no pong is pending or the receive time precedes the send time.
+    pub fn complete_pong(&mut self, client_receive: u64) -> bool {
+        match self.pending_pong.take() {
+            Some((client_send, server_time)) if client_receive >= client_send => {
+                self.update_clock_offset(client_send, server_time, server_time, client_receive);
+                true
+            }
+            _ => false,
+        }
+    }
+
     /// Check if the connection should be considered stale.
     pub fn is_stale(&self, timeout: std::time::Duration) -> bool {
         Instant::now().duration_since(self.last_ping) > timeout
@@ -83,14 +127,115 @@ impl ConnectionState {
         self.last_ping = Instant::now();
     }
 
-    /// Convert a client timestamp to server time using the clock offset.
+    /// Convert a client timestamp to server time.
+    ///
+    /// Uses the drift-corrected estimate once ping/pong samples exist, and
+    /// the fixed `clock_offset` otherwise. Saturates at zero for client times
+    /// that precede server start.
     pub fn client_to_server_time(&self, client_time: u64) -> u64 {
-        (client_time as i64 - self.clock_offset) as u64
+        if self.clock.is_synced() {
+            return self.clock.client_to_server_time(client_time);
+        }
+        (client_time as i64).saturating_add(self.clock_offset).max(0) as u64
     }
 
-    /// Convert a server timestamp to client time using the clock offset.
+    /// Convert a server timestamp to client time.
     pub fn server_to_client_time(&self, server_time: u64) -> u64 {
-        (server_time as i64 + self.clock_offset) as u64
+        if self.clock.is_synced() {
+            return self.clock.server_to_client_time(server_time);
+        }
+        (server_time as i64).saturating_sub(self.clock_offset).max(0) as u64
+    }
+}
+
+/// Registry of connection state, split into independently locked shards.
+///
+/// Connections are assigned to a shard by their `NodeId`, so per-client
+/// updates (latency, clock offset) only contend with clients that hash to
+/// the same shard.
+pub struct ConnectionRegistry {
+    shards: Box<[RwLock<HashMap<NodeId, ConnectionState>>]>,
+}
+
+impl ConnectionRegistry {
+    /// Create a registry with the given number of shards.
+    ///
+    /// `shard_count` is clamped to at least one shard.
+    pub fn new(shard_count: usize) -> Self {
+        let shards = (0..shard_count.max(1)).map(|_| RwLock::new(HashMap::new())).collect();
+        Self { shards }
+    }
+
+    /// Get the number of shards.
+    pub fn shard_count(&self) -> usize {
+        self.shards.len()
+    }
+
+    /// Allocate a unique `NodeId` and register a new connection under it.
+    ///
+    /// The uniqueness check and insertion happen under the same shard lock,
+    /// so concurrent registrations can never hand out the same ID.
+    pub async fn register(&self, clock_micros: u64, room_code: String, client_name: Option<String>) -> NodeId {
+        loop {
+            let candidate = NodeId::generate_with_entropy(clock_micros);
+            let mut shard = self.shard(&candidate).write().await;
+            if let Entry::Vacant(entry) = shard.entry(candidate) {
+                entry.insert(ConnectionState::new(candidate, room_code, client_name));
+                return candidate;
+            }
+        }
+    }
+
+    /// Insert or replace the state for a connection.
+    pub async fn insert(&self, state: ConnectionState) {
+        self.shard(&state.node_id).write().await.insert(state.node_id, state);
+    }
+
+    /// Remove a connection, returning its last known state.
+    pub async fn remove(&self, node_id: &NodeId) -> Option<ConnectionState> {
+        self.shard(node_id).write().await.remove(node_id)
+    }
+
+    /// Check if a connection is registered.
+    pub async fn contains(&self, node_id: &NodeId) -> bool {
+        self.shard(node_id).read().await.contains_key(node_id)
+    }
+
+    /// Get a snapshot of a connection's state.
+    pub async fn get(&self, node_id: &NodeId) -> Option<ConnectionState> {
+        self.shard(node_id).read().await.get(node_id).cloned()
+    }
+
+    /// Read a connection's state without cloning it.
+    ///
+    /// Returns `None` if the connection is not registered.
+    pub async fn inspect<R>(&self, node_id: &NodeId, f: impl FnOnce(&ConnectionState) -> R) -> Option<R> {
+        self.shard(node_id).read().await.get(node_id).map(f)
+    }
+
+    /// Apply `f` to a connection's state in place.
+    ///
+    /// Returns `None` if the connection is not registered.
+    pub async fn update<R>(&self, node_id: &NodeId, f: impl FnOnce(&mut ConnectionState) -> R) -> Option<R> {
+        self.shard(node_id).write().await.get_mut(node_id).map(f)
+    }
+
+    /// Get the total number of registered connections.
+    pub async fn len(&self) -> usize {
+        let mut count = 0;
+        for shard in self.shards.iter() {
+            count += shard.read().await.len();
+        }
+        count
+    }
+
+    /// Check if no connections are registered.
+    pub async fn is_empty(&self) -> bool {
+        self.len().await == 0
+    }
+
+    fn shard(&self, node_id: &NodeId) -> &RwLock<HashMap<NodeId, ConnectionState>> {
+        &self.shards[((node_id.high ^ node_id.low) % self.shards.len() as u64) as usize]
     }
 }
 
@@ -158,12 +303,66 @@ mod tests {
         state.clock_offset = 100;
 
         let server_time = state.client_to_server_time(1000);
-        assert_eq!(server_time, 900);
+        assert_eq!(server_time, 1100);
 
-        let client_time = state.server_to_client_time(900);
+        let client_time = state.server_to_client_time(1100);
         assert_eq!(client_time, 1000);
     }
 
+    #[test]
+    fn test_measured_offset_maps_client_to_server() {
+        let node_id = NodeId::from_parts(1, 2);
+        let mut state = ConnectionState::new(node_id, "123456".to_string(), None);
+
+        // Client clock is 5000us behind the server, 200us each way.
+        state.update_clock_offset(10_000, 15_200, 15_200, 10_400);
+
+        assert_eq!(state.clock_offset, 5000);
+        assert_eq!(state.client_to_server_time(12_000), 17_000);
+        assert_eq!(state.server_to_client_time(17_000), 12_000);
+    }
+
+    #[test]
+    fn test_complete_pong() {
+        let node_id = NodeId::from_parts(1, 2);
+        let mut state = ConnectionState::new(node_id, "123456".to_string(), None);
+
+        assert!(!state.complete_pong(10_400));
+        assert!(!state.clock.is_synced());
+
+        state.record_pong(10_000, 15_200);
+        assert!(state.complete_pong(10_400));
+        assert!(state.clock.is_synced());
+        assert_eq!(state.clock_offset, 5000);
+        assert_eq!(state.latency_us, 200);
+
+        // Each pong can only complete one exchange.
+        assert!(!state.complete_pong(10_800));
+    }
+
+    #[test]
+    fn test_clock_offset_filters_slow_exchange() {
+        let node_id = NodeId::from_parts(1, 2);
+        let mut state = ConnectionState::new(node_id, "123456".to_string(), None);
+
+        state.update_clock_offset(10_000, 15_200, 15_200, 10_400);
+        // Queued on the way out: 40ms forward, 200us back. Raw NTP offset would be off by ~20ms.
+        state.update_clock_offset(20_000, 65_000, 65_000, 45_200);
+
+        assert_eq!(state.client_to_server_time(30_000), 35_000);
+        assert!(state.clock_error_us() <= 200.0);
+    }
+
+    #[test]
+    fn test_complete_pong_rejects_reordered_receive() {
+        let node_id = NodeId::from_parts(1, 2);
+        let mut state = ConnectionState::new(node_id, "123456".to_string(), None);
+
+        state.record_pong(10_000, 15_200);
+        assert!(!state.complete_pong(9_000));
+        assert!(!state.clock.is_synced());
+    }
+
     #[test]
     fn test_is_stale() {
         use std::time::Duration;
@@ -173,4 +372,47 @@ mod tests {
 
         assert!(!state.is_stale(Duration::from_secs(60)));
     }
+
+    #[tokio::test]
+    async fn test_registry_register_and_remove() {
+        let registry = ConnectionRegistry::new(8);
+
+        let id = registry
+            .register(1000, "123456".to_string(), Some("phone".to_string()))
+            .await;
+        assert!(registry.contains(&id).await);
+        assert_eq!(registry.len().await, 1);
+
+        let state = registry.get(&id).await.unwrap();
+        assert_eq!(state.room_code, "123456");
+        assert_eq!(state.client_name.as_deref(), Some("phone"));
+
+        assert!(registry.remove(&id).await.is_some());
+        assert!(registry.is_empty().await);
+    }
+
+    #[tokio::test]
+    async fn test_registry_unique_ids() {
+        let registry = ConnectionRegistry::new(4);
+        let mut ids = std::collections::HashSet::new();
+
+        for _ in 0..500 {
+            ids.insert(registry.register(42, "123456".to_string(), None).await);
+        }
+
+        assert_eq!(ids.len(), 500);
+        assert_eq!(registry.len().await, 500);
+    }
+
+    #[tokio::test]
+    async fn test_registry_update() {
+        let registry = ConnectionRegistry::new(4);
+        let id = registry.register(0, "123456".to_string(), None).await;
+
+        let result = registry.update(&id, |state| state.update_latency(2000)).await;
+        assert!(result.is_some());
+        assert_eq!(registry.get(&id).await.unwrap().latency_us, 1000);
+
+        assert!(registry.update(&NodeId::from_parts(0, 0), |_| ()).await.is_none());
+    }
 }
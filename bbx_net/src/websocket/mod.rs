@@ -14,7 +14,7 @@ mod protocol;
 mod room;
 mod server;
 
-pub use connection::ConnectionState;
+pub use connection::{ConnectionRegistry, ConnectionState};
 pub use protocol::{ClientMessage, ParamState, ServerMessage};
-pub use room::{Room, RoomConfig, RoomManager};
+pub use room::{Room, RoomConfig, RoomManager, ShardedRoomManager};
 pub use server::{ServerCommand, WsServer, WsServerConfig};
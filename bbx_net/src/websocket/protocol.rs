@@ -18,7 +18,9 @@ pub enum ClientMessage {
     Parameter {
         param: String,
         value: f32,
-        /// Optional scheduled time (microseconds since session start).
+        /// Optional scheduled time on the client's clock (microseconds).
+        ///
+        /// Translated to server time using the connection's clock offset.
         #[serde(default)]
         at: Option<u64>,
     },
@@ -27,6 +29,7 @@ pub enum ClientMessage {
     #[serde(rename = "trigger")]
     Trigger {
         name: String,
+        /// Optional scheduled time on the client's clock (microseconds).
         #[serde(default)]
         at: Option<u64>,
     },
@@ -37,7 +40,13 @@ pub enum ClientMessage {
 
     /// Ping for latency measurement.
     #[serde(rename = "ping")]
-    Ping { client_time: u64 },
+    Ping {
+        client_time: u64,
+        /// Client time when the previous pong arrived, completing that
+        /// exchange so the server can estimate the clock offset.
+        #[serde(default)]
+        pong_received: Option<u64>,
+    },
 
     /// Leave current room.
     #[serde(rename = "leave")]
@@ -62,7 +71,13 @@ pub enum ServerMessage {
 
     /// Pong response.
     #[serde(rename = "pong")]
-    Pong { client_time: u64, server_time: u64 },
+    Pong {
+        client_time: u64,
+        server_time: u64,
+        /// Suggested delay before the client's next ping, in milliseconds.
+        #[serde(skip_serializing_if = "Option::is_none")]
+        ping_interval_ms: Option<u64>,
+    },
 
     /// Error notification.
     #[serde(rename = "error")]
@@ -189,8 +204,25 @@ mod tests {
         let msg: ClientMessage = serde_json::from_str(json).unwrap();
 
         match msg {
-            ClientMessage::Ping { client_time } => {
+            ClientMessage::Ping {
+                client_time,
+                pong_received,
+            } => {
                 assert_eq!(client_time, 12345);
+                assert!(pong_received.is_none());
+            }
+            _ => panic!("Expected Ping message"),
+        }
+    }
+
+    #[test]
+    fn test_client_message_ping_with_pong_received() {
+        let json = r#"{"type": "ping", "client_time": 12345, "pong_received": 12000}"#;
+        let msg: ClientMessage = serde_json::from_str(json).unwrap();
+
+        match msg {
+            ClientMessage::Ping { pong_received, .. } => {
+                assert_eq!(pong_received, Some(12000));
             }
             _ => panic!("Expected Ping message"),
         }
@@ -208,6 +240,26 @@ mod tests {
         assert!(json.contains("\"node_id\":\"abc-123\""));
     }
 
+    #[test]
+    fn test_server_message_pong() {
+        let msg = ServerMessage::Pong {
+            client_time: 100,
+            server_time: 200,
+            ping_interval_ms: None,
+        };
+        let json = serde_json::to_string(&msg).unwrap();
+        assert!(json.contains("\"type\":\"pong\""));
+        assert!(!json.contains("ping_interval_ms"));
+
+        let msg = ServerMessage::Pong {
+            client_time: 100,
+            server_time: 200,
+            ping_interval_ms: Some(500),
+        };
+        let json = serde_json::to_string(&msg).unwrap();
+        assert!(json.contains("\"ping_interval_ms\":500"));
+    }
+
     #[test]
     fn test_server_message_state() {
         let msg = ServerMessage::State {
@@ -2,17 +2,21 @@
 
 use std::{
     collections::HashMap,
+    sync::Mutex,
     time::{Duration, Instant},
 };
 
 use bbx_core::random::XorShiftRng;
+use tokio::sync::RwLock;
 
 use crate::{
     address::NodeId,
     error::{NetError, Result},
+    message::hash_param_name,
 };
 
 /// Room configuration.
+#[derive(Debug, Clone)]
 pub struct RoomConfig {
     /// Number of digits in room code (4-6).
     pub code_length: usize,
@@ -77,29 +81,34 @@ impl RoomManager {
 
     /// Create a new room manager with custom configuration.
     pub fn with_config(config: RoomConfig) -> Self {
-        let seed = std::time::SystemTime::now()
-            .duration_since(std::time::UNIX_EPOCH)
-            .map(|d| d.as_nanos() as u64)
-            .unwrap_or(1);
-
         Self {
             rooms: HashMap::new(),
             config,
-            rng: XorShiftRng::new(seed),
+            rng: XorShiftRng::new(time_seed()),
         }
     }
 
     /// Generate a new room code and create the room.
     pub fn create_room(&mut self) -> String {
         loop {
-            let code = self.generate_code();
-            if !self.rooms.contains_key(&code) {
-                self.rooms.insert(code.clone(), Room::new(code.clone()));
+            let code = generate_code(&mut self.rng, self.config.code_length);
+            if self.insert_room(code.clone()) {
                 return code;
             }
         }
     }
 
+    /// Create a room with an explicit code.
+    ///
+    /// Returns `false` if a room with this code already exists.
+    pub fn insert_room(&mut self, code: String) -> bool {
+        if self.rooms.contains_key(&code) {
+            return false;
+        }
+        self.rooms.insert(code.clone(), Room::new(code));
+        true
+    }
+
     /// Check if a room code is valid.
     pub fn room_exists(&self, code: &str) -> bool {
         self.rooms.contains_key(code)
@@ -183,16 +192,6 @@ impl RoomManager {
     pub fn room_count(&self) -> usize {
         self.rooms.len()
     }
-
-    fn generate_code(&mut self) -> String {
-        let mut code = String::with_capacity(self.config.code_length);
-        for _ in 0..self.config.code_length {
-            let sample = (self.rng.next_noise_sample() + 1.0) / 2.0;
-            let digit = (sample * 10.0).min(9.0) as u8;
-            code.push((b'0' + digit) as char);
-        }
-        code
-    }
 }
 
 impl Default for RoomManager {
@@ -201,6 +200,135 @@ impl Default for RoomManager {
     }
 }
 
+/// Room manager split into independently locked shards.
+///
+/// Rooms are assigned to a shard by hashing their code, so joins and leaves
+/// in different rooms never contend on the same lock. Each shard is a plain
+/// [`RoomManager`] and is only locked for the duration of a single map
+/// operation.
+pub struct ShardedRoomManager {
+    shards: Box<[RwLock<RoomManager>]>,
+    config: RoomConfig,
+    rng: Mutex<XorShiftRng>,
+}
+
+impl ShardedRoomManager {
+    /// Create a sharded room manager with default configuration.
+    pub fn new(shard_count: usize) -> Self {
+        Self::with_config(shard_count, RoomConfig::default())
+    }
+
+    /// Create a sharded room manager with custom configuration.
+    ///
+    /// `shard_count` is clamped to at least one shard.
+    pub fn with_config(shard_count: usize, config: RoomConfig) -> Self {
+        let shards = (0..shard_count.max(1))
+            .map(|_| RwLock::new(RoomManager::with_config(config.clone())))
+            .collect();
+
+        Self {
+            shards,
+            config,
+            rng: Mutex::new(XorShiftRng::new(time_seed())),
+        }
+    }
+
+    /// Get the number of shards.
+    pub fn shard_count(&self) -> usize {
+        self.shards.len()
+    }
+
+    /// Generate a new room code and create the room.
+    pub async fn create_room(&self) -> String {
+        loop {
+            let code = {
+                let mut rng = self.rng.lock().unwrap_or_else(|e| e.into_inner());
+                generate_code(&mut rng, self.config.code_length)
+            };
+            if self.shard(&code).write().await.insert_room(code.clone()) {
+                return code;
+            }
+        }
+    }
+
+    /// Check if a room code is valid.
+    pub async fn room_exists(&self, code: &str) -> bool {
+        self.shard(code).read().await.room_exists(code)
+    }
+
+    /// Get the number of clients in a room.
+    pub async fn client_count(&self, code: &str) -> Option<usize> {
+        self.shard(code).read().await.client_count(code)
+    }
+
+    /// Validate a room code and add client.
+    pub async fn join_room(&self, code: &str, node_id: NodeId, client_name: Option<String>) -> Result<()> {
+        self.shard(code).write().await.join_room(code, node_id, client_name)
+    }
+
+    /// Remove a client from their room.
+    pub async fn leave_room(&self, code: &str, node_id: NodeId) -> bool {
+        self.shard(code).write().await.leave_room(code, node_id)
+    }
+
+    /// Update client activity timestamp.
+    pub async fn update_activity(&self, code: &str, node_id: NodeId) {
+        self.shard(code).write().await.update_activity(code, node_id);
+    }
+
+    /// Get all node IDs in a room.
+    pub async fn get_room_clients(&self, code: &str) -> Vec<NodeId> {
+        self.shard(code).read().await.get_room_clients(code)
+    }
+
+    /// Close a room and return all client node IDs.
+    pub async fn close_room(&self, code: &str) -> Vec<NodeId> {
+        self.shard(code).write().await.close_room(code)
+    }
+
+    /// Clean up expired rooms across all shards.
+    ///
+    /// Returns the number of rooms removed.
+    pub async fn cleanup_expired(&self) -> usize {
+        let mut removed = 0;
+        for shard in self.shards.iter() {
+            removed += shard.write().await.cleanup_expired();
+        }
+        removed
+    }
+
+    /// Get the total number of active rooms.
+    pub async fn room_count(&self) -> usize {
+        let mut count = 0;
+        for shard in self.shards.iter() {
+            count += shard.read().await.room_count();
+        }
+        count
+    }
+
+    fn shard(&self, code: &str) -> &RwLock<RoomManager> {
+        &self.shards[hash_param_name(code) as usize % self.shards.len()]
+    }
+}
+
+fn time_seed() -> u64 {
+    std::time::SystemTime::now()
+        .duration_since(std::time::UNIX_EPOCH)
+        .map(|d| d.as_nanos() as u64)
+        .unwrap_or(1)
+        .max(1)
+}
+
+fn generate_code(rng: &mut XorShiftRng, length: usize) -> String {
+    let mut code = String::with_capacity(length);
+    for _ in 0..length {
+        let sample = (rng.next_noise_sample() + 1.0) / 2.0;
+        let digit = (sample * 10.0).min(9.0) as u8;
+        code.push((b'0' + digit) as char);
+    }
+    code
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -315,4 +443,80 @@ mod tests {
         let unique: std::collections::HashSet<_> = codes.iter().collect();
         assert_eq!(unique.len(), 100);
     }
+
+    #[test]
+    fn test_insert_room_rejects_duplicate() {
+        let mut manager = RoomManager::new();
+
+        assert!(manager.insert_room("123456".to_string()));
+        assert!(!manager.insert_room("123456".to_string()));
+        assert_eq!(manager.room_count(), 1);
+    }
+
+    #[tokio::test]
+    async fn test_sharded_create_and_join() {
+        let manager = ShardedRoomManager::new(8);
+        let code = manager.create_room().await;
+
+        assert!(manager.room_exists(&code).await);
+
+        let node_id = NodeId::from_parts(1, 2);
+        assert!(manager.join_room(&code, node_id, None).await.is_ok());
+        assert_eq!(manager.client_count(&code).await, Some(1));
+        assert!(manager.leave_room(&code, node_id).await);
+        assert_eq!(manager.client_count(&code).await, Some(0));
+    }
+
+    #[tokio::test]
+    async fn test_sharded_join_invalid_room() {
+        let manager = ShardedRoomManager::new(4);
+        let result = manager.join_room("000000", NodeId::from_parts(1, 2), None).await;
+        assert_eq!(result, Err(NetError::InvalidRoomCode));
+    }
+
+    #[tokio::test]
+    async fn test_sharded_room_capacity() {
+        let config = RoomConfig {
+            max_clients: 1,
+            ..Default::default()
+        };
+        let manager = ShardedRoomManager::with_config(4, config);
+        let code = manager.create_room().await;
+
+        assert!(manager.join_room(&code, NodeId::from_parts(1, 1), None).await.is_ok());
+        assert_eq!(
+            manager.join_room(&code, NodeId::from_parts(2, 2), None).await,
+            Err(NetError::RoomFull)
+        );
+    }
+
+    #[tokio::test]
+    async fn test_sharded_rooms_spread_across_shards() {
+        let manager = ShardedRoomManager::new(4);
+        for _ in 0..100 {
+            manager.create_room().await;
+        }
+
+        assert_eq!(manager.room_count().await, 100);
+        for shard in manager.shards.iter() {
+            assert!(shard.read().await.room_count() > 0);
+        }
+    }
+
+    #[tokio::test]
+    async fn test_sharded_close_room() {
+        let manager = ShardedRoomManager::new(4);
+        let code = manager.create_room().await;
+        manager.join_room(&code, NodeId::from_parts(7, 8), None).await.unwrap();
+
+        let clients = manager.close_room(&code).await;
+        assert_eq!(clients.len(), 1);
+        assert!(!manager.room_exists(&code).await);
+    }
+
+    #[test]
+    fn test_zero_shards_clamped() {
+        let manager = ShardedRoomManager::new(0);
+        assert_eq!(manager.shard_count(), 1);
+    }
 }
@@ -1,22 +1,31 @@
 //! WebSocket server for phone PWA connections.
 
-use std::{collections::HashMap, net::SocketAddr, sync::Arc};
+use std::{
+    net::SocketAddr,
+    sync::{
+        Arc,
+        atomic::{AtomicBool, Ordering},
+    },
+    time::Duration,
+};
 
 use tokio::{
-    net::TcpListener,
-    sync::{RwLock, broadcast, mpsc},
+    net::{TcpListener, TcpStream},
+    sync::{Semaphore, broadcast, mpsc},
+    time::MissedTickBehavior,
 };
 
 use crate::{
     address::NodeId,
     buffer::NetBufferProducer,
-    clock::ClockSync,
+    clock::{ClockSync, SyncedTimestamp},
     error::{NetError, Result},
+    feedback::{FeedbackChange, FeedbackPublisher},
     message::NetMessage,
     websocket::{
-        connection::ConnectionState,
+        connection::ConnectionRegistry,
         protocol::{ClientMessage, ParamState, ServerMessage},
-        room::RoomManager,
+        room::{RoomConfig, ShardedRoomManager},
     },
 };
 
@@ -26,12 +35,28 @@ pub struct WsServerConfig {
     pub bind_addr: SocketAddr,
     /// Maximum connections per room.
     pub max_connections_per_room: usize,
-    /// Ping interval in milliseconds.
+    /// Longest interval between client pings in milliseconds.
     pub ping_interval_ms: u64,
+    /// Shortest interval between client pings in milliseconds.
+    ///
+    /// Clients are asked to ping at this rate until their clock estimate
+    /// settles below `clock_error_target_us`.
+    pub min_ping_interval_ms: u64,
+    /// Target clock offset error in microseconds for adaptive ping rate.
+    pub clock_error_target_us: u64,
     /// Connection timeout in milliseconds.
     pub connection_timeout_ms: u64,
     /// Capacity for the state broadcast channel.
     pub broadcast_capacity: usize,
+    /// Maximum number of WebSocket handshakes in flight at once.
+    pub max_concurrent_handshakes: usize,
+    /// Time a client has to complete the WebSocket handshake in milliseconds,
+    /// counted from accept and including any wait for a handshake slot.
+    pub handshake_timeout_ms: u64,
+    /// Number of lock shards for room and connection state.
+    pub shard_count: usize,
+    /// Furthest into the future a client may schedule an event, in milliseconds.
+    pub max_schedule_ahead_ms: u64,
 }
 
 impl Default for WsServerConfig {
@@ -40,8 +65,14 @@ impl Default for WsServerConfig {
             bind_addr: "0.0.0.0:8080".parse().unwrap(),
             max_connections_per_room: 100,
             ping_interval_ms: 5000,
+            min_ping_interval_ms: 500,
+            clock_error_target_us: 250,
             connection_timeout_ms: 30000,
             broadcast_capacity: 1024,
+            max_concurrent_handshakes: 64,
+            handshake_timeout_ms: 5000,
+            shard_count: 16,
+            max_schedule_ahead_ms: 4000,
         }
     }
 }
@@ -63,16 +94,26 @@ pub enum ServerCommand {
 }
 
 /// WebSocket server for phone PWA connections.
+///
+/// The accept loop never awaits a client: each accepted socket is handed to
+/// its own task, which performs the WebSocket handshake (bounded by
+/// `max_concurrent_handshakes` and `handshake_timeout_ms`) and then services
+/// the connection. Room and connection state are sharded so concurrent joins
+/// only contend when they land on the same shard.
 pub struct WsServer {
     config: WsServerConfig,
-    room_manager: Arc<RwLock<RoomManager>>,
+    room_manager: Arc<ShardedRoomManager>,
     clock_sync: Arc<ClockSync>,
     producer: NetBufferProducer,
     state_broadcast: broadcast::Sender<ServerMessage>,
     command_rx: mpsc::Receiver<ServerCommand>,
-    connections: Arc<RwLock<HashMap<NodeId, ConnectionState>>>,
+    connections: Arc<ConnectionRegistry>,
+    handshake_permits: Arc<Semaphore>,
     message_tx: mpsc::Sender<NetMessage>,
     message_rx: mpsc::Receiver<NetMessage>,
+    feedback: Option<FeedbackPublisher>,
+    feedback_changes: Vec<FeedbackChange>,
+    feedback_resync: Arc<AtomicBool>,
 }
 
 impl WsServer {
@@ -87,19 +128,39 @@ impl WsServer {
         let (state_broadcast, _) = broadcast::channel(config.broadcast_capacity);
         let (message_tx, message_rx) = mpsc::channel(1024);
 
+        let room_config = RoomConfig {
+            max_clients: config.max_connections_per_room,
+            ..Default::default()
+        };
+
         Self {
-            config,
-            room_manager: Arc::new(RwLock::new(RoomManager::new())),
+            room_manager: Arc::new(ShardedRoomManager::with_config(config.shard_count, room_config)),
             clock_sync: Arc::new(ClockSync::new()),
             producer,
             state_broadcast,
             command_rx,
-            connections: Arc::new(RwLock::new(HashMap::new())),
+            connections: Arc::new(ConnectionRegistry::new(config.shard_count)),
+            handshake_permits: Arc::new(Semaphore::new(config.max_concurrent_handshakes.max(1))),
             message_tx,
             message_rx,
+            feedback: None,
+            feedback_changes: Vec::new(),
+            feedback_resync: Arc::new(AtomicBool::new(false)),
+            config,
         }
     }
 
+    /// Mirror engine parameter state to all clients.
+    ///
+    /// At the publisher's rate, changed values are batched into a single
+    /// `ServerMessage::State` broadcast. Clients that join or send `sync`
+    /// trigger a full resend on the next tick.
+    pub fn with_feedback(mut self, publisher: FeedbackPublisher) -> Self {
+        self.feedback_changes = Vec::with_capacity(publisher.len());
+        self.feedback = Some(publisher);
+        self
+    }
+
     /// Create a command channel pair for communicating with the server.
     pub fn command_channel() -> (mpsc::Sender<ServerCommand>, mpsc::Receiver<ServerCommand>) {
         mpsc::channel(256)
@@ -118,17 +179,28 @@ impl WsServer {
     /// Run the WebSocket server.
     ///
     /// This method runs until a shutdown command is received or an error occurs.
-    pub async fn run(mut self) -> Result<()> {
+    pub async fn run(self) -> Result<()> {
         let listener = TcpListener::bind(&self.config.bind_addr)
             .await
             .map_err(|_| NetError::ConnectionFailed)?;
 
+        self.run_with_listener(listener).await
+    }
+
+    /// Run the WebSocket server on an already bound listener.
+    ///
+    /// Useful when binding to port 0 and reading back the assigned address.
+    pub async fn run_with_listener(mut self, listener: TcpListener) -> Result<()> {
+        let feedback_interval = self.feedback.as_ref().map_or(Duration::from_secs(1), |f| f.interval());
+        let mut feedback_tick = tokio::time::interval(feedback_interval);
+        feedback_tick.set_missed_tick_behavior(MissedTickBehavior::Skip);
+
         loop {
             tokio::select! {
                 accept_result = listener.accept() => {
                     match accept_result {
                         Ok((stream, addr)) => {
-                            self.handle_connection(stream, addr).await;
+                            self.spawn_connection(stream, addr);
                         }
                         Err(_) => {
                             continue;
@@ -140,6 +212,10 @@ impl WsServer {
                     let _ = self.producer.try_send(msg);
                 }
 
+                _ = feedback_tick.tick(), if self.feedback.is_some() => {
+                    self.publish_feedback();
+                }
+
                 Some(cmd) = self.command_rx.recv() => {
                     match cmd {
                         ServerCommand::Shutdown => {
@@ -155,13 +231,13 @@ impl WsServer {
                             // Visualization broadcasts would be handled here
                         }
                         ServerCommand::CreateRoom { response } => {
-                            let code = self.room_manager.write().await.create_room();
+                            let code = self.room_manager.create_room().await;
                             let _ = response.send(code);
                         }
                         ServerCommand::CloseRoom { code } => {
-                            let clients = self.room_manager.write().await.close_room(&code);
+                            let clients = self.room_manager.close_room(&code).await;
                             for node_id in clients {
-                                self.connections.write().await.remove(&node_id);
+                                self.connections.remove(&node_id).await;
                             }
                             let _ = self.state_broadcast.send(ServerMessage::RoomClosed);
                         }
@@ -171,147 +247,267 @@ impl WsServer {
         }
     }
 
-    async fn handle_connection(&self, stream: tokio::net::TcpStream, _addr: SocketAddr) {
-        use futures_util::{SinkExt, StreamExt};
-        use tokio_tungstenite::accept_async;
+    fn publish_feedback(&mut self) {
+        let Some(feedback) = self.feedback.as_mut() else {
+            return;
+        };
+
+        if self.feedback_resync.swap(false, Ordering::Relaxed) {
+            feedback.resync();
+        }
+
+        if feedback.poll(&mut self.feedback_changes) == 0 {
+            return;
+        }
+
+        let params = self
+            .feedback_changes
+            .iter()
+            .map(|change| ParamState::new(feedback.name(change.index), change.value))
+            .collect();
+        let _ = self.state_broadcast.send(ServerMessage::State { params });
+    }
 
-        let ws_stream = match accept_async(stream).await {
-            Ok(ws) => ws,
-            Err(_) => return,
+    fn spawn_connection(&self, stream: TcpStream, _addr: SocketAddr) {
+        let _ = stream.set_nodelay(true);
+
+        let ctx = ConnectionContext {
+            room_manager: Arc::clone(&self.room_manager),
+            clock_sync: Arc::clone(&self.clock_sync),
+            connections: Arc::clone(&self.connections),
+            handshake_permits: Arc::clone(&self.handshake_permits),
+            handshake_timeout: Duration::from_millis(self.config.handshake_timeout_ms),
+            max_schedule_ahead_us: self.config.max_schedule_ahead_ms * 1000,
+            ping_policy: PingPolicy {
+                min_interval_ms: self.config.min_ping_interval_ms,
+                max_interval_ms: self.config.ping_interval_ms,
+                target_error_us: self.config.clock_error_target_us as f64,
+            },
+            state_broadcast: self.state_broadcast.clone(),
+            message_tx: self.message_tx.clone(),
+            feedback_resync: Arc::clone(&self.feedback_resync),
         };
 
-        let (mut write, mut read) = ws_stream.split();
-
-        let room_manager = Arc::clone(&self.room_manager);
-        let clock_sync = Arc::clone(&self.clock_sync);
-        let connections = Arc::clone(&self.connections);
-        let mut broadcast_rx = self.state_broadcast.subscribe();
-        let message_tx = self.message_tx.clone();
-
-        tokio::spawn(async move {
-            let mut node_id: Option<NodeId> = None;
-            let mut room_code: Option<String> = None;
-            let mut should_cleanup = true;
-
-            loop {
-                tokio::select! {
-                    msg = read.next() => {
-                        match msg {
-                            Some(Ok(tokio_tungstenite::tungstenite::Message::Text(text))) => {
-                                if let Ok(client_msg) = serde_json::from_str::<ClientMessage>(&text) {
-                                    match client_msg {
-                                        ClientMessage::Join { room_code: code, client_name } => {
-                                            let mut rm = room_manager.write().await;
-                                            let connections_read = connections.read().await;
-                                            let new_node_id = NodeId::generate_unique(
-                                                clock_sync.now().as_micros(),
-                                                |id| connections_read.contains_key(id),
-                                            );
-                                            drop(connections_read);
-
-                                            match rm.join_room(&code, new_node_id, client_name.clone()) {
-                                                Ok(()) => {
-                                                    node_id = Some(new_node_id);
-                                                    room_code = Some(code);
-
-                                                    let state = ConnectionState::new(
-                                                        new_node_id,
-                                                        room_code.clone().unwrap(),
-                                                        client_name,
-                                                    );
-                                                    connections.write().await.insert(new_node_id, state);
-
-                                                    let response = ServerMessage::Welcome {
-                                                        node_id: new_node_id.to_uuid_string(),
-                                                        server_time: clock_sync.now().as_micros(),
-                                                    };
-
-                                                    let json = serde_json::to_string(&response).unwrap();
-                                                    let _ = write.send(
-                                                        tokio_tungstenite::tungstenite::Message::Text(json)
-                                                    ).await;
-                                                }
-                                                Err(NetError::InvalidRoomCode) => {
-                                                    let response = ServerMessage::invalid_room_code();
-                                                    let json = serde_json::to_string(&response).unwrap();
-                                                    let _ = write.send(
-                                                        tokio_tungstenite::tungstenite::Message::Text(json)
-                                                    ).await;
-                                                }
-                                                Err(NetError::RoomFull) => {
-                                                    let response = ServerMessage::room_full();
-                                                    let json = serde_json::to_string(&response).unwrap();
-                                                    let _ = write.send(
-                                                        tokio_tungstenite::tungstenite::Message::Text(json)
-                                                    ).await;
-                                                }
-                                                Err(_) => {}
-                                            }
-                                        }
-                                        ClientMessage::Parameter { param, value, at: _ } => {
-                                            if let Some(nid) = node_id {
-                                                let msg = NetMessage::param_change(&param, value, nid)
-                                                    .with_timestamp(clock_sync.now());
-                                                let _ = message_tx.send(msg).await;
-                                            }
+        tokio::spawn(handle_connection(ctx, stream));
+    }
+}
+
+/// Shared server state handed to each connection task.
+struct ConnectionContext {
+    room_manager: Arc<ShardedRoomManager>,
+    clock_sync: Arc<ClockSync>,
+    connections: Arc<ConnectionRegistry>,
+    handshake_permits: Arc<Semaphore>,
+    handshake_timeout: Duration,
+    max_schedule_ahead_us: u64,
+    ping_policy: PingPolicy,
+    state_broadcast: broadcast::Sender<ServerMessage>,
+    message_tx: mpsc::Sender<NetMessage>,
+    feedback_resync: Arc<AtomicBool>,
+}
+
+/// Bounds for the ping interval suggested to each client.
+#[derive(Clone, Copy)]
+struct PingPolicy {
+    min_interval_ms: u64,
+    max_interval_ms: u64,
+    target_error_us: f64,
+}
+
+async fn handle_connection(ctx: ConnectionContext, stream: TcpStream) {
+    use futures_util::{SinkExt, StreamExt};
+    use tokio_tungstenite::accept_async;
+
+    let ConnectionContext {
+        room_manager,
+        clock_sync,
+        connections,
+        handshake_permits,
+        handshake_timeout,
+        max_schedule_ahead_us,
+        ping_policy,
+        state_broadcast,
+        message_tx,
+        feedback_resync,
+    } = ctx;
+
+    // The permit only covers the handshake; established connections do not
+    // count against the limit. The timeout starts at accept, so a client
+    // queued behind other handshakes can't hold its socket open forever.
+    let handshake = async {
+        let _permit = handshake_permits.acquire().await.ok()?;
+        accept_async(stream).await.ok()
+    };
+    let Ok(Some(ws_stream)) = tokio::time::timeout(handshake_timeout, handshake).await else {
+        return;
+    };
+
+    let (mut write, mut read) = ws_stream.split();
+    let mut broadcast_rx = state_broadcast.subscribe();
+
+    let mut node_id: Option<NodeId> = None;
+    let mut room_code: Option<String> = None;
+    let mut should_cleanup = true;
+
+    loop {
+        tokio::select! {
+            msg = read.next() => {
+                match msg {
+                    Some(Ok(tokio_tungstenite::tungstenite::Message::Text(text))) => {
+                        if let Ok(client_msg) = serde_json::from_str::<ClientMessage>(&text) {
+                            match client_msg {
+                                ClientMessage::Join { room_code: code, client_name } => {
+                                    let new_node_id = connections
+                                        .register(clock_sync.now().as_micros(), code.clone(), client_name.clone())
+                                        .await;
+
+                                    let response = match room_manager.join_room(&code, new_node_id, client_name).await {
+                                        Ok(()) => {
+                                            node_id = Some(new_node_id);
+                                            room_code = Some(code);
+                                            feedback_resync.store(true, Ordering::Relaxed);
+
+                                            Some(ServerMessage::Welcome {
+                                                node_id: new_node_id.to_uuid_string(),
+                                                server_time: clock_sync.now().as_micros(),
+                                            })
                                         }
-                                        ClientMessage::Trigger { name, at: _ } => {
-                                            if let Some(nid) = node_id {
-                                                let msg = if let Some((x, y)) = parse_trigger_coordinates(&name) {
-                                                    NetMessage::trigger_with_coordinates(&name, x, y, nid)
-                                                } else {
-                                                    NetMessage::trigger(&name, nid)
-                                                };
-                                                let msg = msg.with_timestamp(clock_sync.now());
-                                                let _ = message_tx.send(msg).await;
+                                        Err(err) => {
+                                            connections.remove(&new_node_id).await;
+                                            match err {
+                                                NetError::InvalidRoomCode => Some(ServerMessage::invalid_room_code()),
+                                                NetError::RoomFull => Some(ServerMessage::room_full()),
+                                                _ => None,
                                             }
                                         }
-                                        ClientMessage::Ping { client_time } => {
-                                            let server_time = clock_sync.now().as_micros();
-                                            let response = ServerMessage::Pong {
-                                                client_time,
-                                                server_time,
-                                            };
-                                            let json = serde_json::to_string(&response).unwrap();
-                                            let _ = write.send(
-                                                tokio_tungstenite::tungstenite::Message::Text(json)
-                                            ).await;
-                                        }
-                                        ClientMessage::Leave => {
-                                            if let (Some(nid), Some(code)) = (node_id, &room_code) {
-                                                room_manager.write().await.leave_room(code, nid);
-                                                connections.write().await.remove(&nid);
+                                    };
+
+                                    if let Some(response) = response {
+                                        let json = serde_json::to_string(&response).unwrap();
+                                        let _ = write.send(
+                                            tokio_tungstenite::tungstenite::Message::Text(json)
+                                        ).await;
+                                    }
+                                }
+                                ClientMessage::Parameter { param, value, at } => {
+                                    if let Some(nid) = node_id {
+                                        let timestamp = scheduled_timestamp(
+                                            &connections, &nid, at, clock_sync.now(), max_schedule_ahead_us
+                                        ).await;
+                                        let msg = NetMessage::param_change(&param, value, nid)
+                                            .with_timestamp(timestamp);
+                                        let _ = message_tx.send(msg).await;
+                                    }
+                                }
+                                ClientMessage::Trigger { name, at } => {
+                                    if let Some(nid) = node_id {
+                                        let timestamp = scheduled_timestamp(
+                                            &connections, &nid, at, clock_sync.now(), max_schedule_ahead_us
+                                        ).await;
+                                        let msg = if let Some((x, y)) = parse_trigger_coordinates(&name) {
+                                            NetMessage::trigger_with_coordinates(&name, x, y, nid)
+                                        } else {
+                                            NetMessage::trigger(&name, nid)
+                                        };
+                                        let msg = msg.with_timestamp(timestamp);
+                                        let _ = message_tx.send(msg).await;
+                                    }
+                                }
+                                ClientMessage::Ping { client_time, pong_received } => {
+                                    let server_time = clock_sync.now().as_micros();
+                                    let ping_interval_ms = match node_id {
+                                        Some(nid) => connections.update(&nid, |state| {
+                                            if let Some(received) = pong_received {
+                                                state.complete_pong(received);
                                             }
-                                            should_cleanup = false;
-                                            break;
-                                        }
-                                        _ => {}
+                                            state.record_pong(client_time, server_time);
+                                            state.clock.suggested_ping_interval_ms(
+                                                ping_policy.target_error_us,
+                                                ping_policy.min_interval_ms,
+                                                ping_policy.max_interval_ms,
+                                            )
+                                        }).await,
+                                        None => None,
+                                    };
+                                    let response = ServerMessage::Pong {
+                                        client_time,
+                                        server_time,
+                                        ping_interval_ms,
+                                    };
+                                    let json = serde_json::to_string(&response).unwrap();
+                                    let _ = write.send(
+                                        tokio_tungstenite::tungstenite::Message::Text(json)
+                                    ).await;
+                                }
+                                ClientMessage::Leave => {
+                                    if let (Some(nid), Some(code)) = (node_id, &room_code) {
+                                        room_manager.leave_room(code, nid).await;
+                                        connections.remove(&nid).await;
+                                    }
+                                    should_cleanup = false;
+                                    break;
+                                }
+                                ClientMessage::Sync => {
+                                    if node_id.is_some() {
+                                        feedback_resync.store(true, Ordering::Relaxed);
                                     }
                                 }
                             }
-                            Some(Ok(tokio_tungstenite::tungstenite::Message::Close(_))) | None => {
-                                break;
-                            }
-                            _ => {}
                         }
                     }
-
-                    Ok(broadcast_msg) = broadcast_rx.recv() => {
-                        if node_id.is_some() {
-                            let json = serde_json::to_string(&broadcast_msg).unwrap();
-                            let _ = write.send(
-                                tokio_tungstenite::tungstenite::Message::Text(json)
-                            ).await;
-                        }
+                    Some(Ok(tokio_tungstenite::tungstenite::Message::Close(_))) | None => {
+                        break;
                     }
+                    _ => {}
                 }
             }
 
-            if should_cleanup && let (Some(nid), Some(code)) = (node_id, room_code) {
-                room_manager.write().await.leave_room(&code, nid);
-                connections.write().await.remove(&nid);
+            Ok(broadcast_msg) = broadcast_rx.recv() => {
+                if node_id.is_some() {
+                    let json = serde_json::to_string(&broadcast_msg).unwrap();
+                    let _ = write.send(
+                        tokio_tungstenite::tungstenite::Message::Text(json)
+                    ).await;
+                }
             }
-        });
+        }
+    }
+
+    if should_cleanup && let (Some(nid), Some(code)) = (node_id, room_code) {
+        room_manager.leave_room(&code, nid).await;
+        connections.remove(&nid).await;
+    }
+}
+
+/// Translate a client-scheduled `at` time into a server timestamp.
+///
+/// Unscheduled events, and events from clients without a completed clock
+/// exchange, are stamped with `now`. Late events are clamped to `now` and
+/// events beyond `max_ahead_us` are clamped to that horizon.
+async fn scheduled_timestamp(
+    connections: &ConnectionRegistry,
+    node_id: &NodeId,
+    at: Option<u64>,
+    now: SyncedTimestamp,
+    max_ahead_us: u64,
+) -> SyncedTimestamp {
+    let Some(client_time) = at else {
+        return now;
+    };
+
+    let server_time = connections
+        .inspect(node_id, |state| {
+            state
+                .clock
+                .is_synced()
+                .then(|| state.client_to_server_time(client_time))
+        })
+        .await
+        .flatten();
+
+    match server_time {
+        Some(t) => SyncedTimestamp::from_micros(t.clamp(now.as_micros(), now.as_micros() + max_ahead_us)),
+        None => now,
     }
 }
 
@@ -342,6 +538,8 @@ mod tests {
         let config = WsServerConfig::default();
         assert_eq!(config.bind_addr.port(), 8080);
         assert_eq!(config.max_connections_per_room, 100);
+        assert_eq!(config.max_concurrent_handshakes, 64);
+        assert_eq!(config.shard_count, 16);
     }
 
     #[test]
@@ -360,4 +558,278 @@ mod tests {
         let (tx, _rx) = WsServer::command_channel();
         assert!(!tx.is_closed());
     }
+
+    async fn start_server(config: WsServerConfig) -> (SocketAddr, mpsc::Sender<ServerCommand>) {
+        let (addr, command_tx, _consumer) = start_server_with_consumer(config).await;
+        (addr, command_tx)
+    }
+
+    async fn start_server_with_consumer(
+        config: WsServerConfig,
+    ) -> (
+        SocketAddr,
+        mpsc::Sender<ServerCommand>,
+        crate::buffer::NetBufferConsumer,
+    ) {
+        let listener = TcpListener::bind("127.0.0.1:0").await.unwrap();
+        let addr = listener.local_addr().unwrap();
+        let (producer, consumer) = crate::buffer::net_buffer(64);
+        let (command_tx, command_rx) = WsServer::command_channel();
+
+        let server = WsServer::new(config, producer, command_rx);
+        tokio::spawn(server.run_with_listener(listener));
+
+        (addr, command_tx, consumer)
+    }
+
+    async fn create_room(command_tx: &mpsc::Sender<ServerCommand>) -> String {
+        let (response, rx) = tokio::sync::oneshot::channel();
+        command_tx.send(ServerCommand::CreateRoom { response }).await.unwrap();
+        rx.await.unwrap()
+    }
+
+    type ClientStream = tokio_tungstenite::WebSocketStream<tokio_tungstenite::MaybeTlsStream<TcpStream>>;
+
+    /// Join `code` and return the `type` of the server's first reply along
+    /// with the still-open client stream.
+    async fn join(addr: SocketAddr, code: &str) -> (String, ClientStream) {
+        use futures_util::{SinkExt, StreamExt};
+        use tokio_tungstenite::tungstenite::Message;
+
+        let url = format!("ws://{addr}");
+        let (mut ws, _) = tokio_tungstenite::connect_async(url.as_str()).await.unwrap();
+        let join = format!(r#"{{"type":"join","room_code":"{code}"}}"#);
+        ws.send(Message::Text(join)).await.unwrap();
+
+        loop {
+            if let Some(Ok(Message::Text(text))) = ws.next().await {
+                let reply: serde_json::Value = serde_json::from_str(&text).unwrap();
+                return (reply["type"].as_str().unwrap().to_string(), ws);
+            }
+        }
+    }
+
+    #[tokio::test(flavor = "multi_thread", worker_threads = 2)]
+    async fn test_concurrent_joins() {
+        let (addr, command_tx) = start_server(WsServerConfig::default()).await;
+        let code = create_room(&command_tx).await;
+
+        let handles: Vec<_> = (0..50)
+            .map(|_| {
+                let code = code.clone();
+                tokio::spawn(async move { join(addr, &code).await })
+            })
+            .collect();
+
+        for handle in handles {
+            assert_eq!(handle.await.unwrap().0, "welcome");
+        }
+
+        command_tx.send(ServerCommand::Shutdown).await.unwrap();
+    }
+
+    #[tokio::test]
+    async fn test_stalled_client_does_not_block_accept() {
+        let (addr, command_tx) = start_server(WsServerConfig::default()).await;
+        let code = create_room(&command_tx).await;
+
+        // Opens a TCP connection but never sends a handshake.
+        let _stalled = TcpStream::connect(addr).await.unwrap();
+
+        let (response, _ws) = tokio::time::timeout(Duration::from_secs(2), join(addr, &code))
+            .await
+            .expect("join should not wait on the stalled client");
+        assert_eq!(response, "welcome");
+
+        command_tx.send(ServerCommand::Shutdown).await.unwrap();
+    }
+
+    #[tokio::test]
+    async fn test_handshake_timeout_includes_wait_for_permit() {
+        use tokio::io::AsyncReadExt;
+
+        let config = WsServerConfig {
+            max_concurrent_handshakes: 1,
+            handshake_timeout_ms: 300,
+            ..Default::default()
+        };
+        let (addr, command_tx) = start_server(config).await;
+
+        // The first stalled client holds the only permit until it times out;
+        // the second queues behind it and must time out at the same time.
+        let _first = TcpStream::connect(addr).await.unwrap();
+        let mut queued = TcpStream::connect(addr).await.unwrap();
+        let started = tokio::time::Instant::now();
+
+        let mut buf = [0u8; 16];
+        let read = tokio::time::timeout(Duration::from_secs(2), queued.read(&mut buf))
+            .await
+            .expect("queued client should be closed");
+        assert!(matches!(read, Ok(0) | Err(_)));
+        assert!(
+            started.elapsed() < Duration::from_millis(500),
+            "closed after {:?}",
+            started.elapsed()
+        );
+
+        command_tx.send(ServerCommand::Shutdown).await.unwrap();
+    }
+
+    #[tokio::test]
+    async fn test_room_capacity_from_config() {
+        let config = WsServerConfig {
+            max_connections_per_room: 1,
+            ..Default::default()
+        };
+        let (addr, command_tx) = start_server(config).await;
+        let code = create_room(&command_tx).await;
+
+        let (first, _ws) = join(addr, &code).await;
+        assert_eq!(first, "welcome");
+        assert_eq!(join(addr, &code).await.0, "error");
+
+        command_tx.send(ServerCommand::Shutdown).await.unwrap();
+    }
+
+    #[tokio::test]
+    async fn test_scheduled_timestamp_unscheduled_is_now() {
+        let registry = ConnectionRegistry::new(1);
+        let id = registry.register(0, "123456".to_string(), None).await;
+        let now = SyncedTimestamp::from_micros(50_000);
+
+        assert_eq!(scheduled_timestamp(&registry, &id, None, now, 1_000_000).await, now);
+    }
+
+    #[tokio::test]
+    async fn test_scheduled_timestamp_requires_clock_sync() {
+        let registry = ConnectionRegistry::new(1);
+        let id = registry.register(0, "123456".to_string(), None).await;
+        let now = SyncedTimestamp::from_micros(50_000);
+
+        assert_eq!(
+            scheduled_timestamp(&registry, &id, Some(60_000), now, 1_000_000).await,
+            now
+        );
+    }
+
+    #[tokio::test]
+    async fn test_scheduled_timestamp_translates_and_clamps() {
+        let registry = ConnectionRegistry::new(1);
+        let id = registry.register(0, "123456".to_string(), None).await;
+        registry
+            .update(&id, |state| {
+                state.record_pong(10_000, 15_200);
+                state.complete_pong(10_400);
+            })
+            .await;
+        let now = SyncedTimestamp::from_micros(20_000);
+
+        // Client time 20_000 is server time 25_000.
+        let t = scheduled_timestamp(&registry, &id, Some(20_000), now, 1_000_000).await;
+        assert_eq!(t.as_micros(), 25_000);
+
+        // Already late: play immediately.
+        let t = scheduled_timestamp(&registry, &id, Some(1_000), now, 1_000_000).await;
+        assert_eq!(t, now);
+
+        // Too far ahead: clamp to the horizon.
+        let t = scheduled_timestamp(&registry, &id, Some(10_000_000), now, 1_000_000).await;
+        assert_eq!(t.as_micros(), 1_020_000);
+    }
+
+    #[tokio::test]
+    async fn test_scheduled_parameter_end_to_end() {
+        use futures_util::SinkExt;
+        use tokio_tungstenite::tungstenite::Message;
+
+        let (addr, command_tx, mut consumer) = start_server_with_consumer(WsServerConfig::default()).await;
+        let code = create_room(&command_tx).await;
+        let (_, mut ws) = join(addr, &code).await;
+
+        // Client clock runs 1s ahead of the server's (which starts near zero).
+        let client_clock = 1_000_000_000u64;
+        ws.send(Message::Text(format!(
+            r#"{{"type":"ping","client_time":{client_time}}}"#,
+            client_time = client_clock
+        )))
+        .await
+        .unwrap();
+        let pong = next_json(&mut ws).await;
+        let server_time = pong["server_time"].as_u64().unwrap();
+        let received = client_clock + 200;
+
+        ws.send(Message::Text(format!(
+            r#"{{"type":"ping","client_time":{received},"pong_received":{received}}}"#
+        )))
+        .await
+        .unwrap();
+        next_json(&mut ws).await;
+
+        // Offset is server - client, measured from the completed exchange.
+        let offset = ((server_time as i64 - client_clock as i64) + (server_time as i64 - received as i64)) / 2;
+        let at = received + 500_000;
+        ws.send(Message::Text(format!(
+            r#"{{"type":"param","param":"gain","value":0.5,"at":{at}}}"#
+        )))
+        .await
+        .unwrap();
+
+        let msg = loop {
+            if let Some(msg) = consumer.try_pop() {
+                break msg;
+            }
+            tokio::time::sleep(Duration::from_millis(1)).await;
+        };
+        assert_eq!(msg.timestamp.as_micros() as i64, at as i64 + offset);
+
+        command_tx.send(ServerCommand::Shutdown).await.unwrap();
+    }
+
+    async fn next_json(ws: &mut ClientStream) -> serde_json::Value {
+        use futures_util::StreamExt;
+        use tokio_tungstenite::tungstenite::Message;
+
+        loop {
+            if let Some(Ok(Message::Text(text))) = ws.next().await {
+                return serde_json::from_str(&text).unwrap();
+            }
+        }
+    }
+
+    #[tokio::test]
+    async fn test_feedback_batches_changes_into_state() {
+        let listener = TcpListener::bind("127.0.0.1:0").await.unwrap();
+        let addr = listener.local_addr().unwrap();
+        let (producer, _consumer) = crate::buffer::net_buffer(64);
+        let (command_tx, command_rx) = WsServer::command_channel();
+        let (writer, publisher) = crate::feedback::feedback_channel(&["gain", "cutoff", "pan"]);
+
+        let server =
+            WsServer::new(WsServerConfig::default(), producer, command_rx).with_feedback(publisher.with_rate(100.0));
+        tokio::spawn(server.run_with_listener(listener));
+
+        let code = create_room(&command_tx).await;
+        let (_, mut ws) = join(addr, &code).await;
+
+        // Joining triggers a full resync.
+        let state = next_json(&mut ws).await;
+        assert_eq!(state["type"], "state");
+        assert_eq!(state["params"].as_array().unwrap().len(), 3);
+
+        // Many writes between ticks collapse into one batched update.
+        for i in 0..1000 {
+            writer.set(1, i as f32);
+        }
+        loop {
+            let state = next_json(&mut ws).await;
+            let params = state["params"].as_array().unwrap();
+            assert_eq!(params.len(), 1);
+            assert_eq!(params[0]["name"], "cutoff");
+            if params[0]["value"] == 999.0 {
+                break;
+            }
+        }
+
+        command_tx.send(ServerCommand::Shutdown).await.unwrap();
+    }
 }
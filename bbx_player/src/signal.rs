@@ -1,15 +1,25 @@
-use std::sync::{
-    Arc,
-    atomic::{AtomicBool, Ordering},
+use std::{
+    ptr,
+    sync::{
+        Arc,
+        atomic::{AtomicBool, Ordering},
+    },
 };
 
-use bbx_core::StackVec;
 use bbx_dsp::{
     buffer::{AudioBuffer, Buffer},
     graph::{Graph, MAX_BLOCK_OUTPUTS},
     sample::Sample,
 };
 
+/// Output slices handed to the graph, sized to the channel count once.
+struct OutputTable<S>(Box<[*mut [S]]>);
+
+// SAFETY: The pointers are only dereferenced inside `Signal::process`, after
+// being repointed at the signal's own output buffers, so moving the table to
+// another thread moves nothing it borrows.
+unsafe impl<S: Send> Send for OutputTable<S> {}
+
 /// Wraps a DSP graph as an iterator of interleaved samples.
 ///
 /// The iterator yields samples in interleaved format (L, R, L, R, ...)
@@ -17,6 +27,7 @@ use bbx_dsp::{
 pub struct Signal<S: Sample> {
     graph: Graph<S>,
     output_buffers: Vec<AudioBuffer<S>>,
+    output_table: OutputTable<S>,
     sample_rate: u32,
     num_channels: usize,
     buffer_size: usize,
@@ -40,6 +51,9 @@ impl<S: Sample> Signal<S> {
         Self {
             graph,
             output_buffers,
+            output_table: OutputTable(
+                vec![ptr::slice_from_raw_parts_mut(ptr::null_mut(), 0); channels].into_boxed_slice(),
+            ),
             channel_index: 0,
             sample_index: 0,
             num_channels: channels,
@@ -67,11 +81,14 @@ impl<S: Sample> Signal<S> {
                 self.num_channels,
                 MAX_BLOCK_OUTPUTS
             );
-            let mut output_refs: StackVec<&mut [S], MAX_BLOCK_OUTPUTS> = StackVec::new();
-            for buf in self.output_buffers.iter_mut() {
-                let _ = output_refs.push(buf.as_mut_slice());
+            for (slot, buf) in self.output_table.0.iter_mut().zip(&mut self.output_buffers) {
+                *slot = ptr::from_mut(buf.as_mut_slice());
             }
-            self.graph.process_buffers(output_refs.as_mut_slice());
+            // SAFETY: Each entry was just pointed at a distinct buffer owned by
+            // `self`, which outlives this call, and `*mut [S]` has the same
+            // layout as `&mut [S]`.
+            let outputs = unsafe { &mut *(ptr::from_mut(&mut *self.output_table.0) as *mut [&mut [S]]) };
+            self.graph.process_buffers(outputs);
         }
 
         // SAFETY: Bounds guaranteed by construction:
@@ -0,0 +1,263 @@
+//! FFI benchmarks driven by the C++ host simulator.
+//!
+//! The simulator (`host_sim/host_sim.cpp`, built by `build.rs` with the
+//! `host-sim` feature) calls `bbx_graph_process` through the `bbx::Graph`
+//! C++ wrapper with JUCE-like call patterns. This file exports a small
+//! gain plugin through `bbx_plugin_ffi!` for it to drive.
+//!
+//! - `ffi_process`: Criterion timing of the C++ call loop, per pattern and buffer size, next to a `rust_direct`
+//!   baseline that calls the same DSP without the FFI layer. The difference is the per-call FFI overhead.
+//! - Host simulation: each pattern runs on a real-time priority thread and reports latency percentiles and a deadline
+//!   histogram. Set `BBX_HOST_SIM_PACED=1` to wait for each callback's deadline like an audio device instead of calling
+//!   back to back.
+//!
+//! Run with `cargo bench -p bbx_plugin --features host-sim --bench host_sim`.
+
+use std::{env, ffi::c_void, time::Duration};
+
+use bbx_bench::export_json_with;
+use bbx_plugin::{BbxError, DspContext, PluginDsp, bbx_plugin_ffi, dsp::channel::ChannelLayout, midi::MidiEvent};
+use criterion::{BenchmarkId, Criterion, Throughput, black_box};
+
+const SAMPLE_RATE: f64 = 48000.0;
+const BUFFER_SIZES: &[usize] = &[64, 256, 1024];
+const NUM_CHANNELS: usize = 2;
+const NUM_PARAMS: usize = 16;
+
+/// Process calls per pattern in the host simulation.
+const SIMULATED_CALLS: u64 = 20_000;
+
+const HISTOGRAM_BINS: usize = 40;
+
+#[repr(C)]
+#[derive(Clone, Copy)]
+#[allow(dead_code)]
+enum Pattern {
+    Steady = 0,
+    VariableBuffer = 1,
+    NullInputs = 2,
+    MidiBurst = 3,
+    Automation = 4,
+}
+
+const PATTERNS: &[(Pattern, &str)] = &[
+    (Pattern::Steady, "steady"),
+    (Pattern::VariableBuffer, "variable_buffer"),
+    (Pattern::NullInputs, "null_inputs"),
+    (Pattern::MidiBurst, "midi_burst"),
+    (Pattern::Automation, "automation"),
+];
+
+/// Mirrors `BbxHostSimConfig` in `host_sim/bbx_host_sim.h`.
+#[repr(C)]
+struct HostSimConfig {
+    sample_rate: f64,
+    buffer_size: u32,
+    num_channels: u32,
+    num_params: u32,
+    pattern: Pattern,
+    paced: bool,
+}
+
+/// Mirrors `BbxHostSimReport` in `host_sim/bbx_host_sim.h`.
+#[repr(C)]
+struct HostSimReport {
+    calls: u64,
+    deadline_misses: u64,
+    deadline_ns: f64,
+    mean_ns: f64,
+    min_ns: f64,
+    p50_ns: f64,
+    p99_ns: f64,
+    p999_ns: f64,
+    max_ns: f64,
+    histogram: [u64; HISTOGRAM_BINS],
+    realtime_priority: bool,
+}
+
+impl Default for HostSimReport {
+    fn default() -> Self {
+        // SAFETY: every field is an integer, float or bool, for which all-zero
+        // bytes are a valid value.
+        unsafe { std::mem::zeroed() }
+    }
+}
+
+unsafe extern "C" {
+    fn bbx_host_sim_create(config: *const HostSimConfig) -> *mut c_void;
+    fn bbx_host_sim_destroy(sim: *mut c_void);
+    fn bbx_host_sim_time(sim: *mut c_void, iterations: u64) -> u64;
+    fn bbx_host_sim_run(config: *const HostSimConfig, num_calls: u64, report: *mut HostSimReport) -> BbxError;
+}
+
+/// Stereo gain driven by parameter 0; counts note-ons so MIDI dispatch
+/// isn't optimized away.
+#[derive(Default)]
+pub struct BenchPlugin {
+    gain: f32,
+    notes: u32,
+}
+
+impl PluginDsp for BenchPlugin {
+    fn new() -> Self {
+        Self { gain: 1.0, notes: 0 }
+    }
+
+    fn prepare(&mut self, _context: &DspContext) {}
+
+    fn reset(&mut self) {
+        self.notes = 0;
+    }
+
+    fn apply_parameters(&mut self, params: &[f32]) {
+        if let Some(&gain) = params.first() {
+            self.gain = gain;
+        }
+    }
+
+    fn process(&mut self, inputs: &[&[f32]], outputs: &mut [&mut [f32]], midi: &[MidiEvent], _context: &DspContext) {
+        self.notes += midi.len() as u32;
+        for (input, output) in inputs.iter().zip(outputs.iter_mut()) {
+            for (out, &x) in output.iter_mut().zip(input.iter()) {
+                *out = x * self.gain;
+            }
+        }
+    }
+}
+
+bbx_plugin_ffi!(BenchPlugin);
+
+fn config(buffer_size: usize, pattern: Pattern, paced: bool) -> HostSimConfig {
+    HostSimConfig {
+        sample_rate: SAMPLE_RATE,
+        buffer_size: buffer_size as u32,
+        num_channels: NUM_CHANNELS as u32,
+        num_params: NUM_PARAMS as u32,
+        pattern,
+        paced,
+    }
+}
+
+fn bench_ffi_process(c: &mut Criterion) {
+    let mut group = c.benchmark_group("ffi_process");
+
+    for &buffer_size in BUFFER_SIZES {
+        group.throughput(Throughput::Elements(buffer_size as u64));
+
+        for &(pattern, name) in PATTERNS {
+            let config = config(buffer_size, pattern, false);
+            // SAFETY: `config` outlives the call; the handle is destroyed below.
+            let sim = unsafe { bbx_host_sim_create(&config) };
+            assert!(!sim.is_null(), "failed to create host simulator");
+
+            group.bench_function(BenchmarkId::new(name, buffer_size), |b| {
+                // SAFETY: `sim` is a live handle from `bbx_host_sim_create`.
+                b.iter_custom(|iters| Duration::from_nanos(unsafe { bbx_host_sim_time(sim, iters) }));
+            });
+
+            // SAFETY: `sim` is not used after this.
+            unsafe { bbx_host_sim_destroy(sim) };
+        }
+
+        group.bench_function(BenchmarkId::new("rust_direct", buffer_size), |b| {
+            let mut plugin = BenchPlugin::new();
+            let context = DspContext {
+                sample_rate: SAMPLE_RATE,
+                buffer_size,
+                num_channels: NUM_CHANNELS,
+                current_sample: 0,
+                is_playing: true,
+                tempo: None,
+                ppq_position: None,
+                channel_layout: ChannelLayout::default(),
+            };
+            let inputs = vec![vec![0.5f32; buffer_size]; NUM_CHANNELS];
+            let mut outputs = vec![vec![0.0f32; buffer_size]; NUM_CHANNELS];
+            let params = [0.5f32; NUM_PARAMS];
+
+            b.iter(|| {
+                let input_slices: [&[f32]; NUM_CHANNELS] = [&inputs[0], &inputs[1]];
+                let (left, right) = outputs.split_at_mut(1);
+                let mut output_slices: [&mut [f32]; NUM_CHANNELS] = [&mut left[0], &mut right[0]];
+                plugin.apply_parameters(black_box(&params));
+                plugin.process(black_box(&input_slices), black_box(&mut output_slices), &[], &context);
+            });
+        });
+    }
+
+    group.finish();
+}
+
+fn simulate_hosts() -> Vec<serde_json::Value> {
+    let paced = paced();
+    let mut results = Vec::new();
+
+    println!("\nhost simulation ({SIMULATED_CALLS} calls per pattern, paced: {paced})");
+    println!(
+        "{:<24} {:>10} {:>10} {:>10} {:>10} {:>10} {:>8}",
+        "pattern/buffer", "mean ns", "p50 ns", "p99 ns", "p99.9 ns", "max ns", "misses"
+    );
+
+    for &buffer_size in BUFFER_SIZES {
+        for &(pattern, name) in PATTERNS {
+            let config = config(buffer_size, pattern, paced);
+            let mut report = HostSimReport::default();
+            // SAFETY: both pointers are valid for the duration of the call.
+            let status = unsafe { bbx_host_sim_run(&config, SIMULATED_CALLS, &mut report) };
+            if status != BbxError::Ok {
+                eprintln!("{name}/{buffer_size}: host simulation failed ({status:?})");
+                continue;
+            }
+
+            println!(
+                "{:<24} {:>10.0} {:>10.0} {:>10.0} {:>10.0} {:>10.0} {:>8}{}",
+                format!("{name}/{buffer_size}"),
+                report.mean_ns,
+                report.p50_ns,
+                report.p99_ns,
+                report.p999_ns,
+                report.max_ns,
+                report.deadline_misses,
+                if report.realtime_priority {
+                    ""
+                } else {
+                    "  (no RT priority)"
+                },
+            );
+
+            results.push(serde_json::json!({
+                "pattern": name,
+                "buffer_size": buffer_size,
+                "calls": report.calls,
+                "deadline_ns": report.deadline_ns,
+                "deadline_misses": report.deadline_misses,
+                "mean_ns": report.mean_ns,
+                "min_ns": report.min_ns,
+                "p50_ns": report.p50_ns,
+                "p99_ns": report.p99_ns,
+                "p999_ns": report.p999_ns,
+                "max_ns": report.max_ns,
+                "histogram_bin_fraction": 0.05,
+                "histogram": report.histogram.to_vec(),
+                "realtime_priority": report.realtime_priority,
+            }));
+        }
+    }
+
+    results
+}
+
+fn paced() -> bool {
+    env::var_os("BBX_HOST_SIM_PACED").is_some_and(|v| v == "1")
+}
+
+fn main() {
+    let mut criterion = Criterion::default().configure_from_args();
+    bench_ffi_process(&mut criterion);
+    criterion.final_summary();
+
+    let mut extra = serde_json::Map::new();
+    extra.insert("paced".into(), paced().into());
+    extra.insert("simulation".into(), simulate_hosts().into());
+    export_json_with("host_sim", &["ffi_process"], cfg!(feature = "simd"), extra);
+}
@@ -16,4 +16,27 @@ fn main() {
     // Re-run if headers change
     println!("cargo:rerun-if-changed=include/bbx_ffi.h");
     println!("cargo:rerun-if-changed=include/bbx_graph.h");
+
+    #[cfg(feature = "host-sim")]
+    build_host_sim(&manifest_dir, &include_dir);
+}
+
+/// Compile the C++ host simulator used by the `host_sim` benchmark.
+///
+/// The simulator calls the `bbx_graph_*` functions, so it links only into
+/// binaries that also invoke `bbx_plugin_ffi!`.
+#[cfg(feature = "host-sim")]
+fn build_host_sim(manifest_dir: &std::path::Path, include_dir: &std::path::Path) {
+    let host_sim_dir = manifest_dir.join("host_sim");
+
+    cc::Build::new()
+        .cpp(true)
+        .std("c++17")
+        .include(include_dir)
+        .include(&host_sim_dir)
+        .file(host_sim_dir.join("host_sim.cpp"))
+        .compile("bbx_host_sim");
+
+    println!("cargo:rerun-if-changed=host_sim/host_sim.cpp");
+    println!("cargo:rerun-if-changed=host_sim/bbx_host_sim.h");
 }
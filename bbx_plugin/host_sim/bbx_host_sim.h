@@ -0,0 +1,98 @@
+/* bbx_host_sim - C++ host simulator for the bbx_plugin FFI */
+
+#ifndef BBX_HOST_SIM_H
+#define BBX_HOST_SIM_H
+
+#include "bbx_ffi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Number of histogram bins. Each bin covers 5% of the callback deadline;
+ * the last bin also counts every call at or above 195%.
+ */
+#define BBX_HOST_SIM_HISTOGRAM_BINS 40
+
+/**
+ * How the simulated host drives bbx_graph_process.
+ */
+typedef enum BbxHostSimPattern {
+    /** Fixed buffer size, constant parameters, no MIDI. */
+    BBX_HOST_SIM_STEADY = 0,
+    /** Buffer size changes every call, up to the prepared size. */
+    BBX_HOST_SIM_VARIABLE_BUFFER = 1,
+    /** Null input pointers, as for an instrument plugin. */
+    BBX_HOST_SIM_NULL_INPUTS = 2,
+    /** A burst of note on/off events every 16th call. */
+    BBX_HOST_SIM_MIDI_BURST = 3,
+    /** Every parameter changes on every call. */
+    BBX_HOST_SIM_AUTOMATION = 4,
+} BbxHostSimPattern;
+
+/**
+ * Simulated host configuration.
+ */
+typedef struct BbxHostSimConfig {
+    double sample_rate;
+    uint32_t buffer_size;
+    uint32_t num_channels;
+    uint32_t num_params;
+    BbxHostSimPattern pattern;
+    /** Wait for each callback's deadline like a real audio device. */
+    bool paced;
+} BbxHostSimConfig;
+
+/**
+ * Timing of a simulator run. Durations are per bbx_graph_process call.
+ */
+typedef struct BbxHostSimReport {
+    uint64_t calls;
+    uint64_t deadline_misses;
+    double deadline_ns;
+    double mean_ns;
+    double min_ns;
+    double p50_ns;
+    double p99_ns;
+    double p999_ns;
+    double max_ns;
+    /** Calls by duration as a fraction of the deadline, in 5% bins. */
+    uint64_t histogram[BBX_HOST_SIM_HISTOGRAM_BINS];
+    /** Whether the processing thread got real-time scheduling. */
+    bool realtime_priority;
+} BbxHostSimReport;
+
+typedef struct BbxHostSim BbxHostSim;
+
+/**
+ * Create a host with its own graph, buffers, parameters and MIDI events.
+ *
+ * @return Host handle, or NULL if the graph could not be created or prepared.
+ */
+BbxHostSim* bbx_host_sim_create(const BbxHostSimConfig* config);
+
+/**
+ * Destroy a host (safe to call with NULL).
+ */
+void bbx_host_sim_destroy(BbxHostSim* sim);
+
+/**
+ * Make `iterations` process calls back to back on the calling thread.
+ *
+ * @return Total elapsed time in nanoseconds.
+ */
+uint64_t bbx_host_sim_time(BbxHostSim* sim, uint64_t iterations);
+
+/**
+ * Make `num_calls` process calls on a new high-priority thread, timing each.
+ *
+ * @return BBX_ERROR_OK on success, or an error code on failure.
+ */
+BbxError bbx_host_sim_run(const BbxHostSimConfig* config, uint64_t num_calls, BbxHostSimReport* report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BBX_HOST_SIM_H */
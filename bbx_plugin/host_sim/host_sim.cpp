@@ -0,0 +1,251 @@
+/* bbx_host_sim - C++ host simulator for the bbx_plugin FFI
+ *
+ * Drives bbx::Graph the way a JUCE processBlock does: preallocated channel
+ * buffers, a parameter array on every call, and MIDI events with sample
+ * offsets. Used by the host_sim benchmark in bbx_plugin.
+ */
+
+#include "bbx_host_sim.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "bbx_graph.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** Calls between MIDI bursts in BBX_HOST_SIM_MIDI_BURST. */
+constexpr uint64_t kMidiBurstInterval = 16;
+
+/** Note on/off events per burst. */
+constexpr uint32_t kMidiBurstSize = 128;
+
+/** Block sizes used by BBX_HOST_SIM_VARIABLE_BUFFER, as fractions of the prepared size. */
+constexpr double kVariableBlockFractions[] = { 1.0, 0.5, 0.0, 0.3, 0.99, 0.75 };
+
+bool SetRealtimePriority()
+{
+#if defined(_WIN32)
+    return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#else
+    sched_param param {};
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#endif
+}
+
+class HostSimulator {
+public:
+    explicit HostSimulator(const BbxHostSimConfig& config)
+        : m_config(config)
+        , m_inputs(config.num_channels, std::vector<float>(config.buffer_size))
+        , m_outputs(config.num_channels, std::vector<float>(config.buffer_size))
+        , m_params(config.num_params, 0.5f)
+    {
+        for (uint32_t ch = 0; ch < config.num_channels; ++ch) {
+            for (uint32_t i = 0; i < config.buffer_size; ++i) {
+                m_inputs[ch][i] = std::sin(static_cast<float>(i) * 0.05f);
+            }
+            m_inputPtrs.push_back(m_inputs[ch].data());
+            m_outputPtrs.push_back(m_outputs[ch].data());
+        }
+
+        m_midi.reserve(kMidiBurstSize);
+        for (uint32_t i = 0; i < kMidiBurstSize; ++i) {
+            BbxMidiEvent event {};
+            event.message.channel = 0;
+            event.message.status = (i % 2 == 0) ? BBX_MIDI_STATUS_NOTE_ON : BBX_MIDI_STATUS_NOTE_OFF;
+            event.message.data_1 = static_cast<uint8_t>(36 + (i / 2) % 48);
+            event.message.data_2 = 100;
+            event.sample_offset = i * config.buffer_size / kMidiBurstSize;
+            m_midi.push_back(event);
+        }
+    }
+
+    bool Prepare()
+    {
+        return m_graph.IsValid()
+            && m_graph.Prepare(m_config.sample_rate, m_config.buffer_size, m_config.num_channels) == BBX_ERROR_OK;
+    }
+
+    double DeadlineNs() const { return 1e9 * m_config.buffer_size / m_config.sample_rate; }
+
+    void ProcessBlock()
+    {
+        uint32_t numSamples = m_config.buffer_size;
+        const float* const* inputs = m_inputPtrs.data();
+        const BbxMidiEvent* midi = nullptr;
+        uint32_t numMidi = 0;
+
+        switch (m_config.pattern) {
+        case BBX_HOST_SIM_STEADY:
+            break;
+        case BBX_HOST_SIM_VARIABLE_BUFFER: {
+            constexpr size_t count = sizeof(kVariableBlockFractions) / sizeof(kVariableBlockFractions[0]);
+            double fraction = kVariableBlockFractions[m_callIndex % count];
+            numSamples = std::max<uint32_t>(1, static_cast<uint32_t>(fraction * m_config.buffer_size));
+            break;
+        }
+        case BBX_HOST_SIM_NULL_INPUTS:
+            inputs = nullptr;
+            break;
+        case BBX_HOST_SIM_MIDI_BURST:
+            if (m_callIndex % kMidiBurstInterval == 0) {
+                midi = m_midi.data();
+                numMidi = static_cast<uint32_t>(m_midi.size());
+            }
+            break;
+        case BBX_HOST_SIM_AUTOMATION:
+            for (size_t i = 0; i < m_params.size(); ++i) {
+                m_params[i] = static_cast<float>((m_callIndex + i) % 128) / 127.0f;
+            }
+            break;
+        }
+
+        m_graph.Process(inputs,
+            m_outputPtrs.data(),
+            m_config.num_channels,
+            numSamples,
+            m_params.data(),
+            static_cast<uint32_t>(m_params.size()),
+            midi,
+            numMidi);
+        ++m_callIndex;
+    }
+
+private:
+    BbxHostSimConfig m_config;
+    bbx::Graph m_graph;
+    std::vector<std::vector<float>> m_inputs;
+    std::vector<std::vector<float>> m_outputs;
+    std::vector<const float*> m_inputPtrs;
+    std::vector<float*> m_outputPtrs;
+    std::vector<float> m_params;
+    std::vector<BbxMidiEvent> m_midi;
+    uint64_t m_callIndex { 0 };
+};
+
+double Percentile(const std::vector<double>& sorted, double fraction)
+{
+    size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+void Summarize(std::vector<double>& durations, double deadlineNs, BbxHostSimReport* report)
+{
+    *report = BbxHostSimReport {};
+    report->calls = durations.size();
+    report->deadline_ns = deadlineNs;
+    if (durations.empty()) {
+        return;
+    }
+
+    double total = 0.0;
+    for (double ns : durations) {
+        total += ns;
+        if (ns > deadlineNs) {
+            ++report->deadline_misses;
+        }
+        size_t bin = static_cast<size_t>(ns / deadlineNs * 20.0);
+        ++report->histogram[std::min<size_t>(bin, BBX_HOST_SIM_HISTOGRAM_BINS - 1)];
+    }
+
+    std::sort(durations.begin(), durations.end());
+    report->mean_ns = total / static_cast<double>(durations.size());
+    report->min_ns = durations.front();
+    report->p50_ns = Percentile(durations, 0.5);
+    report->p99_ns = Percentile(durations, 0.99);
+    report->p999_ns = Percentile(durations, 0.999);
+    report->max_ns = durations.back();
+}
+
+} // namespace
+
+struct BbxHostSim {
+    HostSimulator host;
+};
+
+extern "C" {
+
+BbxHostSim* bbx_host_sim_create(const BbxHostSimConfig* config)
+{
+    if (!config || config->buffer_size == 0 || config->num_channels == 0) {
+        return nullptr;
+    }
+    auto* sim = new (std::nothrow) BbxHostSim { HostSimulator(*config) };
+    if (sim && !sim->host.Prepare()) {
+        delete sim;
+        return nullptr;
+    }
+    return sim;
+}
+
+void bbx_host_sim_destroy(BbxHostSim* sim)
+{
+    delete sim;
+}
+
+uint64_t bbx_host_sim_time(BbxHostSim* sim, uint64_t iterations)
+{
+    if (!sim) {
+        return 0;
+    }
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        sim->host.ProcessBlock();
+    }
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+BbxError bbx_host_sim_run(const BbxHostSimConfig* config, uint64_t num_calls, BbxHostSimReport* report)
+{
+    if (!config || !report) {
+        return BBX_ERROR_NULL_POINTER;
+    }
+    BbxHostSim* sim = bbx_host_sim_create(config);
+    if (!sim) {
+        return BBX_ERROR_INVALID_PARAMETER;
+    }
+
+    // Allocate before the audio thread starts so it never touches the heap.
+    std::vector<double> durations(num_calls);
+    bool realtime = false;
+    double deadlineNs = sim->host.DeadlineNs();
+
+    std::thread audioThread([&] {
+        realtime = SetRealtimePriority();
+        auto period = std::chrono::nanoseconds(static_cast<int64_t>(deadlineNs));
+        auto nextCallback = Clock::now();
+
+        for (uint64_t i = 0; i < num_calls; ++i) {
+            if (config->paced) {
+                std::this_thread::sleep_until(nextCallback);
+                nextCallback += period;
+            }
+            auto start = Clock::now();
+            sim->host.ProcessBlock();
+            durations[i] = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+    });
+    audioThread.join();
+    bbx_host_sim_destroy(sim);
+
+    Summarize(durations, deadlineNs, report);
+    report->realtime_priority = realtime;
+    return BBX_ERROR_OK;
+}
+
+} // extern "C"
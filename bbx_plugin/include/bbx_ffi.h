@@ -64,6 +64,27 @@ typedef struct BbxMidiEvent {
     uint32_t sample_offset;
 } BbxMidiEvent;
 
+/**
+ * Latest measurement of a tapped block output.
+ */
+typedef struct BbxTapReading {
+    float peak;       /* Peak magnitude over the last processed buffer */
+    float rms;        /* RMS level over the last processed buffer */
+    uint64_t clips;   /* Samples above full scale since the tap was enabled */
+    uint64_t updates; /* Buffers measured since the tap was enabled */
+} BbxTapReading;
+
+/**
+ * Memory held by a plugin graph, in bytes.
+ */
+typedef struct BbxMemoryUsage {
+    uint64_t total;   /* Everything below combined */
+    uint64_t buffers; /* Audio buffers for block outputs */
+    uint64_t state;   /* Block state, including heap storage each block owns */
+    uint64_t shared;  /* Data blocks share with other owners, e.g. decoded audio files */
+    uint64_t graph;   /* Graph bookkeeping and the handle itself */
+} BbxMemoryUsage;
+
 /* ============================================================================
  * Lifecycle Functions
  * ============================================================================ */
@@ -131,6 +152,88 @@ void bbx_graph_process(BbxGraph* handle,
                        const BbxMidiEvent* midi_events,
                        uint32_t num_midi_events);
 
+/* ============================================================================
+ * Metering Functions
+ * ============================================================================ */
+
+/**
+ * Switch the metering tap on a block output on or off.
+ *
+ * Taps are only available when the plugin's DSP exposes them through
+ * PluginDsp::meter_taps. Safe to call from any thread while processing,
+ * like bbx_graph_read_tap.
+ *
+ * @param handle Effects chain handle.
+ * @param block_id Block ID in the plugin's graph.
+ * @param output Output port index on the block.
+ * @param enabled Whether the tap should measure.
+ * @return BBX_ERROR_OK on success, or BBX_ERROR_INVALID_PARAMETER if the
+ *         output doesn't exist or the DSP exposes no taps.
+ */
+BbxError bbx_graph_set_tap(BbxGraph* handle, uint32_t block_id, uint32_t output, bool enabled);
+
+/**
+ * Read the latest measurement of a tapped block output.
+ *
+ * @param handle Effects chain handle.
+ * @param block_id Block ID in the plugin's graph.
+ * @param output Output port index on the block.
+ * @param reading Receives the measurement.
+ * @return BBX_ERROR_OK on success, or BBX_ERROR_INVALID_PARAMETER if the
+ *         tap is off or doesn't exist.
+ */
+BbxError bbx_graph_read_tap(BbxGraph* handle, uint32_t block_id, uint32_t output, BbxTapReading* reading);
+
+/* ============================================================================
+ * Memory Functions
+ * ============================================================================ */
+
+/**
+ * Report the memory held by the graph.
+ *
+ * The breakdown is only available when the plugin's DSP exposes it through
+ * PluginDsp::memory_report; otherwise only the handle is counted. The
+ * usage is a snapshot taken at creation and on each bbx_graph_prepare, so
+ * this is safe to call from any thread while processing.
+ *
+ * @param handle Effects chain handle.
+ * @param usage Receives the memory usage.
+ * @return BBX_ERROR_OK on success.
+ */
+BbxError bbx_graph_get_memory_usage(BbxGraph* handle, BbxMemoryUsage* usage);
+
+/* ============================================================================
+ * Tracing Functions
+ * ============================================================================ */
+
+/**
+ * Start writing the duration of each bbx_graph_process call to a Chrome
+ * trace file, viewable in chrome://tracing or Perfetto.
+ *
+ * Only traces when the Rust library is built with bbx_plugin's `trace`
+ * feature. Replaces any trace already running. Call from the message
+ * thread, not concurrently with bbx_graph_process.
+ *
+ * @param handle Effects chain handle.
+ * @param path UTF-8 path of the trace file to create.
+ * @param capacity Events buffered between the audio and writer threads.
+ * @return BBX_ERROR_OK on success, or BBX_ERROR_INVALID_PARAMETER if the
+ *         file can't be created, capacity is zero, or tracing isn't built in.
+ */
+BbxError bbx_graph_start_trace(BbxGraph* handle, const char* path, uint32_t capacity);
+
+/**
+ * Stop the trace started by bbx_graph_start_trace and finish its file.
+ *
+ * bbx_graph_destroy also stops a running trace. Call from the message
+ * thread, not concurrently with bbx_graph_process.
+ *
+ * @param handle Effects chain handle.
+ * @return BBX_ERROR_OK on success, or BBX_ERROR_INVALID_PARAMETER if no
+ *         trace was running or the file couldn't be written.
+ */
+BbxError bbx_graph_stop_trace(BbxGraph* handle);
+
 #ifdef __cplusplus
 }
 #endif
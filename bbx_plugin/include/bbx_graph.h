@@ -106,6 +106,85 @@ public:
         }
     }
 
+    /**
+     * Switch the metering tap on a block output on or off.
+     *
+     * @param blockId Block ID in the plugin's graph.
+     * @param output Output port index on the block.
+     * @param enabled Whether the tap should measure.
+     * @return BBX_ERROR_OK on success.
+     */
+    BbxError SetTap(uint32_t blockId, uint32_t output, bool enabled)
+    {
+        if (!m_handle) {
+            return BBX_ERROR_NULL_POINTER;
+        }
+        return bbx_graph_set_tap(m_handle, blockId, output, enabled);
+    }
+
+    /**
+     * Read the latest measurement of a tapped block output.
+     *
+     * @param blockId Block ID in the plugin's graph.
+     * @param output Output port index on the block.
+     * @param reading Receives the measurement.
+     * @return BBX_ERROR_OK on success.
+     */
+    BbxError ReadTap(uint32_t blockId, uint32_t output, BbxTapReading& reading) const
+    {
+        if (!m_handle) {
+            return BBX_ERROR_NULL_POINTER;
+        }
+        return bbx_graph_read_tap(m_handle, blockId, output, &reading);
+    }
+
+    /**
+     * Report the memory held by the graph, as of the last Prepare().
+     *
+     * Safe to call from any thread while processing.
+     *
+     * @param usage Receives the memory usage.
+     * @return BBX_ERROR_OK on success.
+     */
+    BbxError GetMemoryUsage(BbxMemoryUsage& usage) const
+    {
+        if (!m_handle) {
+            return BBX_ERROR_NULL_POINTER;
+        }
+        return bbx_graph_get_memory_usage(m_handle, &usage);
+    }
+
+    /**
+     * Start writing each Process() call to a Chrome trace file.
+     *
+     * Only traces when the library is built with the `trace` feature.
+     * Call from the message thread, not concurrently with Process().
+     *
+     * @param path UTF-8 path of the trace file to create.
+     * @param capacity Events buffered between the audio and writer threads.
+     * @return BBX_ERROR_OK on success.
+     */
+    BbxError StartTrace(const char* path, uint32_t capacity = 65536)
+    {
+        if (!m_handle) {
+            return BBX_ERROR_NULL_POINTER;
+        }
+        return bbx_graph_start_trace(m_handle, path, capacity);
+    }
+
+    /**
+     * Stop the trace and finish its file.
+     *
+     * @return BBX_ERROR_OK on success.
+     */
+    BbxError StopTrace()
+    {
+        if (!m_handle) {
+            return BBX_ERROR_NULL_POINTER;
+        }
+        return bbx_graph_stop_trace(m_handle);
+    }
+
     /**
      * Check if the graph holds a valid handle.
      */
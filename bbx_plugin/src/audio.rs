@@ -65,6 +65,9 @@ pub unsafe fn process_audio<D: PluginDsp>(
             return;
         }
 
+        #[cfg(feature = "trace")]
+        let trace_start = inner.trace_start();
+
         // Debug check for buffer size limits
         debug_assert!(
             num_samples <= MAX_SAMPLES,
@@ -141,6 +144,11 @@ pub unsafe fn process_audio<D: PluginDsp>(
                 &inner.context,
             );
         }
+
+        inner.context.advance(samples_to_process);
+
+        #[cfg(feature = "trace")]
+        inner.trace_end(trace_start);
     }));
 
     // On panic, zero all outputs to produce silence instead of crashing the host
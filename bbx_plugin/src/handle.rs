@@ -4,7 +4,18 @@
 //! to reference the Rust effects chain, along with the generic
 //! `GraphInner` wrapper that holds any `PluginDsp` implementation.
 
-use bbx_dsp::{ChannelLayout, PluginDsp, context::DspContext};
+use std::{
+    cell::UnsafeCell,
+    sync::{Arc, Mutex, MutexGuard, PoisonError},
+};
+#[cfg(feature = "trace")]
+use std::{io, path::Path};
+
+#[cfg(feature = "trace")]
+use bbx_dsp::trace::{self, CALLBACK_ID, TraceConsumer, TraceRecorder, TraceStats, TraceWriter};
+use bbx_dsp::{PluginDsp, context::DspContext, tap::MeterTaps};
+
+use crate::memory::{BbxMemoryUsage, MemorySlot};
 
 /// Opaque handle representing a DSP effects chain.
 ///
@@ -16,6 +27,23 @@ pub struct BbxGraph {
     _private: [u8; 0],
 }
 
+/// Metering taps from [`PluginDsp::meter_taps`], shared with host threads.
+///
+/// Only `prepare` and the tap FFI functions lock it, never the audio thread.
+#[derive(Clone, Default)]
+pub struct TapSlot(Arc<Mutex<Option<MeterTaps>>>);
+
+impl TapSlot {
+    fn store(&self, taps: Option<MeterTaps>) {
+        *self.lock() = taps;
+    }
+
+    /// Lock the slot for reading or switching taps.
+    pub fn lock(&self) -> MutexGuard<'_, Option<MeterTaps>> {
+        self.0.lock().unwrap_or_else(PoisonError::into_inner)
+    }
+}
+
 /// Internal wrapper holding the plugin DSP and context.
 ///
 /// Generic over any type implementing `PluginDsp`.
@@ -28,21 +56,40 @@ pub struct GraphInner<D: PluginDsp> {
 
     /// Whether the graph has been prepared for playback.
     pub prepared: bool,
+
+    /// Metering taps, refreshed on each `prepare`.
+    pub taps: TapSlot,
+
+    /// Memory usage, refreshed on each `prepare`.
+    pub memory: MemorySlot,
+
+    /// Records the duration of each `process_audio` callback when set.
+    #[cfg(feature = "trace")]
+    pub tracer: Option<TraceRecorder>,
+
+    /// Writes the callback trace started by [`start_trace`](Self::start_trace).
+    #[cfg(feature = "trace")]
+    trace_writer: Option<TraceWriter>,
 }
 
 impl<D: PluginDsp> GraphInner<D> {
     /// Create a new GraphInner with default configuration.
     pub fn new() -> Self {
+        let dsp = D::new();
+        let taps = TapSlot::default();
+        taps.store(dsp.meter_taps());
+        let memory = MemorySlot::default();
+        memory.store(BbxMemoryUsage::of(&dsp));
         Self {
-            context: DspContext {
-                sample_rate: 44100.0,
-                buffer_size: 512,
-                num_channels: 2,
-                current_sample: 0,
-                channel_layout: ChannelLayout::default(),
-            },
-            dsp: D::new(),
+            context: DspContext::new(44100.0, 512, 2),
+            taps,
+            memory,
+            dsp,
             prepared: false,
+            #[cfg(feature = "trace")]
+            tracer: None,
+            #[cfg(feature = "trace")]
+            trace_writer: None,
         }
     }
 
@@ -54,15 +101,11 @@ impl<D: PluginDsp> GraphInner<D> {
         #[cfg(feature = "ftz-daz")]
         bbx_core::denormal::enable_ftz_daz();
 
-        self.context = DspContext {
-            sample_rate,
-            buffer_size,
-            num_channels,
-            current_sample: 0,
-            channel_layout: ChannelLayout::default(),
-        };
+        self.context = DspContext::new(sample_rate, buffer_size, num_channels);
 
         self.dsp.prepare(&self.context);
+        self.taps.store(self.dsp.meter_taps());
+        self.memory.store(BbxMemoryUsage::of(&self.dsp));
         self.prepared = true;
     }
 
@@ -70,6 +113,61 @@ impl<D: PluginDsp> GraphInner<D> {
     pub fn reset(&mut self) {
         self.dsp.reset();
     }
+
+    /// Start recording the duration of each `process_audio` callback.
+    ///
+    /// Returns the consumer for a [`TraceWriter`](bbx_dsp::trace::TraceWriter).
+    /// Graphs inside the DSP can trace their blocks separately with
+    /// [`Graph::enable_tracing`](bbx_dsp::graph::Graph::enable_tracing).
+    #[cfg(feature = "trace")]
+    pub fn enable_tracing(&mut self, capacity: usize) -> TraceConsumer {
+        let (recorder, consumer) = trace::trace_channel(capacity, Vec::new(), "process_audio");
+        self.tracer = Some(recorder);
+        consumer
+    }
+
+    /// Record each `process_audio` callback to a Chrome trace file at `path`.
+    ///
+    /// Replaces any trace already running. Like `prepare`, this must not be
+    /// called concurrently with `process_audio`.
+    #[cfg(feature = "trace")]
+    pub fn start_trace(&mut self, path: impl AsRef<Path>, capacity: usize) -> io::Result<()> {
+        self.stop_trace();
+        let consumer = self.enable_tracing(capacity);
+        match TraceWriter::spawn(consumer, path) {
+            Ok(writer) => {
+                self.trace_writer = Some(writer);
+                Ok(())
+            }
+            Err(e) => {
+                self.tracer = None;
+                Err(e)
+            }
+        }
+    }
+
+    /// Stop the trace started by [`start_trace`](Self::start_trace) and close its file.
+    ///
+    /// Returns `None` if no trace was running.
+    #[cfg(feature = "trace")]
+    pub fn stop_trace(&mut self) -> Option<io::Result<TraceStats>> {
+        self.tracer = None;
+        self.trace_writer.take().map(TraceWriter::stop)
+    }
+
+    #[cfg(feature = "trace")]
+    #[inline]
+    pub(crate) fn trace_start(&self) -> u64 {
+        if self.tracer.is_some() { trace::now_ns() } else { 0 }
+    }
+
+    #[cfg(feature = "trace")]
+    #[inline]
+    pub(crate) fn trace_end(&mut self, start_ns: u64) {
+        if let Some(tracer) = &mut self.tracer {
+            tracer.record(CALLBACK_ID, start_ns);
+        }
+    }
 }
 
 impl<D: PluginDsp> Default for GraphInner<D> {
@@ -78,6 +176,25 @@ impl<D: PluginDsp> Default for GraphInner<D> {
     }
 }
 
+#[cfg(feature = "trace")]
+impl<D: PluginDsp> Drop for GraphInner<D> {
+    fn drop(&mut self) {
+        // Finish the trace file so destroying the handle doesn't leave it truncated.
+        self.stop_trace();
+    }
+}
+
+/// Allocation behind a `BbxGraph` handle.
+///
+/// The graph sits in an `UnsafeCell` so the `&mut GraphInner` held while
+/// processing never covers `taps` or `memory`, which host threads read
+/// concurrently.
+struct GraphCell<D: PluginDsp> {
+    taps: TapSlot,
+    memory: MemorySlot,
+    inner: UnsafeCell<GraphInner<D>>,
+}
+
 /// Convert a raw pointer to a GraphInner reference.
 ///
 /// # Safety
@@ -88,11 +205,53 @@ impl<D: PluginDsp> Default for GraphInner<D> {
 /// - No other mutable references to the same handle exist concurrently.
 #[inline]
 pub unsafe fn graph_from_handle<'a, D: PluginDsp>(handle: *mut BbxGraph) -> &'a mut GraphInner<D> {
-    unsafe { &mut *(handle as *mut GraphInner<D>) }
+    unsafe { &mut *(*(handle as *const GraphCell<D>)).inner.get() }
+}
+
+/// Get the metering taps of a handle without borrowing its graph.
+///
+/// # Safety
+///
+/// The pointer must be valid and created by `handle_from_graph` with the same DSP type.
+#[inline]
+pub unsafe fn taps_from_handle<'a, D: PluginDsp>(handle: *mut BbxGraph) -> &'a TapSlot {
+    unsafe { &(*(handle as *const GraphCell<D>)).taps }
+}
+
+/// Get the memory usage snapshot of a handle without borrowing its graph.
+///
+/// # Safety
+///
+/// The pointer must be valid and created by `handle_from_graph` with the same DSP type.
+#[inline]
+pub unsafe fn memory_from_handle<'a, D: PluginDsp>(handle: *mut BbxGraph) -> &'a MemorySlot {
+    unsafe { &(*(handle as *const GraphCell<D>)).memory }
 }
 
 /// Convert a GraphInner to an opaque handle.
 #[inline]
+#[allow(clippy::boxed_local)] // Kept boxed to match the macro and docs
 pub fn handle_from_graph<D: PluginDsp>(inner: Box<GraphInner<D>>) -> *mut BbxGraph {
-    Box::into_raw(inner) as *mut BbxGraph
+    let cell = Box::new(GraphCell {
+        taps: inner.taps.clone(),
+        memory: inner.memory.clone(),
+        inner: UnsafeCell::new(*inner),
+    });
+    Box::into_raw(cell) as *mut BbxGraph
+}
+
+/// Destroy a handle created by `handle_from_graph`.
+///
+/// # Safety
+///
+/// The pointer must be valid, created by `handle_from_graph` with the same DSP
+/// type, and not used again afterwards.
+#[inline]
+pub unsafe fn drop_handle<D: PluginDsp>(handle: *mut BbxGraph) {
+    unsafe { drop(Box::from_raw(handle as *mut GraphCell<D>)) };
+}
+
+/// Size of the allocation behind a handle.
+pub(crate) fn handle_size<D: PluginDsp>() -> usize {
+    size_of::<GraphCell<D>>()
 }
@@ -33,7 +33,10 @@
 mod audio;
 mod handle;
 mod macros;
+mod memory;
 pub mod params;
+mod taps;
+mod trace;
 
 // Re-export the entire `bbx_*` crates as `*` so plugin projects only need bbx_plugin
 pub mod core {
@@ -51,8 +54,14 @@ pub use core::BbxError;
 
 pub use audio::process_audio;
 pub use dsp::{PluginDsp, context::DspContext};
-pub use handle::{BbxGraph, GraphInner, graph_from_handle, handle_from_graph};
+pub use handle::{
+    BbxGraph, GraphInner, TapSlot, drop_handle, graph_from_handle, handle_from_graph, memory_from_handle,
+    taps_from_handle,
+};
+pub use memory::{BbxMemoryUsage, MemorySlot, get_memory_usage};
 // Re-export parameter utilities
 pub use params::{
     JsonParamDef, ParamDef, ParamType, ParamsFile, generate_c_header_from_defs, generate_rust_indices_from_defs,
 };
+pub use taps::{BbxTapReading, read_tap, set_tap};
+pub use trace::{start_trace, stop_trace};
@@ -11,6 +11,11 @@
 /// - `bbx_graph_prepare()` - Prepare for playback
 /// - `bbx_graph_reset()` - Reset DSP state
 /// - `bbx_graph_process()` - Process audio
+/// - `bbx_graph_set_tap()` - Switch a metering tap on or off
+/// - `bbx_graph_read_tap()` - Read a metering tap
+/// - `bbx_graph_get_memory_usage()` - Report memory held by the graph
+/// - `bbx_graph_start_trace()` - Start writing a callback trace file
+/// - `bbx_graph_stop_trace()` - Stop the callback trace
 ///
 /// # Example
 ///
@@ -42,7 +47,7 @@ macro_rules! bbx_plugin_ffi {
         pub extern "C" fn bbx_graph_destroy(handle: *mut $crate::BbxGraph) {
             if !handle.is_null() {
                 unsafe {
-                    drop(Box::from_raw(handle as *mut PluginGraphInner));
+                    $crate::drop_handle::<$dsp_type>(handle);
                 }
             }
         }
@@ -113,5 +118,52 @@ macro_rules! bbx_plugin_ffi {
                 num_midi_events,
             );
         }
+
+        /// Switch the metering tap on a block output on or off.
+        #[unsafe(no_mangle)]
+        pub unsafe extern "C" fn bbx_graph_set_tap(
+            handle: *mut $crate::BbxGraph,
+            block_id: u32,
+            output: u32,
+            enabled: bool,
+        ) -> $crate::BbxError {
+            unsafe { $crate::set_tap::<$dsp_type>(handle, block_id, output, enabled) }
+        }
+
+        /// Read the latest measurement of a tapped block output.
+        #[unsafe(no_mangle)]
+        pub unsafe extern "C" fn bbx_graph_read_tap(
+            handle: *mut $crate::BbxGraph,
+            block_id: u32,
+            output: u32,
+            reading: *mut $crate::BbxTapReading,
+        ) -> $crate::BbxError {
+            unsafe { $crate::read_tap::<$dsp_type>(handle, block_id, output, reading) }
+        }
+
+        /// Report the memory held by the graph.
+        #[unsafe(no_mangle)]
+        pub unsafe extern "C" fn bbx_graph_get_memory_usage(
+            handle: *mut $crate::BbxGraph,
+            usage: *mut $crate::BbxMemoryUsage,
+        ) -> $crate::BbxError {
+            unsafe { $crate::get_memory_usage::<$dsp_type>(handle, usage) }
+        }
+
+        /// Start writing each process callback to a Chrome trace file.
+        #[unsafe(no_mangle)]
+        pub unsafe extern "C" fn bbx_graph_start_trace(
+            handle: *mut $crate::BbxGraph,
+            path: *const ::std::ffi::c_char,
+            capacity: u32,
+        ) -> $crate::BbxError {
+            unsafe { $crate::start_trace::<$dsp_type>(handle, path, capacity) }
+        }
+
+        /// Stop the callback trace and finish its file.
+        #[unsafe(no_mangle)]
+        pub unsafe extern "C" fn bbx_graph_stop_trace(handle: *mut $crate::BbxGraph) -> $crate::BbxError {
+            unsafe { $crate::stop_trace::<$dsp_type>(handle) }
+        }
     };
 }
@@ -0,0 +1,177 @@
+//! Memory usage FFI function.
+//!
+//! This module provides the generic function behind
+//! `bbx_graph_get_memory_usage`, which reports the memory held by a graph
+//! exposed through [`PluginDsp::memory_report`].
+
+use std::sync::{Arc, Mutex, PoisonError};
+
+use bbx_core::BbxError;
+use bbx_dsp::PluginDsp;
+
+use crate::handle::{BbxGraph, handle_size, memory_from_handle};
+
+/// Memory held by a plugin graph, in bytes (matches `BbxMemoryUsage` in C).
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct BbxMemoryUsage {
+    /// Everything below combined.
+    pub total: u64,
+    /// Audio buffers for block outputs.
+    pub buffers: u64,
+    /// Block state, including heap storage each block owns.
+    pub state: u64,
+    /// Data blocks share with other owners, such as decoded audio files.
+    pub shared: u64,
+    /// Graph bookkeeping and the FFI handle itself.
+    pub graph: u64,
+}
+
+impl BbxMemoryUsage {
+    /// Build the usage of `dsp` from its [`PluginDsp::memory_report`].
+    ///
+    /// Without a report only the handle is counted.
+    pub fn of<D: PluginDsp>(dsp: &D) -> Self {
+        let report = dsp.memory_report().unwrap_or_default();
+        let graph = report.graph + handle_size::<D>();
+        Self {
+            total: (report.buffers() + report.state() + report.shared() + graph) as u64,
+            buffers: report.buffers() as u64,
+            state: report.state() as u64,
+            shared: report.shared() as u64,
+            graph: graph as u64,
+        }
+    }
+}
+
+/// Memory usage snapshot, shared with host threads.
+///
+/// Written when the graph is created and on each `prepare`, which walk the
+/// graph on the thread that owns it. The FFI only reads the snapshot, so it
+/// never touches the graph the audio thread is processing.
+#[derive(Clone, Default)]
+pub struct MemorySlot(Arc<Mutex<BbxMemoryUsage>>);
+
+impl MemorySlot {
+    pub(crate) fn store(&self, usage: BbxMemoryUsage) {
+        *self.0.lock().unwrap_or_else(PoisonError::into_inner) = usage;
+    }
+
+    /// The usage recorded by the last `prepare`.
+    pub fn load(&self) -> BbxMemoryUsage {
+        *self.0.lock().unwrap_or_else(PoisonError::into_inner)
+    }
+}
+
+/// Report the memory held by a plugin graph.
+///
+/// Returns the snapshot taken when the graph was created or last prepared.
+/// Safe to call from any thread while audio is processing, like
+/// `bbx_graph_read_tap`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid pointer from `bbx_graph_create`, or null.
+/// - `usage` must be valid for writing one `BbxMemoryUsage`, or null.
+pub unsafe fn get_memory_usage<D: PluginDsp>(handle: *mut BbxGraph, usage: *mut BbxMemoryUsage) -> BbxError {
+    if handle.is_null() || usage.is_null() {
+        return BbxError::NullPointer;
+    }
+
+    let value = unsafe { memory_from_handle::<D>(handle) }.load();
+    unsafe { usage.write(value) };
+    BbxError::Ok
+}
+
+#[cfg(test)]
+mod tests {
+    use bbx_dsp::{
+        blocks::OscillatorBlock,
+        context::DspContext,
+        graph::{Graph, GraphBuilder},
+        memory::MemoryReport,
+        waveform::Waveform,
+    };
+    use bbx_midi::MidiEvent;
+
+    use super::*;
+    use crate::handle::{GraphInner, drop_handle, handle_from_graph};
+
+    struct OscillatorDsp {
+        graph: Graph<f32>,
+    }
+
+    impl Default for OscillatorDsp {
+        fn default() -> Self {
+            let mut builder = GraphBuilder::new(44100.0, 64, 1);
+            builder.add(OscillatorBlock::new(440.0, Waveform::Sine, None));
+            Self { graph: builder.build() }
+        }
+    }
+
+    impl PluginDsp for OscillatorDsp {
+        fn new() -> Self {
+            Self::default()
+        }
+
+        fn prepare(&mut self, _context: &DspContext) {}
+
+        fn reset(&mut self) {}
+
+        fn apply_parameters(&mut self, _params: &[f32]) {}
+
+        fn process(&mut self, _inputs: &[&[f32]], outputs: &mut [&mut [f32]], _midi: &[MidiEvent], _: &DspContext) {
+            self.graph.process_buffers(outputs);
+        }
+
+        fn memory_report(&self) -> Option<MemoryReport> {
+            Some(self.graph.memory_report())
+        }
+    }
+
+    #[test]
+    fn test_get_memory_usage() {
+        let handle = handle_from_graph(Box::new(GraphInner::<OscillatorDsp>::new()));
+        let mut usage = BbxMemoryUsage::default();
+
+        unsafe {
+            assert_eq!(get_memory_usage::<OscillatorDsp>(handle, &mut usage), BbxError::Ok);
+            assert_eq!(
+                get_memory_usage::<OscillatorDsp>(handle, std::ptr::null_mut()),
+                BbxError::NullPointer
+            );
+            drop_handle::<OscillatorDsp>(handle);
+        }
+
+        // Oscillator and output block buffers, one channel each.
+        assert_eq!(usage.buffers, 2 * 64 * size_of::<f32>() as u64);
+        assert!(usage.state > 0);
+        assert_eq!(usage.shared, 0);
+        assert!(usage.graph >= handle_size::<OscillatorDsp>() as u64);
+        assert_eq!(usage.total, usage.buffers + usage.state + usage.shared + usage.graph);
+    }
+
+    #[test]
+    fn test_get_memory_usage_while_processing() {
+        let handle = handle_from_graph(Box::new(GraphInner::<OscillatorDsp>::new()));
+        let expected = BbxMemoryUsage::of(&OscillatorDsp::default());
+
+        let address = handle as usize;
+        let reader = std::thread::spawn(move || {
+            let handle = address as *mut BbxGraph;
+            for _ in 0..1000 {
+                let mut usage = BbxMemoryUsage::default();
+                unsafe { get_memory_usage::<OscillatorDsp>(handle, &mut usage) };
+                assert_eq!(usage, expected);
+            }
+        });
+
+        let inner = unsafe { crate::handle::graph_from_handle::<OscillatorDsp>(handle) };
+        let mut output = [0.0f32; 64];
+        while !reader.is_finished() {
+            inner.dsp.graph.process_buffers(&mut [&mut output]);
+        }
+        reader.join().unwrap();
+        unsafe { drop_handle::<OscillatorDsp>(handle) };
+    }
+}
@@ -0,0 +1,190 @@
+//! Metering tap FFI functions.
+//!
+//! This module provides the generic functions behind `bbx_graph_set_tap` and
+//! `bbx_graph_read_tap`, which let the host meter any block output of a graph
+//! exposed through [`PluginDsp::meter_taps`].
+
+use bbx_core::BbxError;
+use bbx_dsp::{PluginDsp, block::BlockId, tap::TapReading};
+
+use crate::handle::{BbxGraph, taps_from_handle};
+
+/// Latest measurement of a tapped block output (matches `BbxTapReading` in C).
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct BbxTapReading {
+    /// Peak magnitude over the last processed buffer.
+    pub peak: f32,
+    /// RMS level over the last processed buffer.
+    pub rms: f32,
+    /// Samples above full scale since the tap was enabled or last reset.
+    pub clips: u64,
+    /// Number of buffers measured since the tap was enabled.
+    pub updates: u64,
+}
+
+impl From<TapReading> for BbxTapReading {
+    fn from(reading: TapReading) -> Self {
+        Self {
+            peak: reading.peak,
+            rms: reading.rms,
+            clips: reading.clips,
+            updates: reading.updates,
+        }
+    }
+}
+
+/// Switch the tap on a block output on or off.
+///
+/// Safe to call from any thread while audio is processing: only the tap slot
+/// is touched, which lives outside the graph borrowed by `bbx_graph_process`.
+/// Calls briefly wait on a concurrent `bbx_graph_prepare` swapping the taps.
+///
+/// # Safety
+///
+/// `handle` must be a valid pointer from `bbx_graph_create`, or null.
+pub unsafe fn set_tap<D: PluginDsp>(handle: *mut BbxGraph, block: u32, output: u32, enabled: bool) -> BbxError {
+    if handle.is_null() {
+        return BbxError::NullPointer;
+    }
+
+    let taps = unsafe { taps_from_handle::<D>(handle) }.lock();
+    match &*taps {
+        Some(taps) if taps.set(BlockId(block as usize), output as usize, enabled) => BbxError::Ok,
+        _ => BbxError::InvalidParameter,
+    }
+}
+
+/// Read the latest measurement of a tapped block output.
+///
+/// Returns `BbxError::InvalidParameter` if the tap is off or doesn't exist.
+/// Safe to call from any thread, like [`set_tap`].
+///
+/// # Safety
+///
+/// - `handle` must be a valid pointer from `bbx_graph_create`, or null.
+/// - `reading` must be valid for writing one `BbxTapReading`, or null.
+pub unsafe fn read_tap<D: PluginDsp>(
+    handle: *mut BbxGraph,
+    block: u32,
+    output: u32,
+    reading: *mut BbxTapReading,
+) -> BbxError {
+    if handle.is_null() || reading.is_null() {
+        return BbxError::NullPointer;
+    }
+
+    let taps = unsafe { taps_from_handle::<D>(handle) }.lock();
+    match taps
+        .as_ref()
+        .and_then(|taps| taps.read(BlockId(block as usize), output as usize))
+    {
+        Some(value) => {
+            unsafe { reading.write(value.into()) };
+            BbxError::Ok
+        }
+        None => BbxError::InvalidParameter,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use bbx_dsp::{
+        blocks::OscillatorBlock,
+        context::DspContext,
+        graph::{Graph, GraphBuilder},
+        tap::MeterTaps,
+        waveform::Waveform,
+    };
+    use bbx_midi::MidiEvent;
+
+    use super::*;
+    use crate::handle::{GraphInner, drop_handle, graph_from_handle, handle_from_graph};
+
+    struct OscillatorDsp {
+        graph: Graph<f32>,
+        taps: MeterTaps,
+    }
+
+    impl Default for OscillatorDsp {
+        fn default() -> Self {
+            let mut builder = GraphBuilder::new(44100.0, 64, 1);
+            builder.add(OscillatorBlock::new(440.0, Waveform::Square, None));
+            let mut graph = builder.build();
+            let taps = graph.enable_taps();
+            Self { graph, taps }
+        }
+    }
+
+    impl PluginDsp for OscillatorDsp {
+        fn new() -> Self {
+            Self::default()
+        }
+
+        fn prepare(&mut self, _context: &DspContext) {}
+
+        fn reset(&mut self) {}
+
+        fn apply_parameters(&mut self, _params: &[f32]) {}
+
+        fn process(&mut self, _inputs: &[&[f32]], outputs: &mut [&mut [f32]], _midi: &[MidiEvent], _: &DspContext) {
+            self.graph.process_buffers(outputs);
+        }
+
+        fn meter_taps(&self) -> Option<MeterTaps> {
+            Some(self.taps.clone())
+        }
+    }
+
+    #[test]
+    fn test_set_and_read_tap() {
+        let handle = handle_from_graph(Box::new(GraphInner::<OscillatorDsp>::new()));
+        let mut reading = BbxTapReading::default();
+
+        unsafe {
+            assert_eq!(
+                read_tap::<OscillatorDsp>(handle, 0, 0, &mut reading),
+                BbxError::InvalidParameter
+            );
+            assert_eq!(set_tap::<OscillatorDsp>(handle, 0, 0, true), BbxError::Ok);
+            assert_eq!(set_tap::<OscillatorDsp>(handle, 0, 5, true), BbxError::InvalidParameter);
+
+            let inner = graph_from_handle::<OscillatorDsp>(handle);
+            let mut output = [0.0f32; 64];
+            inner.dsp.graph.process_buffers(&mut [&mut output]);
+
+            assert_eq!(read_tap::<OscillatorDsp>(handle, 0, 0, &mut reading), BbxError::Ok);
+            assert_eq!(
+                read_tap::<OscillatorDsp>(handle, 0, 0, std::ptr::null_mut()),
+                BbxError::NullPointer
+            );
+            drop_handle::<OscillatorDsp>(handle);
+        }
+
+        assert_eq!(reading.updates, 1);
+        assert!(reading.peak > 0.9);
+    }
+
+    #[test]
+    fn test_read_tap_while_processing() {
+        let handle = handle_from_graph(Box::new(GraphInner::<OscillatorDsp>::new()));
+        unsafe { assert_eq!(set_tap::<OscillatorDsp>(handle, 0, 0, true), BbxError::Ok) };
+
+        let address = handle as usize;
+        let meter = std::thread::spawn(move || {
+            let handle = address as *mut BbxGraph;
+            let mut reading = BbxTapReading::default();
+            while reading.updates < 100 {
+                unsafe { read_tap::<OscillatorDsp>(handle, 0, 0, &mut reading) };
+            }
+        });
+
+        let inner = unsafe { graph_from_handle::<OscillatorDsp>(handle) };
+        let mut output = [0.0f32; 64];
+        while !meter.is_finished() {
+            inner.dsp.graph.process_buffers(&mut [&mut output]);
+        }
+        meter.join().unwrap();
+        unsafe { drop_handle::<OscillatorDsp>(handle) };
+    }
+}
@@ -0,0 +1,172 @@
+//! Callback tracing FFI functions.
+//!
+//! This module provides the generic functions behind `bbx_graph_start_trace`
+//! and `bbx_graph_stop_trace`, which record the duration of each
+//! `bbx_graph_process` call to a Chrome trace file. They only trace when
+//! `bbx_plugin` is built with the `trace` feature.
+
+use std::ffi::c_char;
+
+use bbx_core::BbxError;
+use bbx_dsp::PluginDsp;
+
+use crate::handle::BbxGraph;
+
+/// Start writing each `process_audio` callback to a Chrome trace file.
+///
+/// `capacity` is the number of events buffered between the audio thread and
+/// the writer thread; callbacks that find it full are counted as dropped.
+/// Returns `BbxError::InvalidParameter` if the path can't be created, if
+/// `capacity` is zero, or if the crate was built without the `trace` feature.
+/// Call from the message thread, not concurrently with `bbx_graph_process`.
+///
+/// # Safety
+///
+/// - `handle` must be a valid pointer from `bbx_graph_create`, or null.
+/// - `path` must be a NUL-terminated UTF-8 string, or null.
+pub unsafe fn start_trace<D: PluginDsp>(handle: *mut BbxGraph, path: *const c_char, capacity: u32) -> BbxError {
+    if handle.is_null() || path.is_null() {
+        return BbxError::NullPointer;
+    }
+
+    #[cfg(feature = "trace")]
+    {
+        let Ok(path) = unsafe { std::ffi::CStr::from_ptr(path) }.to_str() else {
+            return BbxError::InvalidParameter;
+        };
+        if capacity == 0 {
+            return BbxError::InvalidParameter;
+        }
+
+        let inner = unsafe { crate::handle::graph_from_handle::<D>(handle) };
+        match inner.start_trace(path, capacity as usize) {
+            Ok(()) => BbxError::Ok,
+            Err(_) => BbxError::InvalidParameter,
+        }
+    }
+
+    #[cfg(not(feature = "trace"))]
+    {
+        let _ = capacity;
+        BbxError::InvalidParameter
+    }
+}
+
+/// Stop the trace started by [`start_trace`] and finish its file.
+///
+/// Returns `BbxError::InvalidParameter` if no trace was running or the file
+/// couldn't be written. Destroying the handle also stops the trace.
+/// Call from the message thread, not concurrently with `bbx_graph_process`.
+///
+/// # Safety
+///
+/// `handle` must be a valid pointer from `bbx_graph_create`, or null.
+pub unsafe fn stop_trace<D: PluginDsp>(handle: *mut BbxGraph) -> BbxError {
+    if handle.is_null() {
+        return BbxError::NullPointer;
+    }
+
+    #[cfg(feature = "trace")]
+    {
+        let inner = unsafe { crate::handle::graph_from_handle::<D>(handle) };
+        match inner.stop_trace() {
+            Some(Ok(_)) => BbxError::Ok,
+            _ => BbxError::InvalidParameter,
+        }
+    }
+
+    #[cfg(not(feature = "trace"))]
+    BbxError::InvalidParameter
+}
+
+#[cfg(test)]
+mod tests {
+    use bbx_midi::MidiEvent;
+
+    use super::*;
+    use crate::{
+        DspContext,
+        handle::{GraphInner, drop_handle, handle_from_graph},
+    };
+
+    #[derive(Default)]
+    struct SilentDsp;
+
+    impl PluginDsp for SilentDsp {
+        fn new() -> Self {
+            Self
+        }
+
+        fn prepare(&mut self, _context: &DspContext) {}
+
+        fn reset(&mut self) {}
+
+        fn apply_parameters(&mut self, _params: &[f32]) {}
+
+        fn process(
+            &mut self,
+            _inputs: &[&[f32]],
+            outputs: &mut [&mut [f32]],
+            _midi_events: &[MidiEvent],
+            _context: &DspContext,
+        ) {
+            for output in outputs.iter_mut() {
+                output.fill(0.0);
+            }
+        }
+    }
+
+    #[test]
+    fn test_stop_without_trace_is_rejected() {
+        let handle = handle_from_graph(Box::new(GraphInner::<SilentDsp>::new()));
+        unsafe {
+            assert_eq!(stop_trace::<SilentDsp>(handle), BbxError::InvalidParameter);
+            assert_eq!(
+                start_trace::<SilentDsp>(handle, std::ptr::null(), 64),
+                BbxError::NullPointer
+            );
+            drop_handle::<SilentDsp>(handle);
+        }
+    }
+
+    #[cfg(feature = "trace")]
+    #[test]
+    fn test_trace_records_process_callbacks() {
+        let path = std::env::temp_dir().join(format!("bbx_plugin_trace_{}.json", std::process::id()));
+        let c_path = std::ffi::CString::new(path.to_str().unwrap()).unwrap();
+
+        let handle = handle_from_graph(Box::new(GraphInner::<SilentDsp>::new()));
+        let mut output = vec![0.0f32; 64];
+        let mut outputs = [output.as_mut_ptr()];
+        unsafe {
+            assert_eq!(
+                start_trace::<SilentDsp>(handle, c_path.as_ptr(), 0),
+                BbxError::InvalidParameter
+            );
+            assert_eq!(start_trace::<SilentDsp>(handle, c_path.as_ptr(), 64), BbxError::Ok);
+            let inner = crate::graph_from_handle::<SilentDsp>(handle);
+            inner.prepare(44100.0, 64, 1);
+            for _ in 0..3 {
+                crate::process_audio::<SilentDsp>(
+                    handle,
+                    std::ptr::null(),
+                    outputs.as_mut_ptr(),
+                    1,
+                    64,
+                    std::ptr::null(),
+                    0,
+                    std::ptr::null(),
+                    0,
+                );
+            }
+            assert_eq!(stop_trace::<SilentDsp>(handle), BbxError::Ok);
+            drop_handle::<SilentDsp>(handle);
+        }
+
+        let json: serde_json::Value = serde_json::from_str(&std::fs::read_to_string(&path).unwrap()).unwrap();
+        std::fs::remove_file(&path).ok();
+        let events = json["traceEvents"].as_array().unwrap();
+        assert_eq!(events.len(), 3);
+        assert!(events.iter().all(|event| event["name"] == "process_audio"));
+    }
+}